@@ -0,0 +1,643 @@
+/**
+ * @file bench.c
+ * @brief Microbenchmarks and load test for the todo library
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the program behind "make bench". For every list
+ * size it builds a synthetic list and times the core operations: create,
+ * find, status and text queries, rendering with todo_read_all, saving and
+ * loading (plain, mapped and compressed) and delete. Each size runs in a
+ * child process so its peak RSS is its own. Results are printed as one
+ * JSON object per line:
+ *
+ *   {"bench":"find","n":100000,"ops":100000,"seconds":0.0041,
+ *    "ops_per_sec":24390243.9,"p50_ns":30,"p90_ns":41,"p99_ns":70,
+ *    "max_ns":5120,"peak_rss_kb":10432}
+ *
+ * Per-operation benches time single calls (sampling at most
+ * BENCH_MAX_SAMPLES of them for the percentiles); whole-list benches are
+ * repeated and their percentiles are over the repetitions.
+ */
+
+// Needed for clock_gettime, fork and dup2 under -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/todo.h"
+#include "../include/file_io.h"
+#include "../include/search.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Largest list the harness builds
+#define BENCH_MAX_SIZE 10000000
+
+// Most list sizes given with -s
+#define BENCH_MAX_SIZES 16
+
+// Most latencies kept per bench; longer runs time every k-th call
+#define BENCH_MAX_SAMPLES 1000000
+
+// Whole-list benches run at least this often and for at least this long
+#define BENCH_MIN_REPEATS 5
+#define BENCH_MIN_SECONDS 0.5
+
+// Queries timed per query bench, fewer once they take BENCH_QUERY_SECONDS
+#define BENCH_QUERIES 1000
+#define BENCH_QUERY_SECONDS 2.0
+
+/**
+ * @brief Latencies and totals of one bench
+ */
+typedef struct {
+    uint64_t* samples;          // Latency of timed calls, in nanoseconds
+    size_t count;
+    size_t capacity;
+    long ops;                   // Calls made
+    double seconds;             // Time spent in the calls
+} BenchResult;
+
+/**
+ * @brief Read the monotonic clock
+ * @return Nanoseconds since an arbitrary point
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Cheap deterministic random numbers (xorshift32)
+ * @param state Generator state, never 0
+ * @return Next value
+ */
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Start a bench
+ * @param result Result to reset
+ * @param expected Calls the bench will make
+ * @return 0 on success, -1 on allocation failure
+ */
+static int result_init(BenchResult* result, long expected) {
+    memset(result, 0, sizeof(BenchResult));
+    result->capacity = expected < BENCH_MAX_SAMPLES ? (size_t)expected : BENCH_MAX_SAMPLES;
+    if (result->capacity == 0) {
+        result->capacity = 1;
+    }
+    result->samples = (uint64_t*)malloc(sizeof(uint64_t) * result->capacity);
+    return result->samples ? 0 : -1;
+}
+
+/**
+ * @brief Record one timed call
+ * @param result Result of the bench
+ * @param elapsed Latency in nanoseconds
+ */
+static void result_add(BenchResult* result, uint64_t elapsed) {
+    if (result->count < result->capacity) {
+        result->samples[result->count++] = elapsed;
+    }
+}
+
+/**
+ * @brief Order latencies for qsort
+ * @param a First latency
+ * @param b Second latency
+ * @return Negative, zero or positive
+ */
+static int compare_samples(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Latency at a percentile of sorted samples
+ * @param result Result with sorted samples
+ * @param percent Percentile (0-100)
+ * @return Latency in nanoseconds
+ */
+static uint64_t percentile(const BenchResult* result, double percent) {
+    if (result->count == 0) {
+        return 0;
+    }
+    size_t index = (size_t)(percent / 100.0 * (double)(result->count - 1) + 0.5);
+    return result->samples[index];
+}
+
+/**
+ * @brief Peak resident set size of this process
+ * @return Kibibytes
+ */
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#ifdef __APPLE__
+    return (long)(usage.ru_maxrss / 1024);   // Bytes on macOS
+#else
+    return (long)usage.ru_maxrss;            // Kibibytes elsewhere
+#endif
+}
+
+/**
+ * @brief Print a finished bench as one JSON line and free it
+ * @param name Bench name
+ * @param n List size
+ * @param result Result of the bench
+ */
+static void report(const char* name, int n, BenchResult* result) {
+    qsort(result->samples, result->count, sizeof(uint64_t), compare_samples);
+    double ops_per_sec = result->seconds > 0 ? (double)result->ops / result->seconds : 0.0;
+    printf("{\"bench\":\"%s\",\"n\":%d,\"ops\":%ld,\"seconds\":%.6f,\"ops_per_sec\":%.1f,"
+           "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu,\"peak_rss_kb\":%ld}\n",
+           name, n, result->ops, result->seconds, ops_per_sec,
+           (unsigned long long)percentile(result, 50), (unsigned long long)percentile(result, 90),
+           (unsigned long long)percentile(result, 99),
+           (unsigned long long)(result->count > 0 ? result->samples[result->count - 1] : 0),
+           peak_rss_kb());
+    fflush(stdout);
+    free(result->samples);
+}
+
+/**
+ * @brief Print a bench that could not run
+ * @param name Bench name
+ * @param n List size
+ * @param error Negative TodoError
+ */
+static void report_failure(const char* name, int n, int error) {
+    printf("{\"bench\":\"%s\",\"n\":%d,\"error\":\"%s\"}\n", name, n, todo_strerror(error));
+    fflush(stdout);
+}
+
+// Words the synthetic titles are made of, so text queries have matches
+static const char* const WORDS[] = {
+    "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+    "india", "juliet", "kilo", "lima", "mike", "november", "oscar", "papa"
+};
+#define WORD_COUNT ((int)(sizeof(WORDS) / sizeof(WORDS[0])))
+
+/**
+ * @brief Time todo_create on an empty list
+ * @param list Empty list; filled with n todos
+ * @param n Todos to create
+ * @param seed Generator state
+ * @return TODO_OK, or negative TodoError if a create failed
+ */
+static int bench_create(TodoList* list, int n, uint32_t* seed) {
+    BenchResult result;
+    if (result_init(&result, n) != 0) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    long stride = n / BENCH_MAX_SAMPLES + 1;
+    char title[64];
+    char description[96];
+    uint64_t start = now_ns();
+    for (int i = 0; i < n; i++) {
+        uint32_t r = next_random(seed);
+        snprintf(title, sizeof(title), "%s %s task %d", WORDS[r % WORD_COUNT], WORDS[(r >> 4) % WORD_COUNT], i);
+        snprintf(description, sizeof(description), "Generated %s item for the benchmark", WORDS[(r >> 8) % WORD_COUNT]);
+        Priority priority = (Priority)(PRIORITY_LOW + (int)((r >> 12) % 3));
+        
+        int id;
+        if (i % stride == 0) {
+            uint64_t t0 = now_ns();
+            id = todo_create(list, title, description, priority);
+            result_add(&result, now_ns() - t0);
+        } else {
+            id = todo_create(list, title, description, priority);
+        }
+        if (id < 0) {
+            free(result.samples);
+            return id;
+        }
+        if ((r >> 16) % 4 == 0) {
+            todo_complete(list, id);
+        }
+    }
+    result.seconds = (double)(now_ns() - start) / 1e9;
+    result.ops = n;
+    report("create", n, &result);
+    return TODO_OK;
+}
+
+/**
+ * @brief Time todo_find_by_id with random existing IDs
+ * @param list List to search
+ * @param n List size
+ * @param seed Generator state
+ */
+static void bench_find(const TodoList* list, int n, uint32_t* seed) {
+    BenchResult result;
+    if (result_init(&result, n) != 0) {
+        report_failure("find", n, TODO_ERR_NO_MEMORY);
+        return;
+    }
+    
+    long stride = n / BENCH_MAX_SAMPLES + 1;
+    long found = 0;
+    uint64_t start = now_ns();
+    for (int i = 0; i < n; i++) {
+        int id = 1 + (int)(next_random(seed) % (uint32_t)n);
+        if (i % stride == 0) {
+            uint64_t t0 = now_ns();
+            found += todo_find_by_id(list, id) != NULL;
+            result_add(&result, now_ns() - t0);
+        } else {
+            found += todo_find_by_id(list, id) != NULL;
+        }
+    }
+    result.seconds = (double)(now_ns() - start) / 1e9;
+    result.ops = n;
+    if (found != n) {
+        fprintf(stderr, "find: %ld of %d IDs found\n", found, n);
+    }
+    report("find", n, &result);
+}
+
+/**
+ * @brief Count a visited todo
+ * @param list Unused
+ * @param todo Unused
+ * @param user_data Counter
+ * @return 0 to keep going
+ */
+static int count_visit(const TodoList* list, const Todo* todo, void* user_data) {
+    (void)list;
+    (void)todo;
+    (*(long*)user_data)++;
+    return 0;
+}
+
+/**
+ * @brief Check whether a query bench should run another query
+ * @param result Result of the bench so far
+ * @return 1 to keep going, 0 once enough queries ran or time is up
+ */
+static int more_queries(const BenchResult* result) {
+    return result->ops < BENCH_QUERIES &&
+           (result->ops < BENCH_MIN_REPEATS || result->seconds < BENCH_QUERY_SECONDS);
+}
+
+/**
+ * @brief Time status/priority queries and full-text searches
+ * @param list List to query
+ * @param n List size
+ * @param seed Generator state
+ */
+static void bench_queries(TodoList* list, int n, uint32_t* seed) {
+    BenchResult result;
+    long visited = 0;
+    
+    // Random combinations of one status and one or two priorities
+    if (result_init(&result, BENCH_QUERIES) == 0) {
+        while (more_queries(&result)) {
+            uint32_t r = next_random(seed);
+            unsigned status_mask = TODO_STATUS_BIT(r % 2 ? STATUS_COMPLETED : STATUS_PENDING);
+            unsigned priority_mask = TODO_PRIORITY_BIT(PRIORITY_LOW + (int)((r >> 1) % 3)) |
+                                     (r & 0x10 ? TODO_PRIORITY_BIT(PRIORITY_HIGH) : 0);
+            uint64_t t0 = now_ns();
+            todo_query(list, status_mask, priority_mask, count_visit, &visited);
+            uint64_t elapsed = now_ns() - t0;
+            result_add(&result, elapsed);
+            result.seconds += (double)elapsed / 1e9;
+            result.ops++;
+        }
+        report("query", n, &result);
+    } else {
+        report_failure("query", n, TODO_ERR_NO_MEMORY);
+    }
+    
+    // Building the inverted index is timed as one operation
+    if (result_init(&result, 1) != 0) {
+        report_failure("search_index", n, TODO_ERR_NO_MEMORY);
+        return;
+    }
+    uint64_t t0 = now_ns();
+    int status = todo_list_enable_search(list);
+    result_add(&result, now_ns() - t0);
+    result.seconds = (double)result.samples[0] / 1e9;
+    result.ops = 1;
+    if (status != TODO_OK) {
+        free(result.samples);
+        report_failure("search_index", n, status);
+        return;
+    }
+    report("search_index", n, &result);
+    
+    // Two-word queries, one of them a prefix
+    if (result_init(&result, BENCH_QUERIES) != 0) {
+        report_failure("search", n, TODO_ERR_NO_MEMORY);
+        return;
+    }
+    char query[64];
+    while (more_queries(&result)) {
+        uint32_t r = next_random(seed);
+        snprintf(query, sizeof(query), "%s %.3s*", WORDS[r % WORD_COUNT], WORDS[(r >> 4) % WORD_COUNT]);
+        t0 = now_ns();
+        todo_search(list, query, 0, count_visit, &visited);
+        uint64_t elapsed = now_ns() - t0;
+        result_add(&result, elapsed);
+        result.seconds += (double)elapsed / 1e9;
+        result.ops++;
+    }
+    report("search", n, &result);
+    todo_list_disable_search(list);
+}
+
+/**
+ * @brief Run a whole-list operation repeatedly and report its timings
+ * @param name Bench name
+ * @param n List size
+ * @param run Operation; returns TODO_OK or a negative TodoError
+ * @param list List passed to run
+ * @param filename File passed to run
+ */
+static void bench_repeated(const char* name, int n, int (*run)(TodoList*, const char*), TodoList* list,
+                           const char* filename) {
+    BenchResult result;
+    if (result_init(&result, BENCH_MAX_SAMPLES) != 0) {
+        report_failure(name, n, TODO_ERR_NO_MEMORY);
+        return;
+    }
+    
+    while (result.ops < BENCH_MIN_REPEATS || result.seconds < BENCH_MIN_SECONDS) {
+        uint64_t t0 = now_ns();
+        int status = run(list, filename);
+        uint64_t elapsed = now_ns() - t0;
+        if (status != TODO_OK) {
+            free(result.samples);
+            report_failure(name, n, status);
+            return;
+        }
+        result_add(&result, elapsed);
+        result.seconds += (double)elapsed / 1e9;
+        result.ops++;
+    }
+    report(name, n, &result);
+}
+
+/**
+ * @brief Render the whole list with output sent to /dev/null
+ * @param list List to render
+ * @param filename Unused
+ * @return TODO_OK, or TODO_ERR_IO if stdout could not be redirected
+ */
+static int run_read_all(TodoList* list, const char* filename) {
+    (void)filename;
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved < 0 || null_fd < 0 || dup2(null_fd, STDOUT_FILENO) < 0) {
+        if (saved >= 0) {
+            close(saved);
+        }
+        if (null_fd >= 0) {
+            close(null_fd);
+        }
+        return TODO_ERR_IO;
+    }
+    close(null_fd);
+    
+    todo_read_all(list);
+    
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    return TODO_OK;
+}
+
+/**
+ * @brief Save the list as a plain snapshot
+ * @param list List to save
+ * @param filename Snapshot to write
+ * @return TODO_OK or negative TodoError
+ */
+static int run_save(TodoList* list, const char* filename) {
+    return save_todos_to_file_ex(list, filename, TODO_SAVE_UNCOMPRESSED);
+}
+
+/**
+ * @brief Save the list as a compressed snapshot
+ * @param list List to save
+ * @param filename Snapshot to write
+ * @return TODO_OK or negative TodoError
+ */
+static int run_save_packed(TodoList* list, const char* filename) {
+    return save_todos_to_file_ex(list, filename, TODO_SAVE_COMPRESS);
+}
+
+/**
+ * @brief Load a snapshot into a fresh list
+ * @param filename Snapshot to read
+ * @param flags TODO_LOAD_* flags
+ * @return TODO_OK or negative TodoError
+ */
+static int load_fresh(const char* filename, int flags) {
+    TodoList* loaded = todo_list_create();
+    if (!loaded) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    int status = load_todos_from_file_ex(loaded, filename, flags);
+    todo_list_destroy(loaded);
+    return status;
+}
+
+/**
+ * @brief Load a snapshot into the heap
+ * @param list Unused
+ * @param filename Snapshot to read
+ * @return TODO_OK or negative TodoError
+ */
+static int run_load(TodoList* list, const char* filename) {
+    (void)list;
+    return load_fresh(filename, 0);
+}
+
+/**
+ * @brief Map a snapshot
+ * @param list Unused
+ * @param filename Snapshot to map
+ * @return TODO_OK or negative TodoError
+ */
+static int run_load_mapped(TodoList* list, const char* filename) {
+    (void)list;
+    return load_fresh(filename, TODO_LOAD_MAP);
+}
+
+/**
+ * @brief Time todo_delete of every todo in random order
+ * @param list List to empty
+ * @param n List size
+ * @param seed Generator state
+ */
+static void bench_delete(TodoList* list, int n, uint32_t* seed) {
+    BenchResult result;
+    int* ids = (int*)malloc(sizeof(int) * (size_t)n);
+    if (!ids || result_init(&result, n) != 0) {
+        free(ids);
+        report_failure("delete", n, TODO_ERR_NO_MEMORY);
+        return;
+    }
+    
+    // Shuffle so deletes do not simply peel the list from one end
+    for (int i = 0; i < n; i++) {
+        ids[i] = i + 1;
+    }
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(next_random(seed) % (uint32_t)(i + 1));
+        int id = ids[i];
+        ids[i] = ids[j];
+        ids[j] = id;
+    }
+    
+    long stride = n / BENCH_MAX_SAMPLES + 1;
+    uint64_t start = now_ns();
+    for (int i = 0; i < n; i++) {
+        if (i % stride == 0) {
+            uint64_t t0 = now_ns();
+            todo_delete(list, ids[i]);
+            result_add(&result, now_ns() - t0);
+        } else {
+            todo_delete(list, ids[i]);
+        }
+    }
+    result.seconds = (double)(now_ns() - start) / 1e9;
+    result.ops = n;
+    report("delete", n, &result);
+    free(ids);
+}
+
+/**
+ * @brief Run every bench at one list size
+ * @param n List size
+ * @param filename Scratch snapshot file
+ * @return 0 on success, 1 if the list could not be built
+ */
+static int run_size(int n, const char* filename) {
+    uint32_t seed = 0x9e3779b9u ^ (uint32_t)n;
+    TodoList* list = todo_list_create();
+    if (!list) {
+        report_failure("create", n, TODO_ERR_NO_MEMORY);
+        return 1;
+    }
+    
+    int status = bench_create(list, n, &seed);
+    if (status != TODO_OK) {
+        report_failure("create", n, status);
+        todo_list_destroy(list);
+        return 1;
+    }
+    bench_find(list, n, &seed);
+    bench_queries(list, n, &seed);
+    bench_repeated("read_all", n, run_read_all, list, filename);
+    bench_repeated("save", n, run_save, list, filename);
+    bench_repeated("load", n, run_load, list, filename);
+    bench_repeated("load_mapped", n, run_load_mapped, list, filename);
+    bench_repeated("save_packed", n, run_save_packed, list, filename);
+    bench_repeated("load_packed", n, run_load, list, filename);
+    bench_delete(list, n, &seed);
+    todo_list_destroy(list);
+    
+    // Drop the scratch snapshot and the generation saves kept beside it
+    char path[FILENAME_MAX];
+    remove(filename);
+    snprintf(path, sizeof(path), "%s%s", filename, BACKUP_SUFFIX);
+    remove(path);
+    return 0;
+}
+
+/**
+ * @brief Parse a comma-separated list of sizes
+ * @param text Argument of -s
+ * @param sizes Receives the sizes
+ * @return Number of sizes, -1 if one is malformed or out of range
+ */
+static int parse_sizes(const char* text, int sizes[BENCH_MAX_SIZES]) {
+    int count = 0;
+    while (*text) {
+        char* end;
+        errno = 0;
+        long value = strtol(text, &end, 10);
+        if (end == text || errno != 0 || value < 1 || value > BENCH_MAX_SIZE || count == BENCH_MAX_SIZES) {
+            return -1;
+        }
+        if (*end == 'k' || *end == 'M') {
+            value *= *end == 'k' ? 1000 : 1000000;
+            end++;
+            if (value > BENCH_MAX_SIZE) {
+                return -1;
+            }
+        }
+        if (*end != ',' && *end != '\0') {
+            return -1;
+        }
+        sizes[count++] = (int)value;
+        text = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+/**
+ * @brief Main function of the benchmark
+ * @param argc Argument count
+ * @param argv Options: -s SIZES (e.g. 1k,100k,10M) and -f SCRATCH_FILE
+ * @return 0 on success, 1 if a size failed, 2 on usage errors
+ */
+int main(int argc, char** argv) {
+    int sizes[BENCH_MAX_SIZES] = { 1000, 10000, 100000, 1000000 };
+    int size_count = 4;
+    const char* filename = "bench.dat";
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            size_count = parse_sizes(argv[++i], sizes);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            filename = argv[++i];
+        } else {
+            size_count = -1;
+        }
+        if (size_count <= 0) {
+            fprintf(stderr, "Usage: %s [-s SIZE[,SIZE]...] [-f SCRATCH_FILE]\n", argv[0]);
+            fprintf(stderr, "Sizes run from 1 to %d todos; k and M suffixes are accepted.\n", BENCH_MAX_SIZE);
+            return 2;
+        }
+    }
+    
+    // Fork per size so peak_rss_kb belongs to that size alone
+    int status = 0;
+    for (int i = 0; i < size_count; i++) {
+        fflush(stdout);
+        pid_t child = fork();
+        if (child < 0) {
+            status = run_size(sizes[i], filename) || status;
+            continue;
+        }
+        if (child == 0) {
+            exit(run_size(sizes[i], filename));
+        }
+        
+        int child_status;
+        if (waitpid(child, &child_status, 0) < 0 || !WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0) {
+            fprintf(stderr, "Benchmark of %d todos failed\n", sizes[i]);
+            status = 1;
+        }
+    }
+    return status;
+}
\ No newline at end of file
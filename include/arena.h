@@ -0,0 +1,104 @@
+/**
+ * @file arena.h
+ * @brief Bump arena and fixed-size pool allocators
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * An Arena hands out memory from large chunks by bumping a pointer and
+ * frees it all at once; a Pool recycles fixed-size records from an arena
+ * through a free list. Structures with many small nodes allocate from
+ * them so that inserts rarely reach malloc and emptying or destroying
+ * the structure costs one free per chunk instead of one per node.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Alignment of every block returned by arena_alloc
+#define ARENA_ALIGNMENT 8
+
+// Size of the first chunk; later chunks double up to ARENA_MAX_CHUNK
+#define ARENA_MIN_CHUNK 65536
+#define ARENA_MAX_CHUNK (4u << 20)
+
+typedef struct ArenaChunk ArenaChunk;
+
+/**
+ * @brief Chunked bump allocator
+ */
+typedef struct {
+    ArenaChunk* chunks;                    /**< Most recent chunk first */
+    char* next;                            /**< Next free byte of the current chunk */
+    char* end;                             /**< End of the current chunk */
+    size_t next_chunk_size;                /**< Size of the next chunk to allocate */
+} Arena;
+
+/**
+ * @brief Free list of equally sized records carved from an arena
+ */
+typedef struct {
+    Arena* arena;                          /**< Arena new records come from */
+    size_t size;                           /**< Record size, rounded up to ARENA_ALIGNMENT */
+    void* free_list;                       /**< Released records */
+} Pool;
+
+/**
+ * @brief Prepare an empty arena (allocates nothing)
+ * @param arena Arena to initialize
+ */
+void arena_init(Arena* arena);
+
+/**
+ * @brief Allocate a block from an arena
+ * @param arena Arena to allocate from
+ * @param size Size of the block in bytes
+ * @return Block aligned to ARENA_ALIGNMENT, NULL on allocation failure
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/**
+ * @brief Release every block at once
+ *
+ * The most recent chunk is kept for reuse and the others are freed.
+ *
+ * @param arena Arena to empty
+ */
+void arena_reset(Arena* arena);
+
+/**
+ * @brief Free every chunk of an arena
+ * @param arena Arena to destroy (left empty and reusable)
+ */
+void arena_destroy(Arena* arena);
+
+/**
+ * @brief Prepare a pool of records of one size
+ * @param pool Pool to initialize
+ * @param arena Arena the records are carved from
+ * @param size Size of each record (at least sizeof(void*))
+ */
+void pool_init(Pool* pool, Arena* arena, size_t size);
+
+/**
+ * @brief Take a record from a pool
+ * @param pool Pool to allocate from
+ * @return Record, NULL on allocation failure
+ */
+void* pool_alloc(Pool* pool);
+
+/**
+ * @brief Return a record to its pool
+ * @param pool Pool the record came from
+ * @param record Record to release
+ */
+void pool_free(Pool* pool, void* record);
+
+/**
+ * @brief Forget every released record (call after resetting the arena)
+ * @param pool Pool to empty
+ */
+void pool_reset(Pool* pool);
+
+#endif // ARENA_H
\ No newline at end of file
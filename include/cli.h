@@ -0,0 +1,35 @@
+/**
+ * @file cli.h
+ * @brief Header file for the non-interactive command line interface
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file declares the entry point used when the program is started
+ * with arguments, either to run a single subcommand or to apply a batch
+ * of commands read from stdin.
+ */
+
+#ifndef CLI_H
+#define CLI_H
+
+// Longest command line accepted in batch mode
+#define CLI_LINE_SIZE 4096
+
+// Most arguments a single command may have
+#define CLI_MAX_ARGS 32
+
+/**
+ * @brief Run the program non-interactively
+ *
+ * Supported commands are add, list, done, rm, import and export; with
+ * --batch, commands are read from stdin one per line using the same
+ * syntax. The todo file is loaded once before the first command and
+ * saved once after the last one, and only if something changed.
+ *
+ * @param argc Argument count from main
+ * @param argv Argument vector from main
+ * @return Process exit status: 0 on success, 1 if a command failed, 2 on usage errors
+ */
+int cli_run(int argc, char** argv);
+
+#endif // CLI_H
\ No newline at end of file
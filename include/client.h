@@ -0,0 +1,126 @@
+/**
+ * @file client.h
+ * @brief Client side of the server protocol
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * A client connects to a running server (see server.h) and sends the
+ * requests of wire.h. Requests may be pipelined: queue any number with
+ * todo_client_send, then collect the replies in order with
+ * todo_client_receive. todo_client_call does one round trip.
+ */
+
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include "wire.h"
+
+/**
+ * @brief Opaque connection to a server
+ */
+typedef struct TodoClient TodoClient;
+
+/**
+ * @brief One request
+ *
+ * Only the fields used by op are read.
+ */
+typedef struct {
+    TodoWireOp op;                         /**< Operation */
+    int id;                                /**< Todo of GET, UPDATE, DELETE, COMPLETE, PENDING and DUE */
+    int priority;                          /**< Priority of CREATE; 0 keeps it in UPDATE */
+    const char* title;                     /**< Title of CREATE and UPDATE; NULL keeps it in UPDATE */
+    const char* description;               /**< Description of CREATE and UPDATE; NULL keeps it in UPDATE */
+    unsigned status_mask;                  /**< Status filter of LIST */
+    unsigned priority_mask;                /**< Priority filter of LIST */
+    int64_t due_at;                        /**< Due timestamp of DUE (0 clears it) */
+} TodoWireRequest;
+
+/**
+ * @brief One reply
+ *
+ * The body points into the client's receive buffer and stays valid until
+ * the next call of todo_client_flush, todo_client_receive or todo_client_call.
+ */
+typedef struct {
+    TodoWireOp op;                         /**< Operation of the request */
+    int status;                            /**< TODO_OK or the TodoError of the request */
+    uint32_t tag;                          /**< Tag returned by todo_client_send */
+    int id;                                /**< New id (CREATE) */
+    int count;                             /**< Number of todos in body (GET and LIST) */
+    WireReader body;                       /**< Todos still to read with todo_reply_next_todo */
+} TodoClientReply;
+
+/**
+ * @brief Connect to a server
+ * @param socket_path Path of the server's socket (NULL for TODO_SERVER_DEFAULT_SOCKET)
+ * @return New client, NULL on failure
+ */
+TodoClient* todo_client_connect(const char* socket_path);
+
+/**
+ * @brief Close a connection
+ *
+ * Requests queued but not yet flushed are dropped.
+ *
+ * @param client Client to close (may be NULL)
+ */
+void todo_client_close(TodoClient* client);
+
+/**
+ * @brief Queue a request without waiting for its reply
+ * @param client Connected client
+ * @param request Request to queue
+ * @return Tag of the request (the reply carries it), negative TodoError on failure
+ */
+int64_t todo_client_send(TodoClient* client, const TodoWireRequest* request);
+
+/**
+ * @brief Write every queued request to the server
+ *
+ * Replies that arrive while writing are buffered, so long pipelines
+ * cannot deadlock against a server waiting for its replies to be read.
+ *
+ * @param client Connected client
+ * @return TODO_OK on success, TODO_ERR_IO if the connection failed
+ */
+int todo_client_flush(TodoClient* client);
+
+/**
+ * @brief Wait for the reply to the oldest request not yet answered
+ *
+ * Flushes queued requests first.
+ *
+ * @param client Connected client
+ * @param reply Receives the reply
+ * @return TODO_OK when a reply was received (its own status may be an error),
+ *         TODO_ERR_IO if the connection failed, TODO_ERR_CORRUPT if the reply is malformed
+ */
+int todo_client_receive(TodoClient* client, TodoClientReply* reply);
+
+/**
+ * @brief Send one request and wait for its reply
+ * @param client Connected client with no replies outstanding
+ * @param request Request to send
+ * @param reply Receives the reply
+ * @return The reply's status, or the failure of sending or receiving
+ */
+int todo_client_call(TodoClient* client, const TodoWireRequest* request, TodoClientReply* reply);
+
+/**
+ * @brief Read the next todo of a GET or LIST reply
+ * @param reply Reply being read
+ * @param todo Receives the todo
+ * @return 1 if a todo was read, 0 when there are no more, TODO_ERR_CORRUPT if the body is malformed
+ */
+int todo_reply_next_todo(TodoClientReply* reply, TodoWireTodo* todo);
+
+/**
+ * @brief Read the metrics of a STATS reply
+ * @param reply Reply being read
+ * @param metrics Receives the metrics
+ * @return TODO_OK on success, TODO_ERR_CORRUPT if the body is malformed
+ */
+int todo_reply_metrics(TodoClientReply* reply, TodoMetrics* metrics);
+
+#endif // CLIENT_H
\ No newline at end of file
@@ -0,0 +1,135 @@
+/**
+ * @file codec.h
+ * @brief Helpers for portable binary encoding of todo data
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file contains fixed-width little-endian load/store helpers, LEB128
+ * varints, a CRC-32 checksum and a small LZ77 block compressor shared by
+ * the persistence formats.
+ */
+
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Compute or continue a CRC-32 (IEEE 802.3) checksum
+ * @param crc Previous checksum (0 to start a new one)
+ * @param data Bytes to checksum
+ * @param length Number of bytes
+ * @return Updated checksum
+ */
+uint32_t codec_crc32(uint32_t crc, const void* data, size_t length);
+
+/**
+ * @brief Store a 16-bit value in little-endian order
+ * @param dest Destination (2 bytes)
+ * @param value Value to store
+ */
+void codec_put_u16(unsigned char* dest, uint16_t value);
+
+/**
+ * @brief Store a 32-bit value in little-endian order
+ * @param dest Destination (4 bytes)
+ * @param value Value to store
+ */
+void codec_put_u32(unsigned char* dest, uint32_t value);
+
+/**
+ * @brief Store a 64-bit value in little-endian order
+ * @param dest Destination (8 bytes)
+ * @param value Value to store
+ */
+void codec_put_u64(unsigned char* dest, uint64_t value);
+
+/**
+ * @brief Load a little-endian 16-bit value
+ * @param src Source (2 bytes)
+ * @return Decoded value
+ */
+uint16_t codec_get_u16(const unsigned char* src);
+
+/**
+ * @brief Load a little-endian 32-bit value
+ * @param src Source (4 bytes)
+ * @return Decoded value
+ */
+uint32_t codec_get_u32(const unsigned char* src);
+
+/**
+ * @brief Load a little-endian 64-bit value
+ * @param src Source (8 bytes)
+ * @return Decoded value
+ */
+uint64_t codec_get_u64(const unsigned char* src);
+
+// Longest encoding of a 64-bit varint
+#define CODEC_VARINT_MAX 10
+
+// Compressed size a block of n bytes can always shrink or grow to
+#define CODEC_LZ_BOUND(n) ((n) + (n) / 255 + 16)
+
+/**
+ * @brief Store an unsigned varint (7 bits per byte, low bits first)
+ * @param dest Destination (up to CODEC_VARINT_MAX bytes)
+ * @param value Value to store
+ * @return Bytes written
+ */
+size_t codec_put_varint(unsigned char* dest, uint64_t value);
+
+/**
+ * @brief Load an unsigned varint
+ * @param src Source bytes
+ * @param length Bytes available
+ * @param value Receives the decoded value
+ * @return Bytes read, 0 if the varint is truncated or too long
+ */
+size_t codec_get_varint(const unsigned char* src, size_t length, uint64_t* value);
+
+/**
+ * @brief Map a signed value to an unsigned one with small magnitudes first
+ * @param value Signed value
+ * @return Zigzag encoding (0, -1, 1, -2, ... become 0, 1, 2, 3, ...)
+ */
+uint64_t codec_zigzag(int64_t value);
+
+/**
+ * @brief Invert codec_zigzag
+ * @param value Zigzag encoding
+ * @return Signed value
+ */
+int64_t codec_unzigzag(uint64_t value);
+
+/**
+ * @brief Compress a block with a fast LZ77 coder (LZ4 block layout)
+ *
+ * Matches are found through a small hash table of 4-byte sequences and
+ * may reach 65535 bytes back, so blocks larger than that compress
+ * somewhat worse. Decoding needs no table and is a sequence of copies.
+ *
+ * @param src Bytes to compress
+ * @param size Number of bytes
+ * @param dest Receives the compressed block
+ * @param capacity Size of dest
+ * @return Compressed size, 0 if it would not fit in capacity
+ */
+size_t codec_lz_compress(const unsigned char* src, size_t size, unsigned char* dest, size_t capacity);
+
+/**
+ * @brief Decompress a block written by codec_lz_compress
+ *
+ * Every length and offset is checked, so corrupt input cannot read or
+ * write out of bounds.
+ *
+ * @param src Compressed block
+ * @param size Size of the compressed block
+ * @param dest Receives the original bytes
+ * @param dest_size Exact size of the original bytes
+ * @return 0 on success, -1 if the block is malformed or does not decode to dest_size bytes
+ */
+int codec_lz_decompress(const unsigned char* src, size_t size, unsigned char* dest, size_t dest_size);
+
+#endif // CODEC_H
\ No newline at end of file
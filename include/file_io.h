@@ -17,30 +17,135 @@
 #define DEFAULT_FILENAME "data/todos.dat"
 #define DATA_DIR "data"
 
+// Suffixes of the files kept next to a todo file
+#define TEMP_SUFFIX ".tmp"        // New generation while it is being written
+#define BACKUP_SUFFIX ".backup"   // Previous generation
+
+// load_todos_from_file_ex flags
+#define TODO_LOAD_MAP 0x1       // Map the file and read todos in place
+#define TODO_LOAD_VERIFY 0x2    // With TODO_LOAD_MAP, also checksum the text up front
+
+// save_todos_to_file_ex flags (neither keeps the encoding of the existing file)
+#define TODO_SAVE_COMPRESS 0x1      // Write a packed, compressed snapshot
+#define TODO_SAVE_UNCOMPRESSED 0x2  // Write a plain snapshot that can be mapped
+
+/**
+ * @brief Read-only mapping of a whole file
+ */
+typedef struct {
+    void* data;                            /**< Start of the mapped view */
+    size_t size;                           /**< Length of the mapped view */
+    char* path;                            /**< Name of the mapped file */
+} FileMapping;
+
 /**
  * @brief Save todo list to a binary file
+ *
+ * Writes a full snapshot in the portable, checksummed format described in
+ * file_io.c and removes the journal it supersedes. The snapshot goes to a
+ * temporary file that is synced and then renamed over filename, so a
+ * crash leaves either the old or the new file, never a torn one. The
+ * previous generation is kept as filename.backup through a hard link
+ * rather than a copy. Saving over the file a list is mapped from is safe
+ * except on Windows, where the list must be made writable first. A file
+ * that already holds a compressed snapshot stays compressed.
+ *
  * @param list Pointer to the todo list to save
  * @param filename Name of the file to save to (NULL for default)
- * @return 0 on success, -1 on failure
+ * @return TODO_OK on success, negative TodoError on failure
  */
 int save_todos_to_file(const TodoList* list, const char* filename);
 
+/**
+ * @brief Save todo list to a binary file, choosing its encoding
+ *
+ * Like save_todos_to_file. TODO_SAVE_COMPRESS writes a packed snapshot:
+ * delta-encoded varint fields and length-prefixed text in LZ-compressed,
+ * checksummed blocks, typically a fraction of the plain size. Packed
+ * files are read into the heap (never mapped) and are expanded on
+ * several threads. The choice sticks: later saves without a flag,
+ * including journal checkpoints, keep the file's current encoding.
+ *
+ * @param list Pointer to the todo list to save
+ * @param filename Name of the file to save to (NULL for default)
+ * @param flags TODO_SAVE_COMPRESS, TODO_SAVE_UNCOMPRESSED or 0 to keep the file's encoding
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int save_todos_to_file_ex(const TodoList* list, const char* filename, int flags);
+
 /**
  * @brief Load todo list from a binary file
+ *
+ * Every block of the file is checked against its CRC-32 before the list
+ * is touched. Any journal written next to the file (see journal.h) is
+ * replayed on top of the snapshot. Files in an older format are upgraded:
+ * once read they are rewritten in the current one, keeping the original
+ * as the backup. A missing file is not an error: the list is left
+ * unchanged and TODO_OK is returned.
+ *
  * @param list Pointer to the todo list to load into
  * @param filename Name of the file to load from (NULL for default)
- * @return 0 on success, -1 on failure
+ * @return TODO_OK on success, negative TodoError on failure
  */
 int load_todos_from_file(TodoList* list, const char* filename);
 
+/**
+ * @brief Load todo list from a binary file, optionally mapping it
+ *
+ * With TODO_LOAD_MAP the list points straight at a read-only mapping of
+ * the file (mmap, or MapViewOfFile on Windows), so loading costs only a
+ * scan and checksum of the records, and text is paged in as it is read
+ * (add TODO_LOAD_VERIFY to checksum it up front as well). The first
+ * modification copies the todos to the heap (see todo_list_make_writable).
+ * Older formats, packed snapshots, big-endian hosts and journals with
+ * pending changes fall back to loading into the heap.
+ *
+ * @param list Pointer to the todo list to load into
+ * @param filename Name of the file to load from (NULL for default)
+ * @param flags Bitwise OR of TODO_LOAD_* flags
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int load_todos_from_file_ex(TodoList* list, const char* filename, int flags);
+
 /**
  * @brief Export todo list to a human-readable text file
  * @param list Pointer to the todo list to export
  * @param filename Name of the text file to export to
- * @return 0 on success, -1 on failure
+ * @return TODO_OK on success, negative TodoError on failure
  */
 int export_todos_to_text(const TodoList* list, const char* filename);
 
+/**
+ * @brief Stream todos to a JSON-lines file, one object per line
+ *
+ * Each line has the fields id, title, description, priority, status,
+ * created_at, updated_at and due_at (timestamps in seconds since the
+ * epoch; due_at is 0 for todos without a due date).
+ * Records are formatted through a fixed-size buffer, so memory use does
+ * not depend on the size of the list.
+ *
+ * @param list Pointer to the todo list to export
+ * @param filename Name of the file to write, or "-" for stdout
+ * @param filter Callback selecting the todos to export (NULL for all)
+ * @param user_data Context passed to filter
+ * @return Number of todos written, negative TodoError on failure
+ */
+int export_todos_to_jsonl(const TodoList* list, const char* filename, TodoFilterFn filter, void* user_data);
+
+/**
+ * @brief Stream todos to a CSV file with a header row
+ *
+ * Columns match the JSON-lines fields. Values containing commas, quotes
+ * or line breaks are quoted as in RFC 4180.
+ *
+ * @param list Pointer to the todo list to export
+ * @param filename Name of the file to write, or "-" for stdout
+ * @param filter Callback selecting the todos to export (NULL for all)
+ * @param user_data Context passed to filter
+ * @return Number of todos written, negative TodoError on failure
+ */
+int export_todos_to_csv(const TodoList* list, const char* filename, TodoFilterFn filter, void* user_data);
+
 /**
  * @brief Check if a file exists
  * @param filename Name of the file to check
@@ -50,15 +155,65 @@ int file_exists(const char* filename);
 
 /**
  * @brief Ensure data directory exists
- * @return 0 on success, -1 on failure
+ * @return TODO_OK on success, negative TodoError on failure
  */
 int ensure_data_directory(void);
 
+/**
+ * @brief Ensure a directory exists, creating it if needed
+ * @param path Directory to check (its parent must exist)
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int ensure_directory(const char* path);
+
+/**
+ * @brief Ensure the directory holding a file exists, creating it if needed
+ * @param filename File whose directory to check (its grandparent must exist)
+ * @return TODO_OK on success (including files in the current directory), negative TodoError on failure
+ */
+int ensure_parent_directory(const char* filename);
+
 /**
  * @brief Create a backup of the current todo file
  * @param filename Name of the file to backup
- * @return 0 on success, -1 on failure
+ * @return TODO_OK on success, negative TodoError on failure
  */
 int create_backup(const char* filename);
 
+/**
+ * @brief Map a whole file read-only into memory
+ *
+ * Uses mmap, or MapViewOfFile on Windows. Pages are read in lazily as
+ * the data is touched.
+ *
+ * @param filename Name of the file to map
+ * @return New mapping, NULL on failure (including empty files)
+ */
+FileMapping* file_map(const char* filename);
+
+/**
+ * @brief Unmap a file mapped by file_map
+ * @param mapping Mapping to release (may be NULL)
+ */
+void file_unmap(FileMapping* mapping);
+
+/**
+ * @brief Atomically move a fully written file over its destination
+ *
+ * The rename is made durable where the file system allows it, so after a
+ * crash dest holds either its old or its new contents.
+ *
+ * @param source Name of the temporary file
+ * @param dest Name of the file to replace
+ * @return TODO_OK on success, TODO_ERR_IO on failure
+ */
+int file_replace(const char* source, const char* dest);
+
+/**
+ * @brief Flush a file's buffered data and force it to stable storage
+ * @param file Open file to sync
+ * @return TODO_OK on success, TODO_ERR_IO on failure
+ */
+int file_sync(FILE* file);
+
 #endif // FILE_IO_H
\ No newline at end of file
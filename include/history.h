@@ -0,0 +1,122 @@
+/**
+ * @file history.h
+ * @brief Header file for undo/redo history of a todo list
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * A history observes a list and keeps, for every change, the state the
+ * changed todo had just before it. Changes are grouped into steps (one
+ * per todo_history_mark); undoing a step restores those states, and the
+ * states it overwrites become the redo step. Nothing is copied up front
+ * and unchanged todos are never copied at all, so memory grows with the
+ * number of changes rather than with the size of the list. Text is only
+ * kept when a change altered it.
+ *
+ * Undo and redo go through todo_restore and todo_delete, so journals,
+ * views and indexes attached to the list see them as ordinary changes.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "todo.h"
+
+// Steps kept by default; older ones are discarded
+#define TODO_HISTORY_DEFAULT_STEPS 1000
+
+/**
+ * @brief Opaque change history of one list
+ */
+typedef struct TodoHistory TodoHistory;
+
+/**
+ * @brief Start recording the changes of a list
+ *
+ * The history must be detached before the list is destroyed, and
+ * reloading the list (todo_list_clear, loading a file) invalidates it.
+ *
+ * @param list List to observe
+ * @return New history, NULL on failure
+ */
+TodoHistory* todo_history_attach(TodoList* list);
+
+/**
+ * @brief Stop recording and free a history
+ * @param history History to free (may be NULL)
+ */
+void todo_history_detach(TodoHistory* history);
+
+/**
+ * @brief Set how many steps are kept
+ * @param history History to configure
+ * @param max_steps Most recent undo steps to keep (at least 1)
+ */
+void todo_history_set_limit(TodoHistory* history, int max_steps);
+
+/**
+ * @brief End the current step
+ *
+ * The changes made since the previous mark are undone and redone
+ * together. Marking with no changes since the last mark does nothing.
+ *
+ * @param history History to mark
+ */
+void todo_history_mark(TodoHistory* history);
+
+/**
+ * @brief Undo the most recent step
+ *
+ * Changes not yet marked form the step undone.
+ *
+ * @param history History of the list
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND if there is nothing to undo,
+ *         negative TodoError if the list could not be changed
+ */
+int todo_history_undo(TodoHistory* history);
+
+/**
+ * @brief Redo the most recently undone step
+ *
+ * Any new change to the list discards the steps that could be redone.
+ *
+ * @param history History of the list
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND if there is nothing to redo,
+ *         negative TodoError if the list could not be changed
+ */
+int todo_history_redo(TodoHistory* history);
+
+/**
+ * @brief Number of steps that can be undone
+ * @param history History to inspect
+ * @return Step count, including an unmarked step with changes
+ */
+int todo_history_undo_count(const TodoHistory* history);
+
+/**
+ * @brief Number of steps that can be redone
+ * @param history History to inspect
+ * @return Step count
+ */
+int todo_history_redo_count(const TodoHistory* history);
+
+/**
+ * @brief Memory held by the recorded states
+ * @param history History to inspect
+ * @return Bytes allocated
+ */
+size_t todo_history_memory(const TodoHistory* history);
+
+/**
+ * @brief Rebuild the list as it was at a point in time
+ *
+ * The copy is the current list with every step whose last change is
+ * later than when reverted (undone steps are not part of the past). It
+ * has no journal, observers or indexes. The original is not modified.
+ *
+ * @param history History of the list
+ * @param when Point in time
+ * @return New list to be freed with todo_list_destroy, NULL on failure
+ */
+TodoList* todo_history_state_at(const TodoHistory* history, time_t when);
+
+#endif // HISTORY_H
\ No newline at end of file
@@ -0,0 +1,51 @@
+/**
+ * @file import.h
+ * @brief Bulk import of todos from CSV and JSON-lines files
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file declares the import pipeline that parses other trackers'
+ * exports (including this program's own) and adds them to a list through
+ * todo_create_many.
+ */
+
+#ifndef IMPORT_H
+#define IMPORT_H
+
+#include "todo.h"
+
+/**
+ * @brief Input format of an import
+ */
+typedef enum {
+    TODO_IMPORT_AUTO = 0,     /**< Guess from the file extension or the first byte */
+    TODO_IMPORT_CSV = 1,      /**< Comma-separated values (RFC 4180 quoting) */
+    TODO_IMPORT_JSONL = 2     /**< One JSON object per line */
+} TodoImportFormat;
+
+/**
+ * @brief Import todos from a CSV or JSON-lines file
+ *
+ * Recognized fields are title (required), description, priority ("Low",
+ * "Medium", "High" or 1-3; Medium if absent), status ("Pending",
+ * "Completed", "done", 0/1 or true/false) and due_at (a Unix timestamp
+ * as written by the exporters, 0 or empty for none; "due" is accepted
+ * too); others are ignored. A CSV file whose first row names a "title"
+ * column is read by column name, otherwise columns are taken as title,
+ * description, priority, status.
+ *
+ * Imported todos get new IDs and the current time, as with todo_create.
+ * Regular files are mapped; stdin and other streams are read in large
+ * blocks. Fields are decoded into a scratch area reused for each batch,
+ * so nothing is allocated per record. Records that cannot be parsed or
+ * fail validation are skipped and counted.
+ *
+ * @param list Pointer to the todo list to add to
+ * @param filename File to read, or "-" for stdin
+ * @param format Input format
+ * @param out_rejected Receives the number of skipped records (may be NULL)
+ * @return Number of todos imported, negative TodoError on failure
+ */
+int import_todos(TodoList* list, const char* filename, TodoImportFormat format, int* out_rejected);
+
+#endif // IMPORT_H
\ No newline at end of file
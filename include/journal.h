@@ -0,0 +1,132 @@
+/**
+ * @file journal.h
+ * @brief Header file for journaled (write-ahead log) persistence
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * A journal records every create, update and delete made to a TodoList
+ * and appends them to a log file next to the snapshot (e.g.
+ * "data/todos.dat.log"), so that saving costs time proportional to the
+ * changes rather than to the whole list. The log is compacted into a new
+ * snapshot by a checkpoint once it grows past a threshold, and
+ * load_todos_from_file replays it on top of the snapshot.
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "todo.h"
+
+// Extension appended to the snapshot filename to form the log filename
+#define JOURNAL_LOG_SUFFIX ".log"
+
+// Default log size that triggers an automatic checkpoint
+#define JOURNAL_DEFAULT_CHECKPOINT_BYTES (1024 * 1024)
+
+/**
+ * @brief Opaque journal attached to a todo list
+ */
+typedef struct Journal Journal;
+
+/**
+ * @brief Start journaling changes made to a list
+ *
+ * The list should already have been loaded from filename. While the
+ * journal is open, use journal_checkpoint rather than save_todos_to_file.
+ *
+ * @param list Pointer to the todo list to observe
+ * @param filename Snapshot filename (NULL for default)
+ * @return New journal, NULL on failure
+ */
+Journal* journal_open(TodoList* list, const char* filename);
+
+/**
+ * @brief Append all changes recorded since the last commit to the log
+ *
+ * The log is flushed to stable storage before returning. If it has grown
+ * past the checkpoint threshold a checkpoint is taken as well.
+ *
+ * In asynchronous mode the changes are only handed to the writer thread,
+ * and the result reports failures of earlier commits; use journal_flush
+ * to wait until they are durable.
+ *
+ * @param journal Journal to commit
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int journal_commit(Journal* journal);
+
+/**
+ * @brief Write a full snapshot of the list and start a new, empty log
+ * @param journal Journal to checkpoint
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int journal_checkpoint(Journal* journal);
+
+/**
+ * @brief Move log writes to a background thread
+ *
+ * Afterwards commits and checkpoints return without waiting for the disk.
+ * Changes committed while the thread is busy are coalesced into a single
+ * append and sync, and a checkpoint saves a copy of the list taken at the
+ * time of the call, so the list can keep changing meanwhile. The list
+ * must not change while journal_commit, journal_checkpoint or
+ * journal_flush runs.
+ *
+ * @param journal Journal to switch
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int journal_start_async(Journal* journal);
+
+/**
+ * @brief Commit and wait until everything committed so far is on disk
+ * @param journal Journal to flush
+ * @return TODO_OK on success, negative TodoError if this or any earlier commit failed
+ */
+int journal_flush(Journal* journal);
+
+/**
+ * @brief Set the log size that triggers an automatic checkpoint
+ * @param journal Journal to configure
+ * @param bytes Threshold in bytes (0 checkpoints on every commit)
+ */
+void journal_set_checkpoint_threshold(Journal* journal, size_t bytes);
+
+/**
+ * @brief Number of bytes of changes recorded but not yet committed
+ * @param journal Journal to inspect
+ * @return Pending byte count
+ */
+size_t journal_pending_bytes(const Journal* journal);
+
+/**
+ * @brief Stop journaling and free the journal
+ *
+ * Uncommitted changes are discarded; call journal_commit first to keep them.
+ * Changes already handed to the writer thread are written before it stops.
+ *
+ * @param journal Journal to close
+ */
+void journal_close(Journal* journal);
+
+/**
+ * @brief Apply the records of a log file to a list
+ *
+ * Replay stops at the first incomplete or corrupt record, which is what a
+ * crash in the middle of an append leaves behind.
+ *
+ * @param list Pointer to the todo list to apply changes to
+ * @param log_filename Log file to replay
+ * @return TODO_OK on success (including a missing log), negative TodoError on failure
+ */
+int journal_replay(TodoList* list, const char* log_filename);
+
+/**
+ * @brief Build the log filename belonging to a snapshot filename
+ * @param filename Snapshot filename (NULL for default)
+ * @param buffer Buffer receiving the log filename
+ * @param size Size of buffer
+ * @return TODO_OK on success, TODO_ERR_INVALID if the name does not fit
+ */
+int journal_log_path(const char* filename, char* buffer, size_t size);
+
+#endif // JOURNAL_H
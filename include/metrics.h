@@ -0,0 +1,151 @@
+/**
+ * @file metrics.h
+ * @brief Low-overhead counters and latency histograms of the hot paths
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * The core operations count their calls, sample their latency into log2
+ * histograms, and account the bytes the persistence layer reads and
+ * writes and the time it spends in fsync. Each thread records into its
+ * own shard without locking or read-modify-write atomics (its counters
+ * are written with relaxed atomic stores); todo_metrics_snapshot sums
+ * the shards, so a snapshot taken while other threads are recording is
+ * approximate but never blocks them. With compilers other than GCC,
+ * Clang and MSVC, snapshot and reset are only safe while no other thread
+ * records.
+ *
+ * Cheap operations time one call in TODO_METRICS_SAMPLE_EVERY (all are
+ * counted); renders, saves, loads and fsyncs time every call. Failed
+ * calls are counted and timed like successful ones, so calls and timed
+ * agree for the operations timed on every call. Building with
+ * -DTODO_NO_METRICS compiles the instrumentation
+ * out entirely: the recording macros expand to nothing and snapshots
+ * are empty.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Latency buckets: bucket b holds calls taking [2^b, 2^(b+1)) ns, the last one everything slower
+#define TODO_METRICS_BUCKETS 32
+
+// Cheap operations time one call in this many
+#define TODO_METRICS_SAMPLE_EVERY 16
+
+/**
+ * @brief Instrumented operations
+ */
+typedef enum {
+    TODO_METRIC_CREATE = 0,                /**< todo_create */
+    TODO_METRIC_UPDATE,                    /**< todo_update, todo_complete, todo_mark_pending, todo_set_due */
+    TODO_METRIC_DELETE,                    /**< todo_delete */
+    TODO_METRIC_QUERY,                     /**< todo_query and todo_read_matching */
+    TODO_METRIC_RENDER,                    /**< todo_read_all */
+    TODO_METRIC_SAVE,                      /**< save_todos_to_file_ex */
+    TODO_METRIC_LOAD,                      /**< load_todos_from_file_ex */
+    TODO_METRIC_FSYNC,                     /**< file_sync (snapshots and journal) */
+    TODO_METRIC_COUNT                      /**< Number of operations */
+} TodoMetricOp;
+
+/**
+ * @brief Totals of one operation
+ */
+typedef struct {
+    uint64_t calls;                        /**< Calls made */
+    uint64_t timed;                        /**< Calls whose latency was sampled */
+    uint64_t total_ns;                     /**< Sum of the sampled latencies */
+    uint64_t max_ns;                       /**< Slowest sampled call */
+    uint64_t histogram[TODO_METRICS_BUCKETS]; /**< Sampled calls per latency bucket */
+} TodoOpMetrics;
+
+/**
+ * @brief Totals of the whole process
+ */
+typedef struct {
+    TodoOpMetrics ops[TODO_METRIC_COUNT];  /**< Per-operation totals */
+    uint64_t bytes_read;                   /**< Snapshot and journal bytes loaded (mapped files in full) */
+    uint64_t bytes_written;                /**< Snapshot and journal bytes written */
+    int threads;                           /**< Threads that have recorded, including finished ones */
+    int enabled;                           /**< 0 if built with TODO_NO_METRICS */
+} TodoMetrics;
+
+#ifndef TODO_NO_METRICS
+
+/**
+ * @brief Count a call and decide whether to time it
+ * @param op Operation starting
+ * @return Start time in nanoseconds if the call is timed, 0 otherwise
+ */
+uint64_t todo_metrics_begin(TodoMetricOp op);
+
+/**
+ * @brief Record the latency of a timed call
+ * @param op Operation finishing
+ * @param start Value returned by todo_metrics_begin (non-zero)
+ */
+void todo_metrics_end(TodoMetricOp op, uint64_t start);
+
+/**
+ * @brief Account bytes moved to or from files
+ * @param read Bytes read or mapped
+ * @param written Bytes written
+ */
+void todo_metrics_add_bytes(uint64_t read, uint64_t written);
+
+// Recording macros used by the instrumented code
+#define TODO_METRICS_BEGIN(op, var) uint64_t var = todo_metrics_begin(op)
+#define TODO_METRICS_END(op, var) do { if (var) todo_metrics_end(op, var); } while (0)
+#define TODO_METRICS_READ(bytes) todo_metrics_add_bytes((uint64_t)(bytes), 0)
+#define TODO_METRICS_WRITTEN(bytes) todo_metrics_add_bytes(0, (uint64_t)(bytes))
+
+#else
+
+#define TODO_METRICS_BEGIN(op, var) ((void)0)
+#define TODO_METRICS_END(op, var) ((void)0)
+#define TODO_METRICS_READ(bytes) ((void)0)
+#define TODO_METRICS_WRITTEN(bytes) ((void)0)
+
+#endif // TODO_NO_METRICS
+
+/**
+ * @brief Sum the metrics of every thread
+ * @param metrics Receives the totals (all zero if metrics are compiled out)
+ */
+void todo_metrics_snapshot(TodoMetrics* metrics);
+
+/**
+ * @brief Zero the metrics of every thread
+ *
+ * Other threads clear their own totals the next time they record, and
+ * calls they are recording at that moment are dropped.
+ */
+void todo_metrics_reset(void);
+
+/**
+ * @brief Name of an operation
+ * @param op Operation
+ * @return Lower-case name (e.g. "create"), "unknown" if op is out of range
+ */
+const char* todo_metrics_name(TodoMetricOp op);
+
+/**
+ * @brief Estimate a latency percentile from an operation's histogram
+ * @param op Totals of the operation
+ * @param percent Percentile (0-100)
+ * @return Upper bound of the bucket holding the percentile (at most max_ns), 0 if nothing was timed
+ */
+uint64_t todo_metrics_percentile(const TodoOpMetrics* op, double percent);
+
+/**
+ * @brief Write metrics as text in the Prometheus exposition format
+ * @param metrics Totals to write
+ * @param out Stream to write to
+ * @return 0 on success, -1 on a write error
+ */
+int todo_metrics_write(const TodoMetrics* metrics, FILE* out);
+
+#endif // METRICS_H
\ No newline at end of file
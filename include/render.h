@@ -0,0 +1,124 @@
+/**
+ * @file render.h
+ * @brief Buffered text rendering for listing and exporting todos
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * A RenderBuffer formats text into caller-provided storage and writes it
+ * out in large chunks, so rendering many rows costs a handful of writes
+ * instead of several stdio calls per row. Timestamps are broken down
+ * through a cache of the last local day seen, avoiding a timezone
+ * conversion for every timestamp that falls on the same day.
+ */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+// Suggested size of the storage handed to render_init
+#define RENDER_BUFFER_SIZE 32768
+
+// Number of local days remembered (e.g. one for created, one for updated)
+#define RENDER_DAY_CACHE_SIZE 4
+
+/**
+ * @brief One cached local day
+ */
+typedef struct {
+    int64_t start;                         /**< First timestamp of the day */
+    int64_t end;                           /**< First timestamp after the day */
+    struct tm midnight;                    /**< Local time at start */
+} RenderDay;
+
+/**
+ * @brief Output buffer with a cached local-time breakdown
+ */
+typedef struct {
+    FILE* out;                             /**< Destination of flushed data */
+    char* data;                            /**< Caller-provided storage */
+    size_t size;                           /**< Bytes currently buffered */
+    size_t capacity;                       /**< Size of data */
+    int error;                             /**< First write error (TodoError), TODO_OK if none */
+    RenderDay days[RENDER_DAY_CACHE_SIZE]; /**< Recently seen local days */
+    int next_day;                          /**< Cache entry replaced on the next miss */
+} RenderBuffer;
+
+/**
+ * @brief Prepare a render buffer
+ *
+ * No memory is allocated; storage must outlive the buffer.
+ *
+ * @param buffer Buffer to initialize
+ * @param out File the rendered text is written to
+ * @param storage Memory to format into
+ * @param capacity Size of storage in bytes (at least 1)
+ */
+void render_init(RenderBuffer* buffer, FILE* out, char* storage, size_t capacity);
+
+/**
+ * @brief Write all buffered text to the output file
+ * @param buffer Render buffer
+ * @return TODO_OK on success, TODO_ERR_IO if any write so far has failed
+ */
+int render_flush(RenderBuffer* buffer);
+
+/**
+ * @brief Append raw bytes
+ * @param buffer Render buffer
+ * @param text Bytes to append
+ * @param length Number of bytes
+ */
+void render_append(RenderBuffer* buffer, const char* text, size_t length);
+
+/**
+ * @brief Append a NUL-terminated string
+ * @param buffer Render buffer
+ * @param text String to append
+ */
+void render_string(RenderBuffer* buffer, const char* text);
+
+/**
+ * @brief Append a string left-aligned in a field, like printf's "%-W.Ps"
+ * @param buffer Render buffer
+ * @param text String to append
+ * @param width Minimum field width; shorter text is padded with spaces
+ * @param precision Maximum number of bytes taken from text (0 for no limit)
+ */
+void render_padded(RenderBuffer* buffer, const char* text, size_t width, size_t precision);
+
+/**
+ * @brief Append a decimal integer left-aligned in a field, like "%-Wd"
+ * @param buffer Render buffer
+ * @param value Integer to append
+ * @param width Minimum field width (0 for none)
+ */
+void render_int(RenderBuffer* buffer, long long value, size_t width);
+
+/**
+ * @brief Break a timestamp down into local time, using the day cache
+ * @param buffer Render buffer holding the cache
+ * @param timestamp Seconds since the epoch
+ * @param out Receives the local time
+ */
+void render_localtime(RenderBuffer* buffer, int64_t timestamp, struct tm* out);
+
+/**
+ * @brief Append a timestamp as "YYYY-MM-DD HH:MM" or "YYYY-MM-DD HH:MM:SS"
+ * @param buffer Render buffer
+ * @param timestamp Seconds since the epoch
+ * @param with_seconds Non-zero to include seconds
+ */
+void render_datetime(RenderBuffer* buffer, int64_t timestamp, int with_seconds);
+
+/**
+ * @brief Append a timestamp in ctime() layout without the trailing newline
+ * @param buffer Render buffer
+ * @param timestamp Seconds since the epoch
+ */
+void render_ctime(RenderBuffer* buffer, int64_t timestamp);
+
+#endif // RENDER_H
\ No newline at end of file
@@ -0,0 +1,127 @@
+/**
+ * @file scan.h
+ * @brief Header file for columnar scans of status, priority and timestamps
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file declares aggregate queries that combine the status and
+ * priority filters with timestamp ranges, such as "pending high-priority
+ * todos not updated since T". They are answered by scanning column
+ * arrays indexed by todo ID, 64 IDs at a time, with SSE2/AVX2/NEON
+ * kernels where the compiler targets them and a scalar loop otherwise.
+ */
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "todo.h"
+
+/**
+ * @brief Filter applied by the scan functions
+ *
+ * A todo matches when its status and priority are selected by the masks
+ * and both timestamps lie within their inclusive ranges. Start from
+ * todo_scan_filter_init, which matches every todo.
+ */
+typedef struct {
+    unsigned status_mask;          /**< TODO_STATUS_BIT values to include */
+    unsigned priority_mask;        /**< TODO_PRIORITY_BIT values to include */
+    int64_t created_min;           /**< Earliest creation time */
+    int64_t created_max;           /**< Latest creation time */
+    int64_t updated_min;           /**< Earliest update time */
+    int64_t updated_max;           /**< Latest update time */
+} TodoScanFilter;
+
+/**
+ * @brief Initialize a filter that matches every todo
+ * @param filter Filter to initialize
+ */
+void todo_scan_filter_init(TodoScanFilter* filter);
+
+/**
+ * @brief Start maintaining column arrays for scans
+ *
+ * The columns hold one status/priority byte and the two timestamps per
+ * ID (17 bytes) and are updated by every change. Without them the scan
+ * functions still work, reading the todo array instead.
+ *
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_enable_columns(TodoList* list);
+
+/**
+ * @brief Stop maintaining the column arrays and free them
+ * @param list Pointer to the todo list
+ */
+void todo_list_disable_columns(TodoList* list);
+
+/**
+ * @brief Count the todos matching a filter
+ *
+ * Filters without a timestamp range are answered from the query index
+ * without scanning.
+ *
+ * @param list Pointer to the todo list
+ * @param filter Filter to apply
+ * @return Number of matching todos, negative TodoError on invalid arguments
+ */
+int todo_scan_count(const TodoList* list, const TodoScanFilter* filter);
+
+/**
+ * @brief Count the matching todos per status and priority
+ * @param list Pointer to the todo list
+ * @param filter Filter to apply
+ * @param counts Receives the counts, indexed by TODO_BUCKET(status, priority)
+ * @return Total number of matching todos, negative TodoError on invalid arguments
+ */
+int todo_scan_histogram(const TodoList* list, const TodoScanFilter* filter, int counts[TODO_BUCKET_COUNT]);
+
+/**
+ * @brief Number of 64-bit words todo_scan_mask writes
+ * @param list Pointer to the todo list
+ * @return Words needed to hold one bit per possible ID
+ */
+size_t todo_scan_mask_words(const TodoList* list);
+
+/**
+ * @brief Compute a bitmap of the IDs matching a filter
+ *
+ * Bit (id % 64) of bits[id / 64] is set for every matching ID.
+ *
+ * @param list Pointer to the todo list
+ * @param filter Filter to apply
+ * @param bits Receives the bitmap
+ * @param words Size of bits, at least todo_scan_mask_words(list)
+ * @return Number of matching todos, negative TodoError on invalid arguments
+ */
+int todo_scan_mask(const TodoList* list, const TodoScanFilter* filter, uint64_t* bits, size_t words);
+
+/**
+ * @brief Record the current fields of a todo (used internally by the list)
+ * @param columns Columns to update
+ * @param todo Live todo
+ * @return 0 on success, -1 on allocation failure
+ */
+int columns_insert(TodoColumns* columns, const Todo* todo);
+
+/**
+ * @brief Mark an ID as unused (used internally by the list)
+ * @param columns Columns to update
+ * @param id ID of the removed todo
+ */
+void columns_erase(TodoColumns* columns, int id);
+
+/**
+ * @brief Mark every ID as unused (used internally by the list)
+ * @param columns Columns to empty
+ */
+void columns_reset(TodoColumns* columns);
+
+/**
+ * @brief Free column arrays (used internally by the list)
+ * @param columns Columns to free (may be NULL)
+ */
+void columns_destroy(TodoColumns* columns);
+
+#endif // SCAN_H
\ No newline at end of file
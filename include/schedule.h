@@ -0,0 +1,88 @@
+/**
+ * @file schedule.h
+ * @brief Header file for due-date reminders of a todo list
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * A scheduler observes a list and keeps every pending todo with a due
+ * date in a binary min-heap keyed on the due time, so the next reminder
+ * is known in O(1) and each change or fired reminder costs O(log n) no
+ * matter how many todos the list holds. A reminder fires once per due
+ * date: changing the due date or marking a completed todo pending again
+ * arms it anew, other updates do not.
+ */
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include "todo.h"
+
+/**
+ * @brief Opaque reminder schedule of one list
+ */
+typedef struct TodoScheduler TodoScheduler;
+
+/**
+ * @brief Start scheduling the due dates of a list
+ *
+ * Every pending todo with a due date is armed, including overdue ones,
+ * which fire on the first todo_scheduler_fire. The schedule is built in
+ * O(n). It must be detached before the list is destroyed, and reloading
+ * the list (todo_list_clear, loading a file) invalidates it.
+ *
+ * @param list List to observe
+ * @param remind Called for each reminder that fires (may be NULL); it must not modify the list
+ * @param user_data Context passed to remind
+ * @return New scheduler, NULL on failure
+ */
+TodoScheduler* todo_scheduler_attach(TodoList* list, TodoVisitFn remind, void* user_data);
+
+/**
+ * @brief Stop scheduling and free a scheduler
+ * @param scheduler Scheduler to free (may be NULL)
+ */
+void todo_scheduler_detach(TodoScheduler* scheduler);
+
+/**
+ * @brief Number of armed reminders
+ * @param scheduler Scheduler to inspect
+ * @return Pending todos with a due date whose reminder has not fired
+ */
+int todo_scheduler_count(const TodoScheduler* scheduler);
+
+/**
+ * @brief Due time of the next reminder
+ * @param scheduler Scheduler to inspect
+ * @return Earliest armed due time, 0 if nothing is armed
+ */
+time_t todo_scheduler_next_due(const TodoScheduler* scheduler);
+
+/**
+ * @brief Fire every reminder due by a point in time
+ *
+ * Reminders fire in due order (ties by ID) and are disarmed as they do.
+ * The callback given to todo_scheduler_attach may return non-zero to
+ * stop; reminders not yet fired stay armed.
+ *
+ * @param scheduler Scheduler of the list
+ * @param now Fire reminders due at or before this time
+ * @return Number of reminders fired
+ */
+int todo_scheduler_fire(TodoScheduler* scheduler, time_t now);
+
+/**
+ * @brief Visit the armed reminders in due order
+ *
+ * Costs O(k log k) for the first k reminders; the heap is walked, not
+ * popped, so nothing is disarmed. The callback must not modify the list
+ * and may return non-zero to stop early.
+ *
+ * @param scheduler Scheduler of the list
+ * @param limit Most todos to visit (0 for all)
+ * @param fn Callback invoked for each todo
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, negative TodoError on failure
+ */
+int todo_scheduler_upcoming(const TodoScheduler* scheduler, int limit, TodoVisitFn fn, void* user_data);
+
+#endif // SCHEDULE_H
\ No newline at end of file
@@ -0,0 +1,94 @@
+/**
+ * @file search.h
+ * @brief Header file for full-text search over titles and descriptions
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file declares word search backed by an optional inverted index,
+ * and a case-insensitive substring scan for queries the index cannot
+ * answer.
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "todo.h"
+
+// Indexed words longer than this are truncated to it
+#define SEARCH_MAX_TERM 64
+
+// todo_search flag: match the query as a substring instead of by words
+#define TODO_SEARCH_SUBSTRING 0x1
+
+/**
+ * @brief Start maintaining an inverted index of a list's text
+ *
+ * Titles and descriptions are split into words (runs of letters, digits
+ * and non-ASCII bytes, compared without ASCII case). The index is built
+ * from the current contents and then updated by every change, including
+ * loads into the list. Enabling it again does nothing.
+ *
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_enable_search(TodoList* list);
+
+/**
+ * @brief Stop maintaining the inverted index and free it
+ * @param list Pointer to the todo list
+ */
+void todo_list_disable_search(TodoList* list);
+
+/**
+ * @brief Find todos whose title or description matches a query
+ *
+ * By default every word of the query must occur as a word of the todo;
+ * a word ending in '*' matches any word starting with it ("mil*" finds
+ * "milk"). With the index enabled the cost depends on the rarest query
+ * word rather than on the list size; without it every todo is checked.
+ * With TODO_SEARCH_SUBSTRING the whole query is matched as a
+ * case-insensitive substring by scanning every todo, using SSE2 where
+ * available.
+ *
+ * Matches are visited in ID order. The callback must not modify the list.
+ *
+ * @param list Pointer to the todo list
+ * @param query Words to look for
+ * @param flags 0 or TODO_SEARCH_SUBSTRING
+ * @param fn Callback invoked for each match (return non-zero to stop)
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, negative TodoError on failure
+ */
+int todo_search(const TodoList* list, const char* query, int flags, TodoVisitFn fn, void* user_data);
+
+/**
+ * @brief Index the current text of a todo (used internally by the list)
+ * @param search Index to update
+ * @param list List owning the todo
+ * @param todo Live todo whose text was added or replaced
+ * @return 0 on success, -1 on allocation failure
+ */
+int search_index_todo(TodoSearch* search, const TodoList* list, const Todo* todo);
+
+/**
+ * @brief Forget a deleted todo (used internally by the list)
+ * @param search Index to update
+ * @param id ID of the deleted todo
+ */
+void search_forget_todo(TodoSearch* search, int id);
+
+/**
+ * @brief Rebuild the index from the list's contents (used internally by the list)
+ * @param search Index to rebuild
+ * @param list List to index
+ * @return 0 on success, -1 on allocation failure
+ */
+int search_rebuild(TodoSearch* search, const TodoList* list);
+
+/**
+ * @brief Free an index (used internally by the list)
+ * @param search Index to free (may be NULL)
+ */
+void search_destroy(TodoSearch* search);
+
+#endif // SEARCH_H
\ No newline at end of file
@@ -0,0 +1,52 @@
+/**
+ * @file server.h
+ * @brief Long-running server keeping a todo list resident
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * The server owns one TodoList for its whole lifetime and answers the
+ * requests of wire.h over a Unix domain socket, so clients neither load
+ * nor save the file themselves and several processes can share one list
+ * safely. A single thread multiplexes every connection with epoll (Linux),
+ * kqueue (BSD and macOS) or poll elsewhere. Mutations are journaled, and
+ * the changes of all requests handled in one wakeup are committed
+ * together before any of their responses is sent.
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "todo.h"
+#include "journal.h"
+#include "schedule.h"
+
+// Socket used when none is given
+#define TODO_SERVER_DEFAULT_SOCKET "data/todo.sock"
+
+// Most clients connected at once; further connections are refused
+#define TODO_SERVER_MAX_CLIENTS 256
+
+/**
+ * @brief Serve a list until todo_server_stop is called
+ *
+ * A stale socket file left by a server that is no longer running is
+ * replaced; a socket with a live server behind it is an error. The
+ * socket file is removed on return. Reminders of the scheduler fire
+ * between wakeups, and the wait for clients is cut short when one is due.
+ *
+ * @param list List to serve
+ * @param journal Journal recording changes to list, or NULL to keep them in memory only
+ * @param scheduler Scheduler whose reminders to fire, or NULL
+ * @param socket_path Path of the Unix socket (NULL for TODO_SERVER_DEFAULT_SOCKET)
+ * @return TODO_OK once stopped, negative TodoError if the server could not start or failed
+ */
+int todo_server_run(TodoList* list, Journal* journal, TodoScheduler* scheduler, const char* socket_path);
+
+/**
+ * @brief Ask a running server to finish its current wakeup and return
+ *
+ * Safe to call from a signal handler.
+ */
+void todo_server_stop(void);
+
+#endif // SERVER_H
\ No newline at end of file
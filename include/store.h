@@ -0,0 +1,127 @@
+/**
+ * @file store.h
+ * @brief Header file for the sharded multi-project store
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * A store keeps one TodoList per named project, each in its own snapshot
+ * file with its own journal (e.g. "data/projects/work.dat" and
+ * "data/projects/work.dat.log"), plus a small text manifest listing the
+ * projects and their todo counts. A project is loaded only when it is
+ * first asked for and saving commits only the projects that changed, so
+ * working on one project never reads or rewrites the others.
+ */
+
+#ifndef STORE_H
+#define STORE_H
+
+#include "todo.h"
+
+// Directory used when todo_store_open is given NULL
+#define TODO_STORE_DEFAULT_DIR "data/projects"
+
+// Name of the manifest inside the store directory
+#define TODO_STORE_MANIFEST "manifest"
+
+// Maximum length of a project name, excluding the terminator
+#define TODO_STORE_MAX_NAME 63
+
+/**
+ * @brief Opaque sharded store
+ */
+typedef struct TodoStore TodoStore;
+
+/**
+ * @brief Open a store and read its manifest, creating the directory if needed
+ *
+ * No project is loaded yet. A missing manifest is an empty store.
+ *
+ * @param directory Store directory (NULL for TODO_STORE_DEFAULT_DIR)
+ * @return New store, NULL on failure (including a corrupt manifest)
+ */
+TodoStore* todo_store_open(const char* directory);
+
+/**
+ * @brief Free a store and every project it loaded
+ *
+ * Changes not saved with todo_store_save are discarded.
+ *
+ * @param store Store to close (may be NULL)
+ */
+void todo_store_close(TodoStore* store);
+
+/**
+ * @brief Number of projects in a store
+ * @param store Store to inspect
+ * @return Project count
+ */
+int todo_store_count(const TodoStore* store);
+
+/**
+ * @brief Name of a project
+ * @param store Store to inspect
+ * @param index Project position (0 to todo_store_count - 1, in name order)
+ * @return Project name, NULL if index is out of range
+ */
+const char* todo_store_name(const TodoStore* store, int index);
+
+/**
+ * @brief Number of todos in a project, without loading it
+ * @param store Store to inspect
+ * @param index Project position
+ * @return Live todo count (as of the last save for projects not loaded), negative TodoError on failure
+ */
+int todo_store_todo_count(const TodoStore* store, int index);
+
+/**
+ * @brief Position of a project
+ * @param store Store to search
+ * @param name Project name
+ * @return Project position, -1 if there is no such project
+ */
+int todo_store_find(const TodoStore* store, const char* name);
+
+/**
+ * @brief Get a project's list, loading it on first use
+ *
+ * The list stays owned by the store; do not destroy it.
+ *
+ * @param store Store holding the project
+ * @param name Project name
+ * @return The project's list, NULL if there is no such project or it fails to load
+ */
+TodoList* todo_store_get(TodoStore* store, const char* name);
+
+/**
+ * @brief Add an empty project
+ *
+ * The manifest is rewritten straight away so that the project's files
+ * are never left without an entry. Names may contain letters, digits,
+ * '-', '_' and '.', but may not start with '.'.
+ *
+ * @param store Store to add to
+ * @param name Project name
+ * @return The new project's list (owned by the store), NULL on failure
+ */
+TodoList* todo_store_add(TodoStore* store, const char* name);
+
+/**
+ * @brief Delete a project and its files
+ * @param store Store holding the project
+ * @param name Project name
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND if there is no such project, negative TodoError on failure
+ */
+int todo_store_remove(TodoStore* store, const char* name);
+
+/**
+ * @brief Commit the changes of every loaded project and update the manifest
+ *
+ * Projects that were not changed are not touched, and the manifest is
+ * rewritten only if a todo count changed.
+ *
+ * @param store Store to save
+ * @return TODO_OK on success, negative TodoError if any project failed to save
+ */
+int todo_store_save(TodoStore* store);
+
+#endif // STORE_H
\ No newline at end of file
@@ -11,6 +11,9 @@
 #ifndef TODO_H
 #define TODO_H
 
+#include "todo_sync.h"
+
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,7 +22,9 @@
 // Maximum string lengths
 #define MAX_TITLE_LENGTH 100
 #define MAX_DESC_LENGTH 500
-#define MAX_TODOS 1000
+
+// Number of slots allocated the first time a list grows
+#define INITIAL_TODO_CAPACITY 16
 
 /**
  * @brief Enumeration for todo priority levels
@@ -38,37 +43,248 @@ typedef enum {
     STATUS_COMPLETED = 1
 } Status;
 
+/**
+ * @brief Result codes returned by the todo library
+ *
+ * Functions return TODO_OK (or a non-negative value such as an ID) on
+ * success and one of the negative codes below on failure. The library
+ * prints nothing itself; see todo_log.h for optional diagnostics.
+ */
+typedef enum {
+    TODO_OK = 0,                /**< Success */
+    TODO_ERR_INVALID = -1,      /**< Invalid argument */
+    TODO_ERR_NOT_FOUND = -2,    /**< No todo with the given ID */
+    TODO_ERR_TOO_LONG = -3,     /**< Title or description exceeds its limit */
+    TODO_ERR_NO_MEMORY = -4,    /**< Allocation failed or storage limit reached */
+    TODO_ERR_IO = -5,           /**< File could not be opened, read or written */
+    TODO_ERR_CORRUPT = -6       /**< Stored data is malformed */
+} TodoError;
+
+/**
+ * @brief Strategy used by todo_delete to close the gap left by a todo
+ */
+typedef enum {
+    TODO_DELETE_STABLE = 0,   /**< Keep insertion order (tombstone + lazy compaction) */
+    TODO_DELETE_SWAP = 1      /**< Move the last todo into the gap (order not kept) */
+} TodoDeleteMode;
+
+/**
+ * @brief Orders in which a sorted view keeps todos (see view.h)
+ */
+typedef enum {
+    TODO_SORT_PRIORITY = 0,   /**< Highest priority first, then oldest created, then lowest ID */
+    TODO_SORT_CREATED = 1,    /**< Oldest created first, then lowest ID */
+    TODO_SORT_UPDATED = 2     /**< Most recently updated first, then highest ID */
+} TodoSortKey;
+
+// Number of TodoSortKey values
+#define TODO_SORT_COUNT 3
+
+// ID stored in a slot whose todo was deleted but not yet compacted away
+#define TODO_TOMBSTONE_ID 0
+
 /**
  * @brief Structure representing a single todo item
+ *
+ * This is a fixed 40-byte header. The title and description live out of
+ * line in the owning list's string arena as "title\0description\0"
+ * starting at text_offset; use todo_get_title() and
+ * todo_get_description() to read them.
  */
 typedef struct {
-    int id;                                  /**< Unique identifier */
-    char title[MAX_TITLE_LENGTH];           /**< Todo title */
-    char description[MAX_DESC_LENGTH];      /**< Todo description */
-    Priority priority;                      /**< Priority level */
-    Status status;                         /**< Completion status */
-    time_t created_at;                     /**< Creation timestamp */
-    time_t updated_at;                     /**< Last update timestamp */
+    int32_t id;                              /**< Unique identifier */
+    uint8_t priority;                        /**< Priority level (Priority) */
+    uint8_t status;                          /**< Completion status (Status) */
+    uint16_t flags;                          /**< Reserved, always 0 */
+    uint32_t text_offset;                    /**< Offset of the title in the string arena */
+    uint16_t title_length;                   /**< Title length, excluding terminator */
+    uint16_t desc_length;                    /**< Description length, excluding terminator */
+    int64_t created_at;                      /**< Creation timestamp */
+    int64_t updated_at;                      /**< Last update timestamp */
+    int64_t due_at;                          /**< Due timestamp, 0 if the todo has no due date */
 } Todo;
 
 /**
- * @brief Structure for managing the todo list
+ * @brief Input for one todo in a todo_create_many batch
  */
 typedef struct {
+    const char* title;                     /**< Title of the todo */
+    const char* description;               /**< Description (NULL for none) */
+    Priority priority;                     /**< Priority level */
+} TodoSpec;
+
+/**
+ * @brief Input for one todo in a todo_update_many batch
+ *
+ * Fields follow the todo_update conventions: NULL strings and a priority
+ * of -1 leave the existing value unchanged.
+ */
+typedef struct {
+    int id;                                /**< ID of the todo to update */
+    const char* title;                     /**< New title (NULL to keep existing) */
+    const char* description;               /**< New description (NULL to keep existing) */
+    int priority;                          /**< New priority (-1 to keep existing) */
+} TodoUpdate;
+
+/**
+ * @brief Kind of change reported to list observers
+ */
+typedef enum {
+    TODO_CHANGE_CREATE = 0,   /**< A todo was added */
+    TODO_CHANGE_UPDATE = 1,   /**< Fields of an existing todo changed */
+    TODO_CHANGE_DELETE = 2,   /**< A todo is about to be removed */
+    TODO_CHANGE_PREPARE = 3   /**< An existing todo is about to change (usually followed by UPDATE) */
+} TodoChange;
+
+// Maximum number of observers attached to one list
+#define TODO_MAX_OBSERVERS 8
+
+// Number of (status, priority) combinations tracked by the query index
+#define TODO_BUCKET_COUNT 6
+
+// Bucket of the query index holding todos with this status and priority
+#define TODO_BUCKET(status, priority) ((int)(status) * 3 + (int)(priority) - PRIORITY_LOW)
+
+// Query mask bits selecting one status or priority (todo_query)
+#define TODO_STATUS_BIT(status) (1u << (status))
+#define TODO_PRIORITY_BIT(priority) (1u << (priority))
+
+// Query masks matching every status or priority
+#define TODO_STATUS_ANY (TODO_STATUS_BIT(STATUS_PENDING) | TODO_STATUS_BIT(STATUS_COMPLETED))
+#define TODO_PRIORITY_ANY (TODO_PRIORITY_BIT(PRIORITY_LOW) | TODO_PRIORITY_BIT(PRIORITY_MEDIUM) | \
+                           TODO_PRIORITY_BIT(PRIORITY_HIGH))
+
+typedef struct TodoList TodoList;
+
+/**
+ * @brief Sorted view of a list, maintained as the list changes (see view.h)
+ */
+typedef struct TodoView TodoView;
+
+/**
+ * @brief Inverted index of a list's text (see search.h)
+ */
+typedef struct TodoSearch TodoSearch;
+
+/**
+ * @brief Column-oriented copies of the scanned fields (see scan.h)
+ */
+typedef struct TodoColumns TodoColumns;
+
+/**
+ * @brief Callback invoked after each change to a list
+ *
+ * todo points at the todo's current state (for TODO_CHANGE_DELETE and
+ * TODO_CHANGE_PREPARE, the state just before the change) and is only
+ * valid during the call. Observers that only track the latest state can
+ * ignore TODO_CHANGE_PREPARE. Observers must not modify the list.
+ *
+ * @param list List that changed
+ * @param change Kind of change
+ * @param todo Affected todo
+ * @param user_data Pointer given to todo_list_add_observer
+ */
+typedef void (*TodoObserverFn)(const TodoList* list, TodoChange change, const Todo* todo, void* user_data);
+
+/**
+ * @brief Predicate selecting todos, e.g. for exports
+ * @param list List the todo belongs to
+ * @param todo Todo to test
+ * @param user_data Context given alongside the callback
+ * @return Non-zero to include the todo, 0 to skip it
+ */
+typedef int (*TodoFilterFn)(const TodoList* list, const Todo* todo, void* user_data);
+
+/**
+ * @brief Callback receiving each result of todo_query
+ *
+ * The callback must not modify the list.
+ *
+ * @param list List being queried
+ * @param todo Matching todo
+ * @param user_data Pointer given to todo_query
+ * @return 0 to continue, non-zero to stop the query
+ */
+typedef int (*TodoVisitFn)(const TodoList* list, const Todo* todo, void* user_data);
+
+/**
+ * @brief Registered observer
+ */
+typedef struct {
+    TodoObserverFn fn;                     /**< Callback */
+    void* user_data;                       /**< Context passed to the callback */
+} TodoObserver;
+
+/**
+ * @brief Structure for managing the todo list
+ *
+ * Slots 0..used-1 of todos hold the items in insertion order. With the
+ * default TODO_DELETE_STABLE mode some of those slots may be tombstones
+ * (id == TODO_TOMBSTONE_ID) that must be skipped when iterating; they are
+ * compacted away once they make up half of the used slots.
+ *
+ * When backing is set (see todo_list_attach) the todos and strings arrays
+ * live in read-only memory such as a mapped file, and capacity and
+ * strings_capacity are 0. The first modification copies them to the heap.
+ *
+ * For filtered queries every live ID is also set in the bitmap of its
+ * (status, priority) bucket. Each bitmap covers index_capacity IDs; a
+ * summary bitmap marks its non-zero words so sparse buckets are walked
+ * without touching empty ones.
+ */
+struct TodoList {
     Todo* todos;                           /**< Dynamic array of todos */
     int count;                            /**< Current number of todos */
-    int capacity;                         /**< Maximum capacity */
+    int used;                             /**< Slots in use, including tombstones */
+    int capacity;                         /**< Allocated slots in todos */
     int next_id;                         /**< Next available ID */
-} TodoList;
+    int* id_index;                       /**< Maps ID to slot in todos (-1 if absent) */
+    int index_capacity;                  /**< Number of IDs covered by id_index */
+    char* strings;                       /**< String arena holding all titles and descriptions */
+    size_t strings_size;                 /**< Bytes used in the string arena */
+    size_t strings_capacity;             /**< Bytes allocated for the string arena */
+    size_t strings_garbage;              /**< Bytes in the arena no longer referenced */
+    TodoDeleteMode delete_mode;          /**< How todo_delete fills gaps */
+    TodoObserver observers[TODO_MAX_OBSERVERS]; /**< Change observers */
+    int observer_count;                  /**< Number of registered observers */
+    void* backing;                       /**< Read-only storage todos and strings point into (NULL if heap-owned) */
+    void (*backing_release)(void* backing); /**< Frees backing once the list no longer uses it */
+    uint64_t* bucket_bits;               /**< TODO_BUCKET_COUNT bitmaps of index_capacity bits each */
+    uint64_t* bucket_summary;            /**< Per bucket, one bit per non-zero word of bucket_bits */
+    int bucket_counts[TODO_BUCKET_COUNT]; /**< Number of todos in each bucket */
+    TodoView* views[TODO_SORT_COUNT];    /**< Enabled sorted views (NULL if disabled) */
+    TodoSearch* search;                  /**< Inverted index of the text (NULL if disabled) */
+    TodoColumns* columns;                /**< Columnar copies of the fields (NULL if disabled) */
+    TodoRwLock* lock;                    /**< Lock for use from several threads (NULL if disabled) */
+};
 
 // Function declarations for CRUD operations
 
 /**
  * @brief Initialize a new todo list
+ *
+ * The list starts empty and allocates no storage for todos until the
+ * first item is added; capacity then grows geometrically as needed.
+ *
  * @return Pointer to initialized TodoList, NULL on failure
  */
 TodoList* todo_list_create(void);
 
+/**
+ * @brief Ensure a todo list can hold at least min_capacity todos
+ * @param list Pointer to the todo list
+ * @param min_capacity Number of todos the list must be able to hold
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_reserve(TodoList* list, int min_capacity);
+
+/**
+ * @brief Compact the list and release unused capacity
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_shrink_to_fit(TodoList* list);
+
 /**
  * @brief Free memory allocated for todo list
  * @param list Pointer to the todo list to destroy
@@ -81,21 +297,63 @@ void todo_list_destroy(TodoList* list);
  * @param title Title of the todo
  * @param description Description of the todo
  * @param priority Priority level
- * @return ID of created todo, -1 on failure
+ * @return ID of created todo, negative TodoError on failure
  */
 int todo_create(TodoList* list, const char* title, const char* description, Priority priority);
 
 /**
  * @brief Read/display all todos
+ *
+ * This, todo_read_matching and todo_read_by_id are the only library
+ * functions that write to stdout, since rendering is their purpose.
+ *
  * @param list Pointer to the todo list
  */
 void todo_read_all(const TodoList* list);
 
+/**
+ * @brief Display the todos matching a status and priority filter
+ *
+ * Output has the same layout as todo_read_all, in ID order.
+ *
+ * @param list Pointer to the todo list
+ * @param status_mask TODO_STATUS_BIT values to include (TODO_STATUS_ANY for all)
+ * @param priority_mask TODO_PRIORITY_BIT values to include (TODO_PRIORITY_ANY for all)
+ */
+void todo_read_matching(const TodoList* list, unsigned status_mask, unsigned priority_mask);
+
+/**
+ * @brief Visit the todos matching a status and priority filter
+ *
+ * Matches are found through the list's per-bucket ID bitmaps, which are
+ * kept up to date by every change, so the cost is proportional to the
+ * number of results (plus one word per 4096 IDs per selected bucket)
+ * rather than to the size of the list. Todos are visited in ID order.
+ *
+ * @param list Pointer to the todo list
+ * @param status_mask TODO_STATUS_BIT values to include (TODO_STATUS_ANY for all)
+ * @param priority_mask TODO_PRIORITY_BIT values to include (TODO_PRIORITY_ANY for all)
+ * @param fn Callback invoked for each match
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, negative TodoError on invalid arguments
+ */
+int todo_query(const TodoList* list, unsigned status_mask, unsigned priority_mask,
+               TodoVisitFn fn, void* user_data);
+
+/**
+ * @brief Count the todos matching a status and priority filter in constant time
+ * @param list Pointer to the todo list
+ * @param status_mask TODO_STATUS_BIT values to include
+ * @param priority_mask TODO_PRIORITY_BIT values to include
+ * @return Number of matching todos, negative TodoError on invalid arguments
+ */
+int todo_query_count(const TodoList* list, unsigned status_mask, unsigned priority_mask);
+
 /**
  * @brief Read/display a specific todo by ID
  * @param list Pointer to the todo list
  * @param id ID of the todo to display
- * @return 0 on success, -1 if not found
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
  */
 int todo_read_by_id(const TodoList* list, int id);
 
@@ -106,15 +364,19 @@ int todo_read_by_id(const TodoList* list, int id);
  * @param title New title (NULL to keep existing)
  * @param description New description (NULL to keep existing)
  * @param priority New priority (-1 to keep existing)
- * @return 0 on success, -1 if not found
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
  */
 int todo_update(TodoList* list, int id, const char* title, const char* description, int priority);
 
 /**
  * @brief Delete a todo item
+ *
+ * Runs in amortized O(1): depending on the list's delete mode the slot is
+ * either turned into a tombstone or filled with the last todo.
+ *
  * @param list Pointer to the todo list
  * @param id ID of the todo to delete
- * @return 0 on success, -1 if not found
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
  */
 int todo_delete(TodoList* list, int id);
 
@@ -122,7 +384,7 @@ int todo_delete(TodoList* list, int id);
  * @brief Mark a todo as completed
  * @param list Pointer to the todo list
  * @param id ID of the todo to complete
- * @return 0 on success, -1 if not found
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
  */
 int todo_complete(TodoList* list, int id);
 
@@ -130,18 +392,282 @@ int todo_complete(TodoList* list, int id);
  * @brief Mark a todo as pending
  * @param list Pointer to the todo list
  * @param id ID of the todo to mark pending
- * @return 0 on success, -1 if not found
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
  */
 int todo_mark_pending(TodoList* list, int id);
 
+/**
+ * @brief Set or clear the due date of a todo
+ *
+ * Counts as an update: updated_at is refreshed and observers are told.
+ * Setting the due date a todo already has does nothing.
+ *
+ * @param list Pointer to the todo list
+ * @param id ID of the todo
+ * @param due_at Due timestamp (0 to clear it)
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+int todo_set_due(TodoList* list, int id, time_t due_at);
+
+/**
+ * @brief Create many todo items in one pass
+ *
+ * All specs are validated up front, storage is reserved once and a single
+ * timestamp is used for the whole batch. Nothing is printed; the outcome
+ * of each item is reported through out_ids instead.
+ *
+ * @param list Pointer to the todo list
+ * @param specs Array of todos to create
+ * @param n Number of entries in specs
+ * @param out_ids Receives the new ID, or a negative TodoError if that spec was rejected (may be NULL)
+ * @return Number of todos created, negative TodoError on invalid arguments or allocation failure
+ */
+int todo_create_many(TodoList* list, const TodoSpec* specs, int n, int* out_ids);
+
+/**
+ * @brief Update many todo items in one pass
+ * @param list Pointer to the todo list
+ * @param updates Array of updates to apply
+ * @param n Number of entries in updates
+ * @param out_results Receives TODO_OK or a negative TodoError per update (may be NULL)
+ * @return Number of todos updated, negative TodoError on invalid arguments or allocation failure
+ */
+int todo_update_many(TodoList* list, const TodoUpdate* updates, int n, int* out_results);
+
+/**
+ * @brief Mark many todos as completed in one pass
+ * @param list Pointer to the todo list
+ * @param ids Array of IDs to complete
+ * @param n Number of entries in ids
+ * @param out_results Receives TODO_OK or TODO_ERR_NOT_FOUND per ID (may be NULL)
+ * @return Number of IDs found, TODO_ERR_INVALID on invalid arguments
+ */
+int todo_complete_many(TodoList* list, const int* ids, int n, int* out_results);
+
 /**
  * @brief Find a todo by ID
+ *
+ * The returned pointer refers to storage owned by the list. It stays valid
+ * across todo_update, todo_complete and todo_mark_pending, but is
+ * invalidated by any call that can move or reallocate the array:
+ * todo_create, todo_delete, todo_list_reserve, todo_list_shrink_to_fit,
+ * todo_list_compact, todo_list_set_delete_mode and loading into the list. Look the todo up again after such a call.
+ * While the list is backed by a mapped file, the first modifying call of
+ * any kind also moves the todos (see todo_list_make_writable).
+ *
  * @param list Pointer to the todo list
  * @param id ID to search for
  * @return Pointer to todo if found, NULL otherwise
  */
 Todo* todo_find_by_id(const TodoList* list, int id);
 
+/**
+ * @brief Choose how todo_delete closes the gap left by a deleted todo
+ *
+ * Switching to TODO_DELETE_SWAP compacts away any pending tombstones.
+ *
+ * @param list Pointer to the todo list
+ * @param mode Deletion strategy
+ */
+void todo_list_set_delete_mode(TodoList* list, TodoDeleteMode mode);
+
+/**
+ * @brief Remove tombstones so that slots 0..count-1 are all live todos
+ * @param list Pointer to the todo list
+ */
+void todo_list_compact(TodoList* list);
+
+/**
+ * @brief Make a list safe to share between threads
+ *
+ * Attaches a reader-writer lock to the list; call this before the list
+ * is shared. From then on, calls that only read the list (those taking a
+ * const TodoList*, including saving, exporting and searching) must be
+ * made while holding todo_list_lock_shared, and all other calls while
+ * holding todo_list_lock_exclusive. Any number of readers then run in
+ * parallel and writers run alone. Pointers returned by todo_find_by_id
+ * and todo_get_title stay valid until the lock is released. Library
+ * functions never take the lock themselves, so several calls can be
+ * grouped under one acquisition. Enabling it again does nothing.
+ *
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_enable_locking(TodoList* list);
+
+/**
+ * @brief Acquire the list's lock for reading (no-op unless locking is enabled)
+ * @param list Pointer to the todo list
+ */
+void todo_list_lock_shared(const TodoList* list);
+
+/**
+ * @brief Release the list's lock after reading
+ * @param list Pointer to the todo list
+ */
+void todo_list_unlock_shared(const TodoList* list);
+
+/**
+ * @brief Acquire the list's lock for modification (no-op unless locking is enabled)
+ * @param list Pointer to the todo list
+ */
+void todo_list_lock_exclusive(TodoList* list);
+
+/**
+ * @brief Release the list's lock after modification
+ * @param list Pointer to the todo list
+ */
+void todo_list_unlock_exclusive(TodoList* list);
+
+/**
+ * @brief Register a callback to be told about every change to the list
+ * @param list Pointer to the todo list
+ * @param fn Callback to invoke
+ * @param user_data Context passed to the callback
+ * @return TODO_OK on success, TODO_ERR_NO_MEMORY if all observer slots are taken
+ */
+int todo_list_add_observer(TodoList* list, TodoObserverFn fn, void* user_data);
+
+/**
+ * @brief Unregister a callback added with todo_list_add_observer
+ * @param list Pointer to the todo list
+ * @param fn Callback to remove
+ * @param user_data Context it was registered with
+ */
+void todo_list_remove_observer(TodoList* list, TodoObserverFn fn, void* user_data);
+
+/**
+ * @brief Replace the contents of a list with prepared arrays
+ *
+ * The list takes ownership of the arrays in every case, including failure.
+ * With backing NULL they must come from malloc and are freed by the list.
+ * Otherwise they are treated as read-only memory kept alive by backing,
+ * which is passed to release once the list stops using it: on clear,
+ * destroy, or the first modification, which copies the data to the heap.
+ * The ID index is rebuilt; each todo's text_offset must address a
+ * "title\0description\0" block inside strings.
+ *
+ * @param list Pointer to the todo list
+ * @param todos Array of used todo slots
+ * @param used Number of slots in todos
+ * @param strings String arena referenced by the todos
+ * @param strings_size Size of the string arena in bytes
+ * @param next_id Next ID to hand out (raised past the largest ID if needed)
+ * @param backing Owner of read-only storage, or NULL for heap arrays
+ * @param release Called with backing when it is no longer needed (may be NULL)
+ * @return TODO_OK on success, negative TodoError on failure (the list is left empty)
+ */
+int todo_list_attach(TodoList* list, Todo* todos, int used, char* strings, size_t strings_size,
+                     int next_id, void* backing, void (*release)(void* backing));
+
+/**
+ * @brief Make an independent copy of a list's todos
+ *
+ * The copy has the same todos, text and next ID but none of the
+ * observers, optional indexes or lock, so it can be saved or read on
+ * another thread while the original keeps changing.
+ *
+ * @param list Pointer to the todo list
+ * @return New list (free with todo_list_destroy), NULL on failure
+ */
+TodoList* todo_list_clone(const TodoList* list);
+
+/**
+ * @brief Copy read-only backing storage into heap memory owned by the list
+ *
+ * Modifying functions call this automatically; it does nothing if the
+ * list is already heap-owned.
+ *
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_make_writable(TodoList* list);
+
+/**
+ * @brief Remove all todos from the list, keeping its allocations
+ *
+ * Observers are not notified; this is meant for reloading a list. Any
+ * backing storage is released.
+ *
+ * @param list Pointer to the todo list
+ */
+void todo_list_clear(TodoList* list);
+
+/**
+ * @brief Insert or replace a todo with explicit field values
+ *
+ * Unlike todo_create, the ID and timestamps are taken from the caller and
+ * next_id is advanced past the given ID if needed. If a todo with this ID
+ * already exists it is overwritten in place; otherwise the todo is
+ * appended. Used when loading and replaying saved data.
+ *
+ * @param list Pointer to the todo list
+ * @param id ID of the todo
+ * @param title Title of the todo
+ * @param description Description of the todo (NULL for none)
+ * @param priority Priority level
+ * @param status Completion status
+ * @param created_at Creation timestamp
+ * @param updated_at Last update timestamp
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_restore(TodoList* list, int id, const char* title, const char* description,
+                 Priority priority, Status status, time_t created_at, time_t updated_at);
+
+/**
+ * @brief Restore a todo with explicit field values, including its due date
+ *
+ * Like todo_restore, which restores todos without a due date.
+ *
+ * @param list Pointer to the todo list
+ * @param id ID of the todo
+ * @param title Title of the todo
+ * @param description Description of the todo (NULL for none)
+ * @param priority Priority level
+ * @param status Completion status
+ * @param created_at Creation timestamp
+ * @param updated_at Last update timestamp
+ * @param due_at Due timestamp (0 for none)
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_restore_ex(TodoList* list, int id, const char* title, const char* description,
+                    Priority priority, Status status, time_t created_at, time_t updated_at,
+                    time_t due_at);
+
+/**
+ * @brief Get the title of a todo
+ *
+ * The returned string is owned by the list and is invalidated by the same
+ * calls that invalidate pointers returned by todo_find_by_id, and also by
+ * todo_update.
+ *
+ * @param list Pointer to the todo list owning the todo
+ * @param todo Pointer to the todo
+ * @return NUL-terminated title
+ */
+const char* todo_get_title(const TodoList* list, const Todo* todo);
+
+/**
+ * @brief Get the description of a todo
+ * @param list Pointer to the todo list owning the todo
+ * @param todo Pointer to the todo
+ * @return NUL-terminated description ("" if none)
+ */
+const char* todo_get_description(const TodoList* list, const Todo* todo);
+
+/**
+ * @brief Rebuild the ID index from the current contents of the list
+ *
+ * Must be called after todos, used or next_id are changed directly
+ * rather than through the CRUD functions. count is recomputed from the
+ * non-tombstone slots. Large lists without sorted views or scan columns
+ * are indexed on up to todo_parallelism() threads.
+ *
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_rebuild_index(TodoList* list);
+
 /**
  * @brief Get priority string representation
  * @param priority Priority enum value
@@ -156,4 +682,11 @@ const char* get_priority_string(Priority priority);
  */
 const char* get_status_string(Status status);
 
+/**
+ * @brief Get a human-readable description of a result code
+ * @param error TodoError value (or any negative return code)
+ * @return Static description string
+ */
+const char* todo_strerror(int error);
+
 #endif // TODO_H
\ No newline at end of file
@@ -0,0 +1,49 @@
+/**
+ * @file todo_log.h
+ * @brief Pluggable diagnostic logging for the todo library
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * The core library never writes to stdout or stderr on its own. Details
+ * about failures are passed to an optional log handler installed by the
+ * application; without one they are discarded at almost no cost.
+ */
+
+#ifndef TODO_LOG_H
+#define TODO_LOG_H
+
+/**
+ * @brief Severity of a log message
+ */
+typedef enum {
+    TODO_LOG_ERROR = 0,
+    TODO_LOG_WARNING = 1,
+    TODO_LOG_INFO = 2
+} TodoLogLevel;
+
+/**
+ * @brief Signature of a log handler
+ * @param level Severity of the message
+ * @param message Formatted message without trailing newline
+ * @param user_data Pointer passed to todo_set_log_handler
+ */
+typedef void (*TodoLogFn)(TodoLogLevel level, const char* message, void* user_data);
+
+/**
+ * @brief Install the handler that receives library log messages
+ * @param handler Handler to call, or NULL to discard messages
+ * @param user_data Pointer handed back to the handler on every call
+ */
+void todo_set_log_handler(TodoLogFn handler, void* user_data);
+
+/**
+ * @brief Emit a log message (used internally by the library)
+ *
+ * The message is only formatted when a handler is installed.
+ *
+ * @param level Severity of the message
+ * @param format printf-style format string
+ */
+void todo_log(TodoLogLevel level, const char* format, ...);
+
+#endif // TODO_LOG_H
@@ -0,0 +1,221 @@
+/**
+ * @file todo_sync.h
+ * @brief Portable synchronization primitives
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file declares thin wrappers over POSIX threads and the Win32
+ * threading API (slim reader/writer locks, critical sections and
+ * condition variables), so the rest of the library can start threads
+ * and synchronize without platform conditionals. It also provides a
+ * small fork-join pool for splitting CPU-bound work into tasks.
+ */
+
+#ifndef TODO_SYNC_H
+#define TODO_SYNC_H
+
+#include <stdint.h>
+
+// Most threads todo_parallel_run uses, including the caller
+#define TODO_MAX_PARALLELISM 16
+
+// Storage class of per-thread variables
+#ifdef _MSC_VER
+    #define TODO_THREAD_LOCAL __declspec(thread)
+#else
+    #define TODO_THREAD_LOCAL __thread
+#endif
+
+/**
+ * @brief Reader-writer lock (opaque)
+ */
+typedef struct TodoRwLock TodoRwLock;
+
+/**
+ * @brief Create a reader-writer lock
+ * @return New lock, NULL on failure
+ */
+TodoRwLock* todo_rwlock_create(void);
+
+/**
+ * @brief Destroy a reader-writer lock, which must not be held
+ * @param lock Lock to destroy (may be NULL)
+ */
+void todo_rwlock_destroy(TodoRwLock* lock);
+
+/**
+ * @brief Acquire a lock in shared mode, waiting for any writer
+ * @param lock Lock to acquire
+ */
+void todo_rwlock_read_lock(TodoRwLock* lock);
+
+/**
+ * @brief Release a lock held in shared mode
+ * @param lock Lock to release
+ */
+void todo_rwlock_read_unlock(TodoRwLock* lock);
+
+/**
+ * @brief Acquire a lock in exclusive mode, waiting for readers and writers
+ * @param lock Lock to acquire
+ */
+void todo_rwlock_write_lock(TodoRwLock* lock);
+
+/**
+ * @brief Release a lock held in exclusive mode
+ * @param lock Lock to release
+ */
+void todo_rwlock_write_unlock(TodoRwLock* lock);
+
+/**
+ * @brief Mutual exclusion lock (opaque)
+ */
+typedef struct TodoMutex TodoMutex;
+
+/**
+ * @brief Condition variable used together with a TodoMutex (opaque)
+ */
+typedef struct TodoCond TodoCond;
+
+/**
+ * @brief Handle of a started thread (opaque)
+ */
+typedef struct TodoThread TodoThread;
+
+/**
+ * @brief Create a mutex
+ * @return New mutex, NULL on failure
+ */
+TodoMutex* todo_mutex_create(void);
+
+/**
+ * @brief Destroy a mutex, which must not be held
+ * @param mutex Mutex to destroy (may be NULL)
+ */
+void todo_mutex_destroy(TodoMutex* mutex);
+
+/**
+ * @brief Acquire a mutex
+ * @param mutex Mutex to acquire
+ */
+void todo_mutex_lock(TodoMutex* mutex);
+
+/**
+ * @brief Release a mutex
+ * @param mutex Mutex to release
+ */
+void todo_mutex_unlock(TodoMutex* mutex);
+
+/**
+ * @brief Create a condition variable
+ * @return New condition variable, NULL on failure
+ */
+TodoCond* todo_cond_create(void);
+
+/**
+ * @brief Destroy a condition variable nobody is waiting on
+ * @param cond Condition variable to destroy (may be NULL)
+ */
+void todo_cond_destroy(TodoCond* cond);
+
+/**
+ * @brief Release a mutex, wait for a signal and reacquire the mutex
+ *
+ * Wakeups can be spurious, so callers re-check their condition in a loop.
+ *
+ * @param cond Condition variable to wait on
+ * @param mutex Mutex held by the caller
+ */
+void todo_cond_wait(TodoCond* cond, TodoMutex* mutex);
+
+/**
+ * @brief Wake one thread waiting on a condition variable
+ * @param cond Condition variable to signal
+ */
+void todo_cond_signal(TodoCond* cond);
+
+/**
+ * @brief Wake every thread waiting on a condition variable
+ * @param cond Condition variable to signal
+ */
+void todo_cond_broadcast(TodoCond* cond);
+
+/**
+ * @brief Start a thread
+ * @param fn Function run by the thread
+ * @param arg Argument passed to fn
+ * @return Handle to pass to todo_thread_join, NULL on failure
+ */
+TodoThread* todo_thread_start(void (*fn)(void* arg), void* arg);
+
+/**
+ * @brief Wait for a thread to finish and free its handle
+ * @param thread Thread to join
+ */
+void todo_thread_join(TodoThread* thread);
+
+/**
+ * @brief Take the process-wide lock
+ *
+ * The lock needs no setup, so it can guard the lazy initialization of
+ * global state. It is not recursive and must be held only briefly.
+ */
+void todo_global_lock(void);
+
+/**
+ * @brief Release the process-wide lock
+ */
+void todo_global_unlock(void);
+
+/**
+ * @brief Set the function threads call as they finish
+ *
+ * Every thread started by todo_thread_start (including the pool of
+ * todo_parallel_run) calls the hook once its function has returned, so
+ * per-thread state can be handed back. The hook is process-wide.
+ *
+ * @param hook Function to call (NULL for none)
+ */
+void todo_thread_set_exit_hook(void (*hook)(void));
+
+/**
+ * @brief Read a monotonic clock
+ * @return Nanoseconds since an arbitrary point, never 0
+ */
+uint64_t todo_clock_ns(void);
+
+/**
+ * @brief Number of processors available to the process
+ * @return Processor count (at least 1)
+ */
+int todo_cpu_count(void);
+
+/**
+ * @brief Set how many threads todo_parallel_run may use
+ *
+ * Call before starting any threads; the setting is process-wide.
+ *
+ * @param threads Thread count, or 0 for one per processor
+ */
+void todo_set_parallelism(int threads);
+
+/**
+ * @brief Number of threads todo_parallel_run uses
+ * @return Thread count between 1 and TODO_MAX_PARALLELISM
+ */
+int todo_parallelism(void);
+
+/**
+ * @brief Run tasks 0 to tasks - 1 on a pool of threads and wait for them
+ *
+ * The calling thread takes part, so with a parallelism of 1 (or if no
+ * thread can be started) the tasks simply run in order on the caller.
+ * Tasks must not depend on each other's order.
+ *
+ * @param tasks Number of tasks
+ * @param fn Function run once per task
+ * @param arg Argument passed to fn
+ */
+void todo_parallel_run(int tasks, void (*fn)(void* arg, int task), void* arg);
+
+#endif // TODO_SYNC_H
\ No newline at end of file
@@ -0,0 +1,82 @@
+/**
+ * @file view.h
+ * @brief Header file for incrementally maintained sorted views
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file declares sorted views of a todo list. A view is a skip list
+ * of todo IDs ordered by one TodoSortKey; once enabled it is updated by
+ * every change to the list, so reading the first N todos in order costs
+ * O(N) instead of a sort of the whole list.
+ */
+
+#ifndef VIEW_H
+#define VIEW_H
+
+#include "todo.h"
+
+/**
+ * @brief Start maintaining a sorted view of a list
+ *
+ * The view is built from the current contents in O(n log n) and then
+ * kept up to date in O(log n) per change. Enabling a view that is
+ * already enabled does nothing.
+ *
+ * @param list Pointer to the todo list
+ * @param key Order of the view
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_enable_view(TodoList* list, TodoSortKey key);
+
+/**
+ * @brief Stop maintaining a sorted view and free it
+ * @param list Pointer to the todo list
+ * @param key Order of the view
+ */
+void todo_list_disable_view(TodoList* list, TodoSortKey key);
+
+/**
+ * @brief Visit todos in the order of an enabled view
+ *
+ * For example, the top 10 by priority are todo_view(list,
+ * TODO_SORT_PRIORITY, 10, fn, data). The callback must not modify the
+ * list; it may return non-zero to stop early, e.g. after collecting
+ * enough todos that pass a filter of its own.
+ *
+ * @param list Pointer to the todo list
+ * @param key Order of the view, which must be enabled
+ * @param limit Most todos to visit (0 for all)
+ * @param fn Callback invoked for each todo
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, TODO_ERR_INVALID if the view is not enabled
+ */
+int todo_view(const TodoList* list, TodoSortKey key, int limit, TodoVisitFn fn, void* user_data);
+
+/**
+ * @brief Add a todo to a view (used internally by the list)
+ * @param view View to update
+ * @param todo Live todo with its current field values
+ * @return 0 on success, -1 on allocation failure
+ */
+int view_insert(TodoView* view, const Todo* todo);
+
+/**
+ * @brief Remove a todo from a view (used internally by the list)
+ * @param view View to update
+ * @param todo Todo with the field values it had when it was inserted
+ */
+void view_erase(TodoView* view, const Todo* todo);
+
+/**
+ * @brief Remove every todo from a view (used internally by the list)
+ * @param view View to empty
+ */
+void view_reset(TodoView* view);
+
+/**
+ * @brief Free a view (used internally by the list)
+ * @param view View to free (may be NULL)
+ */
+void view_destroy(TodoView* view);
+
+#endif // VIEW_H
\ No newline at end of file
@@ -0,0 +1,290 @@
+/**
+ * @file wire.h
+ * @brief Binary request/response protocol spoken by the server
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * Every message, in either direction, is a frame of a fixed header
+ * followed by an operation-specific body. All integers are little-endian
+ * and strings are a u16 length followed by that many bytes (no
+ * terminator).
+ *
+ *   frame header (TODO_WIRE_HEADER_SIZE bytes)
+ *   offset  size  field
+ *        0     4  number of bytes after this field (at least 6)
+ *        4     1  operation (TodoWireOp)
+ *        5     1  status: 0 in requests, TODO_OK or a TodoError in responses
+ *        6     4  tag chosen by the client, echoed in the response
+ *
+ *   operation  request body                       response body (status TODO_OK)
+ *   PING       -                                  -
+ *   CREATE     u8 priority, title, description    u32 id
+ *   GET        u32 id                             todo
+ *   UPDATE     u32 id, u8 priority (0 keeps it),  -
+ *              title, description (length
+ *              TODO_WIRE_KEEP keeps either)
+ *   DELETE     u32 id                             -
+ *   COMPLETE   u32 id                             -
+ *   PENDING    u32 id                             -
+ *   LIST       u8 status mask, u8 priority mask   u32 count, count todos
+ *   CHECKPOINT -                                  -
+ *   DUE        u32 id, u64 due at (0 clears it)   -
+ *   STATS      -                                  metrics of the server
+ *
+ *   todo: u32 id, u8 priority, u8 status, u64 created at, u64 updated at,
+ *         u64 due at (0 if none), title, description
+ *
+ *   metrics: u8 op count, u8 bucket count, then per operation u64 calls,
+ *            u64 timed, u64 total ns, u64 max ns and u64 per bucket;
+ *            then u64 bytes read, u64 bytes written, u32 threads,
+ *            u8 enabled
+ *
+ * Requests may be pipelined: a client can send any number of frames
+ * without waiting, and responses come back in the order of the requests.
+ */
+
+#ifndef WIRE_H
+#define WIRE_H
+
+#include "todo.h"
+#include "metrics.h"
+
+// Size of the frame header
+#define TODO_WIRE_HEADER_SIZE 10
+
+// Largest request body a server accepts (a valid request is far smaller)
+#define TODO_WIRE_MAX_REQUEST 4096
+
+// String length in UPDATE meaning "keep the current text"
+#define TODO_WIRE_KEEP 0xFFFF
+
+/**
+ * @brief Operations of the protocol
+ */
+typedef enum {
+    TODO_OP_PING = 1,                      /**< Check that the server is alive */
+    TODO_OP_CREATE,                        /**< Create a todo */
+    TODO_OP_GET,                           /**< Fetch one todo */
+    TODO_OP_UPDATE,                        /**< Change title, description or priority */
+    TODO_OP_DELETE,                        /**< Delete a todo */
+    TODO_OP_COMPLETE,                      /**< Mark a todo as completed */
+    TODO_OP_PENDING,                       /**< Mark a todo as pending */
+    TODO_OP_LIST,                          /**< Fetch every todo matching a filter */
+    TODO_OP_CHECKPOINT,                    /**< Fold the journal into a new snapshot */
+    TODO_OP_DUE,                           /**< Set or clear the due date of a todo */
+    TODO_OP_STATS                          /**< Fetch the server's metrics */
+} TodoWireOp;
+
+/**
+ * @brief Growable buffer frames are encoded into
+ */
+typedef struct {
+    unsigned char* data;                   /**< Encoded bytes */
+    size_t size;                           /**< Bytes in use */
+    size_t capacity;                       /**< Bytes allocated */
+    int error;                             /**< TODO_ERR_NO_MEMORY once an append failed */
+} WireBuffer;
+
+/**
+ * @brief Cursor over a received frame body
+ */
+typedef struct {
+    const unsigned char* data;             /**< Next unread byte */
+    size_t left;                           /**< Bytes left */
+    int error;                             /**< Set once a read ran past the end */
+} WireReader;
+
+/**
+ * @brief Decoded todo as carried by GET and LIST responses
+ */
+typedef struct {
+    int id;                                /**< Unique identifier */
+    Priority priority;                     /**< Priority level */
+    Status status;                         /**< Completion status */
+    int64_t created_at;                    /**< Creation timestamp */
+    int64_t updated_at;                    /**< Last update timestamp */
+    int64_t due_at;                        /**< Due timestamp, 0 if none */
+    char title[MAX_TITLE_LENGTH];          /**< Title (NUL-terminated) */
+    char description[MAX_DESC_LENGTH];     /**< Description (NUL-terminated) */
+} TodoWireTodo;
+
+/**
+ * @brief Prepare an empty buffer (allocates nothing)
+ * @param buffer Buffer to initialize
+ */
+void wire_buffer_init(WireBuffer* buffer);
+
+/**
+ * @brief Free a buffer's storage
+ * @param buffer Buffer to free (left empty and reusable)
+ */
+void wire_buffer_free(WireBuffer* buffer);
+
+/**
+ * @brief Drop the first bytes of a buffer, moving the rest to the front
+ * @param buffer Buffer to shrink
+ * @param count Number of bytes to drop
+ */
+void wire_buffer_consume(WireBuffer* buffer, size_t count);
+
+/**
+ * @brief Make room for at least extra more bytes
+ * @param buffer Buffer to grow
+ * @param extra Number of bytes needed after size
+ * @return TODO_OK on success, TODO_ERR_NO_MEMORY on failure
+ */
+int wire_buffer_reserve(WireBuffer* buffer, size_t extra);
+
+/**
+ * @brief Start a frame (its length is filled in by wire_end_frame)
+ * @param buffer Buffer to append to
+ * @param op Operation
+ * @param status Status (0 for requests)
+ * @param tag Tag of the request
+ * @return Offset of the frame, to pass to wire_end_frame
+ */
+size_t wire_begin_frame(WireBuffer* buffer, TodoWireOp op, int status, uint32_t tag);
+
+/**
+ * @brief Finish a frame started with wire_begin_frame
+ * @param buffer Buffer holding the frame
+ * @param start Offset returned by wire_begin_frame
+ */
+void wire_end_frame(WireBuffer* buffer, size_t start);
+
+/**
+ * @brief Append an 8-bit value
+ * @param buffer Buffer to append to
+ * @param value Value to append
+ */
+void wire_put_u8(WireBuffer* buffer, uint8_t value);
+
+/**
+ * @brief Append a little-endian 16-bit value
+ * @param buffer Buffer to append to
+ * @param value Value to append
+ */
+void wire_put_u16(WireBuffer* buffer, uint16_t value);
+
+/**
+ * @brief Append a little-endian 32-bit value
+ * @param buffer Buffer to append to
+ * @param value Value to append
+ */
+void wire_put_u32(WireBuffer* buffer, uint32_t value);
+
+/**
+ * @brief Append a little-endian 64-bit value
+ * @param buffer Buffer to append to
+ * @param value Value to append
+ */
+void wire_put_u64(WireBuffer* buffer, uint64_t value);
+
+/**
+ * @brief Append a length-prefixed string
+ * @param buffer Buffer to append to
+ * @param text String bytes (may be NULL if length is 0)
+ * @param length Number of bytes (below TODO_WIRE_KEEP)
+ */
+void wire_put_string(WireBuffer* buffer, const char* text, size_t length);
+
+/**
+ * @brief Append a todo in the layout of GET and LIST responses
+ * @param buffer Buffer to append to
+ * @param list List owning the todo
+ * @param todo Live todo
+ */
+void wire_put_todo(WireBuffer* buffer, const TodoList* list, const Todo* todo);
+
+/**
+ * @brief Append metrics in the layout of STATS responses
+ * @param buffer Buffer to append to
+ * @param metrics Metrics to append
+ */
+void wire_put_metrics(WireBuffer* buffer, const TodoMetrics* metrics);
+
+/**
+ * @brief Decode the header of the frame at the start of some bytes
+ * @param data Received bytes
+ * @param size Number of bytes available
+ * @param body_size Receives the size of the body
+ * @param op Receives the operation
+ * @param status Receives the status
+ * @param tag Receives the tag
+ * @return 1 if the whole frame is available, 0 if more bytes are needed,
+ *         TODO_ERR_INVALID if the length field is malformed
+ */
+int wire_peek_frame(const unsigned char* data, size_t size, size_t* body_size,
+                    int* op, int* status, uint32_t* tag);
+
+/**
+ * @brief Start reading a frame body
+ * @param reader Reader to initialize
+ * @param data First byte of the body
+ * @param size Size of the body
+ */
+void wire_reader_init(WireReader* reader, const unsigned char* data, size_t size);
+
+/**
+ * @brief Read an 8-bit value
+ * @param reader Reader
+ * @return Value read (0 past the end)
+ */
+uint8_t wire_get_u8(WireReader* reader);
+
+/**
+ * @brief Read a little-endian 16-bit value
+ * @param reader Reader
+ * @return Value read (0 past the end)
+ */
+uint16_t wire_get_u16(WireReader* reader);
+
+/**
+ * @brief Read a little-endian 32-bit value
+ * @param reader Reader
+ * @return Value read (0 past the end)
+ */
+uint32_t wire_get_u32(WireReader* reader);
+
+/**
+ * @brief Read a little-endian 64-bit value
+ * @param reader Reader
+ * @return Value read (0 past the end)
+ */
+uint64_t wire_get_u64(WireReader* reader);
+
+/**
+ * @brief Read a length-prefixed string into a NUL-terminated buffer
+ *
+ * Strings of TODO_WIRE_KEEP length carry no bytes and are reported as
+ * kept rather than copied.
+ *
+ * @param reader Reader
+ * @param buffer Receives the string
+ * @param size Size of buffer
+ * @return 1 if a string was read, 0 if it was TODO_WIRE_KEEP, TODO_ERR_TOO_LONG
+ *         if it does not fit, TODO_ERR_INVALID past the end
+ */
+int wire_get_string(WireReader* reader, char* buffer, size_t size);
+
+/**
+ * @brief Read a todo in the layout of GET and LIST responses
+ * @param reader Reader
+ * @param todo Receives the todo
+ * @return TODO_OK on success, TODO_ERR_INVALID if the body is malformed
+ */
+int wire_get_todo(WireReader* reader, TodoWireTodo* todo);
+
+/**
+ * @brief Read metrics in the layout of STATS responses
+ *
+ * Operations and buckets beyond those this build knows are skipped, and
+ * missing ones are left zero, so either side may be newer.
+ *
+ * @param reader Reader
+ * @param metrics Receives the metrics
+ * @return TODO_OK on success, TODO_ERR_INVALID if the body is malformed
+ */
+int wire_get_metrics(WireReader* reader, TodoMetrics* metrics);
+
+#endif // WIRE_H
\ No newline at end of file
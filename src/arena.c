@@ -0,0 +1,165 @@
+/**
+ * @file arena.c
+ * @brief Implementation of the bump arena and fixed-size pool allocators
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements arenas as a list of chunks whose sizes double up
+ * to a cap, so the number of chunks grows only logarithmically at first
+ * and then linearly in large steps, and pools as intrusive free lists.
+ */
+
+#include "../include/arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * @brief Header placed in front of each chunk
+ */
+struct ArenaChunk {
+    ArenaChunk* next;                     // Older chunk
+    size_t size;                          // Usable bytes after the header
+};
+
+// Chunk header size rounded up so that chunk data stays aligned
+#define ARENA_HEADER_SIZE ((sizeof(ArenaChunk) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+/**
+ * @brief Round a size up to the arena alignment
+ * @param size Size in bytes
+ * @return Rounded size (0 on overflow)
+ */
+static size_t align_size(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Prepare an empty arena (allocates nothing)
+ * @param arena Arena to initialize
+ */
+void arena_init(Arena* arena) {
+    arena->chunks = NULL;
+    arena->next = NULL;
+    arena->end = NULL;
+    arena->next_chunk_size = ARENA_MIN_CHUNK;
+}
+
+/**
+ * @brief Allocate a block from an arena
+ * @param arena Arena to allocate from
+ * @param size Size of the block in bytes
+ * @return Block aligned to ARENA_ALIGNMENT, NULL on allocation failure
+ */
+void* arena_alloc(Arena* arena, size_t size) {
+    size = align_size(size);
+    if (size == 0) {
+        size = ARENA_ALIGNMENT;
+    }
+    
+    if (!arena->next || (size_t)(arena->end - arena->next) < size) {
+        size_t chunk_size = arena->next_chunk_size;
+        while (chunk_size < size) {
+            chunk_size *= 2;
+        }
+        if (chunk_size > SIZE_MAX - ARENA_HEADER_SIZE) {
+            return NULL;
+        }
+        
+        ArenaChunk* chunk = (ArenaChunk*)malloc(ARENA_HEADER_SIZE + chunk_size);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        chunk->size = chunk_size;
+        arena->chunks = chunk;
+        arena->next = (char*)chunk + ARENA_HEADER_SIZE;
+        arena->end = arena->next + chunk_size;
+        if (arena->next_chunk_size < ARENA_MAX_CHUNK) {
+            arena->next_chunk_size *= 2;
+        }
+    }
+    
+    void* block = arena->next;
+    arena->next += size;
+    return block;
+}
+
+/**
+ * @brief Release every block at once
+ * @param arena Arena to empty
+ */
+void arena_reset(Arena* arena) {
+    ArenaChunk* keep = arena->chunks;
+    if (!keep) {
+        return;
+    }
+    
+    ArenaChunk* chunk = keep->next;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    keep->next = NULL;
+    arena->next = (char*)keep + ARENA_HEADER_SIZE;
+    arena->end = arena->next + keep->size;
+}
+
+/**
+ * @brief Free every chunk of an arena
+ * @param arena Arena to destroy (left empty and reusable)
+ */
+void arena_destroy(Arena* arena) {
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena_init(arena);
+}
+
+/**
+ * @brief Prepare a pool of records of one size
+ * @param pool Pool to initialize
+ * @param arena Arena the records are carved from
+ * @param size Size of each record (at least sizeof(void*))
+ */
+void pool_init(Pool* pool, Arena* arena, size_t size) {
+    pool->arena = arena;
+    pool->size = align_size(size < sizeof(void*) ? sizeof(void*) : size);
+    pool->free_list = NULL;
+}
+
+/**
+ * @brief Take a record from a pool
+ * @param pool Pool to allocate from
+ * @return Record, NULL on allocation failure
+ */
+void* pool_alloc(Pool* pool) {
+    void* record = pool->free_list;
+    if (record) {
+        pool->free_list = *(void**)record;
+        return record;
+    }
+    return arena_alloc(pool->arena, pool->size);
+}
+
+/**
+ * @brief Return a record to its pool
+ * @param pool Pool the record came from
+ * @param record Record to release
+ */
+void pool_free(Pool* pool, void* record) {
+    *(void**)record = pool->free_list;
+    pool->free_list = record;
+}
+
+/**
+ * @brief Forget every released record (call after resetting the arena)
+ * @param pool Pool to empty
+ */
+void pool_reset(Pool* pool) {
+    pool->free_list = NULL;
+}
\ No newline at end of file
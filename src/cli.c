@@ -0,0 +1,976 @@
+/**
+ * @file cli.c
+ * @brief Implementation of the non-interactive command line interface
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the argv subcommands and the --batch mode that
+ * reads the same commands from stdin. Unlike the menu, nothing waits for
+ * the user: the list is loaded once, every command is applied in memory
+ * and the changes are saved once at the end.
+ */
+
+#include "../include/cli.h"
+#include "../include/todo.h"
+#include "../include/client.h"
+#include "../include/file_io.h"
+#include "../include/import.h"
+#include "../include/journal.h"
+#include "../include/metrics.h"
+#include "../include/schedule.h"
+#include "../include/search.h"
+#include "../include/server.h"
+#include "../include/store.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Exit statuses returned by cli_run and by the command handlers
+#define CLI_OK 0
+#define CLI_FAILED 1
+#define CLI_USAGE 2
+
+/**
+ * @brief State shared by the commands of one run
+ */
+typedef struct {
+    TodoList* list;
+    const char* filename;   // Todo file (NULL for default)
+    TodoStore* store;       // Store holding list when a project is used, NULL otherwise
+    int line;               // Line being executed in batch mode, 0 otherwise
+    int dirty;              // A command changed the list
+} CliContext;
+
+/**
+ * @brief Handler for one command
+ * @param ctx Run state
+ * @param argc Number of arguments after the command name
+ * @param argv Arguments after the command name
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+typedef int (*CliCommandFn)(CliContext* ctx, int argc, char** argv);
+
+/**
+ * @brief Entry in the command table
+ */
+typedef struct {
+    const char* name;
+    int min_args;
+    int max_args;           // -1 for no limit
+    CliCommandFn run;
+    const char* usage;
+} CliCommand;
+
+/**
+ * @brief Print an error, prefixed with the batch line if there is one
+ * @param ctx Run state
+ * @param format printf-style format string
+ */
+static void cli_error(const CliContext* ctx, const char* format, ...) {
+    va_list args;
+    if (ctx->line > 0) {
+        fprintf(stderr, "line %d: ", ctx->line);
+    }
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+/**
+ * @brief Parse a todo ID argument
+ * @param text Argument to parse
+ * @return The ID, or -1 if text is not a positive integer
+ */
+static int parse_id(const char* text) {
+    char* end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno != 0 || value <= 0 || value > INT_MAX) {
+        return -1;
+    }
+    return (int)value;
+}
+
+/**
+ * @brief Parse a priority argument
+ * @param text "low", "medium", "high" or 1-3
+ * @return The priority, or 0 if text is not a priority
+ */
+static int parse_priority_arg(const char* text) {
+    if (strcmp(text, "low") == 0 || strcmp(text, "1") == 0) {
+        return PRIORITY_LOW;
+    }
+    if (strcmp(text, "medium") == 0 || strcmp(text, "2") == 0) {
+        return PRIORITY_MEDIUM;
+    }
+    if (strcmp(text, "high") == 0 || strcmp(text, "3") == 0) {
+        return PRIORITY_HIGH;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse a due date argument
+ *
+ * Accepts +N with an optional m, h or d suffix (minutes, hours or days
+ * from now; plain N is days), YYYY-MM-DD (midnight, local time) and
+ * YYYY-MM-DDTHH:MM.
+ *
+ * @param text Argument to parse
+ * @param now Current time, for relative dates
+ * @return The due timestamp, or -1 if text is not a date
+ */
+static time_t parse_due_arg(const char* text, time_t now) {
+    if (text[0] == '+') {
+        char* end;
+        errno = 0;
+        long amount = strtol(text + 1, &end, 10);
+        long unit = 86400;
+        if (*end == 'm' || *end == 'h' || *end == 'd') {
+            unit = *end == 'm' ? 60 : *end == 'h' ? 3600 : 86400;
+            end++;
+        }
+        if (end == text + 1 || *end != '\0' || errno != 0 || amount < 0 || amount > INT_MAX / unit) {
+            return -1;
+        }
+        return now + (time_t)(amount * unit);
+    }
+    
+    int year, month, day, hour = 0, minute = 0;
+    char extra;
+    int fields = sscanf(text, "%4d-%2d-%2dT%2d:%2d%c", &year, &month, &day, &hour, &minute, &extra);
+    if ((fields != 3 && fields != 5) || (fields == 3 && strlen(text) != 10) || month < 1 || month > 12 ||
+        day < 1 || day > 31 || hour > 23 || minute > 59 || year < 1970) {
+        return -1;
+    }
+    
+    struct tm when = { 0 };
+    when.tm_year = year - 1900;
+    when.tm_mon = month - 1;
+    when.tm_mday = day;
+    when.tm_hour = hour;
+    when.tm_min = minute;
+    when.tm_isdst = -1;
+    time_t due_at = mktime(&when);
+    return due_at > 0 ? due_at : -1;
+}
+
+/**
+ * @brief Print the message for a failed library call
+ * @param ctx Run state
+ * @param result Negative TodoError
+ * @param what What was being done (e.g. "add")
+ */
+static void report_error(const CliContext* ctx, int result, const char* what) {
+    cli_error(ctx, "%s: %s", what, todo_strerror(result));
+}
+
+/**
+ * @brief add TITLE [DESCRIPTION] [-p PRIORITY]: create a todo and print its ID
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_add(CliContext* ctx, int argc, char** argv) {
+    const char* title = NULL;
+    const char* description = "";
+    int priority = PRIORITY_MEDIUM;
+    int positional = 0;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0) {
+            if (i + 1 == argc || (priority = parse_priority_arg(argv[i + 1])) == 0) {
+                return CLI_USAGE;
+            }
+            i++;
+        } else if (positional == 0) {
+            title = argv[i];
+            positional++;
+        } else if (positional == 1) {
+            description = argv[i];
+            positional++;
+        } else {
+            return CLI_USAGE;
+        }
+    }
+    if (!title || title[0] == '\0') {
+        return CLI_USAGE;
+    }
+    
+    int id = todo_create(ctx->list, title, description, (Priority)priority);
+    if (id < 0) {
+        report_error(ctx, id, "add");
+        return CLI_FAILED;
+    }
+    ctx->dirty = 1;
+    printf("%d\n", id);
+    return CLI_OK;
+}
+
+/**
+ * @brief list [--pending|--completed] [-p PRIORITY]...: print todos
+ *
+ * Filters are answered from the list's status/priority index, so their
+ * cost depends on the number of matches rather than on the list size.
+ *
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return CLI_OK or CLI_USAGE
+ */
+static int cmd_list(CliContext* ctx, int argc, char** argv) {
+    unsigned status_mask = 0;
+    unsigned priority_mask = 0;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--pending") == 0) {
+            status_mask |= TODO_STATUS_BIT(STATUS_PENDING);
+        } else if (strcmp(argv[i], "--completed") == 0) {
+            status_mask |= TODO_STATUS_BIT(STATUS_COMPLETED);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc && parse_priority_arg(argv[i + 1]) != 0) {
+            priority_mask |= TODO_PRIORITY_BIT(parse_priority_arg(argv[++i]));
+        } else {
+            return CLI_USAGE;
+        }
+    }
+    
+    if (status_mask == 0 && priority_mask == 0) {
+        todo_read_all(ctx->list);
+    } else {
+        todo_read_matching(ctx->list, status_mask ? status_mask : TODO_STATUS_ANY,
+                           priority_mask ? priority_mask : TODO_PRIORITY_ANY);
+    }
+    return CLI_OK;
+}
+
+/**
+ * @brief Print one search match as "ID<tab>title"
+ * @param list List owning the todo
+ * @param todo Matching todo
+ * @param user_data Unused
+ * @return 0 to keep going
+ */
+static int print_match(const TodoList* list, const Todo* todo, void* user_data) {
+    (void)user_data;
+    printf("%d\t%s\n", todo->id, todo_get_title(list, todo));
+    return 0;
+}
+
+/**
+ * @brief search [--substring] WORD...: print the todos matching the words
+ *
+ * A single command scans the list, which is cheaper than indexing it
+ * once; in batch mode the first search builds the inverted index so
+ * later ones only touch the matching todos.
+ *
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv Optional --substring, then the query words
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_search(CliContext* ctx, int argc, char** argv) {
+    int flags = 0;
+    if (strcmp(argv[0], "--substring") == 0) {
+        flags = TODO_SEARCH_SUBSTRING;
+        argv++;
+        argc--;
+    }
+    if (argc == 0) {
+        return CLI_USAGE;
+    }
+    
+    // Join the words back into one query
+    char query[CLI_LINE_SIZE];
+    size_t length = 0;
+    for (int i = 0; i < argc; i++) {
+        size_t word_length = strlen(argv[i]);
+        if (length + word_length + 1 >= sizeof(query)) {
+            cli_error(ctx, "query too long");
+            return CLI_FAILED;
+        }
+        if (i > 0) {
+            query[length++] = ' ';
+        }
+        memcpy(query + length, argv[i], word_length);
+        length += word_length;
+    }
+    query[length] = '\0';
+    
+    if (ctx->line > 0 && !(flags & TODO_SEARCH_SUBSTRING)) {
+        // Without an index the search below still works, just by scanning
+        todo_list_enable_search(ctx->list);
+    }
+    
+    int result = todo_search(ctx->list, query, flags, print_match, NULL);
+    if (result < 0) {
+        report_error(ctx, result, "search");
+        return CLI_FAILED;
+    }
+    return CLI_OK;
+}
+
+/**
+ * @brief Apply an operation to every ID argument
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv IDs
+ * @param operation todo_complete or todo_delete
+ * @param what Name of the command, for messages
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int for_each_id(CliContext* ctx, int argc, char** argv, int (*operation)(TodoList*, int),
+                       const char* what) {
+    int status = CLI_OK;
+    for (int i = 0; i < argc; i++) {
+        int id = parse_id(argv[i]);
+        if (id < 0) {
+            cli_error(ctx, "%s: '%s' is not a todo ID", what, argv[i]);
+            status = CLI_USAGE;
+            continue;
+        }
+        
+        int result = operation(ctx->list, id);
+        if (result == TODO_OK) {
+            ctx->dirty = 1;
+        } else {
+            char action[64];
+            snprintf(action, sizeof(action), "%s %d", what, id);
+            report_error(ctx, result, action);
+            if (status == CLI_OK) {
+                status = CLI_FAILED;
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief done ID...: mark todos as completed
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv IDs
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_done(CliContext* ctx, int argc, char** argv) {
+    return for_each_id(ctx, argc, argv, todo_complete, "done");
+}
+
+/**
+ * @brief rm ID...: delete todos
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv IDs
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_rm(CliContext* ctx, int argc, char** argv) {
+    return for_each_id(ctx, argc, argv, todo_delete, "rm");
+}
+
+/**
+ * @brief due ID WHEN|none: set or clear the due date of a todo
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv ID, then the due date
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_due(CliContext* ctx, int argc, char** argv) {
+    (void)argc;
+    int id = parse_id(argv[0]);
+    time_t due_at = strcmp(argv[1], "none") == 0 ? 0 : parse_due_arg(argv[1], time(NULL));
+    if (id < 0 || due_at < 0) {
+        return CLI_USAGE;
+    }
+    
+    int result = todo_set_due(ctx->list, id, due_at);
+    if (result != TODO_OK) {
+        char action[64];
+        snprintf(action, sizeof(action), "due %d", id);
+        report_error(ctx, result, action);
+        return CLI_FAILED;
+    }
+    ctx->dirty = 1;
+    return CLI_OK;
+}
+
+/**
+ * @brief Print one upcoming todo as "ID<tab>due<tab>title"
+ * @param list List owning the todo
+ * @param todo Todo with a due date
+ * @param user_data Current time
+ * @return 0 to keep going
+ */
+static int print_upcoming(const TodoList* list, const Todo* todo, void* user_data) {
+    time_t now = *(const time_t*)user_data;
+    time_t due_at = (time_t)todo->due_at;
+    char due_str[20];
+    strftime(due_str, sizeof(due_str), "%Y-%m-%d %H:%M", localtime(&due_at));
+    printf("%d\t%s\t%s%s\n", todo->id, due_str, todo_get_title(list, todo),
+           due_at <= now ? " (overdue)" : "");
+    return 0;
+}
+
+/**
+ * @brief upcoming [COUNT]: print the pending todos that are due soonest
+ *
+ * Building the schedule is O(n) and each todo printed costs O(log k), so
+ * the list is never sorted as a whole.
+ *
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv Optional number of todos to print (default 10)
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_upcoming(CliContext* ctx, int argc, char** argv) {
+    int limit = argc > 0 ? parse_id(argv[0]) : 10;
+    if (limit < 0) {
+        return CLI_USAGE;
+    }
+    
+    TodoScheduler* scheduler = todo_scheduler_attach(ctx->list, NULL, NULL);
+    if (!scheduler) {
+        report_error(ctx, TODO_ERR_NO_MEMORY, "upcoming");
+        return CLI_FAILED;
+    }
+    time_t now = time(NULL);
+    int result = todo_scheduler_upcoming(scheduler, limit, print_upcoming, &now);
+    todo_scheduler_detach(scheduler);
+    if (result < 0) {
+        report_error(ctx, result, "upcoming");
+        return CLI_FAILED;
+    }
+    return CLI_OK;
+}
+
+/**
+ * @brief Print metrics as a table of operations
+ * @param metrics Metrics to print
+ */
+static void print_metrics(const TodoMetrics* metrics) {
+    if (!metrics->enabled) {
+        printf("Metrics are not available (built with TODO_NO_METRICS)\n");
+        return;
+    }
+    
+    printf("%-8s %10s %10s %10s %10s %10s %10s\n", "op", "calls", "timed", "mean_us", "p50_us", "p99_us", "max_us");
+    for (int op = 0; op < TODO_METRIC_COUNT; op++) {
+        const TodoOpMetrics* stats = &metrics->ops[op];
+        double mean = stats->timed ? (double)stats->total_ns / (double)stats->timed : 0.0;
+        printf("%-8s %10llu %10llu %10.2f %10.2f %10.2f %10.2f\n", todo_metrics_name((TodoMetricOp)op),
+               (unsigned long long)stats->calls, (unsigned long long)stats->timed, mean / 1e3,
+               (double)todo_metrics_percentile(stats, 50) / 1e3, (double)todo_metrics_percentile(stats, 99) / 1e3,
+               (double)stats->max_ns / 1e3);
+    }
+    printf("bytes read %llu, bytes written %llu, threads %d\n", (unsigned long long)metrics->bytes_read,
+           (unsigned long long)metrics->bytes_written, metrics->threads);
+}
+
+/**
+ * @brief stats [--prometheus] [--server SOCKET]: print operation metrics
+ *
+ * Without --server the metrics are those of this run (in batch mode,
+ * every command so far, including loading the file); with it they are
+ * fetched from a running server.
+ *
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv Options
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_stats(CliContext* ctx, int argc, char** argv) {
+    int prometheus = 0;
+    const char* socket_path = NULL;
+    int remote = 0;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--prometheus") == 0) {
+            prometheus = 1;
+        } else if (strcmp(argv[i], "--server") == 0) {
+            remote = 1;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                socket_path = argv[++i];
+            }
+        } else {
+            return CLI_USAGE;
+        }
+    }
+    
+    TodoMetrics metrics;
+    if (remote) {
+        TodoClient* client = todo_client_connect(socket_path);
+        if (!client) {
+            cli_error(ctx, "stats: cannot connect to the server");
+            return CLI_FAILED;
+        }
+        TodoWireRequest request = { TODO_OP_STATS, 0, 0, NULL, NULL, 0, 0, 0 };
+        TodoClientReply reply;
+        int result = todo_client_call(client, &request, &reply);
+        if (result == TODO_OK) {
+            result = todo_reply_metrics(&reply, &metrics);
+        }
+        todo_client_close(client);
+        if (result != TODO_OK) {
+            report_error(ctx, result, "stats");
+            return CLI_FAILED;
+        }
+    } else {
+        todo_metrics_snapshot(&metrics);
+    }
+    
+    if (prometheus) {
+        todo_metrics_write(&metrics, stdout);
+    } else {
+        print_metrics(&metrics);
+    }
+    return CLI_OK;
+}
+
+/**
+ * @brief import FILE [--csv|--jsonl]: add todos from a CSV or JSON Lines file
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_import(CliContext* ctx, int argc, char** argv) {
+    TodoImportFormat format = TODO_IMPORT_AUTO;
+    if (argc == 2) {
+        if (strcmp(argv[1], "--csv") == 0) {
+            format = TODO_IMPORT_CSV;
+        } else if (strcmp(argv[1], "--jsonl") == 0) {
+            format = TODO_IMPORT_JSONL;
+        } else {
+            return CLI_USAGE;
+        }
+    }
+    if (ctx->line > 0 && strcmp(argv[0], "-") == 0) {
+        cli_error(ctx, "import: stdin holds the batch commands");
+        return CLI_USAGE;
+    }
+    
+    int rejected = 0;
+    int imported = import_todos(ctx->list, argv[0], format, &rejected);
+    if (imported < 0) {
+        report_error(ctx, imported, "import");
+        return CLI_FAILED;
+    }
+    if (imported > 0) {
+        ctx->dirty = 1;
+    }
+    printf("Imported %d todos (%d rejected)\n", imported, rejected);
+    return CLI_OK;
+}
+
+/**
+ * @brief Check whether a filename ends with an extension
+ * @param filename Name to test
+ * @param extension Extension including the dot
+ * @return 1 if it does, 0 otherwise
+ */
+static int has_extension(const char* filename, const char* extension) {
+    size_t name_length = strlen(filename);
+    size_t extension_length = strlen(extension);
+    return name_length > extension_length &&
+           strcmp(filename + name_length - extension_length, extension) == 0;
+}
+
+/**
+ * @brief export FILE [--text|--csv|--jsonl]: write todos to a file or stdout
+ *
+ * Without a format option the format follows the extension: .csv, .jsonl
+ * and .json select those formats, stdout ("-") defaults to JSON Lines and
+ * anything else gets the text report.
+ *
+ * @param ctx Run state
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int cmd_export(CliContext* ctx, int argc, char** argv) {
+    const char* filename = argv[0];
+    const char* format = "text";
+    if (argc == 2) {
+        if (strcmp(argv[1], "--text") != 0 && strcmp(argv[1], "--csv") != 0 &&
+            strcmp(argv[1], "--jsonl") != 0) {
+            return CLI_USAGE;
+        }
+        format = argv[1] + 2;
+    } else if (has_extension(filename, ".csv")) {
+        format = "csv";
+    } else if (strcmp(filename, "-") == 0 || has_extension(filename, ".jsonl") ||
+               has_extension(filename, ".json")) {
+        format = "jsonl";
+    }
+    
+    int result;
+    if (strcmp(format, "csv") == 0) {
+        result = export_todos_to_csv(ctx->list, filename, NULL, NULL);
+    } else if (strcmp(format, "jsonl") == 0) {
+        result = export_todos_to_jsonl(ctx->list, filename, NULL, NULL);
+    } else if (strcmp(filename, "-") == 0) {
+        cli_error(ctx, "export: the text format cannot be written to stdout");
+        return CLI_USAGE;
+    } else {
+        result = export_todos_to_text(ctx->list, filename);
+    }
+    
+    if (result < 0) {
+        report_error(ctx, result, "export");
+        return CLI_FAILED;
+    }
+    return CLI_OK;
+}
+
+/**
+ * @brief projects: print each project of the store with its todo count
+ *
+ * Counts come from the manifest, so no project is loaded.
+ *
+ * @param ctx Run state
+ * @param argc Number of arguments (0)
+ * @param argv Unused
+ * @return CLI_OK or CLI_FAILED
+ */
+static int cmd_projects(CliContext* ctx, int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    TodoStore* store = ctx->store ? ctx->store : todo_store_open(NULL);
+    if (!store) {
+        cli_error(ctx, "cannot open the project store");
+        return CLI_FAILED;
+    }
+    
+    for (int i = 0; i < todo_store_count(store); i++) {
+        printf("%s\t%d\n", todo_store_name(store, i), todo_store_todo_count(store, i));
+    }
+    
+    if (store != ctx->store) {
+        todo_store_close(store);
+    }
+    return CLI_OK;
+}
+
+static const CliCommand commands[] = {
+    { "add", 1, 4, cmd_add, "add TITLE [DESCRIPTION] [-p low|medium|high]" },
+    { "list", 0, -1, cmd_list, "list [--pending|--completed] [-p low|medium|high]..." },
+    { "search", 1, -1, cmd_search, "search [--substring] WORD[*]..." },
+    { "done", 1, -1, cmd_done, "done ID..." },
+    { "rm", 1, -1, cmd_rm, "rm ID..." },
+    { "due", 2, 2, cmd_due, "due ID +N[m|h|d]|YYYY-MM-DD[THH:MM]|none" },
+    { "upcoming", 0, 1, cmd_upcoming, "upcoming [COUNT]" },
+    { "import", 1, 2, cmd_import, "import FILE|- [--csv|--jsonl]" },
+    { "export", 1, 2, cmd_export, "export FILE|- [--text|--csv|--jsonl]" },
+    { "projects", 0, 0, cmd_projects, "projects" },
+    { "stats", 0, 3, cmd_stats, "stats [--prometheus] [--server [SOCKET]]" }
+};
+
+#define COMMAND_COUNT ((int)(sizeof(commands) / sizeof(commands[0])))
+
+/**
+ * @brief Print the usage summary
+ * @param out Stream to print to
+ * @param program Name the program was started as
+ */
+static void print_usage(FILE* out, const char* program) {
+    fprintf(out, "Usage: %s [-f FILE | -P PROJECT] COMMAND [ARGS...]\n", program);
+    fprintf(out, "       %s [-f FILE | -P PROJECT] --batch < commands.txt\n", program);
+    fprintf(out, "       %s [-f FILE] --serve [SOCKET]\n", program);
+    fprintf(out, "       %s                (interactive menu)\n\n", program);
+    fprintf(out, "Commands:\n");
+    for (int i = 0; i < COMMAND_COUNT; i++) {
+        fprintf(out, "  %s\n", commands[i].usage);
+    }
+    fprintf(out, "\nOptions:\n");
+    fprintf(out, "  -f FILE   Todo file to use (default %s)\n", DEFAULT_FILENAME);
+    fprintf(out, "  -P NAME   Project in %s to use instead (created if missing)\n", TODO_STORE_DEFAULT_DIR);
+    fprintf(out, "  --batch   Read one command per line from stdin; load and save only once\n");
+    fprintf(out, "  --serve   Keep the list loaded and answer clients on SOCKET (default %s)\n",
+            TODO_SERVER_DEFAULT_SOCKET);
+    fprintf(out, "            until interrupted, printing reminders as todos become due\n");
+}
+
+/**
+ * @brief Look up and run one command
+ * @param ctx Run state
+ * @param argc Number of words, including the command name
+ * @param argv Command name followed by its arguments
+ * @return CLI_OK, CLI_FAILED or CLI_USAGE
+ */
+static int run_command(CliContext* ctx, int argc, char** argv) {
+    for (int i = 0; i < COMMAND_COUNT; i++) {
+        const CliCommand* command = &commands[i];
+        if (strcmp(argv[0], command->name) != 0) {
+            continue;
+        }
+        
+        int args = argc - 1;
+        int status = CLI_USAGE;
+        if (args >= command->min_args && (command->max_args < 0 || args <= command->max_args)) {
+            status = command->run(ctx, args, argv + 1);
+        }
+        if (status == CLI_USAGE) {
+            cli_error(ctx, "usage: %s", command->usage);
+        }
+        return status;
+    }
+    
+    cli_error(ctx, "unknown command '%s'", argv[0]);
+    return CLI_USAGE;
+}
+
+/**
+ * @brief Split a batch line into words in place
+ *
+ * Words are separated by blanks. Double quotes group words and accept
+ * \" and \\ escapes, single quotes group words literally and an unquoted
+ * '#' starts a comment.
+ *
+ * @param line Line to split; modified
+ * @param words Receives pointers to the words
+ * @param max_words Capacity of words
+ * @return Number of words, -1 on an unterminated quote or too many words
+ */
+static int split_words(char* line, char** words, int max_words) {
+    int count = 0;
+    char* p = line;
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            p++;
+        }
+        if (*p == '\0' || *p == '#') {
+            return count;
+        }
+        if (count == max_words) {
+            return -1;
+        }
+        
+        // Unquote the word into its own storage; w never passes p
+        char* w = p;
+        words[count++] = w;
+        while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+            char quote = *p;
+            if (quote != '"' && quote != '\'') {
+                *w++ = *p++;
+                continue;
+            }
+            
+            p++;
+            while (*p != quote) {
+                if (*p == '\0') {
+                    return -1;
+                }
+                if (quote == '"' && *p == '\\' && (p[1] == '"' || p[1] == '\\')) {
+                    p++;
+                }
+                *w++ = *p++;
+            }
+            p++;
+        }
+        
+        int at_end = *p == '\0';
+        *w = '\0';
+        if (at_end) {
+            return count;
+        }
+        p++;
+    }
+}
+
+/**
+ * @brief Run commands read from stdin, one per line
+ * @param ctx Run state
+ * @return CLI_OK if every command succeeded, CLI_FAILED or CLI_USAGE otherwise
+ */
+static int run_batch(CliContext* ctx) {
+    char line[CLI_LINE_SIZE];
+    char* words[CLI_MAX_ARGS];
+    int status = CLI_OK;
+    
+    while (fgets(line, sizeof(line), stdin)) {
+        ctx->line++;
+        
+        size_t length = strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n' && !feof(stdin)) {
+            // Discard the rest of an overlong line
+            int c;
+            while ((c = getchar()) != '\n' && c != EOF);
+            cli_error(ctx, "line too long");
+            status = CLI_FAILED;
+            continue;
+        }
+        
+        int count = split_words(line, words, CLI_MAX_ARGS);
+        if (count < 0) {
+            cli_error(ctx, "unterminated quote or too many arguments");
+            status = CLI_FAILED;
+            continue;
+        }
+        if (count == 0) {
+            continue;
+        }
+        
+        int result = run_command(ctx, count, words);
+        if (result != CLI_OK && status == CLI_OK) {
+            status = result;
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Stop the server on SIGINT or SIGTERM
+ * @param signal_number Signal received
+ */
+static void handle_stop_signal(int signal_number) {
+    (void)signal_number;
+    todo_server_stop();
+}
+
+/**
+ * @brief Print a reminder for a todo that became due
+ * @param list List owning the todo
+ * @param todo Todo that is due
+ * @param user_data Unused
+ * @return 0 to keep firing
+ */
+static int print_reminder(const TodoList* list, const Todo* todo, void* user_data) {
+    (void)user_data;
+    printf("Reminder: todo %d is due: %s\n", todo->id, todo_get_title(list, todo));
+    fflush(stdout);
+    return 0;
+}
+
+/**
+ * @brief Serve a todo file to clients until interrupted
+ * @param ctx Run state with the list loaded
+ * @param journal Journal of the list (required: every change is committed)
+ * @param socket_path Socket to listen on (NULL for the default)
+ * @return CLI_OK once stopped, CLI_FAILED if the server could not run
+ */
+static int run_server(CliContext* ctx, Journal* journal, const char* socket_path) {
+    if (!journal) {
+        fprintf(stderr, "Cannot serve without a journal\n");
+        return CLI_FAILED;
+    }
+    
+    // Reminders are printed on stdout as todos become due
+    TodoScheduler* scheduler = todo_scheduler_attach(ctx->list, print_reminder, NULL);
+    if (!scheduler) {
+        return CLI_FAILED;
+    }
+    
+    signal(SIGINT, handle_stop_signal);
+    signal(SIGTERM, handle_stop_signal);
+    int result = todo_server_run(ctx->list, journal, scheduler, socket_path);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    todo_scheduler_detach(scheduler);
+    
+    return result == TODO_OK ? CLI_OK : CLI_FAILED;
+}
+
+/**
+ * @brief Run the program non-interactively
+ * @param argc Argument count from main
+ * @param argv Argument vector from main
+ * @return Process exit status: 0 on success, 1 if a command failed, 2 on usage errors
+ */
+int cli_run(int argc, char** argv) {
+    const char* program = argc > 0 ? argv[0] : "todo_manager";
+    CliContext ctx = { NULL, NULL, NULL, 0, 0 };
+    const char* project = NULL;
+    int batch = 0;
+    int serve = 0;
+    
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc && !project) {
+            ctx.filename = argv[++i];
+        } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc && !ctx.filename && !serve) {
+            project = argv[++i];
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            batch = 1;
+        } else if (strcmp(argv[i], "--serve") == 0 && !project) {
+            serve = 1;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(stdout, program);
+            return CLI_OK;
+        } else {
+            print_usage(stderr, program);
+            return CLI_USAGE;
+        }
+    }
+    if (serve ? batch || argc - i > 1 : batch == (i < argc)) {
+        // Exactly one of --batch, --serve and a command is required
+        print_usage(stderr, program);
+        return CLI_USAGE;
+    }
+    
+    if (project) {
+        // The store loads only this project and journals it itself
+        ctx.store = todo_store_open(NULL);
+        if (ctx.store) {
+            ctx.list = todo_store_find(ctx.store, project) >= 0 ? todo_store_get(ctx.store, project)
+                                                                : todo_store_add(ctx.store, project);
+        }
+        if (!ctx.list) {
+            fprintf(stderr, "Cannot open project '%s'\n", project);
+            todo_store_close(ctx.store);
+            return CLI_FAILED;
+        }
+        
+        int status = batch ? run_batch(&ctx) : run_command(&ctx, argc - i, argv + i);
+        if (ctx.dirty && todo_store_save(ctx.store) != TODO_OK) {
+            // IDs printed by add were never stored
+            fprintf(stderr, "Changes to project '%s' were not saved\n", project);
+            status = CLI_FAILED;
+        }
+        
+        todo_store_close(ctx.store);
+        fflush(stdout);
+        return status;
+    }
+    
+    ctx.list = todo_list_create();
+    if (!ctx.list) {
+        fprintf(stderr, "Failed to initialize todo list\n");
+        return CLI_FAILED;
+    }
+    
+    // Map the file: read-only commands never copy the todos
+    if (load_todos_from_file_ex(ctx.list, ctx.filename, TODO_LOAD_MAP) != TODO_OK) {
+        todo_list_destroy(ctx.list);
+        return CLI_FAILED;
+    }
+    Journal* journal = journal_open(ctx.list, ctx.filename);
+    
+    int status;
+    if (serve) {
+        status = run_server(&ctx, journal, i < argc ? argv[i] : NULL);
+    } else {
+        status = batch ? run_batch(&ctx) : run_command(&ctx, argc - i, argv + i);
+    }
+    
+    // Save once, and only if a command changed something
+    if (ctx.dirty) {
+        int result = journal ? journal_commit(journal) : todo_list_make_writable(ctx.list);
+        if (!journal && result == TODO_OK) {
+            result = save_todos_to_file(ctx.list, ctx.filename);
+        }
+        if (result != TODO_OK) {
+            // IDs printed by add were never stored
+            fprintf(stderr, "Changes were not saved to '%s': %s\n",
+                    ctx.filename ? ctx.filename : DEFAULT_FILENAME, todo_strerror(result));
+            status = CLI_FAILED;
+        }
+    }
+    
+    journal_close(journal);
+    todo_list_destroy(ctx.list);
+    fflush(stdout);
+    return status;
+}
\ No newline at end of file
@@ -0,0 +1,420 @@
+/**
+ * @file client.c
+ * @brief Implementation of the server protocol client
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the client over a non-blocking socket driven by
+ * poll. Requests are encoded into an outgoing buffer and written in as
+ * few system calls as possible; replies are read in large chunks and
+ * handed out one frame at a time.
+ */
+
+#ifndef _WIN32
+    // Needed for sockets and poll under -std=c99
+    #if !defined(__APPLE__) && !defined(__FreeBSD__) && !defined(__NetBSD__) && !defined(__OpenBSD__)
+        #define _POSIX_C_SOURCE 200809L
+    #endif
+#endif
+
+#include "../include/client.h"
+#include "../include/server.h"
+#include "../include/todo_log.h"
+
+#ifndef _WIN32
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+// Bytes requested from the socket per read
+#define CLIENT_READ_SIZE 65536
+
+/**
+ * @brief Connection to a server
+ */
+struct TodoClient {
+    int fd;
+    WireBuffer out;                        // Requests not yet written
+    size_t sent;                           // Bytes at the front of out already written
+    WireBuffer in;                         // Received bytes not yet handed out
+    size_t consumed;                       // Bytes at the front of in already handed out
+    uint32_t next_tag;
+};
+
+#ifdef _WIN32
+
+TodoClient* todo_client_connect(const char* socket_path) {
+    (void)socket_path;
+    todo_log(TODO_LOG_ERROR, "Server mode is not supported on Windows");
+    return NULL;
+}
+
+void todo_client_close(TodoClient* client) {
+    free(client);
+}
+
+int todo_client_flush(TodoClient* client) {
+    (void)client;
+    return TODO_ERR_IO;
+}
+
+int todo_client_receive(TodoClient* client, TodoClientReply* reply) {
+    (void)client;
+    (void)reply;
+    return TODO_ERR_IO;
+}
+
+#else
+
+/**
+ * @brief Connect to a server
+ * @param socket_path Path of the server's socket (NULL for TODO_SERVER_DEFAULT_SOCKET)
+ * @return New client, NULL on failure
+ */
+TodoClient* todo_client_connect(const char* socket_path) {
+    const char* path = socket_path ? socket_path : TODO_SERVER_DEFAULT_SOCKET;
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        todo_log(TODO_LOG_ERROR, "Socket path '%s' is too long", path);
+        return NULL;
+    }
+    strcpy(address.sun_path, path);
+    
+    TodoClient* client = (TodoClient*)calloc(1, sizeof(TodoClient));
+    if (!client) {
+        return NULL;
+    }
+    wire_buffer_init(&client->out);
+    wire_buffer_init(&client->in);
+    client->next_tag = 1;
+    
+    client->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client->fd < 0 || connect(client->fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        todo_log(TODO_LOG_ERROR, "Unable to connect to '%s': %s", path, strerror(errno));
+        if (client->fd >= 0) {
+            close(client->fd);
+        }
+        free(client);
+        return NULL;
+    }
+    
+    // Blocking is done in poll so that reads and writes can interleave
+    int flags = fcntl(client->fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(client->fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        close(client->fd);
+        free(client);
+        return NULL;
+    }
+    return client;
+}
+
+/**
+ * @brief Close a connection
+ * @param client Client to close (may be NULL)
+ */
+void todo_client_close(TodoClient* client) {
+    if (!client) {
+        return;
+    }
+    close(client->fd);
+    wire_buffer_free(&client->out);
+    wire_buffer_free(&client->in);
+    free(client);
+}
+
+/**
+ * @brief Read whatever the server has sent
+ * @param client Connected client
+ * @return TODO_OK if bytes were read or none were ready, TODO_ERR_IO if the connection failed or closed
+ */
+static int receive_available(TodoClient* client) {
+    for (;;) {
+        if (client->consumed > 0 && client->in.capacity - client->in.size < CLIENT_READ_SIZE) {
+            wire_buffer_consume(&client->in, client->consumed);
+            client->consumed = 0;
+        }
+        if (wire_buffer_reserve(&client->in, CLIENT_READ_SIZE) != TODO_OK) {
+            return TODO_ERR_NO_MEMORY;
+        }
+        
+        ssize_t received = recv(client->fd, client->in.data + client->in.size, CLIENT_READ_SIZE, 0);
+        if (received > 0) {
+            client->in.size += (size_t)received;
+        } else if (received < 0 && errno == EINTR) {
+            continue;
+        } else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return TODO_OK;
+        } else {
+            return TODO_ERR_IO;
+        }
+    }
+}
+
+/**
+ * @brief Wait until the socket is ready
+ * @param client Connected client
+ * @param write Whether to wait for writability as well as readability
+ * @return Ready events (POLLIN, POLLOUT), TODO_ERR_IO on failure
+ */
+static int wait_ready(TodoClient* client, int write) {
+    struct pollfd entry;
+    entry.fd = client->fd;
+    entry.events = (short)(POLLIN | (write ? POLLOUT : 0));
+    entry.revents = 0;
+    while (poll(&entry, 1, -1) < 0) {
+        if (errno != EINTR) {
+            return TODO_ERR_IO;
+        }
+    }
+    // Hangups and errors surface as a failed read
+    if (entry.revents & (POLLHUP | POLLERR)) {
+        return POLLIN;
+    }
+    return entry.revents & (POLLIN | POLLOUT);
+}
+
+/**
+ * @brief Write every queued request to the server
+ * @param client Connected client
+ * @return TODO_OK on success, TODO_ERR_IO if the connection failed
+ */
+int todo_client_flush(TodoClient* client) {
+    if (!client) {
+        return TODO_ERR_INVALID;
+    }
+    if (client->out.error != TODO_OK) {
+        return client->out.error;
+    }
+    
+    while (client->sent < client->out.size) {
+        ssize_t written = send(client->fd, client->out.data + client->sent, client->out.size - client->sent,
+#ifdef MSG_NOSIGNAL
+                               MSG_NOSIGNAL);
+#else
+                               0);
+#endif
+        if (written > 0) {
+            client->sent += (size_t)written;
+            continue;
+        }
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            return TODO_ERR_IO;
+        }
+        
+        // The server may be waiting for its replies to be read
+        int ready = wait_ready(client, 1);
+        if (ready < 0) {
+            return ready;
+        }
+        if ((ready & POLLIN) && receive_available(client) != TODO_OK) {
+            return TODO_ERR_IO;
+        }
+    }
+    
+    client->out.size = 0;
+    client->sent = 0;
+    return TODO_OK;
+}
+
+/**
+ * @brief Wait for the reply to the oldest request not yet answered
+ * @param client Connected client
+ * @param reply Receives the reply
+ * @return TODO_OK when a reply was received (its own status may be an error),
+ *         TODO_ERR_IO if the connection failed, TODO_ERR_CORRUPT if the reply is malformed
+ */
+int todo_client_receive(TodoClient* client, TodoClientReply* reply) {
+    if (!client || !reply) {
+        return TODO_ERR_INVALID;
+    }
+    int result = todo_client_flush(client);
+    if (result != TODO_OK) {
+        return result;
+    }
+    
+    size_t body_size;
+    int op, status;
+    uint32_t tag;
+    for (;;) {
+        int complete = wire_peek_frame(client->in.data + client->consumed, client->in.size - client->consumed,
+                                       &body_size, &op, &status, &tag);
+        if (complete < 0) {
+            return TODO_ERR_CORRUPT;
+        }
+        if (complete > 0) {
+            break;
+        }
+        
+        int ready = wait_ready(client, 0);
+        if (ready < 0) {
+            return ready;
+        }
+        result = receive_available(client);
+        if (result != TODO_OK) {
+            return result;
+        }
+    }
+    
+    const unsigned char* frame = client->in.data + client->consumed;
+    client->consumed += TODO_WIRE_HEADER_SIZE + body_size;
+    
+    reply->op = (TodoWireOp)op;
+    reply->status = status;
+    reply->tag = tag;
+    reply->id = 0;
+    reply->count = 0;
+    wire_reader_init(&reply->body, frame + TODO_WIRE_HEADER_SIZE, body_size);
+    if (status != TODO_OK) {
+        return TODO_OK;
+    }
+    
+    if (op == TODO_OP_CREATE) {
+        reply->id = (int)wire_get_u32(&reply->body);
+    } else if (op == TODO_OP_GET) {
+        reply->count = 1;
+    } else if (op == TODO_OP_LIST) {
+        reply->count = (int)wire_get_u32(&reply->body);
+    }
+    return reply->body.error || reply->count < 0 ? TODO_ERR_CORRUPT : TODO_OK;
+}
+
+#endif
+
+/**
+ * @brief Append a string, or the keep marker for NULL
+ * @param buffer Buffer to append to
+ * @param text String, or NULL
+ * @param limit Size of the field on the server, including the terminator
+ * @return TODO_OK on success, TODO_ERR_TOO_LONG if text does not fit
+ */
+static int put_text(WireBuffer* buffer, const char* text, size_t limit) {
+    if (!text) {
+        wire_put_u16(buffer, TODO_WIRE_KEEP);
+        return TODO_OK;
+    }
+    size_t length = strlen(text);
+    if (length >= limit) {
+        return TODO_ERR_TOO_LONG;
+    }
+    wire_put_string(buffer, text, length);
+    return TODO_OK;
+}
+
+/**
+ * @brief Queue a request without waiting for its reply
+ * @param client Connected client
+ * @param request Request to queue
+ * @return Tag of the request (the reply carries it), negative TodoError on failure
+ */
+int64_t todo_client_send(TodoClient* client, const TodoWireRequest* request) {
+    if (!client || !request) {
+        return TODO_ERR_INVALID;
+    }
+    
+    WireBuffer* out = &client->out;
+    uint32_t tag = client->next_tag++;
+    size_t frame = wire_begin_frame(out, request->op, TODO_OK, tag);
+    int result = TODO_OK;
+    
+    switch (request->op) {
+        case TODO_OP_CREATE:
+            wire_put_u8(out, (uint8_t)request->priority);
+            result = put_text(out, request->title ? request->title : "", MAX_TITLE_LENGTH);
+            if (result == TODO_OK) {
+                result = put_text(out, request->description ? request->description : "", MAX_DESC_LENGTH);
+            }
+            break;
+        case TODO_OP_UPDATE:
+            wire_put_u32(out, (uint32_t)request->id);
+            wire_put_u8(out, (uint8_t)request->priority);
+            result = put_text(out, request->title, MAX_TITLE_LENGTH);
+            if (result == TODO_OK) {
+                result = put_text(out, request->description, MAX_DESC_LENGTH);
+            }
+            break;
+        case TODO_OP_GET:
+        case TODO_OP_DELETE:
+        case TODO_OP_COMPLETE:
+        case TODO_OP_PENDING:
+            wire_put_u32(out, (uint32_t)request->id);
+            break;
+        case TODO_OP_DUE:
+            wire_put_u32(out, (uint32_t)request->id);
+            wire_put_u64(out, (uint64_t)request->due_at);
+            break;
+        case TODO_OP_LIST:
+            wire_put_u8(out, (uint8_t)request->status_mask);
+            wire_put_u8(out, (uint8_t)request->priority_mask);
+            break;
+        case TODO_OP_PING:
+        case TODO_OP_CHECKPOINT:
+        case TODO_OP_STATS:
+            break;
+        default:
+            result = TODO_ERR_INVALID;
+            break;
+    }
+    
+    if (result != TODO_OK || out->error != TODO_OK) {
+        // Drop the partial frame; a failed allocation stays recorded for flush
+        out->size = frame;
+        client->next_tag--;
+        return result != TODO_OK ? result : out->error;
+    }
+    wire_end_frame(out, frame);
+    return tag;
+}
+
+/**
+ * @brief Send one request and wait for its reply
+ * @param client Connected client with no replies outstanding
+ * @param request Request to send
+ * @param reply Receives the reply
+ * @return The reply's status, or the failure of sending or receiving
+ */
+int todo_client_call(TodoClient* client, const TodoWireRequest* request, TodoClientReply* reply) {
+    int64_t tag = todo_client_send(client, request);
+    if (tag < 0) {
+        return (int)tag;
+    }
+    int result = todo_client_receive(client, reply);
+    return result != TODO_OK ? result : reply->status;
+}
+
+/**
+ * @brief Read the next todo of a GET or LIST reply
+ * @param reply Reply being read
+ * @param todo Receives the todo
+ * @return 1 if a todo was read, 0 when there are no more, TODO_ERR_CORRUPT if the body is malformed
+ */
+int todo_reply_next_todo(TodoClientReply* reply, TodoWireTodo* todo) {
+    if (!reply || !todo) {
+        return TODO_ERR_INVALID;
+    }
+    if (reply->body.left == 0) {
+        return 0;
+    }
+    return wire_get_todo(&reply->body, todo) == TODO_OK ? 1 : TODO_ERR_CORRUPT;
+}
+
+/**
+ * @brief Read the metrics of a STATS reply
+ * @param reply Reply being read
+ * @param metrics Receives the metrics
+ * @return TODO_OK on success, TODO_ERR_CORRUPT if the body is malformed
+ */
+int todo_reply_metrics(TodoClientReply* reply, TodoMetrics* metrics) {
+    if (!reply || !metrics) {
+        return TODO_ERR_INVALID;
+    }
+    return wire_get_metrics(&reply->body, metrics) == TODO_OK ? TODO_OK : TODO_ERR_CORRUPT;
+}
\ No newline at end of file
@@ -0,0 +1,396 @@
+/**
+ * @file codec.c
+ * @brief Implementation of portable binary encoding helpers
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements little-endian load/store helpers, varints, a
+ * table-driven CRC-32 and an LZ77 block coder, all safe to call from any
+ * thread.
+ */
+
+#include "../include/codec.h"
+
+#include <string.h>
+
+// Sequences shorter than this are stored as literals
+#define LZ_MIN_MATCH 4
+
+// Farthest back a match may start
+#define LZ_MAX_OFFSET 65535
+
+// log2 of the number of hash table slots used by the compressor
+#define LZ_HASH_BITS 12
+
+// Lookup table for the reflected CRC-32 (IEEE 802.3) polynomial 0xEDB88320
+static const uint32_t crc_table[256] = {
+    0x00000000u, 0x77073096u, 0xEE0E612Cu, 0x990951BAu, 0x076DC419u, 0x706AF48Fu,
+    0xE963A535u, 0x9E6495A3u, 0x0EDB8832u, 0x79DCB8A4u, 0xE0D5E91Eu, 0x97D2D988u,
+    0x09B64C2Bu, 0x7EB17CBDu, 0xE7B82D07u, 0x90BF1D91u, 0x1DB71064u, 0x6AB020F2u,
+    0xF3B97148u, 0x84BE41DEu, 0x1ADAD47Du, 0x6DDDE4EBu, 0xF4D4B551u, 0x83D385C7u,
+    0x136C9856u, 0x646BA8C0u, 0xFD62F97Au, 0x8A65C9ECu, 0x14015C4Fu, 0x63066CD9u,
+    0xFA0F3D63u, 0x8D080DF5u, 0x3B6E20C8u, 0x4C69105Eu, 0xD56041E4u, 0xA2677172u,
+    0x3C03E4D1u, 0x4B04D447u, 0xD20D85FDu, 0xA50AB56Bu, 0x35B5A8FAu, 0x42B2986Cu,
+    0xDBBBC9D6u, 0xACBCF940u, 0x32D86CE3u, 0x45DF5C75u, 0xDCD60DCFu, 0xABD13D59u,
+    0x26D930ACu, 0x51DE003Au, 0xC8D75180u, 0xBFD06116u, 0x21B4F4B5u, 0x56B3C423u,
+    0xCFBA9599u, 0xB8BDA50Fu, 0x2802B89Eu, 0x5F058808u, 0xC60CD9B2u, 0xB10BE924u,
+    0x2F6F7C87u, 0x58684C11u, 0xC1611DABu, 0xB6662D3Du, 0x76DC4190u, 0x01DB7106u,
+    0x98D220BCu, 0xEFD5102Au, 0x71B18589u, 0x06B6B51Fu, 0x9FBFE4A5u, 0xE8B8D433u,
+    0x7807C9A2u, 0x0F00F934u, 0x9609A88Eu, 0xE10E9818u, 0x7F6A0DBBu, 0x086D3D2Du,
+    0x91646C97u, 0xE6635C01u, 0x6B6B51F4u, 0x1C6C6162u, 0x856530D8u, 0xF262004Eu,
+    0x6C0695EDu, 0x1B01A57Bu, 0x8208F4C1u, 0xF50FC457u, 0x65B0D9C6u, 0x12B7E950u,
+    0x8BBEB8EAu, 0xFCB9887Cu, 0x62DD1DDFu, 0x15DA2D49u, 0x8CD37CF3u, 0xFBD44C65u,
+    0x4DB26158u, 0x3AB551CEu, 0xA3BC0074u, 0xD4BB30E2u, 0x4ADFA541u, 0x3DD895D7u,
+    0xA4D1C46Du, 0xD3D6F4FBu, 0x4369E96Au, 0x346ED9FCu, 0xAD678846u, 0xDA60B8D0u,
+    0x44042D73u, 0x33031DE5u, 0xAA0A4C5Fu, 0xDD0D7CC9u, 0x5005713Cu, 0x270241AAu,
+    0xBE0B1010u, 0xC90C2086u, 0x5768B525u, 0x206F85B3u, 0xB966D409u, 0xCE61E49Fu,
+    0x5EDEF90Eu, 0x29D9C998u, 0xB0D09822u, 0xC7D7A8B4u, 0x59B33D17u, 0x2EB40D81u,
+    0xB7BD5C3Bu, 0xC0BA6CADu, 0xEDB88320u, 0x9ABFB3B6u, 0x03B6E20Cu, 0x74B1D29Au,
+    0xEAD54739u, 0x9DD277AFu, 0x04DB2615u, 0x73DC1683u, 0xE3630B12u, 0x94643B84u,
+    0x0D6D6A3Eu, 0x7A6A5AA8u, 0xE40ECF0Bu, 0x9309FF9Du, 0x0A00AE27u, 0x7D079EB1u,
+    0xF00F9344u, 0x8708A3D2u, 0x1E01F268u, 0x6906C2FEu, 0xF762575Du, 0x806567CBu,
+    0x196C3671u, 0x6E6B06E7u, 0xFED41B76u, 0x89D32BE0u, 0x10DA7A5Au, 0x67DD4ACCu,
+    0xF9B9DF6Fu, 0x8EBEEFF9u, 0x17B7BE43u, 0x60B08ED5u, 0xD6D6A3E8u, 0xA1D1937Eu,
+    0x38D8C2C4u, 0x4FDFF252u, 0xD1BB67F1u, 0xA6BC5767u, 0x3FB506DDu, 0x48B2364Bu,
+    0xD80D2BDAu, 0xAF0A1B4Cu, 0x36034AF6u, 0x41047A60u, 0xDF60EFC3u, 0xA867DF55u,
+    0x316E8EEFu, 0x4669BE79u, 0xCB61B38Cu, 0xBC66831Au, 0x256FD2A0u, 0x5268E236u,
+    0xCC0C7795u, 0xBB0B4703u, 0x220216B9u, 0x5505262Fu, 0xC5BA3BBEu, 0xB2BD0B28u,
+    0x2BB45A92u, 0x5CB36A04u, 0xC2D7FFA7u, 0xB5D0CF31u, 0x2CD99E8Bu, 0x5BDEAE1Du,
+    0x9B64C2B0u, 0xEC63F226u, 0x756AA39Cu, 0x026D930Au, 0x9C0906A9u, 0xEB0E363Fu,
+    0x72076785u, 0x05005713u, 0x95BF4A82u, 0xE2B87A14u, 0x7BB12BAEu, 0x0CB61B38u,
+    0x92D28E9Bu, 0xE5D5BE0Du, 0x7CDCEFB7u, 0x0BDBDF21u, 0x86D3D2D4u, 0xF1D4E242u,
+    0x68DDB3F8u, 0x1FDA836Eu, 0x81BE16CDu, 0xF6B9265Bu, 0x6FB077E1u, 0x18B74777u,
+    0x88085AE6u, 0xFF0F6A70u, 0x66063BCAu, 0x11010B5Cu, 0x8F659EFFu, 0xF862AE69u,
+    0x616BFFD3u, 0x166CCF45u, 0xA00AE278u, 0xD70DD2EEu, 0x4E048354u, 0x3903B3C2u,
+    0xA7672661u, 0xD06016F7u, 0x4969474Du, 0x3E6E77DBu, 0xAED16A4Au, 0xD9D65ADCu,
+    0x40DF0B66u, 0x37D83BF0u, 0xA9BCAE53u, 0xDEBB9EC5u, 0x47B2CF7Fu, 0x30B5FFE9u,
+    0xBDBDF21Cu, 0xCABAC28Au, 0x53B39330u, 0x24B4A3A6u, 0xBAD03605u, 0xCDD70693u,
+    0x54DE5729u, 0x23D967BFu, 0xB3667A2Eu, 0xC4614AB8u, 0x5D681B02u, 0x2A6F2B94u,
+    0xB40BBE37u, 0xC30C8EA1u, 0x5A05DF1Bu, 0x2D02EF8Du
+};
+
+/**
+ * @brief Compute or continue a CRC-32 (IEEE 802.3) checksum
+ * @param crc Previous checksum (0 to start a new one)
+ * @param data Bytes to checksum
+ * @param length Number of bytes
+ * @return Updated checksum
+ */
+uint32_t codec_crc32(uint32_t crc, const void* data, size_t length) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = crc_table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Store a 16-bit value in little-endian order
+ * @param dest Destination (2 bytes)
+ * @param value Value to store
+ */
+void codec_put_u16(unsigned char* dest, uint16_t value) {
+    dest[0] = (unsigned char)(value & 0xFF);
+    dest[1] = (unsigned char)(value >> 8);
+}
+
+/**
+ * @brief Store a 32-bit value in little-endian order
+ * @param dest Destination (4 bytes)
+ * @param value Value to store
+ */
+void codec_put_u32(unsigned char* dest, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        dest[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Store a 64-bit value in little-endian order
+ * @param dest Destination (8 bytes)
+ * @param value Value to store
+ */
+void codec_put_u64(unsigned char* dest, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        dest[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Load a little-endian 16-bit value
+ * @param src Source (2 bytes)
+ * @return Decoded value
+ */
+uint16_t codec_get_u16(const unsigned char* src) {
+    return (uint16_t)(src[0] | (src[1] << 8));
+}
+
+/**
+ * @brief Load a little-endian 32-bit value
+ * @param src Source (4 bytes)
+ * @return Decoded value
+ */
+uint32_t codec_get_u32(const unsigned char* src) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = (value << 8) | src[i];
+    }
+    return value;
+}
+
+/**
+ * @brief Load a little-endian 64-bit value
+ * @param src Source (8 bytes)
+ * @return Decoded value
+ */
+uint64_t codec_get_u64(const unsigned char* src) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | src[i];
+    }
+    return value;
+}
+
+/**
+ * @brief Store an unsigned varint (7 bits per byte, low bits first)
+ * @param dest Destination (up to CODEC_VARINT_MAX bytes)
+ * @param value Value to store
+ * @return Bytes written
+ */
+size_t codec_put_varint(unsigned char* dest, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        dest[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    dest[length++] = (unsigned char)value;
+    return length;
+}
+
+/**
+ * @brief Load an unsigned varint
+ * @param src Source bytes
+ * @param length Bytes available
+ * @param value Receives the decoded value
+ * @return Bytes read, 0 if the varint is truncated or too long
+ */
+size_t codec_get_varint(const unsigned char* src, size_t length, uint64_t* value) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < length && i < CODEC_VARINT_MAX; i++) {
+        result |= (uint64_t)(src[i] & 0x7F) << (7 * i);
+        if (!(src[i] & 0x80)) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Map a signed value to an unsigned one with small magnitudes first
+ * @param value Signed value
+ * @return Zigzag encoding (0, -1, 1, -2, ... become 0, 1, 2, 3, ...)
+ */
+uint64_t codec_zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (value < 0 ? UINT64_MAX : 0);
+}
+
+/**
+ * @brief Invert codec_zigzag
+ * @param value Zigzag encoding
+ * @return Signed value
+ */
+int64_t codec_unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/**
+ * @brief Load 4 bytes for hashing and comparing (host order)
+ * @param src Source (4 bytes)
+ * @return The bytes as one word
+ */
+static uint32_t lz_read32(const unsigned char* src) {
+    uint32_t value;
+    memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Write the 255-byte continuation of a length field
+ * @param dest Destination
+ * @param length Length beyond what the token holds
+ * @return Bytes written
+ */
+static size_t lz_put_length(unsigned char* dest, size_t length) {
+    size_t written = 0;
+    while (length >= 255) {
+        dest[written++] = 255;
+        length -= 255;
+    }
+    dest[written++] = (unsigned char)length;
+    return written;
+}
+
+/**
+ * @brief Append one sequence: literals, then a match unless it is the last
+ * @param dest Output block
+ * @param out Bytes already in dest (updated)
+ * @param capacity Size of dest
+ * @param literals First literal byte
+ * @param literal_length Number of literal bytes
+ * @param offset Distance back to the match (0 for the final sequence)
+ * @param match_length Length of the match
+ * @return 0 on success, -1 if the output does not fit
+ */
+static int lz_put_sequence(unsigned char* dest, size_t* out, size_t capacity, const unsigned char* literals,
+                           size_t literal_length, size_t offset, size_t match_length) {
+    // Token, both length continuations, literals and offset at their largest
+    size_t worst = 1 + literal_length / 255 + 1 + literal_length + 2 + match_length / 255 + 1;
+    if (worst > capacity - *out) {
+        return -1;
+    }
+    
+    unsigned char* token = dest + (*out)++;
+    *token = (unsigned char)((literal_length < 15 ? literal_length : 15) << 4);
+    if (literal_length >= 15) {
+        *out += lz_put_length(dest + *out, literal_length - 15);
+    }
+    memcpy(dest + *out, literals, literal_length);
+    *out += literal_length;
+    if (offset == 0) {
+        return 0;
+    }
+    
+    dest[(*out)++] = (unsigned char)offset;
+    dest[(*out)++] = (unsigned char)(offset >> 8);
+    size_t extra = match_length - LZ_MIN_MATCH;
+    *token |= (unsigned char)(extra < 15 ? extra : 15);
+    if (extra >= 15) {
+        *out += lz_put_length(dest + *out, extra - 15);
+    }
+    return 0;
+}
+
+/**
+ * @brief Compress a block with a fast LZ77 coder (LZ4 block layout)
+ * @param src Bytes to compress
+ * @param size Number of bytes
+ * @param dest Receives the compressed block
+ * @param capacity Size of dest
+ * @return Compressed size, 0 if it would not fit in capacity
+ */
+size_t codec_lz_compress(const unsigned char* src, size_t size, unsigned char* dest, size_t capacity) {
+    // Positions are only hints: a candidate is used once its bytes compare equal
+    uint32_t table[1 << LZ_HASH_BITS];
+    memset(table, 0, sizeof(table));
+    
+    size_t out = 0;
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + LZ_MIN_MATCH <= size) {
+        uint32_t sequence = lz_read32(src + pos);
+        uint32_t slot = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+        size_t candidate = table[slot];
+        table[slot] = (uint32_t)pos;
+        
+        if (candidate >= pos || pos - candidate > LZ_MAX_OFFSET || lz_read32(src + candidate) != sequence) {
+            // Step faster through data that keeps failing to match
+            pos += 1 + ((pos - anchor) >> 6);
+            continue;
+        }
+        
+        size_t length = LZ_MIN_MATCH;
+        while (pos + length < size && src[candidate + length] == src[pos + length]) {
+            length++;
+        }
+        if (lz_put_sequence(dest, &out, capacity, src + anchor, pos - anchor, pos - candidate, length) != 0) {
+            return 0;
+        }
+        pos += length;
+        anchor = pos;
+    }
+    
+    if (lz_put_sequence(dest, &out, capacity, src + anchor, size - anchor, 0, 0) != 0) {
+        return 0;
+    }
+    return out;
+}
+
+/**
+ * @brief Read the 255-byte continuation of a length field
+ * @param src Compressed block
+ * @param size Size of the block
+ * @param in Read position (updated)
+ * @param length Length to extend (updated)
+ * @return 0 on success, -1 if the block ends first
+ */
+static int lz_get_length(const unsigned char* src, size_t size, size_t* in, size_t* length) {
+    unsigned char byte;
+    do {
+        if (*in >= size) {
+            return -1;
+        }
+        byte = src[(*in)++];
+        *length += byte;
+    } while (byte == 255);
+    return 0;
+}
+
+/**
+ * @brief Decompress a block written by codec_lz_compress
+ * @param src Compressed block
+ * @param size Size of the compressed block
+ * @param dest Receives the original bytes
+ * @param dest_size Exact size of the original bytes
+ * @return 0 on success, -1 if the block is malformed or does not decode to dest_size bytes
+ */
+int codec_lz_decompress(const unsigned char* src, size_t size, unsigned char* dest, size_t dest_size) {
+    size_t in = 0;
+    size_t out = 0;
+    for (;;) {
+        if (in >= size) {
+            return -1;
+        }
+        unsigned char token = src[in++];
+        
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && lz_get_length(src, size, &in, &literal_length) != 0) {
+            return -1;
+        }
+        if (literal_length > size - in || literal_length > dest_size - out) {
+            return -1;
+        }
+        memcpy(dest + out, src + in, literal_length);
+        in += literal_length;
+        out += literal_length;
+        if (in == size) {
+            // The final sequence has no match
+            return out == dest_size ? 0 : -1;
+        }
+        
+        if (size - in < 2) {
+            return -1;
+        }
+        size_t offset = (size_t)src[in] | ((size_t)src[in + 1] << 8);
+        in += 2;
+        size_t match_length = (size_t)(token & 15) + LZ_MIN_MATCH;
+        if ((token & 15) == 15 && lz_get_length(src, size, &in, &match_length) != 0) {
+            return -1;
+        }
+        if (offset == 0 || offset > out || match_length > dest_size - out) {
+            return -1;
+        }
+        
+        // Overlapping matches repeat the bytes they are still producing
+        const unsigned char* from = dest + out - offset;
+        if (offset >= match_length) {
+            memcpy(dest + out, from, match_length);
+        } else {
+            for (size_t i = 0; i < match_length; i++) {
+                dest[out + i] = from[i];
+            }
+        }
+        out += match_length;
+    }
+}
\ No newline at end of file
@@ -8,214 +8,1997 @@
  * to/from files for persistence across program sessions.
  */
 
+// Needed for fileno(), fsync() and mmap() under -std=c99
+#define _POSIX_C_SOURCE 200809L
+
 #include "../include/file_io.h"
+#include "../include/codec.h"
+#include "../include/journal.h"
+#include "../include/metrics.h"
+#include "../include/render.h"
+#include "../include/todo_log.h"
+#include "../include/todo_sync.h"
+
+#include <limits.h>
+#include <stddef.h>
 
 #ifdef _WIN32
     #include <direct.h>
+    #include <io.h>
+    #include <windows.h>
 #else
+    #include <fcntl.h>
+    #include <sys/mman.h>
     #include <sys/stat.h>
     #include <sys/types.h>
+    #include <unistd.h>
+#endif
+
+// Number of records converted per batch when saving or loading
+#define RECORD_BATCH_SIZE 64
+
+// Work per task when a snapshot is checksummed and validated in parallel
+#define LOAD_TASK_BYTES (2u << 20)
+#define LOAD_TASK_RECORDS 65536
+
+// Most IDs a legacy file may skip past its todo count; bounds the dense ID
+// index a damaged header can make a load allocate
+#define LEGACY_MAX_ID_GAP (1 << 20)
+
+/*
+ * Snapshot layout (version 4). All integers are little-endian.
+ *
+ *   header      SNAPSHOT_HEADER_SIZE bytes, see below
+ *   records     count records of SNAPSHOT_RECORD_SIZE bytes
+ *   strings     string arena the records reference
+ *   checksums   CRC-32 of each block of the record region, then of each
+ *               block of the string region (blocks are block_size bytes,
+ *               the last one in a region may be shorter)
+ *
+ *   header                               record
+ *   offset  size  field                  offset  size  field
+ *        0     8  magic "TODOSNAP"            0     4  id
+ *        8     4  format version              4     1  priority
+ *       12     4  record size                 5     1  status
+ *       16     4  number of records           6     2  flags
+ *       20     4  next ID                     8     4  text offset
+ *       24     8  string arena size          12     2  title length
+ *       32     4  block size                 14     2  description length
+ *       36     8  reserved (0)               16     8  created at
+ *       44     4  CRC-32 of bytes 0..43      24     8  updated at
+ *                                            32     8  due at (0 if none)
+ *
+ * The record layout is the in-memory Todo on little-endian hosts, where
+ * records are read and written in bulk and can be mapped in place.
+ * Version 2 had the same layout without the due date (32-byte records);
+ * version 1 also had only the first 32 header bytes and no checksums.
+ *
+ * Packed snapshots (version 3) keep the header, with a record size of 0
+ * and the string arena size replaced by the size of the payload: every
+ * todo in turn as
+ *
+ *   varint     id minus the previous id (zigzag)
+ *   1 byte     priority | status << 2, plus PACKED_HAS_DUE if a due date follows
+ *   varint     created at minus the previous created at (zigzag)
+ *   varint     updated at minus created at (zigzag)
+ *   varint     due at minus created at (zigzag), only with PACKED_HAS_DUE
+ *   varint     title length, then the title
+ *   varint     description length, then the description
+ *
+ * Varints hold 7 bits per byte, low bits first. The payload is cut into
+ * blocks of block_size bytes (the last one may be shorter), each stored
+ * as a 4-byte stored size, the CRC-32 of the stored bytes and the bytes
+ * themselves: LZ-compressed (see codec.h), or raw if the stored size
+ * equals the block's length. Ids ascend in a saved list and timestamps
+ * cluster, so most fields take one or two bytes before compression.
+ */
+#define SNAPSHOT_MAGIC "TODOSNAP"
+#define SNAPSHOT_MAGIC_SIZE 8
+#define SNAPSHOT_VERSION 4
+#define SNAPSHOT_PACKED_VERSION 3
+#define SNAPSHOT_PACKED_BLOCK_SIZE 65536
+#define SNAPSHOT_FRAME_HEADER_SIZE 8
+
+// Bit of the packed status byte telling that a due date is stored
+#define PACKED_HAS_DUE 0x08
+
+// Largest packed todo: four varints, the status byte and both texts with their lengths
+#define PACKED_RECORD_MAX (4 * CODEC_VARINT_MAX + 1 + 4 + MAX_TITLE_LENGTH + MAX_DESC_LENGTH)
+#define SNAPSHOT_HEADER_SIZE 48
+#define SNAPSHOT_V1_HEADER_SIZE 32
+#define SNAPSHOT_RECORD_SIZE 40
+#define SNAPSHOT_V2_RECORD_SIZE 32
+#define SNAPSHOT_BLOCK_SIZE 32768
+
+// Bounds accepted for the block size of a stored snapshot
+#define SNAPSHOT_MIN_BLOCK_SIZE 1024
+#define SNAPSHOT_MAX_BLOCK_SIZE (16 * 1024 * 1024)
+
+/**
+ * @brief Decoded snapshot header
+ */
+typedef struct {
+    uint32_t version;                      /**< Format version */
+    uint32_t record_size;                  /**< Size of one record (0 if packed) */
+    uint32_t count;                        /**< Number of records */
+    uint32_t next_id;                      /**< Next ID to hand out */
+    uint64_t strings_size;                 /**< Size of the string arena (packed: of the payload) */
+    uint32_t block_size;                   /**< Checksum block size (0 if unchecksummed) */
+    size_t header_size;                    /**< Size of the header on disk */
+} SnapshotHeader;
+
+/**
+ * @brief Running per-block checksums of a region being written
+ */
+typedef struct {
+    uint32_t* crcs;                        /**< Finished block checksums */
+    size_t count;                          /**< Number of finished blocks */
+    uint32_t crc;                          /**< Checksum of the current block so far */
+    size_t filled;                         /**< Bytes in the current block */
+} BlockChecksums;
+
+/**
+ * @brief Region being checked against its block checksums by parallel tasks
+ */
+typedef struct {
+    const unsigned char* data;             /**< Region bytes */
+    uint64_t size;                         /**< Region size */
+    uint32_t block_size;                   /**< Checksum block size */
+    const unsigned char* crcs;             /**< Stored checksums, one per block */
+    size_t blocks_per_task;                /**< Blocks checked by each task */
+    long* bad_blocks;                      /**< Per task: first mismatching block, or -1 */
+} VerifyJob;
+
+/**
+ * @brief Records being decoded and validated by parallel tasks
+ */
+typedef struct {
+    Todo* todos;                           /**< Records, decoded in place if decode is set */
+    int count;                             /**< Number of records */
+    int decode;                            /**< Whether records still have the on-disk layout */
+    const char* strings;                   /**< String arena the records reference */
+    size_t strings_size;                   /**< Size of the string arena */
+    int* bad_records;                      /**< Per task: first invalid record, or -1 */
+} RecordJob;
+
+/**
+ * @brief Blocks of a packed payload being checked and expanded by parallel tasks
+ */
+typedef struct {
+    const unsigned char** frames;          /**< Start of each stored block (after its header) */
+    unsigned char* payload;                /**< Receives the expanded payload */
+    uint64_t size;                         /**< Payload size */
+    uint32_t block_size;                   /**< Expanded size of every block but the last */
+    size_t blocks_per_task;                /**< Blocks expanded by each task */
+    long* bad_blocks;                      /**< Per task: first bad block, or -1 */
+} UnpackJob;
+
+/**
+ * @brief Packed payload being compressed into blocks and written
+ */
+typedef struct {
+    FILE* file;                            /**< Destination file */
+    unsigned char* block;                  /**< Payload bytes of the current block */
+    size_t filled;                         /**< Bytes in the current block */
+    unsigned char* packed;                 /**< Compression output */
+} PackWriter;
+
+/**
+ * @brief Legacy on-disk layout of a single todo record
+ *
+ * Files written before the snapshot format store text inline at its
+ * maximum length behind two raw ints (count and next ID). They are still
+ * read, and are rewritten in the current format on the next save.
+ */
+typedef struct {
+    int id;                                  /**< Unique identifier */
+    char title[MAX_TITLE_LENGTH];           /**< Todo title */
+    char description[MAX_DESC_LENGTH];      /**< Todo description */
+    Priority priority;                      /**< Priority level */
+    Status status;                         /**< Completion status */
+    time_t created_at;                     /**< Creation timestamp */
+    time_t updated_at;                     /**< Last update timestamp */
+} TodoRecord;
+
+/**
+ * @brief Ensure a directory exists, creating it if needed
+ * @param path Directory to check (its parent must exist)
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int ensure_directory(const char* path) {
+    char probe[512];
+    if (snprintf(probe, sizeof(probe), "%s/.", path) >= (int)sizeof(probe)) {
+        return TODO_ERR_INVALID;
+    }
+    
+    // Check if the directory exists
+    FILE* test = fopen(probe, "r");
+    if (test) {
+        fclose(test);
+        return TODO_OK; // Directory exists
+    }
+    
+    // Try to create the directory
+#ifdef _WIN32
+    if (_mkdir(path) == 0) {
+#else
+    if (mkdir(path, 0755) == 0) {
+#endif
+        return TODO_OK; // Successfully created
+    }
+    
+    // Directory might already exist, try to verify
+    test = fopen(probe, "r");
+    if (test) {
+        fclose(test);
+        return TODO_OK;
+    }
+    
+    return TODO_ERR_IO; // Failed to create directory
+}
+
+/**
+ * @brief Ensure data directory exists
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int ensure_data_directory(void) {
+    return ensure_directory(DATA_DIR);
+}
+
+/**
+ * @brief Ensure the directory holding a file exists, creating it if needed
+ * @param filename File whose directory to check (its grandparent must exist)
+ * @return TODO_OK on success (including files in the current directory), negative TodoError on failure
+ */
+int ensure_parent_directory(const char* filename) {
+    if (!filename) {
+        return TODO_ERR_INVALID;
+    }
+    
+    const char* end = strrchr(filename, '/');
+#ifdef _WIN32
+    const char* backslash = strrchr(filename, '\\');
+    if (backslash && (!end || backslash > end)) {
+        end = backslash;
+    }
+#endif
+    if (!end || end == filename) {
+        return TODO_OK; // Current or root directory
+    }
+    
+    char directory[512];
+    size_t length = (size_t)(end - filename);
+    if (length >= sizeof(directory)) {
+        return TODO_ERR_TOO_LONG;
+    }
+    memcpy(directory, filename, length);
+    directory[length] = '\0';
+    return ensure_directory(directory);
+}
+
+/**
+ * @brief Map a whole file read-only into memory
+ * @param filename Name of the file to map
+ * @return New mapping, NULL on failure (including empty files)
+ */
+FileMapping* file_map(const char* filename) {
+    size_t name_length = strlen(filename);
+    FileMapping* mapping = (FileMapping*)malloc(sizeof(FileMapping));
+    char* path = (char*)malloc(name_length + 1);
+    if (!mapping || !path) {
+        free(mapping);
+        free(path);
+        return NULL;
+    }
+    memcpy(path, filename, name_length + 1);
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        free(mapping);
+        free(path);
+        return NULL;
+    }
+    
+    LARGE_INTEGER file_size;
+    HANDLE section = NULL;
+    void* data = NULL;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0 &&
+        (unsigned long long)file_size.QuadPart <= SIZE_MAX) {
+        section = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    if (section) {
+        data = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(section); // The view keeps the section alive
+    }
+    CloseHandle(file);
+    
+    if (!data) {
+        free(mapping);
+        free(path);
+        return NULL;
+    }
+    size_t size = (size_t)file_size.QuadPart;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        free(mapping);
+        free(path);
+        return NULL;
+    }
+    
+    struct stat info;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0 && (unsigned long long)info.st_size <= SIZE_MAX) {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd); // The mapping stays valid after the descriptor is closed
+    
+    if (data == MAP_FAILED) {
+        free(mapping);
+        free(path);
+        return NULL;
+    }
+    size_t size = (size_t)info.st_size;
+#endif
+
+    mapping->data = data;
+    mapping->size = size;
+    mapping->path = path;
+    return mapping;
+}
+
+/**
+ * @brief Unmap a file mapped by file_map
+ * @param mapping Mapping to release (may be NULL)
+ */
+void file_unmap(FileMapping* mapping) {
+    if (!mapping) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping->data);
+#else
+    munmap(mapping->data, mapping->size);
+#endif
+    free(mapping->path);
+    free(mapping);
+}
+
+/**
+ * @brief TodoList backing release hook for snapshot mappings
+ * @param backing FileMapping to release
+ */
+static void release_mapping(void* backing) {
+    file_unmap((FileMapping*)backing);
+}
+
+#ifdef _WIN32
+/**
+ * @brief Check whether a list still reads its todos from a mapping of a file
+ * @param list Pointer to the todo list
+ * @param filename Name of the file
+ * @return 1 if list is backed by a mapping of filename, 0 otherwise
+ */
+static int list_maps_file(const TodoList* list, const char* filename) {
+    if (!list->backing || list->backing_release != release_mapping) {
+        return 0;
+    }
+    return strcmp(((const FileMapping*)list->backing)->path, filename) == 0;
+}
+#endif
+
+/**
+ * @brief Check whether Todo already has the on-disk record layout
+ * @return 1 on little-endian hosts with the expected struct layout, 0 otherwise
+ */
+static int records_are_native(void) {
+    const uint16_t probe = 1;
+    return *(const unsigned char*)&probe == 1 &&
+           sizeof(Todo) == SNAPSHOT_RECORD_SIZE &&
+           offsetof(Todo, priority) == 4 && offsetof(Todo, status) == 5 &&
+           offsetof(Todo, flags) == 6 && offsetof(Todo, text_offset) == 8 &&
+           offsetof(Todo, title_length) == 12 && offsetof(Todo, desc_length) == 14 &&
+           offsetof(Todo, created_at) == 16 && offsetof(Todo, updated_at) == 24 &&
+           offsetof(Todo, due_at) == 32;
+}
+
+/**
+ * @brief Encode a todo as an on-disk record
+ * @param dest Destination (SNAPSHOT_RECORD_SIZE bytes)
+ * @param todo Todo to encode
+ */
+static void encode_record(unsigned char* dest, const Todo* todo) {
+    codec_put_u32(dest, (uint32_t)todo->id);
+    dest[4] = todo->priority;
+    dest[5] = todo->status;
+    codec_put_u16(dest + 6, todo->flags);
+    codec_put_u32(dest + 8, todo->text_offset);
+    codec_put_u16(dest + 12, todo->title_length);
+    codec_put_u16(dest + 14, todo->desc_length);
+    codec_put_u64(dest + 16, (uint64_t)todo->created_at);
+    codec_put_u64(dest + 24, (uint64_t)todo->updated_at);
+    codec_put_u64(dest + 32, (uint64_t)todo->due_at);
+}
+
+/**
+ * @brief Decode an on-disk record
+ * @param todo Receives the decoded todo
+ * @param src Record bytes
+ * @param record_size SNAPSHOT_RECORD_SIZE, or SNAPSHOT_V2_RECORD_SIZE for records without a due date
+ */
+static void decode_record(Todo* todo, const unsigned char* src, uint32_t record_size) {
+    todo->id = (int32_t)codec_get_u32(src);
+    todo->priority = src[4];
+    todo->status = src[5];
+    todo->flags = codec_get_u16(src + 6);
+    todo->text_offset = codec_get_u32(src + 8);
+    todo->title_length = codec_get_u16(src + 12);
+    todo->desc_length = codec_get_u16(src + 14);
+    todo->created_at = (int64_t)codec_get_u64(src + 16);
+    todo->updated_at = (int64_t)codec_get_u64(src + 24);
+    todo->due_at = record_size >= SNAPSHOT_RECORD_SIZE ? (int64_t)codec_get_u64(src + 32) : 0;
+}
+
+/**
+ * @brief Number of checksum blocks covering a region
+ * @param size Region size in bytes
+ * @param block_size Block size in bytes
+ * @return Block count
+ */
+static size_t block_count(uint64_t size, uint32_t block_size) {
+    return (size_t)((size + block_size - 1) / block_size);
+}
+
+/**
+ * @brief Feed region bytes into the running block checksums
+ * @param sums Checksum state
+ * @param data Bytes written to the region
+ * @param length Number of bytes
+ */
+static void checksum_blocks(BlockChecksums* sums, const void* data, size_t length) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    while (length > 0) {
+        size_t take = SNAPSHOT_BLOCK_SIZE - sums->filled;
+        if (take > length) {
+            take = length;
+        }
+        
+        sums->crc = codec_crc32(sums->crc, bytes, take);
+        sums->filled += take;
+        bytes += take;
+        length -= take;
+        
+        if (sums->filled == SNAPSHOT_BLOCK_SIZE) {
+            sums->crcs[sums->count++] = sums->crc;
+            sums->crc = 0;
+            sums->filled = 0;
+        }
+    }
+}
+
+/**
+ * @brief Close the partial block at the end of a region
+ * @param sums Checksum state
+ */
+static void finish_blocks(BlockChecksums* sums) {
+    if (sums->filled > 0) {
+        sums->crcs[sums->count++] = sums->crc;
+        sums->crc = 0;
+        sums->filled = 0;
+    }
+}
+
+/**
+ * @brief Check one task's share of a region against its block checksums
+ * @param arg The VerifyJob
+ * @param task Task number
+ */
+static void verify_task(void* arg, int task) {
+    VerifyJob* job = (VerifyJob*)arg;
+    size_t blocks = block_count(job->size, job->block_size);
+    size_t first = (size_t)task * job->blocks_per_task;
+    size_t last = blocks - first > job->blocks_per_task ? first + job->blocks_per_task : blocks;
+    job->bad_blocks[task] = -1;
+    for (size_t i = first; i < last; i++) {
+        uint64_t start = (uint64_t)i * job->block_size;
+        size_t length = job->size - start < job->block_size ? (size_t)(job->size - start) : job->block_size;
+        if (codec_crc32(0, job->data + start, length) != codec_get_u32(job->crcs + i * 4)) {
+            job->bad_blocks[task] = (long)i;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Check a region against its stored block checksums
+ *
+ * Large regions are split into runs of blocks checked on several threads.
+ *
+ * @param data Region bytes
+ * @param size Region size
+ * @param block_size Block size
+ * @param crcs Stored little-endian checksums, one per block
+ * @return TODO_OK if every block matches, negative TodoError otherwise
+ */
+static int verify_blocks(const void* data, uint64_t size, uint32_t block_size, const unsigned char* crcs) {
+    size_t blocks = block_count(size, block_size);
+    size_t blocks_per_task = block_size < LOAD_TASK_BYTES ? LOAD_TASK_BYTES / block_size : 1;
+    int tasks = (int)((blocks + blocks_per_task - 1) / blocks_per_task);
+    if (tasks == 0) {
+        return TODO_OK;
+    }
+    
+    long single = -1;
+    VerifyJob job = {(const unsigned char*)data, size, block_size, crcs, blocks_per_task, &single};
+    if (tasks > 1 && !(job.bad_blocks = (long*)malloc(sizeof(long) * tasks))) {
+        // Fall back to one task covering every block
+        job.bad_blocks = &single;
+        job.blocks_per_task = blocks;
+        tasks = 1;
+    }
+    todo_parallel_run(tasks, verify_task, &job);
+    
+    int result = TODO_OK;
+    for (int task = 0; task < tasks; task++) {
+        if (job.bad_blocks[task] >= 0) {
+            todo_log(TODO_LOG_ERROR, "Checksum mismatch in snapshot block %lu", (unsigned long)job.bad_blocks[task]);
+            result = TODO_ERR_CORRUPT;
+            break;
+        }
+    }
+    if (job.bad_blocks != &single) {
+        free(job.bad_blocks);
+    }
+    return result;
+}
+
+/**
+ * @brief Decode and validate a snapshot header
+ * @param bytes Bytes read from the start of the file
+ * @param length Number of bytes available (at least the version 1 header)
+ * @param header Receives the decoded header
+ * @return TODO_OK on success, TODO_ERR_CORRUPT if the header is not valid
+ */
+static int decode_header(const unsigned char* bytes, size_t length, SnapshotHeader* header) {
+    if (length < SNAPSHOT_V1_HEADER_SIZE || memcmp(bytes, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) != 0) {
+        return TODO_ERR_CORRUPT;
+    }
+    
+    header->version = codec_get_u32(bytes + 8);
+    header->record_size = codec_get_u32(bytes + 12);
+    uint32_t record_size = header->record_size;
+    header->count = codec_get_u32(bytes + 16);
+    header->next_id = codec_get_u32(bytes + 20);
+    header->strings_size = codec_get_u64(bytes + 24);
+    header->block_size = 0;
+    header->header_size = SNAPSHOT_V1_HEADER_SIZE;
+    
+    if (header->version < 1 || header->version > SNAPSHOT_VERSION) {
+        todo_log(TODO_LOG_ERROR, "Unsupported snapshot version %u", (unsigned)header->version);
+        return TODO_ERR_CORRUPT;
+    }
+    
+    if (header->version >= 2) {
+        if (length < SNAPSHOT_HEADER_SIZE ||
+            codec_crc32(0, bytes, SNAPSHOT_HEADER_SIZE - 4) != codec_get_u32(bytes + SNAPSHOT_HEADER_SIZE - 4)) {
+            todo_log(TODO_LOG_ERROR, "Snapshot header checksum mismatch");
+            return TODO_ERR_CORRUPT;
+        }
+        header->block_size = codec_get_u32(bytes + 32);
+        header->header_size = SNAPSHOT_HEADER_SIZE;
+        if (header->block_size < SNAPSHOT_MIN_BLOCK_SIZE || header->block_size > SNAPSHOT_MAX_BLOCK_SIZE) {
+            todo_log(TODO_LOG_ERROR, "Invalid snapshot block size %u", (unsigned)header->block_size);
+            return TODO_ERR_CORRUPT;
+        }
+    }
+    
+    if (header->version == SNAPSHOT_PACKED_VERSION) {
+        // The payload never outgrows its largest possible records
+        if (record_size != 0 || header->count > INT_MAX || header->next_id < 1 || header->next_id > INT_MAX ||
+            header->strings_size > (uint64_t)header->count * PACKED_RECORD_MAX || header->strings_size > SIZE_MAX) {
+            todo_log(TODO_LOG_ERROR, "Invalid snapshot header");
+            return TODO_ERR_CORRUPT;
+        }
+        return TODO_OK;
+    }
+    
+    uint32_t expected_size = header->version == SNAPSHOT_VERSION ? SNAPSHOT_RECORD_SIZE : SNAPSHOT_V2_RECORD_SIZE;
+    if (record_size != expected_size || header->count > INT_MAX ||
+        header->next_id < 1 || header->next_id > INT_MAX || header->strings_size > UINT32_MAX) {
+        todo_log(TODO_LOG_ERROR, "Invalid snapshot header");
+        return TODO_ERR_CORRUPT;
+    }
+    
+    return TODO_OK;
+}
+
+/**
+ * @brief Size in bytes of the checksum table that follows the string arena
+ * @param header Decoded header
+ * @return Table size (0 for unchecksummed versions)
+ */
+static uint64_t checksums_size(const SnapshotHeader* header) {
+    if (header->block_size == 0) {
+        return 0;
+    }
+    return 4 * ((uint64_t)block_count((uint64_t)header->count * header->record_size, header->block_size) +
+                block_count(header->strings_size, header->block_size));
+}
+
+/**
+ * @brief Decode (if needed) and check one task's share of the records
+ * @param arg The RecordJob
+ * @param task Task number
+ */
+static void record_task(void* arg, int task) {
+    RecordJob* job = (RecordJob*)arg;
+    int first = task * LOAD_TASK_RECORDS;
+    int last = job->count - first > LOAD_TASK_RECORDS ? first + LOAD_TASK_RECORDS : job->count;
+    job->bad_records[task] = -1;
+    for (int i = first; i < last; i++) {
+        Todo* todo = &job->todos[i];
+        if (job->decode) {
+            // Records are as large as a Todo here, so each one is decoded over itself
+            unsigned char record[SNAPSHOT_RECORD_SIZE];
+            memcpy(record, todo, SNAPSHOT_RECORD_SIZE);
+            decode_record(todo, record, SNAPSHOT_RECORD_SIZE);
+        }
+        if (todo->id <= 0 || todo->due_at < 0 ||
+            todo->priority < PRIORITY_LOW || todo->priority > PRIORITY_HIGH ||
+            todo->status > STATUS_COMPLETED ||
+            todo->title_length >= MAX_TITLE_LENGTH || todo->desc_length >= MAX_DESC_LENGTH ||
+            (uint64_t)todo->text_offset + todo->title_length + todo->desc_length + 2 > job->strings_size) {
+            job->bad_records[task] = i;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Check that stored records are safe to use in place
+ *
+ * Only the records and the final byte of the string arena are inspected,
+ * so validating a mapped file does not page in the text itself. Large
+ * arrays are split into runs of records checked on several threads,
+ * which also decode records still in the on-disk layout if decode is
+ * set (only allowed when a Todo is exactly SNAPSHOT_RECORD_SIZE bytes).
+ *
+ * @param todos Records to check
+ * @param count Number of records
+ * @param decode Whether to decode the records in place first
+ * @param strings String arena the records reference
+ * @param strings_size Size of the string arena
+ * @return TODO_OK if valid, negative TodoError otherwise
+ */
+static int validate_records(Todo* todos, int count, int decode, const char* strings, size_t strings_size) {
+    // A terminator at the end keeps every string read inside the arena
+    if (strings_size > 0 && strings[strings_size - 1] != '\0') {
+        return TODO_ERR_CORRUPT;
+    }
+    
+    int tasks = (count + LOAD_TASK_RECORDS - 1) / LOAD_TASK_RECORDS;
+    int* bad_records = (int*)malloc(sizeof(int) * (tasks > 0 ? tasks : 1));
+    if (!bad_records) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed while loading");
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    RecordJob job = {todos, count, decode, strings, strings_size, bad_records};
+    todo_parallel_run(tasks, record_task, &job);
+    
+    int result = TODO_OK;
+    for (int task = 0; task < tasks; task++) {
+        if (bad_records[task] >= 0) {
+            todo_log(TODO_LOG_ERROR, "Corrupt todo record at position %d", bad_records[task]);
+            result = TODO_ERR_CORRUPT;
+            break;
+        }
+    }
+    free(bad_records);
+    return result;
+}
+
+/**
+ * @brief Checksum and write a batch of encoded records
+ * @param file Destination file
+ * @param sums Checksum state of the record region
+ * @param records Encoded records
+ * @param batch Number of records
+ * @return TODO_OK on success, TODO_ERR_IO on failure
+ */
+static int write_record_batch(FILE* file, BlockChecksums* sums, const unsigned char* records, int batch) {
+    checksum_blocks(sums, records, (size_t)batch * SNAPSHOT_RECORD_SIZE);
+    if (fwrite(records, SNAPSHOT_RECORD_SIZE, batch, file) != (size_t)batch) {
+        return TODO_ERR_IO;
+    }
+    return TODO_OK;
+}
+
+/**
+ * @brief Write the list to an open file in the snapshot format
+ *
+ * Tombstones and unreferenced text are dropped, so the string arena is
+ * written compacted and each record's text_offset is rebased to match.
+ *
+ * @param list Pointer to the todo list
+ * @param file File opened for binary writing
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int write_snapshot(const TodoList* list, FILE* file) {
+    uint64_t strings_size = 0;
+    for (int slot = 0; slot < list->used; slot++) {
+        const Todo* todo = &list->todos[slot];
+        if (todo->id != TODO_TOMBSTONE_ID) {
+            strings_size += (uint64_t)todo->title_length + todo->desc_length + 2;
+        }
+    }
+    
+    uint64_t records_size = (uint64_t)list->count * SNAPSHOT_RECORD_SIZE;
+    size_t blocks = block_count(records_size, SNAPSHOT_BLOCK_SIZE) + block_count(strings_size, SNAPSHOT_BLOCK_SIZE);
+    BlockChecksums sums = {NULL, 0, 0, 0};
+    sums.crcs = (uint32_t*)malloc(sizeof(uint32_t) * (blocks > 0 ? blocks : 1));
+    if (!sums.crcs) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    unsigned char header[SNAPSHOT_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+    codec_put_u32(header + 8, SNAPSHOT_VERSION);
+    codec_put_u32(header + 12, SNAPSHOT_RECORD_SIZE);
+    codec_put_u32(header + 16, (uint32_t)list->count);
+    codec_put_u32(header + 20, (uint32_t)list->next_id);
+    codec_put_u64(header + 24, strings_size);
+    codec_put_u32(header + 32, SNAPSHOT_BLOCK_SIZE);
+    codec_put_u32(header + 44, codec_crc32(0, header, SNAPSHOT_HEADER_SIZE - 4));
+    if (fwrite(header, sizeof(header), 1, file) != 1) {
+        free(sums.crcs);
+        return TODO_ERR_IO;
+    }
+    
+    // Records, in batches with their text offsets rebased
+    int native = records_are_native();
+    unsigned char records[RECORD_BATCH_SIZE * SNAPSHOT_RECORD_SIZE];
+    uint32_t offset = 0;
+    int batch = 0;
+    for (int slot = 0; slot < list->used; slot++) {
+        const Todo* todo = &list->todos[slot];
+        if (todo->id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        
+        Todo record = *todo;
+        record.text_offset = offset;
+        offset += (uint32_t)todo->title_length + todo->desc_length + 2;
+        if (native) {
+            memcpy(records + batch * SNAPSHOT_RECORD_SIZE, &record, SNAPSHOT_RECORD_SIZE);
+        } else {
+            encode_record(records + batch * SNAPSHOT_RECORD_SIZE, &record);
+        }
+        
+        // Flush full batches; the final partial one is written below
+        if (++batch == RECORD_BATCH_SIZE) {
+            if (write_record_batch(file, &sums, records, batch) != TODO_OK) {
+                free(sums.crcs);
+                return TODO_ERR_IO;
+            }
+            batch = 0;
+        }
+    }
+    if (batch > 0 && write_record_batch(file, &sums, records, batch) != TODO_OK) {
+        free(sums.crcs);
+        return TODO_ERR_IO;
+    }
+    finish_blocks(&sums);
+    
+    // Text blocks in the same order
+    for (int slot = 0; slot < list->used; slot++) {
+        const Todo* todo = &list->todos[slot];
+        if (todo->id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        
+        size_t size = (size_t)todo->title_length + todo->desc_length + 2;
+        checksum_blocks(&sums, list->strings + todo->text_offset, size);
+        if (fwrite(list->strings + todo->text_offset, 1, size, file) != size) {
+            free(sums.crcs);
+            return TODO_ERR_IO;
+        }
+    }
+    finish_blocks(&sums);
+    
+    for (size_t i = 0; i < sums.count; i++) {
+        unsigned char crc[4];
+        codec_put_u32(crc, sums.crcs[i]);
+        if (fwrite(crc, sizeof(crc), 1, file) != 1) {
+            free(sums.crcs);
+            return TODO_ERR_IO;
+        }
+    }
+    
+    free(sums.crcs);
+    return TODO_OK;
+}
+
+/**
+ * @brief Encode a todo in the packed payload layout
+ * @param dest Destination (PACKED_RECORD_MAX bytes)
+ * @param todo Todo to encode
+ * @param strings String arena the todo references
+ * @param previous Previously encoded todo (NULL for the first)
+ * @return Bytes written
+ */
+static size_t encode_packed(unsigned char* dest, const Todo* todo, const char* strings, const Todo* previous) {
+    int64_t last_id = previous ? previous->id : 0;
+    int64_t last_created = previous ? previous->created_at : 0;
+    size_t length = codec_put_varint(dest, codec_zigzag((int64_t)todo->id - last_id));
+    dest[length++] = (unsigned char)(todo->priority | todo->status << 2 | (todo->due_at != 0 ? PACKED_HAS_DUE : 0));
+    length += codec_put_varint(dest + length, codec_zigzag(todo->created_at - last_created));
+    length += codec_put_varint(dest + length, codec_zigzag(todo->updated_at - todo->created_at));
+    if (todo->due_at != 0) {
+        length += codec_put_varint(dest + length, codec_zigzag(todo->due_at - todo->created_at));
+    }
+    
+    length += codec_put_varint(dest + length, todo->title_length);
+    memcpy(dest + length, strings + todo->text_offset, todo->title_length);
+    length += todo->title_length;
+    length += codec_put_varint(dest + length, todo->desc_length);
+    memcpy(dest + length, strings + todo->text_offset + todo->title_length + 1, todo->desc_length);
+    return length + todo->desc_length;
+}
+
+/**
+ * @brief Compress and write the current block of a packed payload
+ * @param writer Payload writer with at least one byte in its block
+ * @return TODO_OK on success, TODO_ERR_IO on failure
+ */
+static int flush_packed_block(PackWriter* writer) {
+    // Only output smaller than the block is kept; anything else is stored raw
+    size_t stored = codec_lz_compress(writer->block, writer->filled, writer->packed, writer->filled - 1);
+    const unsigned char* bytes = stored > 0 ? writer->packed : writer->block;
+    if (stored == 0) {
+        stored = writer->filled;
+    }
+    
+    unsigned char frame[SNAPSHOT_FRAME_HEADER_SIZE];
+    codec_put_u32(frame, (uint32_t)stored);
+    codec_put_u32(frame + 4, codec_crc32(0, bytes, stored));
+    writer->filled = 0;
+    if (fwrite(frame, sizeof(frame), 1, writer->file) != 1 || fwrite(bytes, 1, stored, writer->file) != stored) {
+        return TODO_ERR_IO;
+    }
+    return TODO_OK;
+}
+
+/**
+ * @brief Append payload bytes, writing out every block they complete
+ * @param writer Payload writer
+ * @param data Payload bytes
+ * @param length Number of bytes
+ * @return TODO_OK on success, TODO_ERR_IO on failure
+ */
+static int write_packed_bytes(PackWriter* writer, const unsigned char* data, size_t length) {
+    while (length > 0) {
+        size_t take = SNAPSHOT_PACKED_BLOCK_SIZE - writer->filled;
+        if (take > length) {
+            take = length;
+        }
+        memcpy(writer->block + writer->filled, data, take);
+        writer->filled += take;
+        data += take;
+        length -= take;
+        
+        if (writer->filled == SNAPSHOT_PACKED_BLOCK_SIZE && flush_packed_block(writer) != TODO_OK) {
+            return TODO_ERR_IO;
+        }
+    }
+    return TODO_OK;
+}
+
+/**
+ * @brief Write the list to an open file in the packed snapshot format
+ *
+ * A first pass sizes the payload so the header can be written up front;
+ * the second encodes todos into blocks and compresses each one as it
+ * fills, so memory use does not depend on the size of the list.
+ *
+ * @param list Pointer to the todo list
+ * @param file File opened for binary writing
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int write_packed_snapshot(const TodoList* list, FILE* file) {
+    unsigned char record[PACKED_RECORD_MAX];
+    uint64_t payload_size = 0;
+    const Todo* previous = NULL;
+    for (int slot = 0; slot < list->used; slot++) {
+        const Todo* todo = &list->todos[slot];
+        if (todo->id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        
+        payload_size += encode_packed(record, todo, list->strings, previous);
+        previous = todo;
+    }
+    
+    unsigned char header[SNAPSHOT_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+    codec_put_u32(header + 8, SNAPSHOT_PACKED_VERSION);
+    codec_put_u32(header + 16, (uint32_t)list->count);
+    codec_put_u32(header + 20, (uint32_t)list->next_id);
+    codec_put_u64(header + 24, payload_size);
+    codec_put_u32(header + 32, SNAPSHOT_PACKED_BLOCK_SIZE);
+    codec_put_u32(header + 44, codec_crc32(0, header, SNAPSHOT_HEADER_SIZE - 4));
+    if (fwrite(header, sizeof(header), 1, file) != 1) {
+        return TODO_ERR_IO;
+    }
+    
+    PackWriter writer = {file, NULL, 0, NULL};
+    writer.block = (unsigned char*)malloc(SNAPSHOT_PACKED_BLOCK_SIZE);
+    writer.packed = (unsigned char*)malloc(SNAPSHOT_PACKED_BLOCK_SIZE);
+    if (!writer.block || !writer.packed) {
+        free(writer.block);
+        free(writer.packed);
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    int result = TODO_OK;
+    previous = NULL;
+    for (int slot = 0; slot < list->used && result == TODO_OK; slot++) {
+        const Todo* todo = &list->todos[slot];
+        if (todo->id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        
+        size_t length = encode_packed(record, todo, list->strings, previous);
+        result = write_packed_bytes(&writer, record, length);
+        previous = todo;
+    }
+    if (result == TODO_OK && writer.filled > 0) {
+        result = flush_packed_block(&writer);
+    }
+    
+    free(writer.block);
+    free(writer.packed);
+    return result;
+}
+
+/**
+ * @brief Keep the current generation of a file as its backup
+ *
+ * The backup is a hard link to the existing file, so no data is copied;
+ * the rename that installs the new generation then leaves it as the only
+ * name for the old one. File systems without hard links fall back to a
+ * copy, which still keeps a complete todos.dat in place at every moment.
+ *
+ * @param filename Name of the file about to be replaced
+ * @param backup_filename Name of the backup
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int keep_previous_generation(const char* filename, const char* backup_filename) {
+    remove(backup_filename);
+    
+#ifdef _WIN32
+    if (CreateHardLinkA(backup_filename, filename, NULL)) {
+#else
+    if (link(filename, backup_filename) == 0) {
 #endif
+        return TODO_OK;
+    }
+    
+    return create_backup(filename);
+}
+
+/**
+ * @brief Atomically move a fully written file over its destination
+ * @param source Name of the temporary file
+ * @param dest Name of the file to replace
+ * @return TODO_OK on success, TODO_ERR_IO on failure
+ */
+int file_replace(const char* source, const char* dest) {
+#ifdef _WIN32
+    if (!MoveFileExA(source, dest, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        return TODO_ERR_IO;
+    }
+#else
+    if (rename(source, dest) != 0) {
+        return TODO_ERR_IO;
+    }
+    
+    // Make the rename itself durable; not every file system supports this
+    char directory[512] = ".";
+    const char* slash = strrchr(dest, '/');
+    size_t length = slash == dest ? 1 : (size_t)(slash - dest);
+    if (slash && length < sizeof(directory)) {
+        memcpy(directory, dest, length);
+        directory[length] = '\0';
+    }
+    int fd = open(directory, O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#endif
+    
+    return TODO_OK;
+}
+
+/**
+ * @brief Check whether a file holds a packed snapshot
+ * @param filename Name of the file
+ * @return 1 if filename starts with a packed snapshot header, 0 otherwise
+ */
+static int file_is_packed(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return 0;
+    }
+    
+    unsigned char magic[SNAPSHOT_MAGIC_SIZE + 4];
+    int packed = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                 memcmp(magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) == 0 &&
+                 codec_get_u32(magic + SNAPSHOT_MAGIC_SIZE) == SNAPSHOT_PACKED_VERSION;
+    fclose(file);
+    return packed;
+}
 
 /**
- * @brief Ensure data directory exists
- * @return 0 on success, -1 on failure
+ * @brief Save todo list to a binary file
+ * @param list Pointer to the todo list to save
+ * @param filename Name of the file to save to (NULL for default)
+ * @return TODO_OK on success, negative TodoError on failure
  */
-int ensure_data_directory(void) {
-    // Check if data directory exists
-    FILE* test = fopen("data/.", "r");
-    if (test) {
-        fclose(test);
-        return 0; // Directory exists
+int save_todos_to_file(const TodoList* list, const char* filename) {
+    return save_todos_to_file_ex(list, filename, 0);
+}
+
+/**
+ * @brief Write a snapshot and swap it in for the live file
+ * @param list Pointer to the todo list to save
+ * @param filename Name of the file to save to (NULL for default)
+ * @param flags TODO_SAVE_COMPRESS, TODO_SAVE_UNCOMPRESSED or 0 to keep the file's encoding
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int save_file(const TodoList* list, const char* filename, int flags) {
+    if (!list) {
+        todo_log(TODO_LOG_ERROR, "Invalid todo list");
+        return TODO_ERR_INVALID;
+    }
+    
+    const char* file_to_use = filename ? filename : DEFAULT_FILENAME;
+    
+    // Ensure the directory of the file exists
+    if (ensure_parent_directory(file_to_use) != TODO_OK) {
+        todo_log(TODO_LOG_WARNING, "Could not create the directory of '%s'", file_to_use);
     }
     
-    // Try to create the directory
 #ifdef _WIN32
-    if (_mkdir(DATA_DIR) == 0) {
-#else
-    if (mkdir(DATA_DIR, 0755) == 0) {
+    // Windows cannot replace a file while a view of it is mapped
+    if (list_maps_file(list, file_to_use)) {
+        todo_log(TODO_LOG_ERROR, "'%s' is mapped by the list; call todo_list_make_writable first",
+                 file_to_use);
+        return TODO_ERR_INVALID;
+    }
 #endif
-        return 0; // Successfully created
+    
+    char temp_filename[512], backup_filename[512];
+    if (snprintf(temp_filename, sizeof(temp_filename), "%s%s", file_to_use, TEMP_SUFFIX) >= (int)sizeof(temp_filename) ||
+        snprintf(backup_filename, sizeof(backup_filename), "%s%s", file_to_use, BACKUP_SUFFIX) >= (int)sizeof(backup_filename)) {
+        todo_log(TODO_LOG_ERROR, "File name '%s' is too long", file_to_use);
+        return TODO_ERR_INVALID;
     }
     
-    // Directory might already exist, try to verify
-    test = fopen("data/.", "r");
-    if (test) {
-        fclose(test);
-        return 0;
+    int packed = (flags & TODO_SAVE_COMPRESS) != 0;
+    if (!(flags & (TODO_SAVE_COMPRESS | TODO_SAVE_UNCOMPRESSED))) {
+        packed = file_is_packed(file_to_use);
+    }
+    
+    // Write the new generation next to the live file, which stays untouched
+    FILE* file = fopen(temp_filename, "wb");
+    if (!file) {
+        todo_log(TODO_LOG_ERROR, "Unable to open file '%s' for writing", temp_filename);
+        return TODO_ERR_IO;
+    }
+    
+    int result = packed ? write_packed_snapshot(list, file) : write_snapshot(list, file);
+    if (result != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Failed to write todos to '%s'", temp_filename);
+        fclose(file);
+        remove(temp_filename);
+        return result;
+    }
+    
+    if (fflush(file) != 0 || file_sync(file) != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Failed to flush '%s' to disk", temp_filename);
+        fclose(file);
+        remove(temp_filename);
+        return TODO_ERR_IO;
+    }
+    TODO_METRICS_WRITTEN(ftell(file) > 0 ? ftell(file) : 0);
+    if (fclose(file) != 0) {
+        remove(temp_filename);
+        return TODO_ERR_IO;
+    }
+    
+    if (file_exists(file_to_use) && keep_previous_generation(file_to_use, backup_filename) != TODO_OK) {
+        todo_log(TODO_LOG_WARNING, "Could not keep a backup of '%s'", file_to_use);
+    }
+    
+    if (file_replace(temp_filename, file_to_use) != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Unable to replace '%s'", file_to_use);
+        remove(temp_filename);
+        return TODO_ERR_IO;
+    }
+    
+    // The snapshot now includes every journaled change, so drop the log
+    char log_filename[512];
+    if (journal_log_path(file_to_use, log_filename, sizeof(log_filename)) == TODO_OK &&
+        file_exists(log_filename)) {
+        remove(log_filename);
     }
     
-    return -1; // Failed to create directory
+    return TODO_OK;
 }
 
 /**
- * @brief Save todo list to a binary file
+ * @brief Save todo list to a binary file, choosing its encoding
  * @param list Pointer to the todo list to save
  * @param filename Name of the file to save to (NULL for default)
- * @return 0 on success, -1 on failure
+ * @param flags TODO_SAVE_COMPRESS, TODO_SAVE_UNCOMPRESSED or 0 to keep the file's encoding
+ * @return TODO_OK on success, negative TodoError on failure
  */
-int save_todos_to_file(const TodoList* list, const char* filename) {
-    if (!list) {
-        fprintf(stderr, "Error: Invalid todo list\n");
-        return -1;
+int save_todos_to_file_ex(const TodoList* list, const char* filename, int flags) {
+    TODO_METRICS_BEGIN(TODO_METRIC_SAVE, start);
+    int result = save_file(list, filename, flags);
+    TODO_METRICS_END(TODO_METRIC_SAVE, start);
+    return result;
+}
+
+/**
+ * @brief Load a snapshot by pointing the list straight at a mapping of it
+ *
+ * Only called for current-version files on hosts where records are
+ * native. The record checksums are always verified, since building the
+ * index reads every record anyway; the text is checksummed only with
+ * TODO_LOAD_VERIFY so that it can stay paged out.
+ *
+ * @param list Pointer to the todo list to load into
+ * @param filename Name of the snapshot file
+ * @param flags Bitwise OR of TODO_LOAD_* flags
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int map_snapshot(TodoList* list, const char* filename, int flags) {
+    FileMapping* mapping = file_map(filename);
+    if (!mapping) {
+        todo_log(TODO_LOG_ERROR, "Unable to map '%s'", filename);
+        return TODO_ERR_IO;
     }
+    TODO_METRICS_READ(mapping->size);
+    
+    SnapshotHeader header = {0};
+    unsigned char* data = (unsigned char*)mapping->data;
+    size_t header_bytes = mapping->size < SNAPSHOT_HEADER_SIZE ? mapping->size : SNAPSHOT_HEADER_SIZE;
+    int result = decode_header(data, header_bytes, &header);
     
-    // Ensure data directory exists
-    if (ensure_data_directory() != 0) {
-        fprintf(stderr, "Warning: Could not create data directory\n");
+    uint64_t records_size = (uint64_t)header.count * header.record_size;
+    uint64_t strings_start = header.header_size + records_size;
+    uint64_t checksums_start = strings_start + header.strings_size;
+    if (result == TODO_OK && checksums_start + checksums_size(&header) > mapping->size) {
+        todo_log(TODO_LOG_ERROR, "Snapshot '%s' is truncated", filename);
+        result = TODO_ERR_CORRUPT;
     }
     
-    const char* file_to_use = filename ? filename : DEFAULT_FILENAME;
+    Todo* todos = (Todo*)(data + header.header_size);
+    char* strings = (char*)(data + strings_start);
+    const unsigned char* checksums = data + checksums_start;
+    if (result == TODO_OK) {
+        result = verify_blocks(todos, records_size, header.block_size, checksums);
+    }
+    if (result == TODO_OK && (flags & TODO_LOAD_VERIFY)) {
+        result = verify_blocks(strings, header.strings_size, header.block_size,
+                               checksums + 4 * block_count(records_size, header.block_size));
+    }
+    if (result == TODO_OK) {
+        result = validate_records(todos, (int)header.count, 0, strings, (size_t)header.strings_size);
+    }
     
-    // Create backup before saving
-    if (file_exists(file_to_use)) {
-        create_backup(file_to_use);
+    if (result != TODO_OK) {
+        release_mapping(mapping);
+        return result;
     }
     
-    FILE* file = fopen(file_to_use, "wb");
-    if (!file) {
-        fprintf(stderr, "Error: Unable to open file '%s' for writing\n", file_to_use);
-        return -1;
+    return todo_list_attach(list, todos, (int)header.count, strings, (size_t)header.strings_size,
+                            (int)header.next_id, mapping, release_mapping);
+}
+
+/**
+ * @brief Check and expand one task's share of the blocks of a payload
+ * @param arg The UnpackJob
+ * @param task Task number
+ */
+static void unpack_task(void* arg, int task) {
+    UnpackJob* job = (UnpackJob*)arg;
+    size_t blocks = block_count(job->size, job->block_size);
+    size_t first = (size_t)task * job->blocks_per_task;
+    size_t last = blocks - first > job->blocks_per_task ? first + job->blocks_per_task : blocks;
+    job->bad_blocks[task] = -1;
+    for (size_t i = first; i < last; i++) {
+        uint64_t start = (uint64_t)i * job->block_size;
+        size_t length = job->size - start < job->block_size ? (size_t)(job->size - start) : job->block_size;
+        const unsigned char* frame = job->frames[i];
+        size_t stored = codec_get_u32(frame - SNAPSHOT_FRAME_HEADER_SIZE);
+        
+        int valid = codec_crc32(0, frame, stored) == codec_get_u32(frame - 4);
+        if (valid && stored == length) {
+            memcpy(job->payload + start, frame, length);
+        } else if (valid) {
+            valid = codec_lz_decompress(frame, stored, job->payload + start, length) == 0;
+        }
+        if (!valid) {
+            job->bad_blocks[task] = (long)i;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Decode a packed payload into todos and a string arena
+ * @param payload Expanded payload
+ * @param size Payload size
+ * @param todos Receives count todos
+ * @param count Number of todos the header announced
+ * @param strings Receives the text (at least size bytes)
+ * @param strings_size Receives the size of the string arena
+ * @return TODO_OK on success, TODO_ERR_CORRUPT if the payload is malformed
+ */
+static int parse_packed(const unsigned char* payload, size_t size, Todo* todos, int count,
+                        char* strings, size_t* strings_size) {
+    size_t in = 0;
+    size_t out = 0;
+    int64_t id = 0;
+    int64_t created = 0;
+    for (int i = 0; i < count; i++) {
+        uint64_t fields[6] = {0};
+        size_t used;
+        
+        // Id delta, status byte, then the created, updated and due deltas
+        if (!(used = codec_get_varint(payload + in, size - in, &fields[0])) || size - in - used < 1) {
+            return TODO_ERR_CORRUPT;
+        }
+        in += used;
+        unsigned char state = payload[in++];
+        int deltas = state & PACKED_HAS_DUE ? 4 : 3;
+        for (int field = 1; field < deltas; field++) {
+            if (!(used = codec_get_varint(payload + in, size - in, &fields[field]))) {
+                return TODO_ERR_CORRUPT;
+            }
+            in += used;
+        }
+        id += codec_unzigzag(fields[0]);
+        created += codec_unzigzag(fields[1]);
+        
+        Todo* todo = &todos[i];
+        todo->id = (int32_t)id;
+        todo->priority = (uint8_t)(state & 3);
+        todo->status = (uint8_t)((state & ~PACKED_HAS_DUE) >> 2);
+        todo->flags = 0;
+        todo->text_offset = (uint32_t)out;
+        todo->created_at = created;
+        todo->updated_at = created + codec_unzigzag(fields[2]);
+        todo->due_at = state & PACKED_HAS_DUE ? created + codec_unzigzag(fields[3]) : 0;
+        if (id <= 0 || id > INT_MAX || todo->priority < PRIORITY_LOW || todo->priority > PRIORITY_HIGH ||
+            todo->status > STATUS_COMPLETED || todo->due_at < 0 || out > UINT32_MAX) {
+            todo_log(TODO_LOG_ERROR, "Corrupt todo record at position %d", i);
+            return TODO_ERR_CORRUPT;
+        }
+        
+        // Title and description, each terminated in the arena
+        uint64_t limits[2] = {MAX_TITLE_LENGTH, MAX_DESC_LENGTH};
+        for (int text = 0; text < 2; text++) {
+            if (!(used = codec_get_varint(payload + in, size - in, &fields[4 + text])) ||
+                fields[4 + text] >= limits[text] || fields[4 + text] > size - in - used) {
+                todo_log(TODO_LOG_ERROR, "Corrupt todo record at position %d", i);
+                return TODO_ERR_CORRUPT;
+            }
+            in += used;
+            memcpy(strings + out, payload + in, (size_t)fields[4 + text]);
+            in += (size_t)fields[4 + text];
+            out += (size_t)fields[4 + text];
+            strings[out++] = '\0';
+        }
+        todo->title_length = (uint16_t)fields[4];
+        todo->desc_length = (uint16_t)fields[5];
     }
     
-    // Write header information
-    if (fwrite(&list->count, sizeof(int), 1, file) != 1 ||
-        fwrite(&list->next_id, sizeof(int), 1, file) != 1) {
-        fprintf(stderr, "Error: Failed to write header to file\n");
-        fclose(file);
-        return -1;
+    if (in != size) {
+        todo_log(TODO_LOG_ERROR, "Snapshot payload has %lu trailing bytes", (unsigned long)(size - in));
+        return TODO_ERR_CORRUPT;
+    }
+    *strings_size = out;
+    return TODO_OK;
+}
+
+/**
+ * @brief Load a packed snapshot
+ *
+ * The stored blocks are read in one go, then checked and expanded on
+ * several threads before the payload is decoded into the list.
+ *
+ * @param list Pointer to the todo list to load into
+ * @param file Snapshot file, positioned after its header
+ * @param header Decoded header
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int read_packed(TodoList* list, FILE* file, const SnapshotHeader* header) {
+    size_t size = (size_t)header->strings_size;
+    size_t blocks = block_count(size, header->block_size);
+    
+    // Every block is stored at most at its own size
+    size_t capacity = size + blocks * SNAPSHOT_FRAME_HEADER_SIZE;
+    unsigned char* stored = (unsigned char*)malloc(capacity > 0 ? capacity : 1);
+    unsigned char* payload = (unsigned char*)malloc(size > 0 ? size : 1);
+    const unsigned char** frames = (const unsigned char**)malloc(sizeof(*frames) * (blocks > 0 ? blocks : 1));
+    
+    // The arena holds the text plus two terminators, never more than the payload
+    Todo* todos = (Todo*)malloc(sizeof(Todo) * (header->count > 0 ? header->count : 1));
+    char* strings = (char*)malloc(size > 0 ? size : 1);
+    if (!stored || !payload || !frames || !todos || !strings) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed while loading");
+        free(stored);
+        free(payload);
+        free(frames);
+        free(todos);
+        free(strings);
+        return TODO_ERR_NO_MEMORY;
     }
     
-    // Write todo items
-    if (list->count > 0) {
-        if (fwrite(list->todos, sizeof(Todo), list->count, file) != (size_t)list->count) {
-            fprintf(stderr, "Error: Failed to write todos to file\n");
-            fclose(file);
-            return -1;
+    // Locate the blocks; together they must fill the rest of the file exactly
+    size_t length = fread(stored, 1, capacity, file);
+    size_t offset = 0;
+    int result = TODO_OK;
+    for (size_t i = 0; i < blocks && result == TODO_OK; i++) {
+        size_t expanded = i + 1 < blocks ? header->block_size : size - i * header->block_size;
+        size_t frame_size = length - offset < SNAPSHOT_FRAME_HEADER_SIZE ? 0 :
+                            codec_get_u32(stored + offset);
+        if (length - offset < SNAPSHOT_FRAME_HEADER_SIZE || frame_size == 0 || frame_size > expanded ||
+            frame_size > length - offset - SNAPSHOT_FRAME_HEADER_SIZE) {
+            result = TODO_ERR_CORRUPT;
+            break;
         }
+        frames[i] = stored + offset + SNAPSHOT_FRAME_HEADER_SIZE;
+        offset += SNAPSHOT_FRAME_HEADER_SIZE + frame_size;
+    }
+    if (result != TODO_OK || offset != length || fgetc(file) != EOF) {
+        todo_log(TODO_LOG_ERROR, "Snapshot is truncated or has trailing data");
+        result = TODO_ERR_CORRUPT;
     }
     
-    fclose(file);
-    printf("Successfully saved %d todos to '%s'\n", list->count, file_to_use);
-    return 0;
+    if (result == TODO_OK && blocks > 0) {
+        size_t blocks_per_task = LOAD_TASK_BYTES / header->block_size;
+        if (blocks_per_task == 0) {
+            blocks_per_task = 1;
+        }
+        int tasks = (int)((blocks + blocks_per_task - 1) / blocks_per_task);
+        
+        long single = -1;
+        UnpackJob job = {frames, payload, size, header->block_size, blocks_per_task, &single};
+        if (tasks > 1 && !(job.bad_blocks = (long*)malloc(sizeof(long) * tasks))) {
+            // Fall back to one task covering every block
+            job.bad_blocks = &single;
+            job.blocks_per_task = blocks;
+            tasks = 1;
+        }
+        todo_parallel_run(tasks, unpack_task, &job);
+        
+        for (int task = 0; task < tasks; task++) {
+            if (job.bad_blocks[task] >= 0) {
+                todo_log(TODO_LOG_ERROR, "Checksum mismatch in snapshot block %lu", (unsigned long)job.bad_blocks[task]);
+                result = TODO_ERR_CORRUPT;
+                break;
+            }
+        }
+        if (job.bad_blocks != &single) {
+            free(job.bad_blocks);
+        }
+    }
+    free(stored);
+    free(frames);
+    
+    size_t strings_size = 0;
+    if (result == TODO_OK) {
+        result = parse_packed(payload, size, todos, (int)header->count, strings, &strings_size);
+    }
+    free(payload);
+    
+    if (result != TODO_OK) {
+        free(todos);
+        free(strings);
+        return result;
+    }
+    
+    // Give back the slack left by the length prefixes
+    if (strings_size < size) {
+        char* shrunk = (char*)realloc(strings, strings_size > 0 ? strings_size : 1);
+        if (shrunk) {
+            strings = shrunk;
+        }
+    }
+    if (header->count == 0) {
+        free(todos);
+        todos = NULL;
+    }
+    if (strings_size == 0) {
+        free(strings);
+        strings = NULL;
+    }
+    
+    return todo_list_attach(list, todos, (int)header->count, strings, strings_size,
+                            (int)header->next_id, NULL, NULL);
+}
+
+/**
+ * @brief Load a snapshot with one bulk read per region
+ *
+ * On little-endian hosts current records are read straight into the todo
+ * array; elsewhere, and for records of older versions, they are decoded
+ * in place afterwards.
+ *
+ * @param list Pointer to the todo list to load into
+ * @param file Snapshot file, positioned at its start
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int read_snapshot(TodoList* list, FILE* file) {
+    unsigned char bytes[SNAPSHOT_HEADER_SIZE];
+    size_t length = fread(bytes, 1, SNAPSHOT_V1_HEADER_SIZE, file);
+    if (length == SNAPSHOT_V1_HEADER_SIZE && codec_get_u32(bytes + 8) >= 2) {
+        length += fread(bytes + length, 1, SNAPSHOT_HEADER_SIZE - length, file);
+    }
+    
+    SnapshotHeader header;
+    if (decode_header(bytes, length, &header) != TODO_OK) {
+        return TODO_ERR_CORRUPT;
+    }
+    if (header.version == SNAPSHOT_PACKED_VERSION) {
+        return read_packed(list, file, &header);
+    }
+    
+    uint64_t records_size = (uint64_t)header.count * header.record_size;
+    size_t table_size = (size_t)checksums_size(&header);
+    Todo* todos = NULL;
+    char* strings = NULL;
+    unsigned char* checksums = NULL;
+    if (header.count > 0) {
+        todos = (Todo*)malloc(sizeof(Todo) * header.count);
+    }
+    if (header.strings_size > 0) {
+        strings = (char*)malloc((size_t)header.strings_size);
+    }
+    if (table_size > 0) {
+        checksums = (unsigned char*)malloc(table_size);
+    }
+    if ((header.count > 0 && !todos) || (header.strings_size > 0 && !strings) ||
+        (table_size > 0 && !checksums)) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed while loading");
+        free(todos);
+        free(strings);
+        free(checksums);
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    int result = TODO_OK;
+    if ((todos && fread(todos, header.record_size, header.count, file) != header.count) ||
+        (strings && fread(strings, 1, (size_t)header.strings_size, file) != header.strings_size) ||
+        (checksums && fread(checksums, 1, table_size, file) != table_size)) {
+        todo_log(TODO_LOG_ERROR, "Snapshot is truncated");
+        result = TODO_ERR_CORRUPT;
+    }
+    
+    if (result == TODO_OK && checksums) {
+        result = verify_blocks(todos, records_size, header.block_size, checksums);
+        if (result == TODO_OK) {
+            result = verify_blocks(strings, header.strings_size, header.block_size,
+                                   checksums + 4 * block_count(records_size, header.block_size));
+        }
+    }
+    free(checksums);
+    
+    // Records the size of a Todo are decoded in place while validating.
+    // Otherwise decode back to front: a Todo is then larger than its
+    // record, so writing todos[i] only overwrites records already decoded
+    int decode = !records_are_native() || header.record_size != SNAPSHOT_RECORD_SIZE;
+    if (result == TODO_OK && decode && sizeof(Todo) != header.record_size) {
+        for (uint32_t i = header.count; i-- > 0;) {
+            unsigned char record[SNAPSHOT_RECORD_SIZE];
+            memcpy(record, (unsigned char*)todos + (size_t)i * header.record_size, header.record_size);
+            decode_record(&todos[i], record, header.record_size);
+        }
+        decode = 0;
+    }
+    
+    if (result == TODO_OK) {
+        result = validate_records(todos, (int)header.count, decode, strings, (size_t)header.strings_size);
+    }
+    
+    if (result != TODO_OK) {
+        free(todos);
+        free(strings);
+        return result;
+    }
+    
+    return todo_list_attach(list, todos, (int)header.count, strings, (size_t)header.strings_size,
+                            (int)header.next_id, NULL, NULL);
+}
+
+/**
+ * @brief Load a file in the legacy fixed-size record format
+ * @param list Pointer to the todo list to load into
+ * @param file Legacy file, positioned at its start
+ * @param filename Name of the file (for diagnostics)
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int read_legacy(TodoList* list, FILE* file, const char* filename) {
+    // Read header information
+    int saved_count, saved_next_id;
+    if (fread(&saved_count, sizeof(int), 1, file) != 1 ||
+        fread(&saved_next_id, sizeof(int), 1, file) != 1) {
+        todo_log(TODO_LOG_ERROR, "Failed to read header from file");
+        return TODO_ERR_CORRUPT;
+    }
+    
+    // The records must fit in the file before anything is reserved for them
+    long data_start = ftell(file);
+    long file_size = -1;
+    if (data_start >= 0 && fseek(file, 0, SEEK_END) == 0) {
+        file_size = ftell(file);
+    }
+    if (file_size < data_start || fseek(file, data_start, SEEK_SET) != 0) {
+        todo_log(TODO_LOG_ERROR, "Unable to read the size of '%s'", filename);
+        return TODO_ERR_IO;
+    }
+    long max_count = (file_size - data_start) / (long)sizeof(TodoRecord);
+    
+    // Validate data
+    if (saved_count < 0 || saved_count > max_count || saved_next_id < 1 ||
+        saved_next_id - 1 - saved_count > LEGACY_MAX_ID_GAP) {
+        todo_log(TODO_LOG_ERROR, "Invalid header in file (count %d, next ID %d)",
+                saved_count, saved_next_id);
+        return TODO_ERR_CORRUPT;
+    }
+    
+    todo_list_clear(list);
+    
+    // Read todo items in batches, converting them to the in-memory layout
+    if (saved_count > 0) {
+        TodoRecord* records = (TodoRecord*)malloc(sizeof(TodoRecord) * RECORD_BATCH_SIZE);
+        if (!records || todo_list_reserve(list, saved_count) != 0) {
+            todo_log(TODO_LOG_ERROR, "Memory allocation failed while loading");
+            free(records);
+            return TODO_ERR_NO_MEMORY;
+        }
+        
+        for (int start = 0; start < saved_count; start += RECORD_BATCH_SIZE) {
+            int batch = saved_count - start < RECORD_BATCH_SIZE ? saved_count - start : RECORD_BATCH_SIZE;
+            if (fread(records, sizeof(TodoRecord), batch, file) != (size_t)batch) {
+                todo_log(TODO_LOG_ERROR, "Failed to read todos from file");
+                free(records);
+                todo_list_clear(list);
+                return TODO_ERR_CORRUPT;
+            }
+            
+            for (int i = 0; i < batch; i++) {
+                TodoRecord* record = &records[i];
+                record->title[MAX_TITLE_LENGTH - 1] = '\0';
+                record->description[MAX_DESC_LENGTH - 1] = '\0';
+                if (record->id < 1 || record->id >= saved_next_id ||
+                    todo_restore(list, record->id, record->title, record->description,
+                                 record->priority, record->status,
+                                 record->created_at, record->updated_at) != 0) {
+                    todo_log(TODO_LOG_ERROR, "Corrupt todo data in '%s'", filename);
+                    free(records);
+                    todo_list_clear(list);
+                    return TODO_ERR_CORRUPT;
+                }
+            }
+        }
+        
+        free(records);
+    }
+    
+    if (saved_next_id > list->next_id) {
+        list->next_id = saved_next_id;
+    }
+    
+    return TODO_OK;
 }
 
 /**
  * @brief Load todo list from a binary file
  * @param list Pointer to the todo list to load into
  * @param filename Name of the file to load from (NULL for default)
- * @return 0 on success, -1 on failure
+ * @return TODO_OK on success, negative TodoError on failure
  */
 int load_todos_from_file(TodoList* list, const char* filename) {
+    return load_todos_from_file_ex(list, filename, 0);
+}
+
+/**
+ * @brief Read a snapshot in any format, then replay its journal
+ * @param list Pointer to the todo list to load into
+ * @param filename Name of the file to load from (NULL for default)
+ * @param flags Bitwise OR of TODO_LOAD_* flags
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int load_file(TodoList* list, const char* filename, int flags) {
     if (!list) {
-        fprintf(stderr, "Error: Invalid todo list\n");
-        return -1;
+        todo_log(TODO_LOG_ERROR, "Invalid todo list");
+        return TODO_ERR_INVALID;
     }
     
     const char* file_to_use = filename ? filename : DEFAULT_FILENAME;
     
+    char log_filename[512];
+    if (journal_log_path(file_to_use, log_filename, sizeof(log_filename)) != TODO_OK) {
+        return TODO_ERR_INVALID;
+    }
+    
     if (!file_exists(file_to_use)) {
-        printf("No existing todo file found. Starting with empty list.\n");
-        return 0; // Not an error, just no existing data
+        // Changes may have been journaled before the first snapshot was taken
+        if (!file_exists(log_filename)) {
+            return TODO_OK; // Not an error, just no existing data
+        }
+        todo_list_clear(list);
+        return journal_replay(list, log_filename);
     }
     
     FILE* file = fopen(file_to_use, "rb");
     if (!file) {
-        fprintf(stderr, "Error: Unable to open file '%s' for reading\n", file_to_use);
-        return -1;
+        todo_log(TODO_LOG_ERROR, "Unable to open file '%s' for reading", file_to_use);
+        return TODO_ERR_IO;
     }
     
-    // Read header information
-    int saved_count, saved_next_id;
-    if (fread(&saved_count, sizeof(int), 1, file) != 1 ||
-        fread(&saved_next_id, sizeof(int), 1, file) != 1) {
-        fprintf(stderr, "Error: Failed to read header from file\n");
+    // Tell the snapshot format from the legacy one by its magic
+    unsigned char magic[SNAPSHOT_MAGIC_SIZE + 4];
+    int is_snapshot = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                      memcmp(magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) == 0;
+    uint32_t version = is_snapshot ? codec_get_u32(magic + SNAPSHOT_MAGIC_SIZE) : 0;
+    rewind(file);
+    
+    int result;
+    if (version == SNAPSHOT_VERSION && (flags & TODO_LOAD_MAP) && records_are_native()) {
         fclose(file);
-        return -1;
+        file = NULL;
+        result = map_snapshot(list, file_to_use, flags);
+    } else if (is_snapshot) {
+        result = read_snapshot(list, file);
+    } else {
+        result = read_legacy(list, file, file_to_use);
     }
     
-    // Validate data
-    if (saved_count < 0 || saved_count > MAX_TODOS) {
-        fprintf(stderr, "Error: Invalid todo count in file (%d)\n", saved_count);
+    if (file) {
+        TODO_METRICS_READ(ftell(file) > 0 ? ftell(file) : 0);
         fclose(file);
-        return -1;
+    }
+    if (result != TODO_OK) {
+        return result;
     }
     
-    // Read todo items
-    if (saved_count > 0) {
-        if (fread(list->todos, sizeof(Todo), saved_count, file) != (size_t)saved_count) {
-            fprintf(stderr, "Error: Failed to read todos from file\n");
-            fclose(file);
-            return -1;
-        }
+    // Apply changes journaled since the snapshot was written
+    result = journal_replay(list, log_filename);
+    if (result != TODO_OK) {
+        todo_list_clear(list);
+        return result;
     }
     
-    list->count = saved_count;
-    list->next_id = saved_next_id;
+    // Rewrite older formats once they have been read successfully; the
+    // previous file is kept as the backup. Packed snapshots are current
+    if (version != SNAPSHOT_VERSION && version != SNAPSHOT_PACKED_VERSION) {
+        if (save_todos_to_file(list, file_to_use) == TODO_OK) {
+            todo_log(TODO_LOG_INFO, "Upgraded '%s' to snapshot format version %d",
+                     file_to_use, SNAPSHOT_VERSION);
+        } else {
+            todo_log(TODO_LOG_WARNING, "Could not upgrade '%s' to the current format", file_to_use);
+        }
+    }
     
-    fclose(file);
-    printf("Successfully loaded %d todos from '%s'\n", list->count, file_to_use);
-    return 0;
+    return TODO_OK;
 }
 
+/**
+ * @brief Load todo list from a binary file, optionally mapping it
+ * @param list Pointer to the todo list to load into
+ * @param filename Name of the file to load from (NULL for default)
+ * @param flags Bitwise OR of TODO_LOAD_* flags
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int load_todos_from_file_ex(TodoList* list, const char* filename, int flags) {
+    TODO_METRICS_BEGIN(TODO_METRIC_LOAD, start);
+    int result = load_file(list, filename, flags);
+    TODO_METRICS_END(TODO_METRIC_LOAD, start);
+    return result;
+}
 /**
  * @brief Export todo list to a human-readable text file
  * @param list Pointer to the todo list to export
  * @param filename Name of the text file to export to
- * @return 0 on success, -1 on failure
+ * @return TODO_OK on success, negative TodoError on failure
  */
 int export_todos_to_text(const TodoList* list, const char* filename) {
     if (!list || !filename) {
-        fprintf(stderr, "Error: Invalid parameters\n");
-        return -1;
+        todo_log(TODO_LOG_ERROR, "Invalid parameters");
+        return TODO_ERR_INVALID;
     }
     
     // Ensure data directory exists if filename starts with "data/"
     if (strncmp(filename, "data/", 5) == 0) {
         if (ensure_data_directory() != 0) {
-            fprintf(stderr, "Warning: Could not create data directory\n");
+            todo_log(TODO_LOG_WARNING, "Could not create data directory");
         }
     }
     
     FILE* file = fopen(filename, "w");
     if (!file) {
-        fprintf(stderr, "Error: Unable to open file '%s' for writing\n", filename);
-        return -1;
+        todo_log(TODO_LOG_ERROR, "Unable to open file '%s' for writing", filename);
+        return TODO_ERR_IO;
     }
     
-    fprintf(file, "=== TODO LIST EXPORT ===\n");
-    fprintf(file, "Export Date: %s\n", ctime(&(time_t){time(NULL)}));
-    fprintf(file, "Total Todos: %d\n\n", list->count);
+    // Format into one buffer so each item costs no stdio calls of its own
+    char storage[RENDER_BUFFER_SIZE];
+    RenderBuffer out;
+    render_init(&out, file, storage, sizeof(storage));
+    
+    render_string(&out, "=== TODO LIST EXPORT ===\nExport Date: ");
+    render_ctime(&out, (int64_t)time(NULL));
+    render_string(&out, "\n\nTotal Todos: ");
+    render_int(&out, list->count, 0);
+    render_string(&out, "\n\n");
     
     if (list->count == 0) {
-        fprintf(file, "No todos found.\n");
+        render_string(&out, "No todos found.\n");
     } else {
-        for (int i = 0; i < list->count; i++) {
+        for (int i = 0; i < list->used; i++) {
             const Todo* todo = &list->todos[i];
-            char created_str[26], updated_str[26];
-            
-            // Format timestamps
-            strcpy(created_str, ctime(&todo->created_at));
-            strcpy(updated_str, ctime(&todo->updated_at));
-            
-            // Remove newlines from ctime strings
-            created_str[24] = '\0';
-            updated_str[24] = '\0';
+            if (todo->id == TODO_TOMBSTONE_ID) {
+                continue;
+            }
             
-            fprintf(file, "--- Todo #%d ---\n", todo->id);
-            fprintf(file, "Title: %s\n", todo->title);
-            fprintf(file, "Description: %s\n", todo->description[0] ? todo->description : "(No description)");
-            fprintf(file, "Priority: %s\n", get_priority_string(todo->priority));
-            fprintf(file, "Status: %s\n", get_status_string(todo->status));
-            fprintf(file, "Created: %s\n", created_str);
-            fprintf(file, "Updated: %s\n", updated_str);
-            fprintf(file, "\n");
+            render_string(&out, "--- Todo #");
+            render_int(&out, todo->id, 0);
+            render_string(&out, " ---\nTitle: ");
+            render_append(&out, todo_get_title(list, todo), todo->title_length);
+            render_string(&out, "\nDescription: ");
+            if (todo->desc_length > 0) {
+                render_append(&out, todo_get_description(list, todo), todo->desc_length);
+            } else {
+                render_string(&out, "(No description)");
+            }
+            render_string(&out, "\nPriority: ");
+            render_string(&out, get_priority_string(todo->priority));
+            render_string(&out, "\nStatus: ");
+            render_string(&out, get_status_string(todo->status));
+            render_string(&out, "\nCreated: ");
+            render_ctime(&out, todo->created_at);
+            render_string(&out, "\nUpdated: ");
+            render_ctime(&out, todo->updated_at);
+            if (todo->due_at != 0) {
+                render_string(&out, "\nDue: ");
+                render_ctime(&out, todo->due_at);
+            }
+            render_string(&out, "\n\n");
         }
     }
     
-    fclose(file);
-    printf("Successfully exported todos to '%s'\n", filename);
-    return 0;
+    int result = render_flush(&out);
+    if (fclose(file) != 0) {
+        result = TODO_ERR_IO;
+    }
+    if (result != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Failed to write '%s'", filename);
+    }
+    return result;
+}
+
+/**
+ * @brief Writes one exported record into a render buffer
+ */
+typedef void (*RecordWriter)(RenderBuffer* out, const TodoList* list, const Todo* todo);
+
+/**
+ * @brief Append a string as a quoted JSON string literal
+ * @param out Render buffer
+ * @param text String bytes (UTF-8 is passed through)
+ * @param length Number of bytes
+ */
+static void render_json_string(RenderBuffer* out, const char* text, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+    render_append(out, "\"", 1);
+    
+    // Copy runs of plain bytes in one go and escape the rest
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        
+        render_append(out, text + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':  render_append(out, "\\\"", 2); break;
+            case '\\': render_append(out, "\\\\", 2); break;
+            case '\n': render_append(out, "\\n", 2); break;
+            case '\r': render_append(out, "\\r", 2); break;
+            case '\t': render_append(out, "\\t", 2); break;
+            default: {
+                char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                render_append(out, escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+    
+    render_append(out, text + run, length - run);
+    render_append(out, "\"", 1);
+}
+
+/**
+ * @brief Append a CSV field, quoting it only when needed
+ * @param out Render buffer
+ * @param text Field bytes
+ * @param length Number of bytes
+ */
+static void render_csv_field(RenderBuffer* out, const char* text, size_t length) {
+    if (length == 0 || strcspn(text, ",\"\r\n") >= length) {
+        render_append(out, text, length);
+        return;
+    }
+    
+    render_append(out, "\"", 1);
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '"') {
+            // Double the quote: emit the run including it, then one more
+            render_append(out, text + run, i + 1 - run);
+            render_append(out, "\"", 1);
+            run = i + 1;
+        }
+    }
+    render_append(out, text + run, length - run);
+    render_append(out, "\"", 1);
+}
+
+/**
+ * @brief Write one todo as a JSON object line
+ * @param out Render buffer
+ * @param list Todo list owning the todo
+ * @param todo Todo to write
+ */
+static void write_jsonl_record(RenderBuffer* out, const TodoList* list, const Todo* todo) {
+    render_string(out, "{\"id\":");
+    render_int(out, todo->id, 0);
+    render_string(out, ",\"title\":");
+    render_json_string(out, todo_get_title(list, todo), todo->title_length);
+    render_string(out, ",\"description\":");
+    render_json_string(out, todo_get_description(list, todo), todo->desc_length);
+    render_string(out, ",\"priority\":\"");
+    render_string(out, get_priority_string(todo->priority));
+    render_string(out, "\",\"status\":\"");
+    render_string(out, get_status_string(todo->status));
+    render_string(out, "\",\"created_at\":");
+    render_int(out, todo->created_at, 0);
+    render_string(out, ",\"updated_at\":");
+    render_int(out, todo->updated_at, 0);
+    render_string(out, ",\"due_at\":");
+    render_int(out, todo->due_at, 0);
+    render_string(out, "}\n");
+}
+
+/**
+ * @brief Write one todo as a CSV row
+ * @param out Render buffer
+ * @param list Todo list owning the todo
+ * @param todo Todo to write
+ */
+static void write_csv_record(RenderBuffer* out, const TodoList* list, const Todo* todo) {
+    render_int(out, todo->id, 0);
+    render_append(out, ",", 1);
+    render_csv_field(out, todo_get_title(list, todo), todo->title_length);
+    render_append(out, ",", 1);
+    render_csv_field(out, todo_get_description(list, todo), todo->desc_length);
+    render_append(out, ",", 1);
+    render_string(out, get_priority_string(todo->priority));
+    render_append(out, ",", 1);
+    render_string(out, get_status_string(todo->status));
+    render_append(out, ",", 1);
+    render_int(out, todo->created_at, 0);
+    render_append(out, ",", 1);
+    render_int(out, todo->updated_at, 0);
+    render_append(out, ",", 1);
+    render_int(out, todo->due_at, 0);
+    render_append(out, "\n", 1);
+}
+
+/**
+ * @brief Stream selected todos to a file in a record-per-line format
+ * @param list Pointer to the todo list to export
+ * @param filename Name of the file to write, or "-" for stdout
+ * @param header Text written before the first record (NULL for none)
+ * @param write_record Formatter for one record
+ * @param filter Callback selecting the todos to export (NULL for all)
+ * @param user_data Context passed to filter
+ * @return Number of todos written, negative TodoError on failure
+ */
+static int stream_export(const TodoList* list, const char* filename, const char* header,
+                         RecordWriter write_record, TodoFilterFn filter, void* user_data) {
+    if (!list || !filename) {
+        todo_log(TODO_LOG_ERROR, "Invalid parameters");
+        return TODO_ERR_INVALID;
+    }
+    
+    int to_stdout = strcmp(filename, "-") == 0;
+    if (!to_stdout && strncmp(filename, "data/", 5) == 0 && ensure_data_directory() != 0) {
+        todo_log(TODO_LOG_WARNING, "Could not create data directory");
+    }
+    
+    FILE* file = to_stdout ? stdout : fopen(filename, "wb");
+    if (!file) {
+        todo_log(TODO_LOG_ERROR, "Unable to open file '%s' for writing", filename);
+        return TODO_ERR_IO;
+    }
+    
+    char storage[RENDER_BUFFER_SIZE];
+    RenderBuffer out;
+    render_init(&out, file, storage, sizeof(storage));
+    if (header) {
+        render_string(&out, header);
+    }
+    
+    int written = 0;
+    for (int i = 0; i < list->used && out.error == TODO_OK; i++) {
+        const Todo* todo = &list->todos[i];
+        if (todo->id == TODO_TOMBSTONE_ID || (filter && !filter(list, todo, user_data))) {
+            continue;
+        }
+        write_record(&out, list, todo);
+        written++;
+    }
+    
+    int result = render_flush(&out);
+    if (to_stdout ? fflush(file) != 0 : fclose(file) != 0) {
+        result = TODO_ERR_IO;
+    }
+    if (result != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Failed to write '%s'", filename);
+        return result;
+    }
+    return written;
+}
+
+/**
+ * @brief Stream todos to a JSON-lines file, one object per line
+ * @param list Pointer to the todo list to export
+ * @param filename Name of the file to write, or "-" for stdout
+ * @param filter Callback selecting the todos to export (NULL for all)
+ * @param user_data Context passed to filter
+ * @return Number of todos written, negative TodoError on failure
+ */
+int export_todos_to_jsonl(const TodoList* list, const char* filename, TodoFilterFn filter, void* user_data) {
+    return stream_export(list, filename, NULL, write_jsonl_record, filter, user_data);
+}
+
+/**
+ * @brief Stream todos to a CSV file with a header row
+ * @param list Pointer to the todo list to export
+ * @param filename Name of the file to write, or "-" for stdout
+ * @param filter Callback selecting the todos to export (NULL for all)
+ * @param user_data Context passed to filter
+ * @return Number of todos written, negative TodoError on failure
+ */
+int export_todos_to_csv(const TodoList* list, const char* filename, TodoFilterFn filter, void* user_data) {
+    return stream_export(list, filename, "id,title,description,priority,status,created_at,updated_at,due_at\n",
+                         write_csv_record, filter, user_data);
 }
 
 /**
@@ -239,26 +2022,26 @@ int file_exists(const char* filename) {
 /**
  * @brief Create a backup of the current todo file
  * @param filename Name of the file to backup
- * @return 0 on success, -1 on failure
+ * @return TODO_OK on success, negative TodoError on failure
  */
 int create_backup(const char* filename) {
     if (!filename || !file_exists(filename)) {
-        return -1;
+        return TODO_ERR_INVALID;
     }
     
     // Create backup filename
     char backup_filename[256];
-    snprintf(backup_filename, sizeof(backup_filename), "%s.backup", filename);
+    snprintf(backup_filename, sizeof(backup_filename), "%s%s", filename, BACKUP_SUFFIX);
     
     FILE* source = fopen(filename, "rb");
     if (!source) {
-        return -1;
+        return TODO_ERR_IO;
     }
     
     FILE* dest = fopen(backup_filename, "wb");
     if (!dest) {
         fclose(source);
-        return -1;
+        return TODO_ERR_IO;
     }
     
     // Copy file contents
@@ -268,12 +2051,33 @@ int create_backup(const char* filename) {
         if (fwrite(buffer, 1, bytes, dest) != bytes) {
             fclose(source);
             fclose(dest);
-            return -1;
+            return TODO_ERR_IO;
         }
     }
     
     fclose(source);
     fclose(dest);
     
-    return 0;
+    return TODO_OK;
+}
+
+/**
+ * @brief Flush a file's buffered data and force it to stable storage
+ * @param file Open file to sync
+ * @return TODO_OK on success, TODO_ERR_IO on failure
+ */
+int file_sync(FILE* file) {
+    if (!file || fflush(file) != 0) {
+        return TODO_ERR_IO;
+    }
+    
+    // Failed syncs are timed too, since slow failures are what the metrics are for
+    TODO_METRICS_BEGIN(TODO_METRIC_FSYNC, start);
+#ifdef _WIN32
+    int result = _commit(_fileno(file)) == 0 ? TODO_OK : TODO_ERR_IO;
+#else
+    int result = fsync(fileno(file)) == 0 ? TODO_OK : TODO_ERR_IO;
+#endif
+    TODO_METRICS_END(TODO_METRIC_FSYNC, start);
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,514 @@
+/**
+ * @file history.c
+ * @brief Implementation of undo/redo history
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the history as two stacks of prior states, one
+ * for undo and one for redo. Each entry records what one todo looked
+ * like before one change: absent (for creations) or its fields and,
+ * when the change altered them, its title and description. An entry
+ * whose text did not change reads it from the list when it is applied,
+ * which is safe because entries are always applied newest first, so the
+ * list then holds exactly the state that followed the change.
+ *
+ * Applying a step is itself observed: while undoing, the overwritten
+ * states are recorded onto the redo stack, and while redoing onto the
+ * undo stack, so both directions share one mechanism.
+ */
+
+#include "../include/history.h"
+#include "../include/todo_log.h"
+
+/**
+ * @brief State of one todo before one change
+ */
+typedef struct {
+    int id;
+    uint8_t present;                       // 0 if the todo did not exist yet
+    uint8_t shared_text;                   // Text is that of the state after the change
+    uint8_t priority;
+    uint8_t status;
+    uint16_t title_length;
+    uint16_t desc_length;
+    int64_t created_at;
+    int64_t updated_at;
+    int64_t due_at;
+    size_t text_offset;                    // Title then description in HistoryStack.strings
+} HistoryEntry;
+
+/**
+ * @brief Changes undone or redone together
+ */
+typedef struct {
+    size_t first_entry;
+    size_t first_text;
+    time_t time;                           // Time of the latest change in the step
+} HistoryStep;
+
+/**
+ * @brief Stack of steps with their entries and text
+ */
+typedef struct {
+    HistoryEntry* entries;
+    size_t entry_count;
+    size_t entry_capacity;
+    char* strings;
+    size_t strings_size;
+    size_t strings_capacity;
+    HistoryStep* steps;
+    int step_count;
+    int step_capacity;
+    int open;                              // The last step still takes changes
+} HistoryStack;
+
+/**
+ * @brief History of one list
+ */
+struct TodoHistory {
+    TodoList* list;
+    HistoryStack undo;
+    HistoryStack redo;
+    HistoryStack* recording;               // Stack changes are recorded onto
+    int replaying;                         // An undo or redo is being applied
+    long pending;                          // Entry waiting for its UPDATE, -1 for none
+    int max_steps;
+};
+
+/**
+ * @brief Free a stack's storage
+ * @param stack Stack to free (left empty and reusable)
+ */
+static void stack_free(HistoryStack* stack) {
+    free(stack->entries);
+    free(stack->strings);
+    free(stack->steps);
+    memset(stack, 0, sizeof(*stack));
+}
+
+/**
+ * @brief Forget every step of a stack, keeping its storage
+ * @param stack Stack to empty
+ */
+static void stack_clear(HistoryStack* stack) {
+    stack->entry_count = 0;
+    stack->strings_size = 0;
+    stack->step_count = 0;
+    stack->open = 0;
+}
+
+/**
+ * @brief Grow an array so it holds at least count elements
+ * @param array Array to grow (updated on success)
+ * @param capacity Capacity in elements (updated on success)
+ * @param count Number of elements needed
+ * @param size Size of one element
+ * @return 0 on success, -1 on allocation failure
+ */
+static int grow(void** array, size_t* capacity, size_t count, size_t size) {
+    if (count <= *capacity) {
+        return 0;
+    }
+    size_t new_capacity = *capacity > 0 ? *capacity * 2 : 64;
+    while (new_capacity < count) {
+        new_capacity *= 2;
+    }
+    void* grown = realloc(*array, new_capacity * size);
+    if (!grown) {
+        return -1;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * @brief Drop the oldest steps of a stack
+ * @param stack Stack to trim
+ * @param count Number of steps to drop
+ */
+static void stack_drop_oldest(HistoryStack* stack, int count) {
+    if (count >= stack->step_count) {
+        stack_clear(stack);
+        return;
+    }
+    
+    size_t entries = stack->steps[count].first_entry;
+    size_t text = stack->steps[count].first_text;
+    stack->entry_count -= entries;
+    stack->strings_size -= text;
+    stack->step_count -= count;
+    memmove(stack->entries, stack->entries + entries, sizeof(HistoryEntry) * stack->entry_count);
+    memmove(stack->strings, stack->strings + text, stack->strings_size);
+    memmove(stack->steps, stack->steps + count, sizeof(HistoryStep) * (size_t)stack->step_count);
+    for (size_t i = 0; i < stack->entry_count; i++) {
+        stack->entries[i].text_offset -= text;
+    }
+    for (int i = 0; i < stack->step_count; i++) {
+        stack->steps[i].first_entry -= entries;
+        stack->steps[i].first_text -= text;
+    }
+}
+
+/**
+ * @brief Record the state of a todo before a change
+ * @param history History recording the change
+ * @param stack Stack to record onto
+ * @param list List that is changing
+ * @param todo Todo about to change, or NULL if it does not exist yet
+ * @param id ID of the todo
+ * @return 0 on success, -1 on allocation failure
+ */
+static int record_entry(TodoHistory* history, HistoryStack* stack, const TodoList* list,
+                        const Todo* todo, int id) {
+    size_t text_length = todo ? (size_t)todo->title_length + todo->desc_length : 0;
+    size_t step_capacity = (size_t)stack->step_capacity;
+    if (grow((void**)&stack->entries, &stack->entry_capacity, stack->entry_count + 1, sizeof(HistoryEntry)) != 0 ||
+        grow((void**)&stack->strings, &stack->strings_capacity, stack->strings_size + text_length, 1) != 0 ||
+        grow((void**)&stack->steps, &step_capacity, (size_t)stack->step_count + 1, sizeof(HistoryStep)) != 0) {
+        return -1;
+    }
+    stack->step_capacity = (int)step_capacity;
+    
+    if (!stack->open) {
+        HistoryStep* step = &stack->steps[stack->step_count++];
+        step->first_entry = stack->entry_count;
+        step->first_text = stack->strings_size;
+        stack->open = 1;
+    }
+    stack->steps[stack->step_count - 1].time = time(NULL);
+    
+    HistoryEntry* entry = &stack->entries[stack->entry_count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->id = id;
+    entry->text_offset = stack->strings_size;
+    if (todo) {
+        entry->present = 1;
+        entry->priority = todo->priority;
+        entry->status = todo->status;
+        entry->title_length = todo->title_length;
+        entry->desc_length = todo->desc_length;
+        entry->created_at = todo->created_at;
+        entry->updated_at = todo->updated_at;
+        entry->due_at = todo->due_at;
+        memcpy(stack->strings + stack->strings_size, todo_get_title(list, todo), todo->title_length);
+        memcpy(stack->strings + stack->strings_size + todo->title_length,
+               todo_get_description(list, todo), todo->desc_length);
+        stack->strings_size += text_length;
+    }
+    
+    if (stack == &history->undo && stack->step_count > history->max_steps + history->max_steps / 8) {
+        // Trim in batches so the move is amortized over many steps
+        stack_drop_oldest(stack, stack->step_count - history->max_steps);
+    }
+    return 0;
+}
+
+/**
+ * @brief Drop the text of the pending entry if the change kept it
+ * @param history History with a pending entry
+ * @param list List that changed
+ * @param todo State after the change
+ */
+static void finish_pending(TodoHistory* history, const TodoList* list, const Todo* todo) {
+    HistoryStack* stack = history->recording;
+    HistoryEntry* entry = &stack->entries[history->pending];
+    history->pending = -1;
+    if (entry->id != todo->id || entry->title_length != todo->title_length ||
+        entry->desc_length != todo->desc_length) {
+        return;
+    }
+    
+    const char* text = stack->strings + entry->text_offset;
+    if (memcmp(text, todo_get_title(list, todo), todo->title_length) == 0 &&
+        memcmp(text + todo->title_length, todo_get_description(list, todo), todo->desc_length) == 0) {
+        // The entry was the last one recorded, so its text ends the arena
+        stack->strings_size = entry->text_offset;
+        entry->shared_text = 1;
+    }
+}
+
+/**
+ * @brief Observer recording the prior state of every change
+ * @param list List that changed
+ * @param change Kind of change
+ * @param todo Affected todo
+ * @param user_data The history
+ */
+static void record_change(const TodoList* list, TodoChange change, const Todo* todo, void* user_data) {
+    TodoHistory* history = (TodoHistory*)user_data;
+    HistoryStack* stack = history->recording;
+    
+    if (change == TODO_CHANGE_UPDATE) {
+        if (history->pending >= 0) {
+            finish_pending(history, list, todo);
+        }
+        return;
+    }
+    if (history->pending >= 0) {
+        // The previous change was abandoned after it was announced
+        HistoryEntry* orphan = &stack->entries[history->pending];
+        stack->strings_size = orphan->text_offset;
+        stack->entry_count--;
+        history->pending = -1;
+    }
+    
+    if (!history->replaying) {
+        // A new change makes the undone steps unreachable
+        stack_clear(&history->redo);
+    }
+    if (record_entry(history, stack, list, change == TODO_CHANGE_CREATE ? NULL : todo, todo->id) != 0) {
+        todo_log(TODO_LOG_WARNING, "History out of memory, discarding undo and redo steps");
+        stack_clear(&history->undo);
+        stack_clear(&history->redo);
+        return;
+    }
+    if (change == TODO_CHANGE_PREPARE) {
+        history->pending = (long)stack->entry_count - 1;
+    }
+}
+
+/**
+ * @brief Start recording the changes of a list
+ * @param list List to observe
+ * @return New history, NULL on failure
+ */
+TodoHistory* todo_history_attach(TodoList* list) {
+    if (!list) {
+        return NULL;
+    }
+    
+    TodoHistory* history = (TodoHistory*)calloc(1, sizeof(TodoHistory));
+    if (!history) {
+        return NULL;
+    }
+    history->list = list;
+    history->recording = &history->undo;
+    history->pending = -1;
+    history->max_steps = TODO_HISTORY_DEFAULT_STEPS;
+    
+    if (todo_list_add_observer(list, record_change, history) != TODO_OK) {
+        free(history);
+        return NULL;
+    }
+    return history;
+}
+
+/**
+ * @brief Stop recording and free a history
+ * @param history History to free (may be NULL)
+ */
+void todo_history_detach(TodoHistory* history) {
+    if (!history) {
+        return;
+    }
+    todo_list_remove_observer(history->list, record_change, history);
+    stack_free(&history->undo);
+    stack_free(&history->redo);
+    free(history);
+}
+
+/**
+ * @brief Set how many steps are kept
+ * @param history History to configure
+ * @param max_steps Most recent undo steps to keep (at least 1)
+ */
+void todo_history_set_limit(TodoHistory* history, int max_steps) {
+    if (!history) {
+        return;
+    }
+    history->max_steps = max_steps > 0 ? max_steps : 1;
+    if (history->undo.step_count > history->max_steps) {
+        stack_drop_oldest(&history->undo, history->undo.step_count - history->max_steps);
+    }
+}
+
+/**
+ * @brief End the current step
+ * @param history History to mark
+ */
+void todo_history_mark(TodoHistory* history) {
+    if (history) {
+        history->undo.open = 0;
+    }
+}
+
+/**
+ * @brief Copy a todo's title and description out of its list
+ * @param list List owning the todo
+ * @param todo Todo to copy
+ * @param title Receives the title (MAX_TITLE_LENGTH bytes)
+ * @param description Receives the description (MAX_DESC_LENGTH bytes)
+ */
+static void copy_text(const TodoList* list, const Todo* todo, char* title, char* description) {
+    memcpy(title, todo_get_title(list, todo), todo->title_length);
+    title[todo->title_length] = '\0';
+    memcpy(description, todo_get_description(list, todo), todo->desc_length);
+    description[todo->desc_length] = '\0';
+}
+
+/**
+ * @brief Put one todo of a list back into a recorded state
+ * @param list List to change
+ * @param stack Stack holding the entry
+ * @param entry State to restore
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int apply_entry(TodoList* list, const HistoryStack* stack, const HistoryEntry* entry) {
+    if (!entry->present) {
+        int result = todo_delete(list, entry->id);
+        return result == TODO_ERR_NOT_FOUND ? TODO_OK : result;
+    }
+    
+    char title[MAX_TITLE_LENGTH];
+    char description[MAX_DESC_LENGTH];
+    if (entry->shared_text) {
+        // todo_restore_ex writes a new text block, so copy the text out first
+        const Todo* todo = todo_find_by_id(list, entry->id);
+        if (!todo) {
+            return TODO_ERR_CORRUPT;
+        }
+        copy_text(list, todo, title, description);
+    } else {
+        const char* text = stack->strings + entry->text_offset;
+        memcpy(title, text, entry->title_length);
+        title[entry->title_length] = '\0';
+        memcpy(description, text + entry->title_length, entry->desc_length);
+        description[entry->desc_length] = '\0';
+    }
+    return todo_restore_ex(list, entry->id, title, description, (Priority)entry->priority,
+                           (Status)entry->status, (time_t)entry->created_at, (time_t)entry->updated_at,
+                           (time_t)entry->due_at);
+}
+
+/**
+ * @brief Apply the newest step of one stack, recording onto the other
+ * @param history History of the list
+ * @param from Stack to pop the step from
+ * @param to Stack receiving the overwritten states
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND if from is empty, negative TodoError on failure
+ */
+static int replay_step(TodoHistory* history, HistoryStack* from, HistoryStack* to) {
+    if (from->step_count == 0) {
+        return TODO_ERR_NOT_FOUND;
+    }
+    
+    const HistoryStep* step = &from->steps[from->step_count - 1];
+    from->open = 0;
+    to->open = 0;
+    history->recording = to;
+    history->replaying = 1;
+    
+    int result = TODO_OK;
+    for (size_t i = from->entry_count; i > step->first_entry && result == TODO_OK; i--) {
+        result = apply_entry(history->list, from, &from->entries[i - 1]);
+    }
+    
+    history->recording = &history->undo;
+    history->replaying = 0;
+    to->open = 0;
+    if (result != TODO_OK) {
+        // Part of the step is applied: neither direction is reliable any more
+        todo_log(TODO_LOG_WARNING, "Undo or redo failed, discarding history");
+        stack_clear(&history->undo);
+        stack_clear(&history->redo);
+        return result;
+    }
+    
+    from->entry_count = step->first_entry;
+    from->strings_size = step->first_text;
+    from->step_count--;
+    return TODO_OK;
+}
+
+/**
+ * @brief Undo the most recent step
+ * @param history History of the list
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND if there is nothing to undo,
+ *         negative TodoError if the list could not be changed
+ */
+int todo_history_undo(TodoHistory* history) {
+    if (!history) {
+        return TODO_ERR_INVALID;
+    }
+    return replay_step(history, &history->undo, &history->redo);
+}
+
+/**
+ * @brief Redo the most recently undone step
+ * @param history History of the list
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND if there is nothing to redo,
+ *         negative TodoError if the list could not be changed
+ */
+int todo_history_redo(TodoHistory* history) {
+    if (!history) {
+        return TODO_ERR_INVALID;
+    }
+    return replay_step(history, &history->redo, &history->undo);
+}
+
+/**
+ * @brief Number of steps that can be undone
+ * @param history History to inspect
+ * @return Step count, including an unmarked step with changes
+ */
+int todo_history_undo_count(const TodoHistory* history) {
+    return history ? history->undo.step_count : 0;
+}
+
+/**
+ * @brief Number of steps that can be redone
+ * @param history History to inspect
+ * @return Step count
+ */
+int todo_history_redo_count(const TodoHistory* history) {
+    return history ? history->redo.step_count : 0;
+}
+
+/**
+ * @brief Memory held by the recorded states
+ * @param history History to inspect
+ * @return Bytes allocated
+ */
+size_t todo_history_memory(const TodoHistory* history) {
+    if (!history) {
+        return 0;
+    }
+    size_t total = sizeof(TodoHistory);
+    const HistoryStack* stacks[2] = { &history->undo, &history->redo };
+    for (int i = 0; i < 2; i++) {
+        total += stacks[i]->entry_capacity * sizeof(HistoryEntry) + stacks[i]->strings_capacity +
+                 (size_t)stacks[i]->step_capacity * sizeof(HistoryStep);
+    }
+    return total;
+}
+
+/**
+ * @brief Rebuild the list as it was at a point in time
+ * @param history History of the list
+ * @param when Point in time
+ * @return New list to be freed with todo_list_destroy, NULL on failure
+ */
+TodoList* todo_history_state_at(const TodoHistory* history, time_t when) {
+    if (!history) {
+        return NULL;
+    }
+    
+    TodoList* copy = todo_list_clone(history->list);
+    if (!copy) {
+        return NULL;
+    }
+    
+    // Revert the undo stack onto the copy, newest first, as undo would
+    const HistoryStack* stack = &history->undo;
+    size_t entry = stack->entry_count;
+    for (int s = stack->step_count - 1; s >= 0 && stack->steps[s].time > when; s--) {
+        for (; entry > stack->steps[s].first_entry; entry--) {
+            if (apply_entry(copy, stack, &stack->entries[entry - 1]) != TODO_OK) {
+                todo_list_destroy(copy);
+                return NULL;
+            }
+        }
+    }
+    return copy;
+}
\ No newline at end of file
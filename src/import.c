@@ -0,0 +1,1020 @@
+/**
+ * @file import.c
+ * @brief Implementation of bulk CSV and JSON-lines import
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements a streaming parser for CSV and JSON-lines input.
+ * Input is mapped or read in large blocks and parsed in place; decoded
+ * titles and descriptions are copied into one scratch area that backs a
+ * batch of TodoSpec entries, which is handed to todo_create_many and then
+ * reused, so the parser performs no allocation per record.
+ */
+
+#include "../include/import.h"
+#include "../include/file_io.h"
+#include "../include/todo_log.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of records handed to todo_create_many at once
+#define IMPORT_BATCH_SIZE 512
+
+// Size of the read buffer used when the input cannot be mapped
+#define IMPORT_BLOCK_SIZE (1024 * 1024)
+
+// CSV columns beyond this many are ignored
+#define IMPORT_MAX_COLUMNS 64
+
+// Longest field name, priority or status value recognized
+#define IMPORT_TOKEN_SIZE 32
+
+/**
+ * @brief What a parsed field is used for
+ */
+typedef enum {
+    FIELD_IGNORE = 0,
+    FIELD_TITLE,
+    FIELD_DESCRIPTION,
+    FIELD_PRIORITY,
+    FIELD_STATUS,
+    FIELD_DUE,
+    FIELD_NAME        // Column name in a CSV header row
+} FieldRole;
+
+/**
+ * @brief Outcome of parsing one record
+ */
+typedef enum {
+    RECORD_OK = 0,        // Record parsed and queued
+    RECORD_SKIP,          // Blank line, nothing to import
+    RECORD_REJECT,        // Malformed or invalid record, skipped
+    RECORD_INCOMPLETE,    // The record continues past the available input
+    RECORD_RETRY          // Parse the same bytes again (CSV without a header)
+} RecordStatus;
+
+/**
+ * @brief Import state shared by all records of one input
+ */
+typedef struct {
+    TodoList* list;
+    TodoImportFormat format;
+    
+    // Pending batch; title and description strings live in scratch
+    TodoSpec specs[IMPORT_BATCH_SIZE];
+    unsigned char completed[IMPORT_BATCH_SIZE];
+    time_t due[IMPORT_BATCH_SIZE];
+    int ids[IMPORT_BATCH_SIZE];
+    int count;
+    char* scratch;
+    size_t scratch_used;
+    
+    // CSV column layout
+    FieldRole columns[IMPORT_MAX_COLUMNS];
+    int header_checked;
+    
+    int imported;
+    int rejected;
+} Importer;
+
+/**
+ * @brief Fields of the record currently being parsed
+ */
+typedef struct {
+    const char* title;
+    const char* description;
+    Priority priority;
+    Status status;
+    time_t due_at;
+    unsigned seen;            // Bit per FieldRole already assigned
+    int invalid;              // A value failed validation
+    
+    // Destination of the field being decoded
+    FieldRole role;
+    char* out;
+    size_t out_length;
+    size_t out_capacity;
+    int overflow;
+    char token[IMPORT_TOKEN_SIZE];
+} Record;
+
+/**
+ * @brief Compare a NUL-terminated token with a keyword, ignoring case
+ * @param token Token to test
+ * @param keyword Lower-case keyword
+ * @return 1 if they match, 0 otherwise
+ */
+static int token_is(const char* token, const char* keyword) {
+    while (*token && *keyword) {
+        if (tolower((unsigned char)*token) != *keyword) {
+            return 0;
+        }
+        token++;
+        keyword++;
+    }
+    return *token == '\0' && *keyword == '\0';
+}
+
+/**
+ * @brief Map a field or column name to its role
+ * @param name Field name
+ * @return Role of the field, FIELD_IGNORE if unknown
+ */
+static FieldRole role_for_name(const char* name) {
+    if (token_is(name, "title")) {
+        return FIELD_TITLE;
+    }
+    if (token_is(name, "description")) {
+        return FIELD_DESCRIPTION;
+    }
+    if (token_is(name, "priority")) {
+        return FIELD_PRIORITY;
+    }
+    if (token_is(name, "status")) {
+        return FIELD_STATUS;
+    }
+    if (token_is(name, "due_at") || token_is(name, "due")) {
+        return FIELD_DUE;
+    }
+    return FIELD_IGNORE;
+}
+
+/**
+ * @brief Parse a priority value
+ * @param token Value to parse
+ * @param out Receives the priority
+ * @return 0 on success, -1 if the value is not a priority
+ */
+static int parse_priority(const char* token, Priority* out) {
+    if (token[0] == '\0' || token_is(token, "medium") || strcmp(token, "2") == 0) {
+        *out = PRIORITY_MEDIUM;
+    } else if (token_is(token, "low") || strcmp(token, "1") == 0) {
+        *out = PRIORITY_LOW;
+    } else if (token_is(token, "high") || strcmp(token, "3") == 0) {
+        *out = PRIORITY_HIGH;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse a status value
+ * @param token Value to parse
+ * @param out Receives the status
+ * @return 0 on success, -1 if the value is not a status
+ */
+static int parse_status(const char* token, Status* out) {
+    if (token[0] == '\0' || token_is(token, "pending") || token_is(token, "false") ||
+        strcmp(token, "0") == 0) {
+        *out = STATUS_PENDING;
+    } else if (token_is(token, "completed") || token_is(token, "done") ||
+               token_is(token, "true") || strcmp(token, "1") == 0) {
+        *out = STATUS_COMPLETED;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse a due date value
+ * @param token Unix timestamp in seconds, as written by the exporters (empty or 0 for none)
+ * @param out Receives the due time
+ * @return 0 on success, -1 if the value is not a timestamp
+ */
+static int parse_due(const char* token, time_t* out) {
+    long long value = 0;
+    for (const char* p = token; *p; p++) {
+        if (*p < '0' || *p > '9' || value > (LLONG_MAX - 9) / 10) {
+            return -1;
+        }
+        value = value * 10 + (*p - '0');
+    }
+    *out = (time_t)value;
+    return (long long)*out == value ? 0 : -1;
+}
+
+/**
+ * @brief Reset a record before parsing
+ * @param record Record to reset
+ */
+static void record_init(Record* record) {
+    record->title = NULL;
+    record->description = NULL;
+    record->priority = PRIORITY_MEDIUM;
+    record->status = STATUS_PENDING;
+    record->due_at = 0;
+    record->seen = 0;
+    record->invalid = 0;
+    record->role = FIELD_IGNORE;
+    record->out = NULL;
+}
+
+/**
+ * @brief Start decoding a field
+ *
+ * Titles and descriptions are decoded straight into the scratch area,
+ * other values into the record's token buffer. A field whose role was
+ * already assigned is ignored, so the first occurrence wins.
+ *
+ * @param imp Importer owning the scratch area
+ * @param record Record being parsed
+ * @param role Role of the field
+ */
+static void field_begin(Importer* imp, Record* record, FieldRole role) {
+    if (role != FIELD_NAME && (record->seen & (1u << role))) {
+        role = FIELD_IGNORE;
+    }
+    
+    record->role = role;
+    record->out_length = 0;
+    record->overflow = 0;
+    switch (role) {
+        case FIELD_TITLE:
+            record->out = imp->scratch + imp->scratch_used;
+            record->out_capacity = MAX_TITLE_LENGTH - 1;
+            break;
+        case FIELD_DESCRIPTION:
+            record->out = imp->scratch + imp->scratch_used;
+            record->out_capacity = MAX_DESC_LENGTH - 1;
+            break;
+        case FIELD_IGNORE:
+            record->out = NULL;
+            record->out_capacity = 0;
+            break;
+        default:
+            record->out = record->token;
+            record->out_capacity = IMPORT_TOKEN_SIZE - 1;
+            break;
+    }
+}
+
+/**
+ * @brief Append decoded bytes to the current field
+ * @param record Record being parsed
+ * @param bytes Bytes to append
+ * @param length Number of bytes
+ */
+static void field_put(Record* record, const char* bytes, size_t length) {
+    if (!record->out || record->overflow) {
+        return;
+    }
+    if (length > record->out_capacity - record->out_length) {
+        record->overflow = 1;
+        return;
+    }
+    memcpy(record->out + record->out_length, bytes, length);
+    record->out_length += length;
+}
+
+/**
+ * @brief Finish the current field and store its value in the record
+ * @param imp Importer owning the scratch area
+ * @param record Record being parsed
+ * @param column CSV column index (header rows only)
+ */
+static void field_end(Importer* imp, Record* record, int column) {
+    FieldRole role = record->role;
+    if (!record->out) {
+        return;
+    }
+    record->out[record->out_length] = '\0';
+    
+    switch (role) {
+        case FIELD_TITLE:
+        case FIELD_DESCRIPTION:
+            if (record->overflow) {
+                record->invalid = 1;
+                break;
+            }
+            if (role == FIELD_TITLE) {
+                record->title = record->out;
+            } else {
+                record->description = record->out;
+            }
+            imp->scratch_used += record->out_length + 1;
+            break;
+        case FIELD_PRIORITY:
+            if (record->overflow || parse_priority(record->token, &record->priority) != 0) {
+                record->invalid = 1;
+            }
+            break;
+        case FIELD_STATUS:
+            if (record->overflow || parse_status(record->token, &record->status) != 0) {
+                record->invalid = 1;
+            }
+            break;
+        case FIELD_DUE:
+            if (record->overflow || parse_due(record->token, &record->due_at) != 0) {
+                record->invalid = 1;
+            }
+            break;
+        case FIELD_NAME:
+            if (column < IMPORT_MAX_COLUMNS) {
+                FieldRole named = record->overflow ? FIELD_IGNORE : role_for_name(record->token);
+                if (named != FIELD_IGNORE && (record->seen & (1u << named))) {
+                    named = FIELD_IGNORE;
+                }
+                imp->columns[column] = named;
+                record->seen |= 1u << named;
+            }
+            return;
+        default:
+            break;
+    }
+    record->seen |= 1u << role;
+}
+
+/**
+ * @brief Hand the pending batch to the list
+ * @param imp Importer with queued records
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int flush_batch(Importer* imp) {
+    if (imp->count == 0) {
+        return TODO_OK;
+    }
+    
+    int created = todo_create_many(imp->list, imp->specs, imp->count, imp->ids);
+    if (created < 0) {
+        return created;
+    }
+    
+    // Due dates are set one by one: they are rare and todo_create_many takes none
+    for (int i = 0; i < imp->count; i++) {
+        if (imp->ids[i] >= 0 && imp->due[i] != 0) {
+            todo_set_due(imp->list, imp->ids[i], imp->due[i]);
+        }
+    }
+    
+    // Reuse the ids array for the ones that must be marked completed
+    int done = 0;
+    for (int i = 0; i < imp->count; i++) {
+        if (imp->ids[i] < 0) {
+            imp->rejected++;
+        } else if (imp->completed[i]) {
+            imp->ids[done++] = imp->ids[i];
+        }
+    }
+    if (done > 0) {
+        todo_complete_many(imp->list, imp->ids, done, NULL);
+    }
+    
+    imp->imported += created;
+    imp->count = 0;
+    imp->scratch_used = 0;
+    return TODO_OK;
+}
+
+/**
+ * @brief Queue a parsed record, flushing the batch when it is full
+ * @param imp Importer
+ * @param record Parsed record
+ * @param mark Scratch offset at which the record started
+ * @return Record status, or a negative TodoError on failure
+ */
+static int finish_record(Importer* imp, const Record* record, size_t mark) {
+    if (record->invalid || !record->title || record->title[0] == '\0') {
+        imp->scratch_used = mark;
+        return RECORD_REJECT;
+    }
+    
+    TodoSpec* spec = &imp->specs[imp->count];
+    spec->title = record->title;
+    spec->description = record->description;
+    spec->priority = record->priority;
+    imp->completed[imp->count] = record->status == STATUS_COMPLETED;
+    imp->due[imp->count] = record->due_at;
+    imp->count++;
+    
+    if (imp->count == IMPORT_BATCH_SIZE) {
+        int result = flush_batch(imp);
+        if (result != TODO_OK) {
+            return result;
+        }
+    }
+    return RECORD_OK;
+}
+
+/**
+ * @brief Find the end of the line starting at p
+ * @param p Start of the line
+ * @param end End of the available input
+ * @param at_eof Whether the input ends at end
+ * @param next Receives the start of the following line
+ * @return End of the line (before any '\n'), or NULL if it is not complete
+ */
+static const char* line_end(const char* p, const char* end, int at_eof, const char** next) {
+    const char* newline = (const char*)memchr(p, '\n', (size_t)(end - p));
+    if (newline) {
+        *next = newline + 1;
+        return newline;
+    }
+    if (!at_eof) {
+        return NULL;
+    }
+    *next = end;
+    return end;
+}
+
+/**
+ * @brief Parse one CSV record
+ * @param imp Importer
+ * @param p Start of the record
+ * @param end End of the available input
+ * @param at_eof Whether the input ends at end
+ * @param next Receives the start of the following record
+ * @return Record status, or a negative TodoError on failure
+ */
+static int parse_csv_record(Importer* imp, const char* p, const char* end, int at_eof,
+                            const char** next) {
+    size_t mark = imp->scratch_used;
+    int header_row = !imp->header_checked;
+    Record record;
+    record_init(&record);
+    
+    // Blank lines separate nothing in CSV; skip them
+    if (p < end && (*p == '\n' || (*p == '\r' && p + 1 < end && p[1] == '\n'))) {
+        *next = p + (*p == '\r' ? 2 : 1);
+        return RECORD_SKIP;
+    }
+    
+    int column = 0;
+    for (;;) {
+        FieldRole role = FIELD_NAME;
+        if (!header_row) {
+            role = column < IMPORT_MAX_COLUMNS ? imp->columns[column] : FIELD_IGNORE;
+        }
+        field_begin(imp, &record, role);
+        
+        if (p < end && *p == '"') {
+            // Quoted field: "" stands for one quote, separators are literal
+            const char* q = p + 1;
+            for (;;) {
+                const char* quote = (const char*)memchr(q, '"', (size_t)(end - q));
+                if (!quote || (quote + 1 == end && !at_eof)) {
+                    imp->scratch_used = mark;
+                    if (at_eof) {
+                        *next = end;
+                        return RECORD_REJECT;
+                    }
+                    return RECORD_INCOMPLETE;
+                }
+                field_put(&record, q, (size_t)(quote - q));
+                if (quote + 1 < end && quote[1] == '"') {
+                    field_put(&record, "\"", 1);
+                    q = quote + 2;
+                    continue;
+                }
+                p = quote + 1;
+                break;
+            }
+            
+            if (p < end && *p == '\r' && p + 1 < end && p[1] == '\n') {
+                p++;
+            }
+            if (p < end && *p != ',' && *p != '\n') {
+                // Text after a closing quote: drop the rest of the line
+                imp->scratch_used = mark;
+                if (!line_end(p, end, at_eof, next)) {
+                    return RECORD_INCOMPLETE;
+                }
+                return RECORD_REJECT;
+            }
+        } else {
+            const char* q = p;
+            while (q < end && *q != ',' && *q != '\n') {
+                q++;
+            }
+            if (q == end && !at_eof) {
+                imp->scratch_used = mark;
+                return RECORD_INCOMPLETE;
+            }
+            
+            const char* value_end = q;
+            if (q < end && *q == '\n' && value_end > p && value_end[-1] == '\r') {
+                value_end--;
+            }
+            field_put(&record, p, (size_t)(value_end - p));
+            p = q;
+        }
+        
+        field_end(imp, &record, column);
+        column++;
+        
+        if (p < end && *p == ',') {
+            p++;
+            continue;
+        }
+        if (p < end) {
+            p++; // The record's '\n'
+        }
+        break;
+    }
+    *next = p;
+    
+    if (header_row) {
+        imp->header_checked = 1;
+        if (record.seen & (1u << FIELD_TITLE)) {
+            return RECORD_SKIP;
+        }
+        
+        // No header: use the positional layout and parse the row as data
+        memset(imp->columns, 0, sizeof(imp->columns));
+        imp->columns[0] = FIELD_TITLE;
+        imp->columns[1] = FIELD_DESCRIPTION;
+        imp->columns[2] = FIELD_PRIORITY;
+        imp->columns[3] = FIELD_STATUS;
+        return RECORD_RETRY;
+    }
+    return finish_record(imp, &record, mark);
+}
+
+/**
+ * @brief Skip JSON whitespace
+ * @param p Current position
+ * @param end End of the line
+ * @return First non-whitespace position
+ */
+static const char* skip_space(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief Parse four hex digits of a \u escape
+ * @param p Start of the digits
+ * @param end End of the line
+ * @param out Receives the code unit
+ * @return 0 on success, -1 if the digits are missing or invalid
+ */
+static int parse_hex4(const char* p, const char* end, unsigned* out) {
+    if (end - p < 4) {
+        return -1;
+    }
+    unsigned value = 0;
+    for (int i = 0; i < 4; i++) {
+        int c = (unsigned char)p[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= (unsigned)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value |= (unsigned)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value |= (unsigned)(c - 'A' + 10);
+        } else {
+            return -1;
+        }
+    }
+    *out = value;
+    return 0;
+}
+
+/**
+ * @brief Decode a JSON string into the current field
+ * @param record Record being parsed
+ * @param p Position just after the opening quote
+ * @param end End of the line
+ * @return Position just after the closing quote, NULL if the string is malformed
+ */
+static const char* parse_json_string(Record* record, const char* p, const char* end) {
+    for (;;) {
+        const char* run = p;
+        while (p < end && *p != '"' && *p != '\\' && (unsigned char)*p >= 0x20) {
+            p++;
+        }
+        field_put(record, run, (size_t)(p - run));
+        if (p == end || (unsigned char)*p < 0x20) {
+            return NULL;
+        }
+        if (*p == '"') {
+            return p + 1;
+        }
+        
+        // Escape sequence
+        if (++p == end) {
+            return NULL;
+        }
+        char c = *p++;
+        switch (c) {
+            case '"': field_put(record, "\"", 1); break;
+            case '\\': field_put(record, "\\", 1); break;
+            case '/': field_put(record, "/", 1); break;
+            case 'b': field_put(record, "\b", 1); break;
+            case 'f': field_put(record, "\f", 1); break;
+            case 'n': field_put(record, "\n", 1); break;
+            case 'r': field_put(record, "\r", 1); break;
+            case 't': field_put(record, "\t", 1); break;
+            case 'u': {
+                unsigned code;
+                if (parse_hex4(p, end, &code) != 0) {
+                    return NULL;
+                }
+                p += 4;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    unsigned low;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u' ||
+                        parse_hex4(p + 2, end, &low) != 0 || low < 0xDC00 || low > 0xDFFF) {
+                        return NULL;
+                    }
+                    p += 6;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                    return NULL;
+                }
+                
+                char utf8[4];
+                size_t length;
+                if (code < 0x80) {
+                    utf8[0] = (char)code;
+                    length = 1;
+                } else if (code < 0x800) {
+                    utf8[0] = (char)(0xC0 | (code >> 6));
+                    utf8[1] = (char)(0x80 | (code & 0x3F));
+                    length = 2;
+                } else if (code < 0x10000) {
+                    utf8[0] = (char)(0xE0 | (code >> 12));
+                    utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    utf8[2] = (char)(0x80 | (code & 0x3F));
+                    length = 3;
+                } else {
+                    utf8[0] = (char)(0xF0 | (code >> 18));
+                    utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+                    utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    utf8[3] = (char)(0x80 | (code & 0x3F));
+                    length = 4;
+                }
+                field_put(record, utf8, length);
+                break;
+            }
+            default:
+                return NULL;
+        }
+    }
+}
+
+/**
+ * @brief Skip a JSON object or array nested inside a record
+ * @param p Position of the opening bracket
+ * @param end End of the line
+ * @return Position just after the matching bracket, NULL if unbalanced
+ */
+static const char* skip_json_nested(const char* p, const char* end) {
+    int depth = 0;
+    while (p < end) {
+        char c = *p++;
+        if (c == '"') {
+            // Strings may contain brackets; skip them with escapes
+            while (p < end && *p != '"') {
+                p += (*p == '\\' && p + 1 < end) ? 2 : 1;
+            }
+            if (p == end) {
+                return NULL;
+            }
+            p++;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) {
+                return p;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Parse one JSON-lines record
+ * @param imp Importer
+ * @param p Start of the line
+ * @param end End of the available input
+ * @param at_eof Whether the input ends at end
+ * @param next Receives the start of the following line
+ * @return Record status, or a negative TodoError on failure
+ */
+static int parse_jsonl_record(Importer* imp, const char* p, const char* end, int at_eof,
+                              const char** next) {
+    const char* line = line_end(p, end, at_eof, next);
+    if (!line) {
+        return RECORD_INCOMPLETE;
+    }
+    end = line;
+    
+    p = skip_space(p, end);
+    if (p == end) {
+        return RECORD_SKIP;
+    }
+    if (*p != '{') {
+        return RECORD_REJECT;
+    }
+    
+    size_t mark = imp->scratch_used;
+    Record record;
+    record_init(&record);
+    
+    p = skip_space(p + 1, end);
+    if (p < end && *p == '}') {
+        p++;
+    } else {
+        for (;;) {
+            // Key: decoded into the token buffer, then mapped to a role
+            if (p == end || *p != '"') {
+                p = NULL;
+                break;
+            }
+            field_begin(imp, &record, FIELD_NAME);
+            p = parse_json_string(&record, p + 1, end);
+            if (!p) {
+                break;
+            }
+            record.token[record.out_length] = '\0';
+            FieldRole role = record.overflow ? FIELD_IGNORE : role_for_name(record.token);
+            
+            p = skip_space(p, end);
+            if (p == end || *p != ':') {
+                p = NULL;
+                break;
+            }
+            p = skip_space(p + 1, end);
+            if (p == end) {
+                p = NULL;
+                break;
+            }
+            
+            // Value
+            if (*p == '"') {
+                field_begin(imp, &record, role);
+                p = parse_json_string(&record, p + 1, end);
+                if (!p) {
+                    break;
+                }
+                field_end(imp, &record, 0);
+            } else if (*p == '{' || *p == '[') {
+                p = skip_json_nested(p, end);
+                if (!p) {
+                    break;
+                }
+            } else {
+                // Number, true, false or null
+                const char* value = p;
+                while (p < end && *p != ',' && *p != '}' && *p != ' ' && *p != '\t' && *p != '\r') {
+                    p++;
+                }
+                if (p == value) {
+                    p = NULL;
+                    break;
+                }
+                size_t length = (size_t)(p - value);
+                if (!(length == 4 && memcmp(value, "null", 4) == 0)) {
+                    if (role == FIELD_TITLE || role == FIELD_DESCRIPTION) {
+                        role = FIELD_IGNORE; // Only strings are text
+                    }
+                    field_begin(imp, &record, role);
+                    field_put(&record, value, length);
+                    field_end(imp, &record, 0);
+                }
+            }
+            
+            p = skip_space(p, end);
+            if (p < end && *p == ',') {
+                p = skip_space(p + 1, end);
+                continue;
+            }
+            if (p < end && *p == '}') {
+                p++;
+                break;
+            }
+            p = NULL;
+            break;
+        }
+    }
+    
+    if (!p || skip_space(p, end) != end) {
+        imp->scratch_used = mark;
+        return RECORD_REJECT;
+    }
+    return finish_record(imp, &record, mark);
+}
+
+/**
+ * @brief Parse as many complete records as the input holds
+ * @param imp Importer
+ * @param data Input bytes
+ * @param size Number of input bytes
+ * @param at_eof Whether the input ends with these bytes
+ * @param consumed Receives the number of bytes fully parsed
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int import_block(Importer* imp, const char* data, size_t size, int at_eof, size_t* consumed) {
+    const char* p = data;
+    const char* end = data + size;
+    
+    while (p < end) {
+        const char* next = end;
+        int status;
+        if (imp->format == TODO_IMPORT_CSV) {
+            status = parse_csv_record(imp, p, end, at_eof, &next);
+        } else {
+            status = parse_jsonl_record(imp, p, end, at_eof, &next);
+        }
+        
+        if (status < 0) {
+            return status;
+        }
+        if (status == RECORD_INCOMPLETE) {
+            break;
+        }
+        if (status == RECORD_RETRY) {
+            continue;
+        }
+        if (status == RECORD_REJECT) {
+            imp->rejected++;
+        }
+        p = next;
+    }
+    
+    *consumed = (size_t)(p - data);
+    return TODO_OK;
+}
+
+/**
+ * @brief Choose a format from the file name or the first bytes of input
+ * @param filename Name of the input
+ * @param data First bytes of input
+ * @param size Number of bytes available
+ * @return TODO_IMPORT_CSV or TODO_IMPORT_JSONL
+ */
+static TodoImportFormat detect_format(const char* filename, const char* data, size_t size) {
+    const char* dot = strrchr(filename, '.');
+    if (dot) {
+        if (token_is(dot, ".csv")) {
+            return TODO_IMPORT_CSV;
+        }
+        if (token_is(dot, ".jsonl") || token_is(dot, ".ndjson") || token_is(dot, ".json")) {
+            return TODO_IMPORT_JSONL;
+        }
+    }
+    
+    for (size_t i = 0; i < size; i++) {
+        if (!isspace((unsigned char)data[i])) {
+            return data[i] == '{' ? TODO_IMPORT_JSONL : TODO_IMPORT_CSV;
+        }
+    }
+    return TODO_IMPORT_CSV;
+}
+
+/**
+ * @brief Skip a UTF-8 byte order mark
+ * @param data Input bytes
+ * @param size Number of input bytes
+ * @return Number of bytes to skip (0 or 3)
+ */
+static size_t bom_length(const char* data, size_t size) {
+    if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        return 3;
+    }
+    return 0;
+}
+
+/**
+ * @brief Import from a stream read in blocks
+ * @param imp Importer
+ * @param file Stream to read
+ * @param filename Name used for format detection
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int import_stream(Importer* imp, FILE* file, const char* filename) {
+    char* buffer = (char*)malloc(IMPORT_BLOCK_SIZE);
+    if (!buffer) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    size_t length = 0;
+    int first = 1;
+    int skipping = 0;
+    int result = TODO_OK;
+    for (;;) {
+        size_t got = fread(buffer + length, 1, IMPORT_BLOCK_SIZE - length, file);
+        length += got;
+        int at_eof = got == 0 || feof(file);
+        if (ferror(file)) {
+            result = TODO_ERR_IO;
+            break;
+        }
+        
+        size_t start = 0;
+        if (first && (length >= 3 || at_eof)) {
+            first = 0;
+            start = bom_length(buffer, length);
+            if (imp->format == TODO_IMPORT_AUTO) {
+                imp->format = detect_format(filename, buffer + start, length - start);
+            }
+        } else if (first) {
+            continue;
+        }
+        
+        if (skipping) {
+            // Drop the rest of a record that did not fit in the buffer
+            const char* newline = (const char*)memchr(buffer, '\n', length);
+            if (!newline) {
+                length = 0;
+                if (at_eof) {
+                    break;
+                }
+                continue;
+            }
+            start = (size_t)(newline + 1 - buffer);
+            skipping = 0;
+        }
+        
+        size_t consumed = 0;
+        result = import_block(imp, buffer + start, length - start, at_eof, &consumed);
+        if (result != TODO_OK || at_eof) {
+            break;
+        }
+        
+        start += consumed;
+        if (start == 0 && length == IMPORT_BLOCK_SIZE) {
+            imp->rejected++;
+            skipping = 1;
+            length = 0;
+            continue;
+        }
+        memmove(buffer, buffer + start, length - start);
+        length -= start;
+    }
+    
+    free(buffer);
+    return result;
+}
+
+/**
+ * @brief Import todos from a CSV or JSON-lines file
+ * @param list Pointer to the todo list to add to
+ * @param filename File to read, or "-" for stdin
+ * @param format Input format
+ * @param out_rejected Receives the number of skipped records (may be NULL)
+ * @return Number of todos imported, negative TodoError on failure
+ */
+int import_todos(TodoList* list, const char* filename, TodoImportFormat format, int* out_rejected) {
+    if (!list || !filename || format < TODO_IMPORT_AUTO || format > TODO_IMPORT_JSONL) {
+        return TODO_ERR_INVALID;
+    }
+    
+    Importer* imp = (Importer*)calloc(1, sizeof(Importer));
+    if (imp) {
+        imp->scratch = (char*)malloc((size_t)IMPORT_BATCH_SIZE * (MAX_TITLE_LENGTH + MAX_DESC_LENGTH));
+    }
+    if (!imp || !imp->scratch) {
+        free(imp);
+        return TODO_ERR_NO_MEMORY;
+    }
+    imp->list = list;
+    imp->format = format;
+    
+    int result = TODO_OK;
+    int use_stdin = strcmp(filename, "-") == 0;
+    FileMapping* mapping = use_stdin ? NULL : file_map(filename);
+    if (mapping) {
+        const char* data = (const char*)mapping->data;
+        size_t skip = bom_length(data, mapping->size);
+        if (imp->format == TODO_IMPORT_AUTO) {
+            imp->format = detect_format(filename, data + skip, mapping->size - skip);
+        }
+        size_t consumed;
+        result = import_block(imp, data + skip, mapping->size - skip, 1, &consumed);
+        file_unmap(mapping);
+    } else {
+        FILE* file = use_stdin ? stdin : fopen(filename, "rb");
+        if (!file) {
+            todo_log(TODO_LOG_ERROR, "Could not open %s for import", filename);
+            free(imp->scratch);
+            free(imp);
+            return TODO_ERR_IO;
+        }
+        result = import_stream(imp, file, filename);
+        if (!use_stdin) {
+            fclose(file);
+        }
+    }
+    
+    if (result == TODO_OK) {
+        result = flush_batch(imp);
+    }
+    
+    int imported = imp->imported;
+    if (out_rejected) {
+        *out_rejected = imp->rejected;
+    }
+    free(imp->scratch);
+    free(imp);
+    
+    return result != TODO_OK ? result : imported;
+}
\ No newline at end of file
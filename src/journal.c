@@ -0,0 +1,736 @@
+/**
+ * @file journal.c
+ * @brief Implementation of journaled (write-ahead log) persistence
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the change log that sits next to the snapshot
+ * file. The log starts with an 8-byte magic followed by records of the
+ * form:
+ *
+ *   u32 payload length | u32 CRC-32 of payload | payload
+ *
+ * where the payload is a u8 operation and a u32 ID, followed for creates
+ * and updates by the full state of the todo (u8 priority, u8 status,
+ * u64 created, u64 updated, u16 title length, u16 description length,
+ * title bytes, description bytes). Todos with a due date are logged as
+ * upserts with due, which add a u64 due time after the description
+ * length. All integers are little-endian. Since
+ * every record carries complete state, replaying a record twice is
+ * harmless, which keeps checkpoints simple.
+ *
+ * In asynchronous mode a worker thread owns the log file. Commits hand
+ * their records to it through a queue that coalesces everything handed
+ * over while the worker is busy into one write and one sync, and a
+ * checkpoint hands over a copy of the list, which supersedes any records
+ * still queued. Failures are remembered and reported by the next commit
+ * or flush, and the next commit then checkpoints, as in synchronous mode.
+ */
+
+#include "../include/journal.h"
+#include "../include/codec.h"
+#include "../include/file_io.h"
+#include "../include/metrics.h"
+#include "../include/todo_log.h"
+#include "../include/todo_sync.h"
+
+// Magic bytes at the start of every log file
+#define LOG_MAGIC "TDLOG\0\0\1"
+#define LOG_MAGIC_SIZE 8
+
+// Size of the length + CRC header in front of each record
+#define RECORD_HEADER_SIZE 8
+
+// Payload size of a delete record and of an upsert record without text
+#define DELETE_PAYLOAD_SIZE 5
+#define UPSERT_FIXED_SIZE 27
+#define UPSERT_DUE_FIXED_SIZE 35
+
+// Operation codes stored in records
+#define OP_UPSERT 1
+#define OP_DELETE 2
+#define OP_UPSERT_DUE 3
+
+// Longest snapshot/log filename the journal can handle
+#define JOURNAL_PATH_SIZE 512
+
+struct Journal {
+    TodoList* list;                         /**< Observed list */
+    char filename[JOURNAL_PATH_SIZE];       /**< Snapshot filename */
+    char log_filename[JOURNAL_PATH_SIZE];   /**< Log filename */
+    FILE* log;                              /**< Log opened for appending (lazily) */
+    size_t log_size;                        /**< Bytes currently in the log file */
+    unsigned char* pending;                 /**< Encoded records not yet committed */
+    size_t pending_size;                    /**< Bytes used in pending */
+    size_t pending_capacity;                /**< Bytes allocated for pending */
+    size_t checkpoint_bytes;                /**< Log size that triggers a checkpoint */
+    int needs_checkpoint;                   /**< Log cannot be appended to safely */
+    
+    // Asynchronous mode; fields below worker are guarded by mutex
+    TodoThread* worker;                     /**< Thread writing the log (NULL when synchronous) */
+    size_t handed_size;                     /**< Log size once everything handed over is written */
+    TodoMutex* mutex;
+    TodoCond* wake;                         /**< Signalled when work is queued or on stop */
+    TodoCond* idle;                         /**< Signalled when the worker finishes a batch */
+    unsigned char* queued;                  /**< Records handed to the worker, not yet written */
+    size_t queued_size;
+    size_t queued_capacity;
+    TodoList* queued_snapshot;              /**< Copy to checkpoint before writing queued */
+    unsigned long submitted;                /**< Batches handed over */
+    unsigned long completed;                /**< Batches written (or failed) */
+    int async_error;                        /**< First failure not yet reported */
+    int stopping;                           /**< Worker should exit once idle */
+};
+
+/**
+ * @brief Make room for extra more bytes in the pending buffer
+ * @param journal Journal owning the buffer
+ * @param extra Number of additional bytes needed
+ * @return 0 on success, -1 on allocation failure
+ */
+static int pending_reserve(Journal* journal, size_t extra) {
+    size_t needed = journal->pending_size + extra;
+    if (needed <= journal->pending_capacity) {
+        return 0;
+    }
+    
+    size_t new_capacity = journal->pending_capacity > 0 ? journal->pending_capacity : 4096;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    
+    unsigned char* new_pending = (unsigned char*)realloc(journal->pending, new_capacity);
+    if (!new_pending) {
+        return -1;
+    }
+    
+    journal->pending = new_pending;
+    journal->pending_capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * @brief Observer that encodes every list change into the pending buffer
+ * @param list List that changed
+ * @param change Kind of change
+ * @param todo Affected todo
+ * @param user_data The journal
+ */
+static void record_change(const TodoList* list, TodoChange change, const Todo* todo, void* user_data) {
+    Journal* journal = (Journal*)user_data;
+    if (change == TODO_CHANGE_PREPARE) {
+        return; // Only the state after the change is logged
+    }
+    
+    // Todos without a due date keep the shorter record older logs use
+    size_t fixed_size = todo->due_at != 0 ? UPSERT_DUE_FIXED_SIZE : UPSERT_FIXED_SIZE;
+    size_t payload_size = change == TODO_CHANGE_DELETE
+        ? DELETE_PAYLOAD_SIZE
+        : fixed_size + todo->title_length + todo->desc_length;
+    
+    if (pending_reserve(journal, RECORD_HEADER_SIZE + payload_size) != 0) {
+        // The change cannot be logged, so the next commit writes a snapshot
+        todo_log(TODO_LOG_WARNING, "Journal out of memory, falling back to a full save");
+        journal->needs_checkpoint = 1;
+        return;
+    }
+    
+    unsigned char* record = journal->pending + journal->pending_size;
+    unsigned char* payload = record + RECORD_HEADER_SIZE;
+    
+    payload[0] = change == TODO_CHANGE_DELETE ? OP_DELETE : todo->due_at != 0 ? OP_UPSERT_DUE : OP_UPSERT;
+    codec_put_u32(payload + 1, (uint32_t)todo->id);
+    if (change != TODO_CHANGE_DELETE) {
+        payload[5] = todo->priority;
+        payload[6] = todo->status;
+        codec_put_u64(payload + 7, (uint64_t)todo->created_at);
+        codec_put_u64(payload + 15, (uint64_t)todo->updated_at);
+        codec_put_u16(payload + 23, todo->title_length);
+        codec_put_u16(payload + 25, todo->desc_length);
+        if (todo->due_at != 0) {
+            codec_put_u64(payload + 27, (uint64_t)todo->due_at);
+        }
+        memcpy(payload + fixed_size, todo_get_title(list, todo), todo->title_length);
+        memcpy(payload + fixed_size + todo->title_length,
+               todo_get_description(list, todo), todo->desc_length);
+    }
+    
+    codec_put_u32(record, (uint32_t)payload_size);
+    codec_put_u32(record + 4, codec_crc32(0, payload, payload_size));
+    journal->pending_size += RECORD_HEADER_SIZE + payload_size;
+}
+
+/**
+ * @brief Walk the records of a log image, optionally applying them
+ * @param list List to apply records to, or NULL to only validate
+ * @param data Log file contents
+ * @param size Size of data
+ * @param valid_size Receives the length of the intact prefix of the log
+ * @return TODO_OK on success, negative TodoError if applying a record failed
+ */
+static int replay_buffer(TodoList* list, const unsigned char* data, size_t size, size_t* valid_size) {
+    *valid_size = 0;
+    if (size < LOG_MAGIC_SIZE || memcmp(data, LOG_MAGIC, LOG_MAGIC_SIZE) != 0) {
+        return TODO_OK;
+    }
+    
+    size_t offset = LOG_MAGIC_SIZE;
+    *valid_size = offset;
+    
+    while (size - offset >= RECORD_HEADER_SIZE) {
+        uint32_t payload_size = codec_get_u32(data + offset);
+        uint32_t crc = codec_get_u32(data + offset + 4);
+        const unsigned char* payload = data + offset + RECORD_HEADER_SIZE;
+        
+        if (payload_size < DELETE_PAYLOAD_SIZE ||
+            payload_size > size - offset - RECORD_HEADER_SIZE ||
+            codec_crc32(0, payload, payload_size) != crc) {
+            break; // Torn or corrupt tail
+        }
+        
+        int id = (int)codec_get_u32(payload + 1);
+        if (payload[0] == OP_UPSERT || payload[0] == OP_UPSERT_DUE) {
+            size_t fixed_size = payload[0] == OP_UPSERT_DUE ? UPSERT_DUE_FIXED_SIZE : UPSERT_FIXED_SIZE;
+            if (payload_size < fixed_size) {
+                break;
+            }
+            size_t title_length = codec_get_u16(payload + 23);
+            size_t desc_length = codec_get_u16(payload + 25);
+            if (fixed_size + title_length + desc_length != payload_size ||
+                title_length >= MAX_TITLE_LENGTH || desc_length >= MAX_DESC_LENGTH) {
+                break;
+            }
+            
+            if (list) {
+                char title[MAX_TITLE_LENGTH];
+                char description[MAX_DESC_LENGTH];
+                memcpy(title, payload + fixed_size, title_length);
+                title[title_length] = '\0';
+                memcpy(description, payload + fixed_size + title_length, desc_length);
+                description[desc_length] = '\0';
+                
+                int64_t due_at = payload[0] == OP_UPSERT_DUE ? (int64_t)codec_get_u64(payload + 27) : 0;
+                int result = todo_restore_ex(list, id, title, description,
+                                             (Priority)payload[5], (Status)payload[6],
+                                             (time_t)(int64_t)codec_get_u64(payload + 7),
+                                             (time_t)(int64_t)codec_get_u64(payload + 15), (time_t)due_at);
+                if (result != TODO_OK) {
+                    return result;
+                }
+            }
+        } else if (payload[0] == OP_DELETE) {
+            if (list) {
+                todo_delete(list, id); // Already absent is fine
+            }
+        } else {
+            break;
+        }
+        
+        offset += RECORD_HEADER_SIZE + payload_size;
+        *valid_size = offset;
+    }
+    
+    return TODO_OK;
+}
+
+/**
+ * @brief Read an entire log file into memory
+ * @param log_filename Log file to read
+ * @param size Receives the file size
+ * @return Heap buffer with the contents (caller frees), NULL if missing or unreadable
+ */
+static unsigned char* read_log(const char* log_filename, size_t* size) {
+    *size = 0;
+    FILE* file = fopen(log_filename, "rb");
+    if (!file) {
+        return NULL;
+    }
+    
+    unsigned char* data = NULL;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long length = ftell(file);
+        if (length > 0 && fseek(file, 0, SEEK_SET) == 0) {
+            data = (unsigned char*)malloc((size_t)length);
+            if (data && fread(data, 1, (size_t)length, file) == (size_t)length) {
+                *size = (size_t)length;
+                TODO_METRICS_READ(length);
+            } else {
+                free(data);
+                data = NULL;
+            }
+        }
+    }
+    
+    fclose(file);
+    return data;
+}
+
+/**
+ * @brief Build the log filename belonging to a snapshot filename
+ * @param filename Snapshot filename (NULL for default)
+ * @param buffer Buffer receiving the log filename
+ * @param size Size of buffer
+ * @return TODO_OK on success, TODO_ERR_INVALID if the name does not fit
+ */
+int journal_log_path(const char* filename, char* buffer, size_t size) {
+    int written = snprintf(buffer, size, "%s%s", filename ? filename : DEFAULT_FILENAME, JOURNAL_LOG_SUFFIX);
+    return written < 0 || (size_t)written >= size ? TODO_ERR_INVALID : TODO_OK;
+}
+
+/**
+ * @brief Apply the records of a log file to a list
+ * @param list Pointer to the todo list to apply changes to
+ * @param log_filename Log file to replay
+ * @return TODO_OK on success (including a missing log), negative TodoError on failure
+ */
+int journal_replay(TodoList* list, const char* log_filename) {
+    if (!list || !log_filename) {
+        return TODO_ERR_INVALID;
+    }
+    
+    size_t size;
+    unsigned char* data = read_log(log_filename, &size);
+    if (!data) {
+        return TODO_OK;
+    }
+    
+    size_t valid_size;
+    int result = replay_buffer(list, data, size, &valid_size);
+    if (result == TODO_OK && valid_size < size) {
+        todo_log(TODO_LOG_WARNING, "Ignoring %zu bytes of incomplete journal in '%s'",
+                 size - valid_size, log_filename);
+    }
+    
+    free(data);
+    return result;
+}
+
+/**
+ * @brief Start journaling changes made to a list
+ * @param list Pointer to the todo list to observe
+ * @param filename Snapshot filename (NULL for default)
+ * @return New journal, NULL on failure
+ */
+Journal* journal_open(TodoList* list, const char* filename) {
+    if (!list) {
+        return NULL;
+    }
+    
+    Journal* journal = (Journal*)calloc(1, sizeof(Journal));
+    if (!journal) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for journal");
+        return NULL;
+    }
+    
+    const char* snapshot = filename ? filename : DEFAULT_FILENAME;
+    if (strlen(snapshot) >= sizeof(journal->filename) ||
+        journal_log_path(snapshot, journal->log_filename, sizeof(journal->log_filename)) != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Journal filename too long");
+        free(journal);
+        return NULL;
+    }
+    strcpy(journal->filename, snapshot);
+    
+    journal->list = list;
+    journal->checkpoint_bytes = JOURNAL_DEFAULT_CHECKPOINT_BYTES;
+    
+    // Find out where new records can be appended; a damaged tail cannot be
+    // appended to, so the first commit will write a fresh snapshot instead
+    size_t size;
+    unsigned char* data = read_log(journal->log_filename, &size);
+    if (data) {
+        size_t valid_size;
+        replay_buffer(NULL, data, size, &valid_size);
+        journal->log_size = size;
+        journal->needs_checkpoint = valid_size < size;
+        free(data);
+    }
+    
+    if (todo_list_add_observer(list, record_change, journal) != TODO_OK) {
+        free(journal);
+        return NULL;
+    }
+    
+    return journal;
+}
+
+/**
+ * @brief Append encoded records to the log file and sync it
+ * @param journal Journal owning the log
+ * @param records Encoded records
+ * @param size Size of records in bytes
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int append_records(Journal* journal, const unsigned char* records, size_t size) {
+    if (!journal->log) {
+        if (ensure_parent_directory(journal->log_filename) != TODO_OK) {
+            todo_log(TODO_LOG_WARNING, "Could not create the directory of '%s'", journal->log_filename);
+        }
+        journal->log = fopen(journal->log_filename, "ab");
+        if (!journal->log) {
+            todo_log(TODO_LOG_ERROR, "Unable to open journal '%s' for appending", journal->log_filename);
+            return TODO_ERR_IO;
+        }
+    }
+    
+    if (journal->log_size == 0) {
+        if (fwrite(LOG_MAGIC, 1, LOG_MAGIC_SIZE, journal->log) != LOG_MAGIC_SIZE) {
+            todo_log(TODO_LOG_ERROR, "Failed to write journal header");
+            return TODO_ERR_IO;
+        }
+        journal->log_size = LOG_MAGIC_SIZE;
+    }
+    
+    if (fwrite(records, 1, size, journal->log) != size || file_sync(journal->log) != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Failed to append to journal '%s'", journal->log_filename);
+        return TODO_ERR_IO;
+    }
+    
+    journal->log_size += size;
+    TODO_METRICS_WRITTEN(size);
+    return TODO_OK;
+}
+
+/**
+ * @brief Save a snapshot over the journal's snapshot file and drop the log
+ * @param journal Journal owning the log
+ * @param list List to save (heap-owned)
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int write_checkpoint(Journal* journal, const TodoList* list) {
+    if (journal->log) {
+        fclose(journal->log);
+        journal->log = NULL;
+    }
+    
+    // Saving a snapshot also removes the log it supersedes
+    int result = save_todos_to_file(list, journal->filename);
+    if (result == TODO_OK) {
+        journal->log_size = 0;
+    }
+    return result;
+}
+
+/**
+ * @brief Body of the asynchronous writer thread
+ *
+ * Takes whatever has been queued, writes it without holding the mutex,
+ * and repeats until asked to stop with nothing left to write. After a
+ * failure nothing more is appended until a checkpoint succeeds, since
+ * the log would otherwise miss the records of the failed batch.
+ *
+ * @param arg The journal
+ */
+static void writer_main(void* arg) {
+    Journal* journal = (Journal*)arg;
+    unsigned char* batch = NULL;
+    size_t batch_capacity = 0;
+    int broken = 0;
+    
+    todo_mutex_lock(journal->mutex);
+    for (;;) {
+        while (!journal->stopping && journal->queued_size == 0 && !journal->queued_snapshot) {
+            todo_cond_wait(journal->wake, journal->mutex);
+        }
+        if (journal->queued_size == 0 && !journal->queued_snapshot) {
+            break;
+        }
+        
+        // Swap buffers so that commits can keep queueing while this batch is written
+        unsigned char* records = journal->queued;
+        size_t size = journal->queued_size;
+        size_t capacity = journal->queued_capacity;
+        journal->queued = batch;
+        journal->queued_capacity = batch_capacity;
+        journal->queued_size = 0;
+        batch = records;
+        batch_capacity = capacity;
+        TodoList* snapshot = journal->queued_snapshot;
+        journal->queued_snapshot = NULL;
+        unsigned long target = journal->submitted;
+        todo_mutex_unlock(journal->mutex);
+        
+        int result = TODO_OK;
+        if (snapshot) {
+            result = write_checkpoint(journal, snapshot);
+            todo_list_destroy(snapshot);
+            broken = result != TODO_OK;
+        }
+        if (result == TODO_OK && size > 0 && !broken) {
+            result = append_records(journal, records, size);
+            broken = result != TODO_OK;
+        }
+        
+        todo_mutex_lock(journal->mutex);
+        if (broken) {
+            journal->needs_checkpoint = 1;
+            if (journal->async_error == TODO_OK) {
+                journal->async_error = result != TODO_OK ? result : TODO_ERR_IO;
+            }
+        }
+        journal->completed = target;
+        todo_cond_broadcast(journal->idle);
+    }
+    todo_mutex_unlock(journal->mutex);
+    free(batch);
+}
+
+/**
+ * @brief Hand the pending records, or a checkpoint, to the writer thread
+ * @param journal Journal in asynchronous mode
+ * @param checkpoint Whether to hand over a copy of the list instead
+ * @return TODO_OK, or the first failure of earlier batches
+ */
+static int submit_async(Journal* journal, int checkpoint) {
+    todo_mutex_lock(journal->mutex);
+    int result = journal->async_error;
+    journal->async_error = TODO_OK;
+    checkpoint = checkpoint || journal->needs_checkpoint ||
+                 journal->handed_size + journal->pending_size > journal->checkpoint_bytes;
+    todo_mutex_unlock(journal->mutex);
+    
+    if (!checkpoint && journal->pending_size == 0) {
+        return result;
+    }
+    
+    TodoList* snapshot = NULL;
+    if (checkpoint) {
+        // The copy is taken here, while the list is known not to change
+        if (todo_list_make_writable(journal->list) != TODO_OK ||
+            !(snapshot = todo_list_clone(journal->list))) {
+            todo_mutex_lock(journal->mutex);
+            journal->needs_checkpoint = 1;
+            todo_mutex_unlock(journal->mutex);
+            return TODO_ERR_NO_MEMORY;
+        }
+    }
+    
+    todo_mutex_lock(journal->mutex);
+    if (snapshot) {
+        // The copy already contains every queued record
+        todo_list_destroy(journal->queued_snapshot);
+        journal->queued_snapshot = snapshot;
+        journal->queued_size = 0;
+        journal->needs_checkpoint = 0;
+        journal->handed_size = LOG_MAGIC_SIZE;
+    } else if (journal->queued_size == 0) {
+        // Nothing is waiting, so hand the buffer over without copying
+        unsigned char* buffer = journal->queued;
+        size_t capacity = journal->queued_capacity;
+        journal->queued = journal->pending;
+        journal->queued_capacity = journal->pending_capacity;
+        journal->queued_size = journal->pending_size;
+        journal->pending = buffer;
+        journal->pending_capacity = capacity;
+        journal->handed_size += journal->pending_size;
+    } else {
+        size_t needed = journal->queued_size + journal->pending_size;
+        if (needed > journal->queued_capacity) {
+            unsigned char* grown = (unsigned char*)realloc(journal->queued, needed * 2);
+            if (!grown) {
+                todo_mutex_unlock(journal->mutex);
+                return TODO_ERR_NO_MEMORY;
+            }
+            journal->queued = grown;
+            journal->queued_capacity = needed * 2;
+        }
+        memcpy(journal->queued + journal->queued_size, journal->pending, journal->pending_size);
+        journal->queued_size = needed;
+        journal->handed_size += journal->pending_size;
+    }
+    journal->pending_size = 0;
+    journal->submitted++;
+    todo_cond_signal(journal->wake);
+    todo_mutex_unlock(journal->mutex);
+    return result;
+}
+
+/**
+ * @brief Append all changes recorded since the last commit to the log
+ * @param journal Journal to commit
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int journal_commit(Journal* journal) {
+    if (!journal) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (journal->worker) {
+        return submit_async(journal, 0);
+    }
+    
+    if (journal->needs_checkpoint) {
+        return journal_checkpoint(journal);
+    }
+    
+    if (journal->pending_size == 0) {
+        return TODO_OK;
+    }
+    
+    if (append_records(journal, journal->pending, journal->pending_size) != TODO_OK) {
+        // Part of the batch may have reached the log; rewrite everything
+        journal->needs_checkpoint = 1;
+        return TODO_ERR_IO;
+    }
+    journal->pending_size = 0;
+    
+    if (journal->log_size > journal->checkpoint_bytes) {
+        return journal_checkpoint(journal);
+    }
+    
+    return TODO_OK;
+}
+
+/**
+ * @brief Write a full snapshot of the list and start a new, empty log
+ * @param journal Journal to checkpoint
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int journal_checkpoint(Journal* journal) {
+    if (!journal) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (journal->worker) {
+        return submit_async(journal, 1);
+    }
+    
+    int result = todo_list_make_writable(journal->list);
+    if (result == TODO_OK) {
+        result = write_checkpoint(journal, journal->list);
+    }
+    if (result != TODO_OK) {
+        journal->needs_checkpoint = 1;
+        return result;
+    }
+    
+    journal->pending_size = 0;
+    journal->needs_checkpoint = 0;
+    return TODO_OK;
+}
+
+/**
+ * @brief Move log writes to a background thread
+ * @param journal Journal to switch
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int journal_start_async(Journal* journal) {
+    if (!journal) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (journal->worker) {
+        return TODO_OK;
+    }
+    
+    journal->mutex = todo_mutex_create();
+    journal->wake = todo_cond_create();
+    journal->idle = todo_cond_create();
+    journal->handed_size = journal->log_size;
+    journal->stopping = 0;
+    if (journal->mutex && journal->wake && journal->idle) {
+        journal->worker = todo_thread_start(writer_main, journal);
+    }
+    
+    if (!journal->worker) {
+        todo_log(TODO_LOG_ERROR, "Failed to start journal writer thread");
+        todo_cond_destroy(journal->idle);
+        todo_cond_destroy(journal->wake);
+        todo_mutex_destroy(journal->mutex);
+        journal->idle = NULL;
+        journal->wake = NULL;
+        journal->mutex = NULL;
+        return TODO_ERR_NO_MEMORY;
+    }
+    return TODO_OK;
+}
+
+/**
+ * @brief Commit and wait until everything committed so far is on disk
+ * @param journal Journal to flush
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int journal_flush(Journal* journal) {
+    if (!journal) {
+        return TODO_ERR_INVALID;
+    }
+    
+    int result = journal_commit(journal);
+    if (!journal->worker) {
+        return result;
+    }
+    
+    todo_mutex_lock(journal->mutex);
+    while (journal->completed != journal->submitted) {
+        todo_cond_wait(journal->idle, journal->mutex);
+    }
+    if (result == TODO_OK) {
+        result = journal->async_error;
+    }
+    journal->async_error = TODO_OK;
+    todo_mutex_unlock(journal->mutex);
+    return result;
+}
+
+/**
+ * @brief Stop the background thread once it has written everything handed to it
+ * @param journal Journal in asynchronous mode
+ */
+static void stop_async(Journal* journal) {
+    todo_mutex_lock(journal->mutex);
+    journal->stopping = 1;
+    todo_cond_signal(journal->wake);
+    todo_mutex_unlock(journal->mutex);
+    
+    todo_thread_join(journal->worker);
+    journal->worker = NULL;
+    
+    if (journal->async_error != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Journal writes failed before close");
+    }
+    todo_list_destroy(journal->queued_snapshot);
+    free(journal->queued);
+    todo_cond_destroy(journal->idle);
+    todo_cond_destroy(journal->wake);
+    todo_mutex_destroy(journal->mutex);
+}
+
+/**
+ * @brief Set the log size that triggers an automatic checkpoint
+ * @param journal Journal to configure
+ * @param bytes Threshold in bytes (0 checkpoints on every commit)
+ */
+void journal_set_checkpoint_threshold(Journal* journal, size_t bytes) {
+    if (journal) {
+        journal->checkpoint_bytes = bytes;
+    }
+}
+
+/**
+ * @brief Number of bytes of changes recorded but not yet committed
+ * @param journal Journal to inspect
+ * @return Pending byte count
+ */
+size_t journal_pending_bytes(const Journal* journal) {
+    return journal ? journal->pending_size : 0;
+}
+
+/**
+ * @brief Stop journaling and free the journal
+ * @param journal Journal to close
+ */
+void journal_close(Journal* journal) {
+    if (!journal) {
+        return;
+    }
+    
+    todo_list_remove_observer(journal->list, record_change, journal);
+    if (journal->worker) {
+        stop_async(journal);
+    }
+    if (journal->log) {
+        fclose(journal->log);
+    }
+    free(journal->pending);
+    free(journal);
+}
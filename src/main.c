@@ -9,7 +9,11 @@
  */
 
 #include "../include/todo.h"
+#include "../include/todo_log.h"
 #include "../include/file_io.h"
+#include "../include/journal.h"
+#include "../include/history.h"
+#include "../include/cli.h"
 
 // Function prototypes for menu functions
 void show_menu(void);
@@ -19,6 +23,11 @@ void handle_delete_todo(TodoList* list);
 void handle_complete_todo(TodoList* list);
 void handle_view_todo(TodoList* list);
 void handle_export_todos(TodoList* list);
+void handle_undo(TodoHistory* history, int redo);
+void load_and_report(TodoList* list);
+void save_and_report(TodoList* list, Journal* journal);
+void report_todo_result(int id, int result, const char* action);
+void print_log_message(TodoLogLevel level, const char* message, void* user_data);
 void clear_input_buffer(void);
 int get_integer_input(const char* prompt);
 Priority get_priority_input(void);
@@ -26,9 +35,22 @@ void get_string_input(const char* prompt, char* buffer, int max_length);
 
 /**
  * @brief Main function - entry point of the program
+ *
+ * With arguments the program runs non-interactively (see cli.h);
+ * without any it shows the menu.
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
  * @return 0 on successful execution, -1 on error
  */
-int main(void) {
+int main(int argc, char** argv) {
+    // Show library diagnostics on stderr
+    todo_set_log_handler(print_log_message, NULL);
+    
+    if (argc > 1) {
+        return cli_run(argc, argv);
+    }
+    
     printf("=== Todo List Manager ===\n");
     printf("Welcome to your personal todo list!\n\n");
     
@@ -40,7 +62,16 @@ int main(void) {
     }
     
     // Load existing todos from file
-    load_todos_from_file(todo_list, NULL);
+    load_and_report(todo_list);
+    
+    // Record further changes in the journal so saves only write what changed
+    Journal* journal = journal_open(todo_list, NULL);
+    if (journal && journal_start_async(journal) != TODO_OK) {
+        printf("Warning: saving in the foreground\n");
+    }
+    
+    // Each menu action becomes one undo step
+    TodoHistory* history = todo_history_attach(todo_list);
     
     int choice;
     int running = 1;
@@ -52,7 +83,7 @@ int main(void) {
         // Handle EOF or input error
         if (choice == -1) {
             printf("\nInput stream ended. Exiting...\n");
-            save_todos_to_file(todo_list, NULL);
+            save_and_report(todo_list, journal);
             running = 0;
             break;
         }
@@ -77,34 +108,49 @@ int main(void) {
                 handle_complete_todo(todo_list);
                 break;
             case 7:
-                save_todos_to_file(todo_list, NULL);
+                save_and_report(todo_list, journal);
                 break;
             case 8:
                 handle_export_todos(todo_list);
                 break;
             case 9:
                 printf("Saving todos before exit...\n");
-                save_todos_to_file(todo_list, NULL);
+                save_and_report(todo_list, journal);
                 running = 0;
                 break;
+            case 10:
+                handle_undo(history, 0);
+                break;
+            case 11:
+                handle_undo(history, 1);
+                break;
             default:
                 printf("Invalid choice. Please try again.\n");
                 break;
         }
         
+        todo_history_mark(history);
+        
+        // Write each change in the background while the user carries on
+        if (journal && journal_pending_bytes(journal) > 0) {
+            journal_commit(journal);
+        }
+        
         if (running) {
             printf("\nPress Enter to continue...");
             // Handle EOF in getchar as well
             int c = getchar();
             if (c == EOF) {
                 printf("\nInput stream ended. Exiting...\n");
-                save_todos_to_file(todo_list, NULL);
+                save_and_report(todo_list, journal);
                 running = 0;
             }
         }
     }
     
     // Cleanup
+    todo_history_detach(history);
+    journal_close(journal);
     todo_list_destroy(todo_list);
     printf("\nThank you for using Todo List Manager!\n");
     return 0;
@@ -124,6 +170,8 @@ void show_menu(void) {
     printf("7. Save todos to file\n");
     printf("8. Export todos to text file\n");
     printf("9. Exit\n");
+    printf("10. Undo last change\n");
+    printf("11. Redo\n");
     printf("================\n");
 }
 
@@ -149,8 +197,11 @@ void handle_create_todo(TodoList* list) {
     Priority priority = get_priority_input();
     
     int id = todo_create(list, title, description[0] ? description : NULL, priority);
-    if (id != -1) {
+    if (id > 0) {
+        printf("Todo created successfully with ID: %d\n", id);
         printf("\nTodo created successfully!\n");
+    } else {
+        printf("Failed to create todo: %s\n", todo_strerror(id));
     }
 }
 
@@ -206,7 +257,8 @@ void handle_update_todo(TodoList* list) {
         new_priority = get_priority_input();
     }
     
-    todo_update(list, id, new_title, new_description, new_priority);
+    report_todo_result(id, todo_update(list, id, new_title, new_description, new_priority),
+                       "updated successfully");
 }
 
 /**
@@ -229,7 +281,7 @@ void handle_delete_todo(TodoList* list) {
     fgets(confirmation, sizeof(confirmation), stdin);
     
     if (confirmation[0] == 'y' || confirmation[0] == 'Y') {
-        todo_delete(list, id);
+        report_todo_result(id, todo_delete(list, id), "deleted successfully");
     } else {
         printf("Delete operation cancelled.\n");
     }
@@ -254,12 +306,22 @@ void handle_complete_todo(TodoList* list) {
     printf("2. Mark as pending\n");
     int choice = get_integer_input("Enter your choice");
     
+    const Todo* todo = todo_find_by_id(list, id);
+    
     switch (choice) {
         case 1:
-            todo_complete(list, id);
+            if (todo && todo->status == STATUS_COMPLETED) {
+                printf("Todo with ID %d is already completed.\n", id);
+            } else {
+                report_todo_result(id, todo_complete(list, id), "marked as completed");
+            }
             break;
         case 2:
-            todo_mark_pending(list, id);
+            if (todo && todo->status == STATUS_PENDING) {
+                printf("Todo with ID %d is already pending.\n", id);
+            } else {
+                report_todo_result(id, todo_mark_pending(list, id), "marked as pending");
+            }
             break;
         default:
             printf("Invalid choice.\n");
@@ -278,7 +340,9 @@ void handle_view_todo(TodoList* list) {
     }
     
     int id = get_integer_input("Enter todo ID to view");
-    todo_read_by_id(list, id);
+    if (todo_read_by_id(list, id) == TODO_ERR_NOT_FOUND) {
+        printf("Todo with ID %d not found.\n", id);
+    }
 }
 
 /**
@@ -289,7 +353,103 @@ void handle_export_todos(TodoList* list) {
     char filename[256];
     
     get_string_input("Enter filename for export (e.g., data/todos.txt)", filename, sizeof(filename));
-    export_todos_to_text(list, filename);
+    if (export_todos_to_text(list, filename) == TODO_OK) {
+        printf("Successfully exported todos to '%s'\n", filename);
+    }
+}
+
+/**
+ * @brief Handle undoing or redoing the last menu action
+ * @param history History of the list (NULL if it could not be created)
+ * @param redo Non-zero to redo instead of undo
+ */
+void handle_undo(TodoHistory* history, int redo) {
+    int result = redo ? todo_history_redo(history) : todo_history_undo(history);
+    if (result == TODO_OK) {
+        printf("%s. %d change(s) can be undone, %d redone.\n", redo ? "Redone" : "Undone",
+               todo_history_undo_count(history), todo_history_redo_count(history));
+    } else if (result == TODO_ERR_NOT_FOUND) {
+        printf("Nothing to %s.\n", redo ? "redo" : "undo");
+    } else {
+        printf("Error: %s\n", todo_strerror(result));
+    }
+}
+
+/**
+ * @brief Load todos from the default file and report the outcome
+ * @param list Pointer to the todo list
+ */
+void load_and_report(TodoList* list) {
+    // Saves may have been journaled before any snapshot was written, so
+    // a log on its own still holds todos
+    char log_filename[512];
+    int has_log = journal_log_path(DEFAULT_FILENAME, log_filename, sizeof(log_filename)) == TODO_OK &&
+                  file_exists(log_filename);
+    if (!file_exists(DEFAULT_FILENAME) && !has_log) {
+        printf("No existing todo file found. Starting with empty list.\n");
+        return;
+    }
+    
+    // Map the file so startup does not copy todos that are never touched
+    if (load_todos_from_file_ex(list, NULL, TODO_LOAD_MAP) == TODO_OK) {
+        printf("Successfully loaded %d todos from '%s'\n", list->count,
+               file_exists(DEFAULT_FILENAME) ? DEFAULT_FILENAME : log_filename);
+    }
+}
+
+/**
+ * @brief Save todos to the default file and report the outcome
+ *
+ * With a journal only the changes since the last save are appended to the
+ * log, and the call waits for the background writer to finish; without
+ * one (e.g. if it could not be opened) a full snapshot is written.
+ *
+ * @param list Pointer to the todo list
+ * @param journal Journal recording changes to list, or NULL
+ */
+void save_and_report(TodoList* list, Journal* journal) {
+    int result = journal ? journal_flush(journal) : todo_list_make_writable(list);
+    if (!journal && result == TODO_OK) {
+        result = save_todos_to_file(list, NULL);
+    }
+    if (result != TODO_OK) {
+        return;
+    }
+    
+    char log_filename[512];
+    if (journal && journal_log_path(DEFAULT_FILENAME, log_filename, sizeof(log_filename)) == TODO_OK &&
+        file_exists(log_filename)) {
+        // Only the changes went to the log; the snapshot is rewritten at checkpoints
+        printf("Successfully saved %d todos (changes journaled to '%s')\n", list->count, log_filename);
+    } else {
+        printf("Successfully saved %d todos to '%s'\n", list->count, DEFAULT_FILENAME);
+    }
+}
+
+/**
+ * @brief Print the outcome of an operation on a single todo
+ * @param id ID of the todo
+ * @param result Return code of the operation
+ * @param action Description of the successful action (e.g. "deleted successfully")
+ */
+void report_todo_result(int id, int result, const char* action) {
+    if (result == TODO_OK) {
+        printf("Todo with ID %d %s.\n", id, action);
+    } else if (result == TODO_ERR_NOT_FOUND) {
+        printf("Todo with ID %d not found.\n", id);
+    }
+    // Other failures have already been reported through the log handler
+}
+
+/**
+ * @brief Log handler that prints library diagnostics to stderr
+ * @param level Severity of the message
+ * @param message Formatted message
+ * @param user_data Unused
+ */
+void print_log_message(TodoLogLevel level, const char* message, void* user_data) {
+    (void)user_data;
+    fprintf(stderr, "%s: %s\n", level == TODO_LOG_ERROR ? "Error" : level == TODO_LOG_WARNING ? "Warning" : "Info", message);
 }
 
 /**
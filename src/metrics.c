@@ -0,0 +1,397 @@
+/**
+ * @file metrics.c
+ * @brief Implementation of the hot-path metrics
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the per-thread shards behind metrics.h. A thread
+ * takes a shard from a registry the first time it records and then
+ * writes to it through a thread-local pointer. Only the owning thread
+ * ever writes a shard's counters, so they are updated with relaxed
+ * atomic loads and stores rather than read-modify-writes, which costs
+ * the same as plain increments on common targets. Resetting bumps a
+ * generation number instead of clearing other threads' shards; each
+ * owner clears its own shard when it next records, and snapshots skip
+ * shards that have not caught up. Threads started by todo_thread_start
+ * hand their shard back when they finish: its totals are folded into a
+ * retired shard and it is reused by the next thread, so short-lived
+ * pool threads do not accumulate shards.
+ */
+
+#include "../include/metrics.h"
+#include "../include/todo_sync.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const OP_NAMES[TODO_METRIC_COUNT] = {
+    "create", "update", "delete", "query", "render", "save", "load", "fsync"
+};
+
+#ifndef TODO_NO_METRICS
+
+// Relaxed access to counters read by other threads; the generation is
+// published with release so a snapshot sees the clearing that preceded it
+#if defined(__GNUC__) || defined(__clang__)
+#define COUNTER_LOAD(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+#define COUNTER_STORE(counter, value) __atomic_store_n(&(counter), (value), __ATOMIC_RELAXED)
+#define GENERATION_LOAD(generation) __atomic_load_n(&(generation), __ATOMIC_ACQUIRE)
+#define GENERATION_STORE(generation, value) __atomic_store_n(&(generation), (value), __ATOMIC_RELEASE)
+#else
+// Aligned volatile words are atomic and ordered on MSVC (/volatile:ms);
+// elsewhere snapshots are only exact while no other thread records
+#define COUNTER_LOAD(counter) (*(volatile uint64_t*)&(counter))
+#define COUNTER_STORE(counter, value) (*(volatile uint64_t*)&(counter) = (value))
+#define GENERATION_LOAD(generation) COUNTER_LOAD(generation)
+#define GENERATION_STORE(generation, value) COUNTER_STORE(generation, value)
+#endif
+
+#define COUNTER_ADD(counter, value) COUNTER_STORE(counter, COUNTER_LOAD(counter) + (value))
+
+// Calls per timed call of each operation; the slow ones are always timed
+static const int SAMPLE_EVERY[TODO_METRIC_COUNT] = {
+    TODO_METRICS_SAMPLE_EVERY, TODO_METRICS_SAMPLE_EVERY, TODO_METRICS_SAMPLE_EVERY,
+    TODO_METRICS_SAMPLE_EVERY, 1, 1, 1, 1
+};
+
+/**
+ * @brief Metrics of one thread
+ */
+typedef struct MetricsShard {
+    TodoMetrics totals;                    // Written only by the owning thread
+    int until_sample[TODO_METRIC_COUNT];   // Calls left before the next timed one
+    uint64_t generation;                   // Reset generation the totals belong to
+    int in_use;                            // Owned by a running thread
+    struct MetricsShard* next;             // Every shard ever allocated
+} MetricsShard;
+
+// Registry of shards and the totals of finished threads (guarded by todo_global_lock)
+static MetricsShard* shards = NULL;
+static TodoMetrics retired;
+static int thread_count = 0;
+static int hook_installed = 0;
+
+// Bumped by todo_metrics_reset under the lock; read by recording threads without it
+static uint64_t generation = 0;
+
+// Shard of the calling thread, NULL until it first records
+static TODO_THREAD_LOCAL MetricsShard* current = NULL;
+
+/**
+ * @brief Add one set of totals to another
+ * @param sum Totals to add to (not shared with other threads)
+ * @param part Totals to add, possibly being recorded into by their owner
+ */
+static void add_totals(TodoMetrics* sum, TodoMetrics* part) {
+    for (int op = 0; op < TODO_METRIC_COUNT; op++) {
+        TodoOpMetrics* to = &sum->ops[op];
+        TodoOpMetrics* from = &part->ops[op];
+        to->calls += COUNTER_LOAD(from->calls);
+        to->timed += COUNTER_LOAD(from->timed);
+        to->total_ns += COUNTER_LOAD(from->total_ns);
+        uint64_t max_ns = COUNTER_LOAD(from->max_ns);
+        if (max_ns > to->max_ns) {
+            to->max_ns = max_ns;
+        }
+        for (int bucket = 0; bucket < TODO_METRICS_BUCKETS; bucket++) {
+            to->histogram[bucket] += COUNTER_LOAD(from->histogram[bucket]);
+        }
+    }
+    sum->bytes_read += COUNTER_LOAD(part->bytes_read);
+    sum->bytes_written += COUNTER_LOAD(part->bytes_written);
+}
+
+/**
+ * @brief Zero a set of totals that other threads may be reading
+ * @param totals Totals to clear
+ */
+static void clear_totals(TodoMetrics* totals) {
+    for (int op = 0; op < TODO_METRIC_COUNT; op++) {
+        TodoOpMetrics* metrics = &totals->ops[op];
+        COUNTER_STORE(metrics->calls, 0);
+        COUNTER_STORE(metrics->timed, 0);
+        COUNTER_STORE(metrics->total_ns, 0);
+        COUNTER_STORE(metrics->max_ns, 0);
+        for (int bucket = 0; bucket < TODO_METRICS_BUCKETS; bucket++) {
+            COUNTER_STORE(metrics->histogram[bucket], 0);
+        }
+    }
+    COUNTER_STORE(totals->bytes_read, 0);
+    COUNTER_STORE(totals->bytes_written, 0);
+}
+
+/**
+ * @brief Shard of the calling thread, cleared first if metrics were reset since it last recorded
+ * @param shard Shard owned by the calling thread
+ * @return shard
+ */
+static MetricsShard* catch_up(MetricsShard* shard) {
+    uint64_t current_generation = GENERATION_LOAD(generation);
+    if (shard->generation != current_generation) {
+        clear_totals(&shard->totals);
+        GENERATION_STORE(shard->generation, current_generation);
+    }
+    return shard;
+}
+
+/**
+ * @brief Hand the calling thread's shard back as the thread finishes
+ */
+static void release_shard(void) {
+    MetricsShard* shard = current;
+    if (!shard) {
+        return;
+    }
+    current = NULL;
+    
+    todo_global_lock();
+    if (shard->generation == generation) {
+        add_totals(&retired, &shard->totals);
+    }
+    clear_totals(&shard->totals);
+    shard->in_use = 0;
+    todo_global_unlock();
+}
+
+/**
+ * @brief Give the calling thread a shard
+ * @return The shard, NULL on allocation failure (nothing is recorded then)
+ */
+static MetricsShard* acquire_shard(void) {
+    todo_global_lock();
+    int install_hook = !hook_installed;
+    hook_installed = 1;
+    MetricsShard* shard = shards;
+    while (shard && shard->in_use) {
+        shard = shard->next;
+    }
+    if (!shard) {
+        shard = (MetricsShard*)calloc(1, sizeof(MetricsShard));
+        if (shard) {
+            shard->next = shards;
+            shards = shard;
+        }
+    }
+    if (shard) {
+        // Free shards are already clear
+        shard->generation = generation;
+        shard->in_use = 1;
+        thread_count++;
+    }
+    todo_global_unlock();
+    
+    // The hook takes the lock itself
+    if (install_hook) {
+        todo_thread_set_exit_hook(release_shard);
+    }
+    
+    current = shard;
+    return shard;
+}
+
+/**
+ * @brief Count a call and decide whether to time it
+ * @param op Operation starting
+ * @return Start time in nanoseconds if the call is timed, 0 otherwise
+ */
+uint64_t todo_metrics_begin(TodoMetricOp op) {
+    MetricsShard* shard = current ? catch_up(current) : acquire_shard();
+    if (!shard) {
+        return 0;
+    }
+    
+    COUNTER_ADD(shard->totals.ops[op].calls, 1);
+    if (--shard->until_sample[op] > 0) {
+        return 0;
+    }
+    shard->until_sample[op] = SAMPLE_EVERY[op];
+    return todo_clock_ns();
+}
+
+/**
+ * @brief Record the latency of a timed call
+ * @param op Operation finishing
+ * @param start Value returned by todo_metrics_begin (non-zero)
+ */
+void todo_metrics_end(TodoMetricOp op, uint64_t start) {
+    uint64_t elapsed = todo_clock_ns() - start;
+    MetricsShard* shard = current;
+    if (!shard) {
+        return;
+    }
+    
+    // Bucket of the highest set bit
+    int bucket = 0;
+    while (bucket < TODO_METRICS_BUCKETS - 1 && (elapsed >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    
+    // A reset since the call began drops it
+    if (shard->generation != GENERATION_LOAD(generation)) {
+        return;
+    }
+    
+    TodoOpMetrics* metrics = &shard->totals.ops[op];
+    COUNTER_ADD(metrics->timed, 1);
+    COUNTER_ADD(metrics->total_ns, elapsed);
+    if (elapsed > metrics->max_ns) {
+        COUNTER_STORE(metrics->max_ns, elapsed);
+    }
+    COUNTER_ADD(metrics->histogram[bucket], 1);
+}
+
+/**
+ * @brief Account bytes moved to or from files
+ * @param read Bytes read or mapped
+ * @param written Bytes written
+ */
+void todo_metrics_add_bytes(uint64_t read, uint64_t written) {
+    MetricsShard* shard = current ? catch_up(current) : acquire_shard();
+    if (shard) {
+        COUNTER_ADD(shard->totals.bytes_read, read);
+        COUNTER_ADD(shard->totals.bytes_written, written);
+    }
+}
+
+/**
+ * @brief Sum the metrics of every thread
+ * @param metrics Receives the totals (all zero if metrics are compiled out)
+ */
+void todo_metrics_snapshot(TodoMetrics* metrics) {
+    if (!metrics) {
+        return;
+    }
+    
+    todo_global_lock();
+    *metrics = retired;
+    for (MetricsShard* shard = shards; shard; shard = shard->next) {
+        // Shards still holding totals from before a reset count as empty
+        if (shard->in_use && GENERATION_LOAD(shard->generation) == generation) {
+            add_totals(metrics, &shard->totals);
+        }
+    }
+    metrics->threads = thread_count;
+    todo_global_unlock();
+    metrics->enabled = 1;
+}
+
+/**
+ * @brief Zero the metrics of every thread
+ */
+void todo_metrics_reset(void) {
+    todo_global_lock();
+    memset(&retired, 0, sizeof(retired));
+    
+    // Running threads clear their own shards when they next record
+    GENERATION_STORE(generation, generation + 1);
+    todo_global_unlock();
+}
+
+#else
+
+/**
+ * @brief Sum the metrics of every thread
+ * @param metrics Receives all zeros, since metrics are compiled out
+ */
+void todo_metrics_snapshot(TodoMetrics* metrics) {
+    if (metrics) {
+        memset(metrics, 0, sizeof(TodoMetrics));
+    }
+}
+
+/**
+ * @brief Zero the metrics of every thread (nothing to do when compiled out)
+ */
+void todo_metrics_reset(void) {
+}
+
+#endif // TODO_NO_METRICS
+
+/**
+ * @brief Name of an operation
+ * @param op Operation
+ * @return Lower-case name (e.g. "create"), "unknown" if op is out of range
+ */
+const char* todo_metrics_name(TodoMetricOp op) {
+    return (int)op >= 0 && op < TODO_METRIC_COUNT ? OP_NAMES[op] : "unknown";
+}
+
+/**
+ * @brief Estimate a latency percentile from an operation's histogram
+ * @param op Totals of the operation
+ * @param percent Percentile (0-100)
+ * @return Upper bound of the bucket holding the percentile (at most max_ns), 0 if nothing was timed
+ */
+uint64_t todo_metrics_percentile(const TodoOpMetrics* op, double percent) {
+    if (!op || op->timed == 0) {
+        return 0;
+    }
+    
+    // Rank of the call at the percentile, counting from 1
+    uint64_t rank = (uint64_t)(percent / 100.0 * (double)op->timed + 0.999999);
+    rank = rank < 1 ? 1 : rank > op->timed ? op->timed : rank;
+    
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < TODO_METRICS_BUCKETS - 1; bucket++) {
+        seen += op->histogram[bucket];
+        if (seen >= rank) {
+            uint64_t bound = (uint64_t)2 << bucket;
+            return bound < op->max_ns ? bound : op->max_ns;
+        }
+    }
+    return op->max_ns;
+}
+
+/**
+ * @brief Write metrics as text in the Prometheus exposition format
+ * @param metrics Totals to write
+ * @param out Stream to write to
+ * @return 0 on success, -1 on a write error
+ */
+int todo_metrics_write(const TodoMetrics* metrics, FILE* out) {
+    if (!metrics || !out) {
+        return -1;
+    }
+    
+    fprintf(out, "# HELP todo_op_calls_total Calls of each operation.\n");
+    fprintf(out, "# TYPE todo_op_calls_total counter\n");
+    for (int op = 0; op < TODO_METRIC_COUNT; op++) {
+        fprintf(out, "todo_op_calls_total{op=\"%s\"} %llu\n", OP_NAMES[op],
+                (unsigned long long)metrics->ops[op].calls);
+    }
+    
+    fprintf(out, "# HELP todo_op_latency_seconds Latency of the timed calls of each operation.\n");
+    fprintf(out, "# TYPE todo_op_latency_seconds histogram\n");
+    for (int op = 0; op < TODO_METRIC_COUNT; op++) {
+        const TodoOpMetrics* stats = &metrics->ops[op];
+        
+        // Buckets past the slowest call add nothing but +Inf
+        int last = TODO_METRICS_BUCKETS - 2;
+        while (last >= 0 && stats->histogram[last] == 0) {
+            last--;
+        }
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket <= last; bucket++) {
+            seen += stats->histogram[bucket];
+            fprintf(out, "todo_op_latency_seconds_bucket{op=\"%s\",le=\"%.9g\"} %llu\n", OP_NAMES[op],
+                    (double)((uint64_t)2 << bucket) / 1e9, (unsigned long long)seen);
+        }
+        fprintf(out, "todo_op_latency_seconds_bucket{op=\"%s\",le=\"+Inf\"} %llu\n", OP_NAMES[op],
+                (unsigned long long)stats->timed);
+        fprintf(out, "todo_op_latency_seconds_sum{op=\"%s\"} %.9f\n", OP_NAMES[op],
+                (double)stats->total_ns / 1e9);
+        fprintf(out, "todo_op_latency_seconds_count{op=\"%s\"} %llu\n", OP_NAMES[op],
+                (unsigned long long)stats->timed);
+    }
+    
+    fprintf(out, "# HELP todo_bytes_read_total Snapshot and journal bytes loaded.\n");
+    fprintf(out, "# TYPE todo_bytes_read_total counter\n");
+    fprintf(out, "todo_bytes_read_total %llu\n", (unsigned long long)metrics->bytes_read);
+    fprintf(out, "# HELP todo_bytes_written_total Snapshot and journal bytes written.\n");
+    fprintf(out, "# TYPE todo_bytes_written_total counter\n");
+    fprintf(out, "todo_bytes_written_total %llu\n", (unsigned long long)metrics->bytes_written);
+    fprintf(out, "# HELP todo_metrics_threads Threads that have recorded metrics.\n");
+    fprintf(out, "# TYPE todo_metrics_threads gauge\n");
+    fprintf(out, "todo_metrics_threads %d\n", metrics->threads);
+    return ferror(out) ? -1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,275 @@
+/**
+ * @file render.c
+ * @brief Implementation of buffered text rendering
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the RenderBuffer formatting primitives and the
+ * cached local-time breakdown used when listing and exporting todos.
+ */
+
+// Needed for localtime_r() under -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/render.h"
+#include "../include/todo.h"
+
+#include <string.h>
+
+// Seconds in a day without a UTC offset change
+#define SECONDS_PER_DAY 86400
+
+static const char* const weekday_names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char* const month_names[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                          "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+/**
+ * @brief Thread-safe localtime wrapper
+ * @param timestamp Time to convert
+ * @param out Receives the local time
+ * @return 1 on success, 0 on failure
+ */
+static int local_time(time_t timestamp, struct tm* out) {
+#ifdef _WIN32
+    return localtime_s(out, &timestamp) == 0;
+#else
+    return localtime_r(&timestamp, out) != NULL;
+#endif
+}
+
+/**
+ * @brief Append a zero-padded two-digit number
+ * @param buffer Render buffer
+ * @param value Number in 0..99
+ */
+static void render_two_digits(RenderBuffer* buffer, int value) {
+    char digits[2];
+    digits[0] = (char)('0' + value / 10 % 10);
+    digits[1] = (char)('0' + value % 10);
+    render_append(buffer, digits, 2);
+}
+
+/**
+ * @brief Append a run of spaces
+ * @param buffer Render buffer
+ * @param count Number of spaces
+ */
+static void render_spaces(RenderBuffer* buffer, size_t count) {
+    static const char spaces[] = "                                ";
+    while (count > 0) {
+        size_t chunk = count < sizeof(spaces) - 1 ? count : sizeof(spaces) - 1;
+        render_append(buffer, spaces, chunk);
+        count -= chunk;
+    }
+}
+
+/**
+ * @brief Prepare a render buffer
+ * @param buffer Buffer to initialize
+ * @param out File the rendered text is written to
+ * @param storage Memory to format into
+ * @param capacity Size of storage in bytes (at least 1)
+ */
+void render_init(RenderBuffer* buffer, FILE* out, char* storage, size_t capacity) {
+    buffer->out = out;
+    buffer->data = storage;
+    buffer->size = 0;
+    buffer->capacity = capacity;
+    buffer->error = TODO_OK;
+    
+    // Empty ranges: the first lookups always fill the cache
+    memset(buffer->days, 0, sizeof(buffer->days));
+    for (int i = 0; i < RENDER_DAY_CACHE_SIZE; i++) {
+        buffer->days[i].start = 1;
+        buffer->days[i].end = 0;
+    }
+    buffer->next_day = 0;
+}
+
+/**
+ * @brief Write all buffered text to the output file
+ * @param buffer Render buffer
+ * @return TODO_OK on success, TODO_ERR_IO if any write so far has failed
+ */
+int render_flush(RenderBuffer* buffer) {
+    if (buffer->size > 0 && buffer->error == TODO_OK &&
+        fwrite(buffer->data, 1, buffer->size, buffer->out) != buffer->size) {
+        buffer->error = TODO_ERR_IO;
+    }
+    buffer->size = 0;
+    return buffer->error;
+}
+
+/**
+ * @brief Append raw bytes
+ * @param buffer Render buffer
+ * @param text Bytes to append
+ * @param length Number of bytes
+ */
+void render_append(RenderBuffer* buffer, const char* text, size_t length) {
+    if (length > buffer->capacity - buffer->size) {
+        render_flush(buffer);
+        
+        // Too big to buffer at all: write it straight through
+        if (length > buffer->capacity) {
+            if (buffer->error == TODO_OK && fwrite(text, 1, length, buffer->out) != length) {
+                buffer->error = TODO_ERR_IO;
+            }
+            return;
+        }
+    }
+    
+    memcpy(buffer->data + buffer->size, text, length);
+    buffer->size += length;
+}
+
+/**
+ * @brief Append a NUL-terminated string
+ * @param buffer Render buffer
+ * @param text String to append
+ */
+void render_string(RenderBuffer* buffer, const char* text) {
+    render_append(buffer, text, strlen(text));
+}
+
+/**
+ * @brief Append a string left-aligned in a field, like printf's "%-W.Ps"
+ * @param buffer Render buffer
+ * @param text String to append
+ * @param width Minimum field width; shorter text is padded with spaces
+ * @param precision Maximum number of bytes taken from text (0 for no limit)
+ */
+void render_padded(RenderBuffer* buffer, const char* text, size_t width, size_t precision) {
+    size_t length = 0;
+    while (text[length] != '\0' && (precision == 0 || length < precision)) {
+        length++;
+    }
+    
+    render_append(buffer, text, length);
+    if (length < width) {
+        render_spaces(buffer, width - length);
+    }
+}
+
+/**
+ * @brief Append a decimal integer left-aligned in a field, like "%-Wd"
+ * @param buffer Render buffer
+ * @param value Integer to append
+ * @param width Minimum field width (0 for none)
+ */
+void render_int(RenderBuffer* buffer, long long value, size_t width) {
+    char digits[24];
+    size_t start = sizeof(digits);
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    
+    do {
+        digits[--start] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        digits[--start] = '-';
+    }
+    
+    size_t length = sizeof(digits) - start;
+    render_append(buffer, digits + start, length);
+    if (length < width) {
+        render_spaces(buffer, width - length);
+    }
+}
+
+/**
+ * @brief Break a timestamp down into local time, using the day cache
+ *
+ * A miss converts the timestamp and then checks that local midnight and
+ * the last second of that day convert to the expected clock times. Only
+ * then, when the UTC offset is constant across the whole day, is the day
+ * cached; days with a daylight-saving change are converted every time.
+ *
+ * @param buffer Render buffer holding the cache
+ * @param timestamp Seconds since the epoch
+ * @param out Receives the local time
+ */
+void render_localtime(RenderBuffer* buffer, int64_t timestamp, struct tm* out) {
+    for (int i = 0; i < RENDER_DAY_CACHE_SIZE; i++) {
+        const RenderDay* day = &buffer->days[i];
+        if (timestamp >= day->start && timestamp < day->end) {
+            int64_t seconds = timestamp - day->start;
+            *out = day->midnight;
+            out->tm_hour = (int)(seconds / 3600);
+            out->tm_min = (int)(seconds / 60 % 60);
+            out->tm_sec = (int)(seconds % 60);
+            return;
+        }
+    }
+    
+    if (!local_time((time_t)timestamp, out)) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    
+    int64_t start = timestamp - (out->tm_hour * 3600 + out->tm_min * 60 + out->tm_sec);
+    int64_t end = start + SECONDS_PER_DAY;
+    struct tm check;
+    if (local_time((time_t)start, &check) && check.tm_mday == out->tm_mday &&
+        check.tm_hour == 0 && check.tm_min == 0 && check.tm_sec == 0 &&
+        local_time((time_t)(end - 1), &check) && check.tm_mday == out->tm_mday &&
+        check.tm_hour == 23 && check.tm_min == 59 && check.tm_sec == 59) {
+        RenderDay* day = &buffer->days[buffer->next_day];
+        buffer->next_day = (buffer->next_day + 1) % RENDER_DAY_CACHE_SIZE;
+        day->midnight = *out;
+        day->midnight.tm_hour = 0;
+        day->midnight.tm_min = 0;
+        day->midnight.tm_sec = 0;
+        day->start = start;
+        day->end = end;
+    }
+}
+
+/**
+ * @brief Append a timestamp as "YYYY-MM-DD HH:MM" or "YYYY-MM-DD HH:MM:SS"
+ * @param buffer Render buffer
+ * @param timestamp Seconds since the epoch
+ * @param with_seconds Non-zero to include seconds
+ */
+void render_datetime(RenderBuffer* buffer, int64_t timestamp, int with_seconds) {
+    struct tm local;
+    render_localtime(buffer, timestamp, &local);
+    
+    render_int(buffer, local.tm_year + 1900, 0);
+    render_append(buffer, "-", 1);
+    render_two_digits(buffer, local.tm_mon + 1);
+    render_append(buffer, "-", 1);
+    render_two_digits(buffer, local.tm_mday);
+    render_append(buffer, " ", 1);
+    render_two_digits(buffer, local.tm_hour);
+    render_append(buffer, ":", 1);
+    render_two_digits(buffer, local.tm_min);
+    if (with_seconds) {
+        render_append(buffer, ":", 1);
+        render_two_digits(buffer, local.tm_sec);
+    }
+}
+
+/**
+ * @brief Append a timestamp in ctime() layout without the trailing newline
+ * @param buffer Render buffer
+ * @param timestamp Seconds since the epoch
+ */
+void render_ctime(RenderBuffer* buffer, int64_t timestamp) {
+    struct tm local;
+    render_localtime(buffer, timestamp, &local);
+    
+    render_string(buffer, weekday_names[local.tm_wday % 7]);
+    render_append(buffer, " ", 1);
+    render_string(buffer, month_names[local.tm_mon % 12]);
+    render_append(buffer, local.tm_mday < 10 ? "  " : " ", local.tm_mday < 10 ? 2 : 1);
+    render_int(buffer, local.tm_mday, 0);
+    render_append(buffer, " ", 1);
+    render_two_digits(buffer, local.tm_hour);
+    render_append(buffer, ":", 1);
+    render_two_digits(buffer, local.tm_min);
+    render_append(buffer, ":", 1);
+    render_two_digits(buffer, local.tm_sec);
+    render_append(buffer, " ", 1);
+    render_int(buffer, local.tm_year + 1900, 0);
+}
\ No newline at end of file
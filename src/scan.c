@@ -0,0 +1,539 @@
+/**
+ * @file scan.c
+ * @brief Implementation of columnar scans of status, priority and timestamps
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the column arrays and the scan kernels. Columns
+ * are indexed by ID rather than by slot, so deletes and compaction never
+ * move them, and are padded to whole blocks of 64 IDs. Every kernel turns
+ * one block into a 64-bit mask; counts, histograms and bitmaps are then
+ * popcounts and ANDs of those masks.
+ */
+
+#include "../include/scan.h"
+#include "../include/todo_log.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SCAN_NEON 1
+#endif
+
+// IDs covered by one kernel call
+#define SCAN_BLOCK 64
+
+// Cell value of an ID without a live todo
+#define SCAN_DEAD 0xFF
+
+struct TodoColumns {
+    uint8_t* cells;           // TODO_BUCKET of each ID, SCAN_DEAD if unused
+    int64_t* created;         // Creation time of each ID
+    int64_t* updated;         // Update time of each ID
+    size_t capacity;          // IDs covered, a multiple of SCAN_BLOCK
+};
+
+/**
+ * @brief Filter translated into what the kernels test
+ */
+typedef struct {
+    uint8_t buckets[TODO_BUCKET_COUNT];   // Selected buckets
+    int bucket_count;
+    int check_created;                    // Creation range excludes something
+    int check_updated;                    // Update range excludes something
+} ScanPlan;
+
+/**
+ * @brief Count the set bits of a word
+ * @param word Word to inspect
+ * @return Number of set bits
+ */
+static int popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+#ifdef SCAN_NEON
+/**
+ * @brief Collect the top bit of each byte of a comparison result
+ * @param v Bytes that are all ones or all zeros
+ * @return One bit per byte, byte 0 in bit 0
+ */
+static uint64_t neon_movemask(uint8x16_t v) {
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t bits = vandq_u8(v, vld1q_u8(weights));
+    uint8x8_t sum = vpadd_u8(vget_low_u8(bits), vget_high_u8(bits));
+    sum = vpadd_u8(sum, sum);
+    sum = vpadd_u8(sum, sum);
+    return (uint64_t)vget_lane_u8(sum, 0) | ((uint64_t)vget_lane_u8(sum, 1) << 8);
+}
+#endif
+
+#if defined(__SSE2__) && !defined(__SSE4_2__)
+/**
+ * @brief Signed 64-bit a > b for SSE2, which only compares 32-bit lanes
+ * @param a First operand
+ * @param b Second operand
+ * @return All ones in each lane where a > b
+ */
+static __m128i sse2_cmpgt_epi64(__m128i a, __m128i b) {
+    // Flip the sign of the low halves so that a signed compare orders them as unsigned
+    __m128i flip = _mm_set_epi32(0, (int)0x80000000u, 0, (int)0x80000000u);
+    a = _mm_xor_si128(a, flip);
+    b = _mm_xor_si128(b, flip);
+    __m128i greater = _mm_cmpgt_epi32(a, b);
+    __m128i equal = _mm_cmpeq_epi32(a, b);
+    __m128i greater_high = _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128i greater_low = _mm_shuffle_epi32(greater, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128i equal_high = _mm_shuffle_epi32(equal, _MM_SHUFFLE(3, 3, 1, 1));
+    return _mm_or_si128(greater_high, _mm_and_si128(equal_high, greater_low));
+}
+#endif
+
+/**
+ * @brief Mask of the IDs of a block whose cell is one of some buckets
+ * @param cells First cell of the block
+ * @param buckets Buckets to look for
+ * @param count Number of buckets
+ * @return Bit i set if cells[i] is one of the buckets
+ */
+static uint64_t cell_mask(const uint8_t* cells, const uint8_t* buckets, int count) {
+    uint64_t mask = 0;
+#if defined(__AVX2__)
+    for (int part = 0; part < SCAN_BLOCK / 32; part++) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(const void*)(cells + part * 32));
+        __m256i hit = _mm256_setzero_si256();
+        for (int b = 0; b < count; b++) {
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(block, _mm256_set1_epi8((char)buckets[b])));
+        }
+        mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(hit) << (part * 32);
+    }
+#elif defined(__SSE2__)
+    for (int part = 0; part < SCAN_BLOCK / 16; part++) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(const void*)(cells + part * 16));
+        __m128i hit = _mm_setzero_si128();
+        for (int b = 0; b < count; b++) {
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, _mm_set1_epi8((char)buckets[b])));
+        }
+        mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(hit) << (part * 16);
+    }
+#elif defined(SCAN_NEON)
+    for (int part = 0; part < SCAN_BLOCK / 16; part++) {
+        uint8x16_t block = vld1q_u8(cells + part * 16);
+        uint8x16_t hit = vdupq_n_u8(0);
+        for (int b = 0; b < count; b++) {
+            hit = vorrq_u8(hit, vceqq_u8(block, vdupq_n_u8(buckets[b])));
+        }
+        mask |= neon_movemask(hit) << (part * 16);
+    }
+#else
+    for (int i = 0; i < SCAN_BLOCK; i++) {
+        for (int b = 0; b < count; b++) {
+            if (cells[i] == buckets[b]) {
+                mask |= 1ull << i;
+            }
+        }
+    }
+#endif
+    return mask;
+}
+
+/**
+ * @brief Mask of the IDs of a block whose timestamp lies in a range
+ * @param values First timestamp of the block
+ * @param min Earliest accepted value
+ * @param max Latest accepted value
+ * @return Bit i set if min <= values[i] <= max
+ */
+static uint64_t range_mask(const int64_t* values, int64_t min, int64_t max) {
+    uint64_t outside = 0;
+#if defined(__AVX2__)
+    __m256i low = _mm256_set1_epi64x(min);
+    __m256i high = _mm256_set1_epi64x(max);
+    for (int i = 0; i < SCAN_BLOCK; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(const void*)(values + i));
+        __m256i out = _mm256_or_si256(_mm256_cmpgt_epi64(low, v), _mm256_cmpgt_epi64(v, high));
+        outside |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(out)) << i;
+    }
+#elif defined(__SSE4_2__)
+    __m128i low = _mm_set1_epi64x(min);
+    __m128i high = _mm_set1_epi64x(max);
+    for (int i = 0; i < SCAN_BLOCK; i += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(const void*)(values + i));
+        __m128i out = _mm_or_si128(_mm_cmpgt_epi64(low, v), _mm_cmpgt_epi64(v, high));
+        outside |= (uint64_t)_mm_movemask_pd(_mm_castsi128_pd(out)) << i;
+    }
+#elif defined(__SSE2__)
+    __m128i low = _mm_set1_epi64x(min);
+    __m128i high = _mm_set1_epi64x(max);
+    for (int i = 0; i < SCAN_BLOCK; i += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(const void*)(values + i));
+        __m128i out = _mm_or_si128(sse2_cmpgt_epi64(low, v), sse2_cmpgt_epi64(v, high));
+        outside |= (uint64_t)_mm_movemask_pd(_mm_castsi128_pd(out)) << i;
+    }
+#elif defined(SCAN_NEON)
+    int64x2_t low = vdupq_n_s64(min);
+    int64x2_t high = vdupq_n_s64(max);
+    for (int i = 0; i < SCAN_BLOCK; i += 2) {
+        int64x2_t v = vld1q_s64(values + i);
+        uint64x2_t out = vorrq_u64(vcltq_s64(v, low), vcgtq_s64(v, high));
+        outside |= ((vgetq_lane_u64(out, 0) & 1) | ((vgetq_lane_u64(out, 1) & 1) << 1)) << i;
+    }
+#else
+    // Branch-free so that compilers can vectorize it for other targets
+    for (int i = 0; i < SCAN_BLOCK; i++) {
+        outside |= (uint64_t)(values[i] < min || values[i] > max) << i;
+    }
+#endif
+    return ~outside;
+}
+
+/**
+ * @brief Translate a filter for the kernels
+ * @param filter Filter to translate
+ * @param plan Receives the selected buckets and the ranges to check
+ */
+static void make_plan(const TodoScanFilter* filter, ScanPlan* plan) {
+    plan->bucket_count = 0;
+    for (int status = STATUS_PENDING; status <= STATUS_COMPLETED; status++) {
+        for (int priority = PRIORITY_LOW; priority <= PRIORITY_HIGH; priority++) {
+            if ((filter->status_mask & TODO_STATUS_BIT(status)) &&
+                (filter->priority_mask & TODO_PRIORITY_BIT(priority))) {
+                plan->buckets[plan->bucket_count++] = (uint8_t)TODO_BUCKET(status, priority);
+            }
+        }
+    }
+    plan->check_created = filter->created_min != INT64_MIN || filter->created_max != INT64_MAX;
+    plan->check_updated = filter->updated_min != INT64_MIN || filter->updated_max != INT64_MAX;
+}
+
+/**
+ * @brief Mask of the IDs of a block passing the timestamp ranges of a filter
+ * @param columns Columns to read
+ * @param filter Filter to apply
+ * @param plan Translated filter
+ * @param base First ID of the block
+ * @return Bit i set if ID base + i passes (whether or not it is live)
+ */
+static uint64_t time_mask(const TodoColumns* columns, const TodoScanFilter* filter, const ScanPlan* plan,
+                          size_t base) {
+    uint64_t mask = ~0ull;
+    if (plan->check_created) {
+        mask &= range_mask(columns->created + base, filter->created_min, filter->created_max);
+    }
+    if (plan->check_updated && mask) {
+        mask &= range_mask(columns->updated + base, filter->updated_min, filter->updated_max);
+    }
+    return mask;
+}
+
+/**
+ * @brief Check a todo in the todo array against a filter
+ * @param todo Live todo
+ * @param filter Filter to apply
+ * @return Non-zero if it matches
+ */
+static int todo_passes(const Todo* todo, const TodoScanFilter* filter) {
+    return (filter->status_mask & TODO_STATUS_BIT(todo->status)) &&
+           (filter->priority_mask & TODO_PRIORITY_BIT(todo->priority)) &&
+           todo->created_at >= filter->created_min && todo->created_at <= filter->created_max &&
+           todo->updated_at >= filter->updated_min && todo->updated_at <= filter->updated_max;
+}
+
+/**
+ * @brief Number of blocks a scan of the columns must cover
+ * @param list Pointer to the todo list
+ * @return Blocks holding every ID below next_id that the columns cover
+ */
+static size_t scan_blocks(const TodoList* list) {
+    size_t blocks = todo_scan_mask_words(list);
+    size_t covered = list->columns->capacity / SCAN_BLOCK;
+    return blocks < covered ? blocks : covered;
+}
+
+/**
+ * @brief Make the columns cover an ID
+ * @param columns Columns to grow
+ * @param id ID that must be covered
+ * @return 0 on success, -1 on allocation failure
+ */
+static int columns_reserve(TodoColumns* columns, int id) {
+    if ((size_t)id < columns->capacity) {
+        return 0;
+    }
+    
+    size_t capacity = columns->capacity > 0 ? columns->capacity : 1024;
+    while (capacity <= (size_t)id) {
+        capacity *= 2;
+    }
+    
+    uint8_t* cells = (uint8_t*)realloc(columns->cells, capacity);
+    if (cells) {
+        columns->cells = cells;
+    }
+    int64_t* created = cells ? (int64_t*)realloc(columns->created, sizeof(int64_t) * capacity) : NULL;
+    if (created) {
+        columns->created = created;
+    }
+    int64_t* updated = created ? (int64_t*)realloc(columns->updated, sizeof(int64_t) * capacity) : NULL;
+    if (!updated) {
+        return -1;
+    }
+    columns->updated = updated;
+    
+    size_t added = capacity - columns->capacity;
+    memset(columns->cells + columns->capacity, SCAN_DEAD, added);
+    memset(columns->created + columns->capacity, 0, sizeof(int64_t) * added);
+    memset(columns->updated + columns->capacity, 0, sizeof(int64_t) * added);
+    columns->capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Record the current fields of a todo (used internally by the list)
+ * @param columns Columns to update
+ * @param todo Live todo
+ * @return 0 on success, -1 on allocation failure
+ */
+int columns_insert(TodoColumns* columns, const Todo* todo) {
+    if (columns_reserve(columns, todo->id) != 0) {
+        return -1;
+    }
+    columns->cells[todo->id] = (uint8_t)TODO_BUCKET(todo->status, todo->priority);
+    columns->created[todo->id] = todo->created_at;
+    columns->updated[todo->id] = todo->updated_at;
+    return 0;
+}
+
+/**
+ * @brief Mark an ID as unused (used internally by the list)
+ * @param columns Columns to update
+ * @param id ID of the removed todo
+ */
+void columns_erase(TodoColumns* columns, int id) {
+    if (id > 0 && (size_t)id < columns->capacity) {
+        columns->cells[id] = SCAN_DEAD;
+    }
+}
+
+/**
+ * @brief Mark every ID as unused (used internally by the list)
+ * @param columns Columns to empty
+ */
+void columns_reset(TodoColumns* columns) {
+    if (columns->capacity > 0) {
+        memset(columns->cells, SCAN_DEAD, columns->capacity);
+    }
+}
+
+/**
+ * @brief Free column arrays (used internally by the list)
+ * @param columns Columns to free (may be NULL)
+ */
+void columns_destroy(TodoColumns* columns) {
+    if (columns) {
+        free(columns->cells);
+        free(columns->created);
+        free(columns->updated);
+        free(columns);
+    }
+}
+
+/**
+ * @brief Start maintaining column arrays for scans
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_enable_columns(TodoList* list) {
+    if (!list) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (list->columns) {
+        return TODO_OK;
+    }
+    
+    TodoColumns* columns = (TodoColumns*)calloc(1, sizeof(TodoColumns));
+    int ok = columns && columns_reserve(columns, list->next_id) == 0;
+    for (int i = 0; ok && i < list->used; i++) {
+        if (list->todos[i].id != TODO_TOMBSTONE_ID) {
+            ok = columns_insert(columns, &list->todos[i]) == 0;
+        }
+    }
+    if (!ok) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for scan columns");
+        columns_destroy(columns);
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    list->columns = columns;
+    return TODO_OK;
+}
+
+/**
+ * @brief Stop maintaining the column arrays and free them
+ * @param list Pointer to the todo list
+ */
+void todo_list_disable_columns(TodoList* list) {
+    if (!list) {
+        return;
+    }
+    
+    columns_destroy(list->columns);
+    list->columns = NULL;
+}
+
+/**
+ * @brief Initialize a filter that matches every todo
+ * @param filter Filter to initialize
+ */
+void todo_scan_filter_init(TodoScanFilter* filter) {
+    filter->status_mask = TODO_STATUS_ANY;
+    filter->priority_mask = TODO_PRIORITY_ANY;
+    filter->created_min = INT64_MIN;
+    filter->created_max = INT64_MAX;
+    filter->updated_min = INT64_MIN;
+    filter->updated_max = INT64_MAX;
+}
+
+/**
+ * @brief Count the matching todos per status and priority
+ * @param list Pointer to the todo list
+ * @param filter Filter to apply
+ * @param counts Receives the counts, indexed by TODO_BUCKET(status, priority)
+ * @return Total number of matching todos, negative TodoError on invalid arguments
+ */
+int todo_scan_histogram(const TodoList* list, const TodoScanFilter* filter, int counts[TODO_BUCKET_COUNT]) {
+    if (!list || !filter || !counts) {
+        return TODO_ERR_INVALID;
+    }
+    
+    ScanPlan plan;
+    make_plan(filter, &plan);
+    memset(counts, 0, sizeof(int) * TODO_BUCKET_COUNT);
+    
+    if (!plan.check_created && !plan.check_updated) {
+        // The query index already counts every bucket
+        for (int b = 0; b < plan.bucket_count; b++) {
+            counts[plan.buckets[b]] = list->bucket_counts[plan.buckets[b]];
+        }
+    } else if (list->columns) {
+        size_t blocks = scan_blocks(list);
+        for (size_t block = 0; block < blocks && plan.bucket_count > 0; block++) {
+            size_t base = block * SCAN_BLOCK;
+            uint64_t times = time_mask(list->columns, filter, &plan, base);
+            if (!times) {
+                continue;
+            }
+            for (int b = 0; b < plan.bucket_count; b++) {
+                counts[plan.buckets[b]] += popcount64(cell_mask(list->columns->cells + base, &plan.buckets[b], 1) & times);
+            }
+        }
+    } else {
+        for (int i = 0; i < list->used; i++) {
+            const Todo* todo = &list->todos[i];
+            if (todo->id != TODO_TOMBSTONE_ID && todo_passes(todo, filter)) {
+                counts[TODO_BUCKET(todo->status, todo->priority)]++;
+            }
+        }
+    }
+    
+    int total = 0;
+    for (int b = 0; b < TODO_BUCKET_COUNT; b++) {
+        total += counts[b];
+    }
+    return total;
+}
+
+/**
+ * @brief Count the todos matching a filter
+ * @param list Pointer to the todo list
+ * @param filter Filter to apply
+ * @return Number of matching todos, negative TodoError on invalid arguments
+ */
+int todo_scan_count(const TodoList* list, const TodoScanFilter* filter) {
+    if (!list || !filter) {
+        return TODO_ERR_INVALID;
+    }
+    
+    ScanPlan plan;
+    make_plan(filter, &plan);
+    if (!list->columns || (!plan.check_created && !plan.check_updated)) {
+        int counts[TODO_BUCKET_COUNT];
+        return todo_scan_histogram(list, filter, counts);
+    }
+    
+    int total = 0;
+    size_t blocks = plan.bucket_count > 0 ? scan_blocks(list) : 0;
+    for (size_t block = 0; block < blocks; block++) {
+        size_t base = block * SCAN_BLOCK;
+        uint64_t times = time_mask(list->columns, filter, &plan, base);
+        if (times) {
+            total += popcount64(cell_mask(list->columns->cells + base, plan.buckets, plan.bucket_count) & times);
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Number of 64-bit words todo_scan_mask writes
+ * @param list Pointer to the todo list
+ * @return Words needed to hold one bit per possible ID
+ */
+size_t todo_scan_mask_words(const TodoList* list) {
+    return list ? ((size_t)list->next_id + SCAN_BLOCK - 1) / SCAN_BLOCK : 0;
+}
+
+/**
+ * @brief Compute a bitmap of the IDs matching a filter
+ * @param list Pointer to the todo list
+ * @param filter Filter to apply
+ * @param bits Receives the bitmap
+ * @param words Size of bits, at least todo_scan_mask_words(list)
+ * @return Number of matching todos, negative TodoError on invalid arguments
+ */
+int todo_scan_mask(const TodoList* list, const TodoScanFilter* filter, uint64_t* bits, size_t words) {
+    if (!list || !filter || !bits || words < todo_scan_mask_words(list)) {
+        return TODO_ERR_INVALID;
+    }
+    
+    ScanPlan plan;
+    make_plan(filter, &plan);
+    memset(bits, 0, sizeof(uint64_t) * words);
+    
+    int total = 0;
+    if (list->columns) {
+        size_t blocks = plan.bucket_count > 0 ? scan_blocks(list) : 0;
+        for (size_t block = 0; block < blocks; block++) {
+            size_t base = block * SCAN_BLOCK;
+            uint64_t mask = time_mask(list->columns, filter, &plan, base);
+            if (mask) {
+                mask &= cell_mask(list->columns->cells + base, plan.buckets, plan.bucket_count);
+                bits[block] = mask;
+                total += popcount64(mask);
+            }
+        }
+    } else {
+        for (int i = 0; i < list->used; i++) {
+            const Todo* todo = &list->todos[i];
+            if (todo->id != TODO_TOMBSTONE_ID && todo_passes(todo, filter)) {
+                bits[todo->id / SCAN_BLOCK] |= 1ull << (todo->id % SCAN_BLOCK);
+                total++;
+            }
+        }
+    }
+    return total;
+}
\ No newline at end of file
@@ -0,0 +1,416 @@
+/**
+ * @file schedule.c
+ * @brief Implementation of due-date reminders
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the scheduler as an implicit binary heap of
+ * (due time, ID) entries. Two arrays indexed by ID, like the scan
+ * columns, record where each todo sits in the heap and which due time
+ * it was last armed for; the second is what keeps a fired reminder from
+ * being armed again by changes that leave its due date alone.
+ */
+
+#include "../include/schedule.h"
+#include "../include/todo_log.h"
+#include <limits.h>
+
+/**
+ * @brief One armed reminder
+ */
+typedef struct {
+    int64_t due;
+    int id;
+} ScheduleEntry;
+
+/**
+ * @brief Reminder schedule of one list
+ */
+struct TodoScheduler {
+    TodoList* list;
+    TodoVisitFn remind;
+    void* user_data;
+    ScheduleEntry* heap;                   // Armed reminders, earliest first
+    int count;
+    int capacity;
+    int* positions;                        // Heap index of each ID, -1 if not armed
+    int64_t* armed;                        // Due time each ID was last armed for, 0 if none
+    int id_capacity;                       // IDs covered by positions and armed
+};
+
+/**
+ * @brief Check whether one reminder fires before another
+ * @param a First reminder
+ * @param b Second reminder
+ * @return 1 if a is due earlier (or at the same time with a lower ID), 0 otherwise
+ */
+static int entry_before(const ScheduleEntry* a, const ScheduleEntry* b) {
+    return a->due < b->due || (a->due == b->due && a->id < b->id);
+}
+
+/**
+ * @brief Store an entry in a heap slot and remember where it went
+ * @param scheduler Scheduler owning the heap
+ * @param index Heap slot
+ * @param entry Entry to store
+ */
+static void heap_place(TodoScheduler* scheduler, int index, ScheduleEntry entry) {
+    scheduler->heap[index] = entry;
+    scheduler->positions[entry.id] = index;
+}
+
+/**
+ * @brief Move an entry towards the root until its parent is earlier
+ * @param scheduler Scheduler owning the heap
+ * @param index Slot of the entry
+ */
+static void sift_up(TodoScheduler* scheduler, int index) {
+    ScheduleEntry entry = scheduler->heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!entry_before(&entry, &scheduler->heap[parent])) {
+            break;
+        }
+        heap_place(scheduler, index, scheduler->heap[parent]);
+        index = parent;
+    }
+    heap_place(scheduler, index, entry);
+}
+
+/**
+ * @brief Move an entry towards the leaves until both children are later
+ * @param scheduler Scheduler owning the heap
+ * @param index Slot of the entry
+ */
+static void sift_down(TodoScheduler* scheduler, int index) {
+    ScheduleEntry entry = scheduler->heap[index];
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= scheduler->count) {
+            break;
+        }
+        if (child + 1 < scheduler->count && entry_before(&scheduler->heap[child + 1], &scheduler->heap[child])) {
+            child++;
+        }
+        if (!entry_before(&scheduler->heap[child], &entry)) {
+            break;
+        }
+        heap_place(scheduler, index, scheduler->heap[child]);
+        index = child;
+    }
+    heap_place(scheduler, index, entry);
+}
+
+/**
+ * @brief Remove the entry in a heap slot
+ * @param scheduler Scheduler owning the heap
+ * @param index Slot to empty
+ */
+static void heap_remove(TodoScheduler* scheduler, int index) {
+    scheduler->positions[scheduler->heap[index].id] = -1;
+    if (--scheduler->count == index) {
+        return;
+    }
+    
+    // Fill the hole with the last entry, which may belong above or below it
+    int moved = scheduler->heap[scheduler->count].id;
+    heap_place(scheduler, index, scheduler->heap[scheduler->count]);
+    sift_up(scheduler, index);
+    sift_down(scheduler, scheduler->positions[moved]);
+}
+
+/**
+ * @brief Make the per-ID arrays cover an ID
+ * @param scheduler Scheduler to grow
+ * @param id Largest ID that must be covered
+ * @return 0 on success, -1 on allocation failure
+ */
+static int reserve_ids(TodoScheduler* scheduler, int id) {
+    if (id < scheduler->id_capacity) {
+        return 0;
+    }
+    
+    int new_capacity = scheduler->id_capacity > 0 ? scheduler->id_capacity : 64;
+    while (new_capacity <= id) {
+        new_capacity = new_capacity > INT_MAX / 2 ? id + 1 : new_capacity * 2;
+    }
+    int* positions = (int*)realloc(scheduler->positions, sizeof(int) * (size_t)new_capacity);
+    if (!positions) {
+        return -1;
+    }
+    scheduler->positions = positions;
+    int64_t* armed = (int64_t*)realloc(scheduler->armed, sizeof(int64_t) * (size_t)new_capacity);
+    if (!armed) {
+        return -1;
+    }
+    scheduler->armed = armed;
+    
+    for (int i = scheduler->id_capacity; i < new_capacity; i++) {
+        positions[i] = -1;
+        armed[i] = 0;
+    }
+    scheduler->id_capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * @brief Append an entry to the heap without restoring the heap order
+ * @param scheduler Scheduler owning the heap
+ * @param id ID of the todo
+ * @param due Due time
+ * @return 0 on success, -1 on allocation failure
+ */
+static int heap_append(TodoScheduler* scheduler, int id, int64_t due) {
+    if (scheduler->count == scheduler->capacity) {
+        int new_capacity = scheduler->capacity > 0 ? scheduler->capacity * 2 : 64;
+        ScheduleEntry* heap = (ScheduleEntry*)realloc(scheduler->heap, sizeof(ScheduleEntry) * (size_t)new_capacity);
+        if (!heap) {
+            return -1;
+        }
+        scheduler->heap = heap;
+        scheduler->capacity = new_capacity;
+    }
+    
+    ScheduleEntry entry = { due, id };
+    heap_place(scheduler, scheduler->count++, entry);
+    return 0;
+}
+
+/**
+ * @brief Bring the reminder of one todo in line with its current state
+ * @param scheduler Scheduler of the list
+ * @param todo Todo that was created or changed
+ */
+static void schedule_todo(TodoScheduler* scheduler, const Todo* todo) {
+    if (reserve_ids(scheduler, todo->id) != 0) {
+        todo_log(TODO_LOG_WARNING, "Out of memory, reminder of todo %d not scheduled", todo->id);
+        return;
+    }
+    
+    int index = scheduler->positions[todo->id];
+    if (todo->status != STATUS_PENDING || todo->due_at == 0) {
+        if (index >= 0) {
+            heap_remove(scheduler, index);
+        }
+        scheduler->armed[todo->id] = 0;
+        return;
+    }
+    
+    if (index >= 0) {
+        // Already armed: move it if the due date changed
+        if (scheduler->heap[index].due != todo->due_at) {
+            scheduler->heap[index].due = todo->due_at;
+            sift_up(scheduler, index);
+            sift_down(scheduler, scheduler->positions[todo->id]);
+        }
+    } else if (scheduler->armed[todo->id] != todo->due_at) {
+        if (heap_append(scheduler, todo->id, todo->due_at) != 0) {
+            todo_log(TODO_LOG_WARNING, "Out of memory, reminder of todo %d not scheduled", todo->id);
+            return;
+        }
+        sift_up(scheduler, scheduler->count - 1);
+    }
+    scheduler->armed[todo->id] = todo->due_at;
+}
+
+/**
+ * @brief Observer keeping the schedule in step with the list
+ * @param list List that changed
+ * @param change Kind of change
+ * @param todo Affected todo
+ * @param user_data The scheduler
+ */
+static void record_change(const TodoList* list, TodoChange change, const Todo* todo, void* user_data) {
+    TodoScheduler* scheduler = (TodoScheduler*)user_data;
+    (void)list;
+    if (change == TODO_CHANGE_PREPARE) {
+        return;
+    }
+    
+    if (change != TODO_CHANGE_DELETE) {
+        schedule_todo(scheduler, todo);
+    } else if (todo->id < scheduler->id_capacity) {
+        if (scheduler->positions[todo->id] >= 0) {
+            heap_remove(scheduler, scheduler->positions[todo->id]);
+        }
+        scheduler->armed[todo->id] = 0;
+    }
+}
+
+/**
+ * @brief Start scheduling the due dates of a list
+ * @param list List to observe
+ * @param remind Called for each reminder that fires (may be NULL); it must not modify the list
+ * @param user_data Context passed to remind
+ * @return New scheduler, NULL on failure
+ */
+TodoScheduler* todo_scheduler_attach(TodoList* list, TodoVisitFn remind, void* user_data) {
+    if (!list) {
+        return NULL;
+    }
+    
+    TodoScheduler* scheduler = (TodoScheduler*)calloc(1, sizeof(TodoScheduler));
+    if (!scheduler) {
+        return NULL;
+    }
+    scheduler->list = list;
+    scheduler->remind = remind;
+    scheduler->user_data = user_data;
+    
+    // Collect the armed todos unordered, then heapify bottom-up in O(n)
+    int failed = reserve_ids(scheduler, list->next_id);
+    for (int slot = 0; slot < list->used && !failed; slot++) {
+        const Todo* todo = &list->todos[slot];
+        if (todo->id != TODO_TOMBSTONE_ID && todo->status == STATUS_PENDING && todo->due_at != 0) {
+            failed = heap_append(scheduler, todo->id, todo->due_at);
+            scheduler->armed[todo->id] = todo->due_at;
+        }
+    }
+    for (int index = scheduler->count / 2 - 1; index >= 0 && !failed; index--) {
+        sift_down(scheduler, index);
+    }
+    
+    if (failed || todo_list_add_observer(list, record_change, scheduler) != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Unable to schedule reminders");
+        free(scheduler->heap);
+        free(scheduler->positions);
+        free(scheduler->armed);
+        free(scheduler);
+        return NULL;
+    }
+    return scheduler;
+}
+
+/**
+ * @brief Stop scheduling and free a scheduler
+ * @param scheduler Scheduler to free (may be NULL)
+ */
+void todo_scheduler_detach(TodoScheduler* scheduler) {
+    if (!scheduler) {
+        return;
+    }
+    todo_list_remove_observer(scheduler->list, record_change, scheduler);
+    free(scheduler->heap);
+    free(scheduler->positions);
+    free(scheduler->armed);
+    free(scheduler);
+}
+
+/**
+ * @brief Number of armed reminders
+ * @param scheduler Scheduler to inspect
+ * @return Pending todos with a due date whose reminder has not fired
+ */
+int todo_scheduler_count(const TodoScheduler* scheduler) {
+    return scheduler ? scheduler->count : 0;
+}
+
+/**
+ * @brief Due time of the next reminder
+ * @param scheduler Scheduler to inspect
+ * @return Earliest armed due time, 0 if nothing is armed
+ */
+time_t todo_scheduler_next_due(const TodoScheduler* scheduler) {
+    return scheduler && scheduler->count > 0 ? (time_t)scheduler->heap[0].due : 0;
+}
+
+/**
+ * @brief Fire every reminder due by a point in time
+ * @param scheduler Scheduler of the list
+ * @param now Fire reminders due at or before this time
+ * @return Number of reminders fired
+ */
+int todo_scheduler_fire(TodoScheduler* scheduler, time_t now) {
+    if (!scheduler) {
+        return 0;
+    }
+    
+    int fired = 0;
+    while (scheduler->count > 0 && scheduler->heap[0].due <= (int64_t)now) {
+        // Disarm first; armed[] keeps the due time so it is not re-armed
+        int id = scheduler->heap[0].id;
+        heap_remove(scheduler, 0);
+        fired++;
+        
+        const Todo* todo = todo_find_by_id(scheduler->list, id);
+        if (todo && scheduler->remind && scheduler->remind(scheduler->list, todo, scheduler->user_data) != 0) {
+            break;
+        }
+    }
+    return fired;
+}
+
+/**
+ * @brief Visit the armed reminders in due order
+ * @param scheduler Scheduler of the list
+ * @param limit Most todos to visit (0 for all)
+ * @param fn Callback invoked for each todo
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, negative TodoError on failure
+ */
+int todo_scheduler_upcoming(const TodoScheduler* scheduler, int limit, TodoVisitFn fn, void* user_data) {
+    if (!scheduler || !fn || limit < 0) {
+        return TODO_ERR_INVALID;
+    }
+    if (limit == 0 || limit > scheduler->count) {
+        limit = scheduler->count;
+    }
+    if (limit == 0) {
+        return 0;
+    }
+    
+    // Best-first walk: a second heap holds the slots whose parents were visited
+    int* frontier = (int*)malloc(sizeof(int) * ((size_t)limit + 1));
+    if (!frontier) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    const ScheduleEntry* heap = scheduler->heap;
+    int size = 1;
+    frontier[0] = 0;
+    
+    int visited = 0;
+    while (size > 0 && visited < limit) {
+        int index = frontier[0];
+        
+        // Pop the earliest slot of the frontier
+        int last = frontier[--size];
+        int hole = 0;
+        for (;;) {
+            int child = 2 * hole + 1;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1 < size && entry_before(&heap[frontier[child + 1]], &heap[frontier[child]])) {
+                child++;
+            }
+            if (!entry_before(&heap[frontier[child]], &heap[last])) {
+                break;
+            }
+            frontier[hole] = frontier[child];
+            hole = child;
+        }
+        frontier[hole] = last;
+        
+        visited++;
+        const Todo* todo = todo_find_by_id(scheduler->list, heap[index].id);
+        if (todo && fn(scheduler->list, todo, user_data) != 0) {
+            break;
+        }
+        
+        // Its children can come next; slots past limit are never needed
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && visited < limit; child++) {
+            if (child >= scheduler->count || size > limit) {
+                continue;
+            }
+            int spot = size++;
+            while (spot > 0 && entry_before(&heap[child], &heap[frontier[(spot - 1) / 2]])) {
+                frontier[spot] = frontier[(spot - 1) / 2];
+                spot = (spot - 1) / 2;
+            }
+            frontier[spot] = child;
+        }
+    }
+    
+    free(frontier);
+    return visited;
+}
\ No newline at end of file
@@ -0,0 +1,995 @@
+/**
+ * @file search.c
+ * @brief Implementation of full-text search over titles and descriptions
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements an inverted index from words to the todos that
+ * contain them, and the scans used when no index is available.
+ *
+ * Postings are only ever appended. Each todo has a version that is bumped
+ * whenever its text changes or it is deleted, and a posting counts only
+ * while its version is current, so updates never search posting lists for
+ * old entries. Once stale postings outnumber live ones the index is
+ * rebuilt. Words live in a hash table for exact lookups and in a sorted
+ * array for prefix lookups; new words wait in an unsorted tail that is
+ * merged in once it grows past a fraction of the sorted part.
+ */
+
+#include "../include/search.h"
+#include "../include/todo_log.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Initial number of slots in the word hash table (a power of two)
+#define SEARCH_INITIAL_TABLE_SIZE 1024
+
+// Unsorted words tolerated before they are merged into the sorted array
+#define SEARCH_MIN_PENDING 256
+
+// Stale postings tolerated before the index is rebuilt
+#define SEARCH_MIN_STALE 65536
+
+// Most words a todo's text can contain (one per two bytes)
+#define SEARCH_MAX_WORDS ((MAX_TITLE_LENGTH + MAX_DESC_LENGTH) / 2)
+
+// Most words considered in a query
+#define SEARCH_MAX_QUERY_WORDS 16
+
+/**
+ * @brief Occurrence of a word in one version of a todo
+ */
+typedef struct {
+    int32_t id;
+    uint32_t version;
+} Posting;
+
+/**
+ * @brief Indexed word and the todos containing it
+ */
+typedef struct {
+    uint32_t text_offset;     // Offset of the word in term_text
+    uint32_t length;          // Length of the word in bytes
+    uint32_t hash;            // Hash of the word
+    int count;                // Postings in use
+    int capacity;             // Postings allocated
+    Posting* postings;
+} Term;
+
+struct TodoSearch {
+    Term* terms;
+    int term_count;
+    int term_capacity;
+    
+    // Open-addressing hash table of term indexes (-1 for empty)
+    int* table;
+    uint32_t table_size;
+    
+    // Text of all terms, back to back
+    char* term_text;
+    size_t text_size;
+    size_t text_capacity;
+    
+    // Term indexes sorted by text; terms from sorted_count on are unsorted
+    int* sorted;
+    int sorted_count;
+    
+    // Per todo ID: current version and number of postings at that version
+    uint32_t* versions;
+    uint16_t* posting_counts;
+    int id_capacity;
+    
+    size_t live_postings;
+    size_t stale_postings;
+    int rebuilding;           // Defer sorting while the whole index is rebuilt
+};
+
+/**
+ * @brief Word taken from a text or a query
+ */
+typedef struct {
+    const char* text;         // Lower-cased bytes (not NUL-terminated)
+    size_t length;
+    int prefix;               // Query words only: match words starting with text
+} Word;
+
+/**
+ * @brief Term reference used while sorting new terms
+ */
+typedef struct {
+    const char* text;
+    uint32_t length;
+    int index;
+} TermRef;
+
+/**
+ * @brief Check whether a byte belongs to a word
+ * @param c Byte to test
+ * @return Non-zero for ASCII letters and digits and for non-ASCII bytes
+ */
+static int is_word_byte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+/**
+ * @brief Lower-case an ASCII letter
+ * @param c Byte to convert
+ * @return The lower-case byte
+ */
+static unsigned char lower_byte(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+/**
+ * @brief Split text into lower-cased words
+ * @param text Text to split
+ * @param length Length of text
+ * @param buffer Receives the lower-cased words (at least length bytes)
+ * @param words Receives the words
+ * @param max_words Capacity of words
+ * @param query Whether to recognize a trailing '*' as a prefix marker
+ * @return Number of words
+ */
+static int split_words(const char* text, size_t length, char* buffer, Word* words, int max_words, int query) {
+    int count = 0;
+    size_t i = 0;
+    char* out = buffer;
+    while (i < length && count < max_words) {
+        while (i < length && !is_word_byte((unsigned char)text[i])) {
+            i++;
+        }
+        if (i == length) {
+            break;
+        }
+        
+        Word* word = &words[count++];
+        word->text = out;
+        word->length = 0;
+        word->prefix = 0;
+        while (i < length && is_word_byte((unsigned char)text[i])) {
+            if (word->length < SEARCH_MAX_TERM) {
+                *out++ = (char)lower_byte((unsigned char)text[i]);
+                word->length++;
+            }
+            i++;
+        }
+        if (query && i < length && text[i] == '*') {
+            word->prefix = 1;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Split the title and description of a todo into words
+ * @param list List owning the todo
+ * @param todo Todo to split
+ * @param buffer Receives the words (MAX_TITLE_LENGTH + MAX_DESC_LENGTH bytes)
+ * @param words Receives the words (SEARCH_MAX_WORDS entries)
+ * @return Number of words
+ */
+static int todo_words(const TodoList* list, const Todo* todo, char* buffer, Word* words) {
+    // The title's terminator separates it from the description
+    size_t length = (size_t)todo->title_length + 1 + todo->desc_length;
+    return split_words(todo_get_title(list, todo), length, buffer, words, SEARCH_MAX_WORDS, 0);
+}
+
+/**
+ * @brief Compare two byte strings
+ * @param a First string
+ * @param a_length Length of a
+ * @param b Second string
+ * @param b_length Length of b
+ * @return Negative, zero or positive as a sorts before, equal to or after b
+ */
+static int compare_bytes(const char* a, size_t a_length, const char* b, size_t b_length) {
+    int result = memcmp(a, b, a_length < b_length ? a_length : b_length);
+    if (result != 0) {
+        return result;
+    }
+    return a_length < b_length ? -1 : (a_length > b_length ? 1 : 0);
+}
+
+/**
+ * @brief qsort comparator for words
+ * @param a First Word
+ * @param b Second Word
+ * @return Comparison of their text
+ */
+static int compare_words(const void* a, const void* b) {
+    const Word* x = (const Word*)a;
+    const Word* y = (const Word*)b;
+    return compare_bytes(x->text, x->length, y->text, y->length);
+}
+
+/**
+ * @brief qsort comparator for term references
+ * @param a First TermRef
+ * @param b Second TermRef
+ * @return Comparison of their text
+ */
+static int compare_term_refs(const void* a, const void* b) {
+    const TermRef* x = (const TermRef*)a;
+    const TermRef* y = (const TermRef*)b;
+    return compare_bytes(x->text, x->length, y->text, y->length);
+}
+
+/**
+ * @brief qsort comparator for todo IDs
+ * @param a First ID
+ * @param b Second ID
+ * @return Negative, zero or positive
+ */
+static int compare_ids(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Check whether a word matches a query word
+ * @param word Word of a todo
+ * @param query Query word
+ * @return Non-zero if it matches
+ */
+static int word_matches(const char* word, size_t length, const Word* query) {
+    if (query->prefix) {
+        return length >= query->length && memcmp(word, query->text, query->length) == 0;
+    }
+    return length == query->length && memcmp(word, query->text, length) == 0;
+}
+
+/**
+ * @brief Check whether a todo contains every query word
+ * @param list List owning the todo
+ * @param todo Todo to check
+ * @param query Query words
+ * @param count Number of query words
+ * @return Non-zero if all of them occur
+ */
+static int todo_matches(const TodoList* list, const Todo* todo, const Word* query, int count) {
+    char buffer[MAX_TITLE_LENGTH + MAX_DESC_LENGTH];
+    Word words[SEARCH_MAX_WORDS];
+    int n = todo_words(list, todo, buffer, words);
+    
+    for (int q = 0; q < count; q++) {
+        int found = 0;
+        for (int i = 0; i < n && !found; i++) {
+            found = word_matches(words[i].text, words[i].length, &query[q]);
+        }
+        if (!found) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief FNV-1a hash of a word
+ * @param text Word bytes
+ * @param length Length of the word
+ * @return Hash value
+ */
+static uint32_t hash_word(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Get the text of a term
+ * @param search Index owning the term
+ * @param term Term
+ * @return Pointer to its bytes
+ */
+static const char* term_text(const TodoSearch* search, const Term* term) {
+    return search->term_text + term->text_offset;
+}
+
+/**
+ * @brief Look up a word in the hash table
+ * @param search Index to search
+ * @param text Word bytes
+ * @param length Length of the word
+ * @param hash Hash of the word
+ * @return Table slot holding the word, or the empty slot it would go in
+ */
+static uint32_t find_slot(const TodoSearch* search, const char* text, size_t length, uint32_t hash) {
+    uint32_t mask = search->table_size - 1;
+    uint32_t slot = hash & mask;
+    for (;;) {
+        int index = search->table[slot];
+        if (index < 0) {
+            return slot;
+        }
+        const Term* term = &search->terms[index];
+        if (term->hash == hash && term->length == length && memcmp(term_text(search, term), text, length) == 0) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+/**
+ * @brief Double the hash table
+ * @param search Index to grow
+ * @return 0 on success, -1 on allocation failure
+ */
+static int grow_table(TodoSearch* search) {
+    uint32_t new_size = search->table_size * 2;
+    int* table = (int*)malloc(sizeof(int) * new_size);
+    if (!table) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < new_size; i++) {
+        table[i] = -1;
+    }
+    
+    for (int i = 0; i < search->term_count; i++) {
+        uint32_t slot = search->terms[i].hash & (new_size - 1);
+        while (table[slot] >= 0) {
+            slot = (slot + 1) & (new_size - 1);
+        }
+        table[slot] = i;
+    }
+    
+    free(search->table);
+    search->table = table;
+    search->table_size = new_size;
+    return 0;
+}
+
+/**
+ * @brief Merge the unsorted tail of new terms into the sorted array
+ * @param search Index to update
+ * @return 0 on success, -1 on allocation failure
+ */
+static int merge_pending(TodoSearch* search) {
+    int pending = search->term_count - search->sorted_count;
+    if (pending == 0) {
+        return 0;
+    }
+    
+    TermRef* refs = (TermRef*)malloc(sizeof(TermRef) * pending);
+    int* merged = (int*)malloc(sizeof(int) * search->term_count);
+    if (!refs || !merged) {
+        free(refs);
+        free(merged);
+        return -1;
+    }
+    
+    for (int i = 0; i < pending; i++) {
+        const Term* term = &search->terms[search->sorted_count + i];
+        refs[i].text = term_text(search, term);
+        refs[i].length = term->length;
+        refs[i].index = search->sorted_count + i;
+    }
+    qsort(refs, (size_t)pending, sizeof(TermRef), compare_term_refs);
+    
+    int a = 0;
+    int b = 0;
+    int out = 0;
+    while (a < search->sorted_count || b < pending) {
+        int take_sorted = b == pending;
+        if (a < search->sorted_count && b < pending) {
+            const Term* term = &search->terms[search->sorted[a]];
+            take_sorted = compare_bytes(term_text(search, term), term->length, refs[b].text, refs[b].length) < 0;
+        }
+        merged[out++] = take_sorted ? search->sorted[a++] : refs[b++].index;
+    }
+    
+    free(refs);
+    free(search->sorted);
+    search->sorted = merged;
+    search->sorted_count = search->term_count;
+    return 0;
+}
+
+/**
+ * @brief Find a term, adding it if it is new
+ * @param search Index to update
+ * @param word Word to look up
+ * @return Term index, -1 on allocation failure
+ */
+static int intern_term(TodoSearch* search, const Word* word) {
+    uint32_t hash = hash_word(word->text, word->length);
+    uint32_t slot = find_slot(search, word->text, word->length, hash);
+    if (search->table[slot] >= 0) {
+        return search->table[slot];
+    }
+    
+    if (search->term_count == search->term_capacity) {
+        int capacity = search->term_capacity > 0 ? search->term_capacity * 2 : 256;
+        Term* terms = (Term*)realloc(search->terms, sizeof(Term) * capacity);
+        if (!terms) {
+            return -1;
+        }
+        search->terms = terms;
+        search->term_capacity = capacity;
+    }
+    if (search->text_size + word->length > search->text_capacity) {
+        size_t capacity = search->text_capacity > 0 ? search->text_capacity * 2 : 4096;
+        while (capacity < search->text_size + word->length) {
+            capacity *= 2;
+        }
+        char* text = (char*)realloc(search->term_text, capacity);
+        if (!text || capacity > UINT32_MAX) {
+            if (text) {
+                search->term_text = text;
+            }
+            return -1;
+        }
+        search->term_text = text;
+        search->text_capacity = capacity;
+    }
+    
+    int index = search->term_count++;
+    Term* term = &search->terms[index];
+    term->text_offset = (uint32_t)search->text_size;
+    term->length = (uint32_t)word->length;
+    term->hash = hash;
+    term->count = 0;
+    term->capacity = 0;
+    term->postings = NULL;
+    memcpy(search->term_text + search->text_size, word->text, word->length);
+    search->text_size += word->length;
+    search->table[slot] = index;
+    
+    // Keep the table at most half full
+    if ((uint32_t)search->term_count * 2 > search->table_size && grow_table(search) != 0) {
+        return -1;
+    }
+    return index;
+}
+
+/**
+ * @brief Append a posting to a term
+ * @param term Term to update
+ * @param id Todo ID
+ * @param version Current version of the todo
+ * @return 0 on success, -1 on allocation failure
+ */
+static int add_posting(Term* term, int id, uint32_t version) {
+    if (term->count == term->capacity) {
+        int capacity = term->capacity > 0 ? term->capacity * 2 : 4;
+        Posting* postings = (Posting*)realloc(term->postings, sizeof(Posting) * capacity);
+        if (!postings) {
+            return -1;
+        }
+        term->postings = postings;
+        term->capacity = capacity;
+    }
+    term->postings[term->count].id = id;
+    term->postings[term->count].version = version;
+    term->count++;
+    return 0;
+}
+
+/**
+ * @brief Check whether a posting belongs to the current version of a live todo
+ * @param search Index owning the posting
+ * @param list List the index belongs to
+ * @param posting Posting to check
+ * @return Non-zero if it is current
+ */
+static int posting_is_live(const TodoSearch* search, const TodoList* list, const Posting* posting) {
+    return posting->id < search->id_capacity && search->versions[posting->id] == posting->version &&
+           todo_find_by_id(list, posting->id) != NULL;
+}
+
+/**
+ * @brief Make the per-ID arrays cover an ID
+ * @param search Index to update
+ * @param id ID that must be covered
+ * @return 0 on success, -1 on allocation failure
+ */
+static int reserve_ids(TodoSearch* search, int id) {
+    if (id < search->id_capacity) {
+        return 0;
+    }
+    
+    int capacity = search->id_capacity > 0 ? search->id_capacity : 64;
+    while (capacity <= id) {
+        capacity *= 2;
+    }
+    uint32_t* versions = (uint32_t*)realloc(search->versions, sizeof(uint32_t) * capacity);
+    if (versions) {
+        search->versions = versions;
+    }
+    uint16_t* counts = versions ? (uint16_t*)realloc(search->posting_counts, sizeof(uint16_t) * capacity) : NULL;
+    if (!counts) {
+        return -1;
+    }
+    search->posting_counts = counts;
+    
+    for (int i = search->id_capacity; i < capacity; i++) {
+        search->versions[i] = 0;
+        search->posting_counts[i] = 0;
+    }
+    search->id_capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Mark the current postings of a todo as stale
+ * @param search Index to update
+ * @param id ID of the todo
+ */
+static void retire_postings(TodoSearch* search, int id) {
+    if (id <= 0 || id >= search->id_capacity) {
+        return;
+    }
+    search->stale_postings += search->posting_counts[id];
+    search->live_postings -= search->posting_counts[id];
+    search->posting_counts[id] = 0;
+    search->versions[id]++;
+}
+
+/**
+ * @brief Free every term and posting, keeping the index usable
+ * @param search Index to empty
+ */
+static void clear_terms(TodoSearch* search) {
+    for (int i = 0; i < search->term_count; i++) {
+        free(search->terms[i].postings);
+    }
+    for (uint32_t i = 0; i < search->table_size; i++) {
+        search->table[i] = -1;
+    }
+    for (int i = 0; i < search->id_capacity; i++) {
+        search->versions[i] = 0;
+        search->posting_counts[i] = 0;
+    }
+    free(search->sorted);
+    search->sorted = NULL;
+    search->sorted_count = 0;
+    search->term_count = 0;
+    search->text_size = 0;
+    search->live_postings = 0;
+    search->stale_postings = 0;
+}
+
+/**
+ * @brief Index the current text of a todo (used internally by the list)
+ * @param search Index to update
+ * @param list List owning the todo
+ * @param todo Live todo whose text was added or replaced
+ * @return 0 on success, -1 on allocation failure
+ */
+int search_index_todo(TodoSearch* search, const TodoList* list, const Todo* todo) {
+    if (reserve_ids(search, todo->id) != 0) {
+        return -1;
+    }
+    retire_postings(search, todo->id);
+    
+    if (!search->rebuilding && search->stale_postings > SEARCH_MIN_STALE &&
+        search->stale_postings > search->live_postings) {
+        // Rebuilding also indexes this todo's new text
+        return search_rebuild(search, list);
+    }
+    
+    char buffer[MAX_TITLE_LENGTH + MAX_DESC_LENGTH];
+    Word words[SEARCH_MAX_WORDS];
+    int n = todo_words(list, todo, buffer, words);
+    qsort(words, (size_t)n, sizeof(Word), compare_words);
+    
+    uint32_t version = search->versions[todo->id];
+    int added = 0;
+    for (int i = 0; i < n; i++) {
+        if (i > 0 && compare_words(&words[i - 1], &words[i]) == 0) {
+            continue;
+        }
+        int index = intern_term(search, &words[i]);
+        if (index < 0 || add_posting(&search->terms[index], todo->id, version) != 0) {
+            return -1;
+        }
+        added++;
+    }
+    search->posting_counts[todo->id] = (uint16_t)added;
+    search->live_postings += (size_t)added;
+    
+    int pending = search->term_count - search->sorted_count;
+    if (!search->rebuilding && pending > SEARCH_MIN_PENDING && pending > search->sorted_count / 8) {
+        return merge_pending(search);
+    }
+    return 0;
+}
+
+/**
+ * @brief Forget a deleted todo (used internally by the list)
+ * @param search Index to update
+ * @param id ID of the deleted todo
+ */
+void search_forget_todo(TodoSearch* search, int id) {
+    retire_postings(search, id);
+}
+
+/**
+ * @brief Rebuild the index from the list's contents (used internally by the list)
+ * @param search Index to rebuild
+ * @param list List to index
+ * @return 0 on success, -1 on allocation failure
+ */
+int search_rebuild(TodoSearch* search, const TodoList* list) {
+    clear_terms(search);
+    
+    // Index everything first and sort the vocabulary once at the end
+    search->rebuilding = 1;
+    int result = 0;
+    for (int i = 0; i < list->used && result == 0; i++) {
+        if (list->todos[i].id != TODO_TOMBSTONE_ID) {
+            result = search_index_todo(search, list, &list->todos[i]);
+        }
+    }
+    search->rebuilding = 0;
+    
+    if (result == 0) {
+        result = merge_pending(search);
+    }
+    return result;
+}
+
+/**
+ * @brief Free an index (used internally by the list)
+ * @param search Index to free (may be NULL)
+ */
+void search_destroy(TodoSearch* search) {
+    if (!search) {
+        return;
+    }
+    for (int i = 0; i < search->term_count; i++) {
+        free(search->terms[i].postings);
+    }
+    free(search->terms);
+    free(search->table);
+    free(search->term_text);
+    free(search->sorted);
+    free(search->versions);
+    free(search->posting_counts);
+    free(search);
+}
+
+/**
+ * @brief Start maintaining an inverted index of a list's text
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_enable_search(TodoList* list) {
+    if (!list) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (list->search) {
+        return TODO_OK;
+    }
+    
+    TodoSearch* search = (TodoSearch*)calloc(1, sizeof(TodoSearch));
+    if (search) {
+        search->table_size = SEARCH_INITIAL_TABLE_SIZE;
+        search->table = (int*)malloc(sizeof(int) * search->table_size);
+    }
+    if (!search || !search->table || search_rebuild(search, list) != 0) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for search index");
+        search_destroy(search);
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    list->search = search;
+    return TODO_OK;
+}
+
+/**
+ * @brief Stop maintaining the inverted index and free it
+ * @param list Pointer to the todo list
+ */
+void todo_list_disable_search(TodoList* list) {
+    if (!list) {
+        return;
+    }
+    
+    search_destroy(list->search);
+    list->search = NULL;
+}
+
+/**
+ * @brief Add the live postings of a term to a candidate array
+ * @param search Index owning the term
+ * @param list List the index belongs to
+ * @param term Term whose postings to add
+ * @param ids Candidate array (grown as needed)
+ * @param count Number of candidates in ids
+ * @param capacity Capacity of ids
+ * @return 0 on success, -1 on allocation failure
+ */
+static int collect_postings(const TodoSearch* search, const TodoList* list, const Term* term,
+                            int** ids, size_t* count, size_t* capacity) {
+    for (int i = 0; i < term->count; i++) {
+        const Posting* posting = &term->postings[i];
+        if (!posting_is_live(search, list, posting)) {
+            continue;
+        }
+        if (*count == *capacity) {
+            size_t new_capacity = *capacity > 0 ? *capacity * 2 : 64;
+            int* grown = (int*)realloc(*ids, sizeof(int) * new_capacity);
+            if (!grown) {
+                return -1;
+            }
+            *ids = grown;
+            *capacity = new_capacity;
+        }
+        (*ids)[(*count)++] = posting->id;
+    }
+    return 0;
+}
+
+/**
+ * @brief Visit the terms matching a query word
+ * @param search Index to search
+ * @param word Query word
+ * @param terms Receives matching term indexes (may be NULL to only count postings)
+ * @param max_terms Capacity of terms
+ * @param postings Receives the total number of postings of the matching terms
+ * @return Number of matching terms (may exceed max_terms)
+ */
+static int match_terms(const TodoSearch* search, const Word* word, int* terms, int max_terms, size_t* postings) {
+    *postings = 0;
+    if (!word->prefix) {
+        uint32_t slot = find_slot(search, word->text, word->length, hash_word(word->text, word->length));
+        int index = search->table[slot];
+        if (index < 0) {
+            return 0;
+        }
+        if (terms && max_terms > 0) {
+            terms[0] = index;
+        }
+        *postings = (size_t)search->terms[index].count;
+        return 1;
+    }
+    
+    // Binary search for the first sorted term not before the prefix
+    int low = 0;
+    int high = search->sorted_count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        const Term* term = &search->terms[search->sorted[mid]];
+        if (compare_bytes(term_text(search, term), term->length, word->text, word->length) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    
+    int matched = 0;
+    for (int i = low; i < search->sorted_count; i++) {
+        const Term* term = &search->terms[search->sorted[i]];
+        if (!word_matches(term_text(search, term), term->length, word)) {
+            break;
+        }
+        if (terms && matched < max_terms) {
+            terms[matched] = search->sorted[i];
+        }
+        *postings += (size_t)term->count;
+        matched++;
+    }
+    
+    // Terms added since the last merge are not sorted yet
+    for (int i = search->sorted_count; i < search->term_count; i++) {
+        const Term* term = &search->terms[i];
+        if (word_matches(term_text(search, term), term->length, word)) {
+            if (terms && matched < max_terms) {
+                terms[matched] = i;
+            }
+            *postings += (size_t)term->count;
+            matched++;
+        }
+    }
+    return matched;
+}
+
+/**
+ * @brief Answer a word query from the inverted index
+ * @param list Pointer to the todo list
+ * @param words Query words
+ * @param count Number of query words
+ * @param fn Callback invoked for each match
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, negative TodoError on failure
+ */
+static int search_indexed(const TodoList* list, const Word* words, int count, TodoVisitFn fn, void* user_data) {
+    const TodoSearch* search = list->search;
+    
+    // Drive the query from the word with the fewest postings
+    int driver = 0;
+    size_t fewest = 0;
+    for (int q = 0; q < count; q++) {
+        size_t postings;
+        match_terms(search, &words[q], NULL, 0, &postings);
+        if (postings == 0) {
+            return 0;
+        }
+        if (q == 0 || postings < fewest) {
+            driver = q;
+            fewest = postings;
+        }
+    }
+    
+    size_t postings;
+    int matched = match_terms(search, &words[driver], NULL, 0, &postings);
+    int* terms = (int*)malloc(sizeof(int) * (size_t)matched);
+    if (!terms) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    match_terms(search, &words[driver], terms, matched, &postings);
+    
+    int* ids = NULL;
+    size_t id_count = 0;
+    size_t id_capacity = 0;
+    for (int t = 0; t < matched; t++) {
+        if (collect_postings(search, list, &search->terms[terms[t]], &ids, &id_count, &id_capacity) != 0) {
+            free(terms);
+            free(ids);
+            return TODO_ERR_NO_MEMORY;
+        }
+    }
+    free(terms);
+    
+    // Every posting may be stale, leaving ids NULL
+    if (id_count == 0) {
+        free(ids);
+        return 0;
+    }
+    
+    // A todo can match several words of a prefix; sorting also gives ID order
+    qsort(ids, id_count, sizeof(int), compare_ids);
+    
+    int visited = 0;
+    for (size_t i = 0; i < id_count; i++) {
+        if (i > 0 && ids[i] == ids[i - 1]) {
+            continue;
+        }
+        const Todo* todo = todo_find_by_id(list, ids[i]);
+        if (count > 1 && !todo_matches(list, todo, words, count)) {
+            continue;
+        }
+        visited++;
+        if (fn(list, todo, user_data) != 0) {
+            break;
+        }
+    }
+    
+    free(ids);
+    return visited;
+}
+
+/**
+ * @brief Compare bytes with an already lower-cased pattern, ignoring ASCII case
+ * @param text Text to compare
+ * @param pattern Lower-cased pattern
+ * @param length Number of bytes
+ * @return Non-zero if they are equal
+ */
+static int equal_folded(const char* text, const char* pattern, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (lower_byte((unsigned char)text[i]) != (unsigned char)pattern[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Find a lower-cased needle in text, ignoring ASCII case
+ *
+ * Candidate positions are found by comparing 16 bytes at a time against
+ * both cases of the needle's first byte when SSE2 is available.
+ *
+ * @param text Text to search
+ * @param length Length of text
+ * @param needle Lower-cased needle
+ * @param needle_length Length of needle (at least 1)
+ * @return Non-zero if the needle occurs in text
+ */
+static int contains_folded(const char* text, size_t length, const char* needle, size_t needle_length) {
+    if (needle_length > length) {
+        return 0;
+    }
+    
+    unsigned char first = (unsigned char)needle[0];
+    unsigned char first_upper = (first >= 'a' && first <= 'z') ? (unsigned char)(first - ('a' - 'A')) : first;
+    size_t last = length - needle_length;
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    __m128i lower = _mm_set1_epi8((char)first);
+    __m128i upper = _mm_set1_epi8((char)first_upper);
+    for (; i + 16 <= last + 1; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(const void*)(text + i));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, lower), _mm_cmpeq_epi8(block, upper)));
+        while (mask) {
+            size_t at = i + (size_t)__builtin_ctz((unsigned)mask);
+            if (equal_folded(text + at + 1, needle + 1, needle_length - 1)) {
+                return 1;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i <= last; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if ((c == first || c == first_upper) && equal_folded(text + i + 1, needle + 1, needle_length - 1)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Find todos whose title or description matches a query
+ * @param list Pointer to the todo list
+ * @param query Words to look for
+ * @param flags 0 or TODO_SEARCH_SUBSTRING
+ * @param fn Callback invoked for each match (return non-zero to stop)
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, negative TodoError on failure
+ */
+int todo_search(const TodoList* list, const char* query, int flags, TodoVisitFn fn, void* user_data) {
+    if (!list || !query || !fn || (flags & ~TODO_SEARCH_SUBSTRING)) {
+        return TODO_ERR_INVALID;
+    }
+    
+    size_t query_length = strlen(query);
+    char* buffer = (char*)malloc(query_length + 1);
+    if (!buffer) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    Word words[SEARCH_MAX_QUERY_WORDS];
+    int count = 0;
+    if (flags & TODO_SEARCH_SUBSTRING) {
+        for (size_t i = 0; i < query_length; i++) {
+            buffer[i] = (char)lower_byte((unsigned char)query[i]);
+        }
+    } else {
+        count = split_words(query, query_length, buffer, words, SEARCH_MAX_QUERY_WORDS, 1);
+    }
+    
+    int visited = 0;
+    if (!(flags & TODO_SEARCH_SUBSTRING) && count == 0) {
+        // Nothing to look for
+    } else if (!(flags & TODO_SEARCH_SUBSTRING) && list->search) {
+        visited = search_indexed(list, words, count, fn, user_data);
+    } else {
+        // Scan in ID order, as the index would answer
+        for (int id = 1; id < list->next_id; id++) {
+            const Todo* todo = todo_find_by_id(list, id);
+            if (!todo) {
+                continue;
+            }
+            
+            int match;
+            if (flags & TODO_SEARCH_SUBSTRING) {
+                size_t length = (size_t)todo->title_length + 1 + todo->desc_length;
+                match = query_length == 0 ||
+                        contains_folded(todo_get_title(list, todo), length, buffer, query_length);
+            } else {
+                match = todo_matches(list, todo, words, count);
+            }
+            
+            if (match) {
+                visited++;
+                if (fn(list, todo, user_data) != 0) {
+                    break;
+                }
+            }
+        }
+    }
+    
+    free(buffer);
+    return visited;
+}
\ No newline at end of file
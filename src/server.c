@@ -0,0 +1,911 @@
+/**
+ * @file server.c
+ * @brief Implementation of the resident todo server
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the event loop behind todo_server_run. Sockets
+ * are non-blocking and level-triggered. Each wakeup reads whatever the
+ * ready connections sent, handles every complete request in order
+ * (pipelined requests are simply consecutive frames), commits the
+ * journal once, and only then writes the queued responses, so a client
+ * never sees a change acknowledged before it is durable. A connection
+ * whose responses are not being read stops being read itself until its
+ * backlog drains.
+ */
+
+// kqueue is hidden by strict POSIX feature macros on the BSDs
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+    #define SERVER_USE_KQUEUE
+#else
+    // Needed for sockets and sigaction-safe fcntl under -std=c99
+    #define _POSIX_C_SOURCE 200809L
+    #ifdef __linux__
+        #define SERVER_USE_EPOLL
+    #endif
+#endif
+
+#include "../include/server.h"
+#include "../include/wire.h"
+#include "../include/todo_log.h"
+
+#include <signal.h>
+
+#ifndef _WIN32
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+    #if defined(SERVER_USE_EPOLL)
+        #include <sys/epoll.h>
+    #elif defined(SERVER_USE_KQUEUE)
+        #include <sys/types.h>
+        #include <sys/event.h>
+        #include <sys/time.h>
+    #else
+        #include <poll.h>
+    #endif
+#endif
+
+// Set by todo_server_stop, possibly from a signal handler
+static volatile sig_atomic_t stop_requested = 0;
+
+/**
+ * @brief Ask a running server to finish its current wakeup and return
+ */
+void todo_server_stop(void) {
+    stop_requested = 1;
+}
+
+#ifdef _WIN32
+
+/**
+ * @brief Serve a list until todo_server_stop is called
+ * @param list List to serve
+ * @param journal Journal recording changes to list, or NULL
+ * @param scheduler Scheduler whose reminders to fire, or NULL
+ * @param socket_path Path of the Unix socket
+ * @return TODO_ERR_INVALID: Unix sockets are not supported on this platform
+ */
+int todo_server_run(TodoList* list, Journal* journal, TodoScheduler* scheduler, const char* socket_path) {
+    (void)list;
+    (void)journal;
+    (void)scheduler;
+    (void)socket_path;
+    todo_log(TODO_LOG_ERROR, "Server mode is not supported on Windows");
+    return TODO_ERR_INVALID;
+}
+
+#else
+
+// Bytes requested from the socket per read
+#define SERVER_READ_SIZE 16384
+
+// Unsent response bytes at which a connection stops being read
+#define SERVER_MAX_BACKLOG (4u << 20)
+
+// Events handled per wakeup
+#define SERVER_MAX_EVENTS 64
+
+// Longest wait between checks of stop_requested, in milliseconds
+#define SERVER_WAIT_MS 500
+
+/**
+ * @brief One client connection
+ */
+typedef struct {
+    int fd;
+    WireBuffer in;                         // Received bytes not yet handled
+    WireBuffer out;                        // Responses not yet written
+    size_t sent;                           // Bytes at the front of out already written
+    int reading;                           // Read interest registered
+    int writing;                           // Write interest registered
+    int closing;                           // Close once out is drained
+    int dead;                              // Closed; freed at the end of the wakeup
+    int touched;                           // Listed in Server.touched this wakeup
+} Connection;
+
+/**
+ * @brief Readiness reported for one socket
+ */
+typedef struct {
+    Connection* connection;                // NULL for the listening socket
+    int readable;
+    int writable;
+} PollEvent;
+
+/**
+ * @brief Readiness notification backend
+ */
+typedef struct {
+#if defined(SERVER_USE_EPOLL) || defined(SERVER_USE_KQUEUE)
+    int fd;                                // epoll or kqueue descriptor
+#else
+    struct pollfd fds[TODO_SERVER_MAX_CLIENTS + 1];
+    Connection* owners[TODO_SERVER_MAX_CLIENTS + 1];
+    int count;
+#endif
+} Poller;
+
+/**
+ * @brief State of a running server
+ */
+typedef struct {
+    TodoList* list;
+    Journal* journal;
+    TodoScheduler* scheduler;
+    int listener;
+    Poller poller;
+    Connection* connections[TODO_SERVER_MAX_CLIENTS];
+    int connection_count;
+    Connection* touched[TODO_SERVER_MAX_CLIENTS];
+    int touched_count;
+    int modified;                          // A request changed the list this wakeup
+} Server;
+
+#if defined(SERVER_USE_EPOLL)
+
+/**
+ * @brief Create the readiness backend
+ * @param poller Poller to initialize
+ * @return 0 on success, -1 on failure
+ */
+static int poller_open(Poller* poller) {
+    poller->fd = epoll_create1(EPOLL_CLOEXEC);
+    return poller->fd >= 0 ? 0 : -1;
+}
+
+/**
+ * @brief Free the readiness backend
+ * @param poller Poller to close
+ */
+static void poller_close(Poller* poller) {
+    close(poller->fd);
+}
+
+/**
+ * @brief Set the interest of a socket, registering it on first use
+ * @param poller Poller
+ * @param fd Socket
+ * @param owner Connection, or NULL for the listening socket
+ * @param added Whether the socket is already registered
+ * @param read Whether to report readability
+ * @param write Whether to report writability
+ * @return 0 on success, -1 on failure
+ */
+static int poller_set(Poller* poller, int fd, Connection* owner, int added, int read, int write) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = (read ? EPOLLIN : 0) | (write ? EPOLLOUT : 0);
+    event.data.ptr = owner;
+    return epoll_ctl(poller->fd, added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event);
+}
+
+/**
+ * @brief Stop watching a socket (before it is closed)
+ * @param poller Poller
+ * @param fd Socket
+ */
+static void poller_remove(Poller* poller, int fd) {
+    struct epoll_event event;
+    epoll_ctl(poller->fd, EPOLL_CTL_DEL, fd, &event);
+}
+
+/**
+ * @brief Wait for sockets to become ready
+ * @param poller Poller
+ * @param events Receives the ready sockets
+ * @param max Size of events
+ * @param timeout_ms Longest wait
+ * @return Number of events, -1 on failure (errno set)
+ */
+static int poller_wait(Poller* poller, PollEvent* events, int max, int timeout_ms) {
+    struct epoll_event ready[SERVER_MAX_EVENTS];
+    int count = epoll_wait(poller->fd, ready, max < SERVER_MAX_EVENTS ? max : SERVER_MAX_EVENTS, timeout_ms);
+    for (int i = 0; i < count; i++) {
+        events[i].connection = (Connection*)ready[i].data.ptr;
+        // Errors and hangups are reported by the next read
+        events[i].readable = (ready[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+        events[i].writable = (ready[i].events & EPOLLOUT) != 0;
+    }
+    return count;
+}
+
+#elif defined(SERVER_USE_KQUEUE)
+
+/**
+ * @brief Create the readiness backend
+ * @param poller Poller to initialize
+ * @return 0 on success, -1 on failure
+ */
+static int poller_open(Poller* poller) {
+    poller->fd = kqueue();
+    return poller->fd >= 0 ? 0 : -1;
+}
+
+/**
+ * @brief Free the readiness backend
+ * @param poller Poller to close
+ */
+static void poller_close(Poller* poller) {
+    close(poller->fd);
+}
+
+/**
+ * @brief Set the interest of a socket, registering it on first use
+ * @param poller Poller
+ * @param fd Socket
+ * @param owner Connection, or NULL for the listening socket
+ * @param added Whether the socket is already registered
+ * @param read Whether to report readability
+ * @param write Whether to report writability
+ * @return 0 on success, -1 on failure
+ */
+static int poller_set(Poller* poller, int fd, Connection* owner, int added, int read, int write) {
+    struct kevent changes[2];
+    (void)added;
+    EV_SET(&changes[0], fd, EVFILT_READ, EV_ADD | (read ? EV_ENABLE : EV_DISABLE), 0, 0, owner);
+    EV_SET(&changes[1], fd, EVFILT_WRITE, EV_ADD | (write ? EV_ENABLE : EV_DISABLE), 0, 0, owner);
+    return kevent(poller->fd, changes, 2, NULL, 0, NULL) < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Stop watching a socket (before it is closed)
+ * @param poller Poller
+ * @param fd Socket
+ */
+static void poller_remove(Poller* poller, int fd) {
+    // Closing the descriptor removes its filters
+    (void)poller;
+    (void)fd;
+}
+
+/**
+ * @brief Wait for sockets to become ready
+ * @param poller Poller
+ * @param events Receives the ready sockets
+ * @param max Size of events
+ * @param timeout_ms Longest wait
+ * @return Number of events, -1 on failure (errno set)
+ */
+static int poller_wait(Poller* poller, PollEvent* events, int max, int timeout_ms) {
+    struct kevent ready[SERVER_MAX_EVENTS];
+    struct timespec timeout = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+    int count = kevent(poller->fd, NULL, 0, ready, max < SERVER_MAX_EVENTS ? max : SERVER_MAX_EVENTS, &timeout);
+    for (int i = 0; i < count; i++) {
+        events[i].connection = (Connection*)ready[i].udata;
+        events[i].readable = ready[i].filter == EVFILT_READ;
+        events[i].writable = ready[i].filter == EVFILT_WRITE;
+    }
+    return count;
+}
+
+#else
+
+/**
+ * @brief Create the readiness backend
+ * @param poller Poller to initialize
+ * @return 0
+ */
+static int poller_open(Poller* poller) {
+    poller->count = 0;
+    return 0;
+}
+
+/**
+ * @brief Free the readiness backend
+ * @param poller Poller to close
+ */
+static void poller_close(Poller* poller) {
+    poller->count = 0;
+}
+
+/**
+ * @brief Set the interest of a socket, registering it on first use
+ * @param poller Poller
+ * @param fd Socket
+ * @param owner Connection, or NULL for the listening socket
+ * @param added Whether the socket is already registered
+ * @param read Whether to report readability
+ * @param write Whether to report writability
+ * @return 0 on success, -1 on failure
+ */
+static int poller_set(Poller* poller, int fd, Connection* owner, int added, int read, int write) {
+    int i = 0;
+    while (added && i < poller->count && poller->fds[i].fd != fd) {
+        i++;
+    }
+    if (!added || i == poller->count) {
+        if (poller->count == TODO_SERVER_MAX_CLIENTS + 1) {
+            return -1;
+        }
+        i = poller->count++;
+        poller->fds[i].fd = fd;
+        poller->owners[i] = owner;
+    }
+    poller->fds[i].events = (short)((read ? POLLIN : 0) | (write ? POLLOUT : 0));
+    return 0;
+}
+
+/**
+ * @brief Stop watching a socket (before it is closed)
+ * @param poller Poller
+ * @param fd Socket
+ */
+static void poller_remove(Poller* poller, int fd) {
+    for (int i = 0; i < poller->count; i++) {
+        if (poller->fds[i].fd == fd) {
+            poller->count--;
+            poller->fds[i] = poller->fds[poller->count];
+            poller->owners[i] = poller->owners[poller->count];
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Wait for sockets to become ready
+ * @param poller Poller
+ * @param events Receives the ready sockets
+ * @param max Size of events
+ * @param timeout_ms Longest wait
+ * @return Number of events, -1 on failure (errno set)
+ */
+static int poller_wait(Poller* poller, PollEvent* events, int max, int timeout_ms) {
+    int ready = poll(poller->fds, (nfds_t)poller->count, timeout_ms);
+    int count = 0;
+    for (int i = 0; i < poller->count && ready > 0 && count < max; i++) {
+        short revents = poller->fds[i].revents;
+        if (revents) {
+            events[count].connection = poller->owners[i];
+            events[count].readable = (revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+            events[count].writable = (revents & POLLOUT) != 0;
+            count++;
+        }
+    }
+    return ready < 0 ? -1 : count;
+}
+
+#endif
+
+/**
+ * @brief Make a socket non-blocking and close-on-exec
+ * @param fd Socket
+ * @return 0 on success, -1 on failure
+ */
+static int prepare_socket(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return -1;
+    }
+    return fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+/**
+ * @brief Create, bind and listen on the server socket
+ *
+ * A socket file nobody accepts connections on is left over from a server
+ * that exited without cleaning up, and is replaced.
+ *
+ * @param path Socket path
+ * @return Listening socket, -1 on failure
+ */
+static int open_listener(const char* path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        todo_log(TODO_LOG_ERROR, "Socket path '%s' is too long", path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        todo_log(TODO_LOG_ERROR, "Unable to create socket: %s", strerror(errno));
+        return -1;
+    }
+    
+    int bound = bind(fd, (struct sockaddr*)&address, sizeof(address));
+    if (bound != 0 && errno == EADDRINUSE) {
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        int alive = probe >= 0 && connect(probe, (struct sockaddr*)&address, sizeof(address)) == 0;
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (alive) {
+            todo_log(TODO_LOG_ERROR, "A server is already listening on '%s'", path);
+            close(fd);
+            return -1;
+        }
+        unlink(path);
+        bound = bind(fd, (struct sockaddr*)&address, sizeof(address));
+    }
+    if (bound != 0 || prepare_socket(fd) != 0 || listen(fd, SOMAXCONN) != 0) {
+        todo_log(TODO_LOG_ERROR, "Unable to listen on '%s': %s", path, strerror(errno));
+        if (bound == 0) {
+            unlink(path);
+        }
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Record that a connection has output to write or may need closing
+ * @param server Server
+ * @param connection Connection handled this wakeup
+ */
+static void touch(Server* server, Connection* connection) {
+    if (!connection->touched) {
+        connection->touched = 1;
+        server->touched[server->touched_count++] = connection;
+    }
+}
+
+/**
+ * @brief Close a connection's socket; the connection is freed later
+ * @param server Server
+ * @param connection Connection to close
+ */
+static void close_connection(Server* server, Connection* connection) {
+    if (!connection->dead) {
+        poller_remove(&server->poller, connection->fd);
+        close(connection->fd);
+        connection->dead = 1;
+    }
+}
+
+/**
+ * @brief Accept every pending connection
+ * @param server Server
+ */
+static void accept_connections(Server* server) {
+    for (;;) {
+        int fd = accept(server->listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                todo_log(TODO_LOG_WARNING, "accept failed: %s", strerror(errno));
+            }
+            return;
+        }
+        
+        Connection* connection = NULL;
+        if (server->connection_count < TODO_SERVER_MAX_CLIENTS && prepare_socket(fd) == 0) {
+            connection = (Connection*)calloc(1, sizeof(Connection));
+        }
+        if (!connection || poller_set(&server->poller, fd, connection, 0, 1, 0) != 0) {
+            todo_log(TODO_LOG_WARNING, "Refusing connection");
+            free(connection);
+            close(fd);
+            continue;
+        }
+        
+        connection->fd = fd;
+        connection->reading = 1;
+        wire_buffer_init(&connection->in);
+        wire_buffer_init(&connection->out);
+        server->connections[server->connection_count++] = connection;
+    }
+}
+
+/**
+ * @brief Context of a LIST request while its matches are encoded
+ */
+typedef struct {
+    WireBuffer* out;
+    uint32_t count;
+} ListReply;
+
+/**
+ * @brief Append one match of a LIST request
+ * @param list List being queried
+ * @param todo Matching todo
+ * @param user_data The ListReply
+ * @return 0 to continue
+ */
+static int encode_match(const TodoList* list, const Todo* todo, void* user_data) {
+    ListReply* reply = (ListReply*)user_data;
+    wire_put_todo(reply->out, list, todo);
+    reply->count++;
+    return 0;
+}
+
+/**
+ * @brief Execute one request and append its response
+ * @param server Server
+ * @param out Buffer the response is appended to
+ * @param op Operation of the request
+ * @param tag Tag of the request
+ * @param body Request body
+ * @param size Size of the body
+ */
+static void handle_request(Server* server, WireBuffer* out, int op, uint32_t tag,
+                           const unsigned char* body, size_t size) {
+    WireReader reader;
+    wire_reader_init(&reader, body, size);
+    size_t frame = wire_begin_frame(out, (TodoWireOp)op, TODO_OK, tag);
+    int status = TODO_OK;
+    
+    switch (op) {
+        case TODO_OP_PING:
+            break;
+        case TODO_OP_CREATE: {
+            char title[MAX_TITLE_LENGTH], description[MAX_DESC_LENGTH];
+            int priority = wire_get_u8(&reader);
+            int has_title = wire_get_string(&reader, title, sizeof(title));
+            int has_description = wire_get_string(&reader, description, sizeof(description));
+            if (has_title < 0 || has_description < 0) {
+                status = has_title < 0 ? has_title : has_description;
+            } else if (has_title != 1 || has_description != 1 || reader.error || reader.left > 0) {
+                status = TODO_ERR_INVALID;
+            } else {
+                int id = todo_create(server->list, title, description, (Priority)priority);
+                if (id < 0) {
+                    status = id;
+                } else {
+                    wire_put_u32(out, (uint32_t)id);
+                    server->modified = 1;
+                }
+            }
+            break;
+        }
+        case TODO_OP_GET: {
+            int id = (int)wire_get_u32(&reader);
+            const Todo* todo = reader.error || reader.left > 0 ? NULL : todo_find_by_id(server->list, id);
+            if (todo) {
+                wire_put_todo(out, server->list, todo);
+            } else {
+                status = reader.error || reader.left > 0 ? TODO_ERR_INVALID : TODO_ERR_NOT_FOUND;
+            }
+            break;
+        }
+        case TODO_OP_UPDATE: {
+            char title[MAX_TITLE_LENGTH], description[MAX_DESC_LENGTH];
+            int id = (int)wire_get_u32(&reader);
+            int priority = wire_get_u8(&reader);
+            int has_title = wire_get_string(&reader, title, sizeof(title));
+            int has_description = wire_get_string(&reader, description, sizeof(description));
+            if (has_title < 0 || has_description < 0) {
+                status = has_title < 0 ? has_title : has_description;
+            } else if (reader.error || reader.left > 0) {
+                status = TODO_ERR_INVALID;
+            } else {
+                status = todo_update(server->list, id, has_title ? title : NULL,
+                                     has_description ? description : NULL, priority ? priority : -1);
+                server->modified |= status == TODO_OK;
+            }
+            break;
+        }
+        case TODO_OP_DELETE:
+        case TODO_OP_COMPLETE:
+        case TODO_OP_PENDING: {
+            int id = (int)wire_get_u32(&reader);
+            if (reader.error || reader.left > 0) {
+                status = TODO_ERR_INVALID;
+            } else if (op == TODO_OP_DELETE) {
+                status = todo_delete(server->list, id);
+            } else if (op == TODO_OP_COMPLETE) {
+                status = todo_complete(server->list, id);
+            } else {
+                status = todo_mark_pending(server->list, id);
+            }
+            server->modified |= status == TODO_OK;
+            break;
+        }
+        case TODO_OP_DUE: {
+            int id = (int)wire_get_u32(&reader);
+            int64_t due_at = (int64_t)wire_get_u64(&reader);
+            if (reader.error || reader.left > 0) {
+                status = TODO_ERR_INVALID;
+            } else {
+                status = todo_set_due(server->list, id, (time_t)due_at);
+                server->modified |= status == TODO_OK;
+            }
+            break;
+        }
+        case TODO_OP_LIST: {
+            unsigned status_mask = wire_get_u8(&reader);
+            unsigned priority_mask = wire_get_u8(&reader);
+            if (reader.error || reader.left > 0) {
+                status = TODO_ERR_INVALID;
+                break;
+            }
+            size_t count_offset = out->size;
+            ListReply reply = { out, 0 };
+            wire_put_u32(out, 0);
+            int result = todo_query(server->list, status_mask, priority_mask, encode_match, &reply);
+            if (result < 0) {
+                status = result;
+            } else if (out->error == TODO_OK) {
+                out->data[count_offset] = (unsigned char)reply.count;
+                out->data[count_offset + 1] = (unsigned char)(reply.count >> 8);
+                out->data[count_offset + 2] = (unsigned char)(reply.count >> 16);
+                out->data[count_offset + 3] = (unsigned char)(reply.count >> 24);
+            }
+            break;
+        }
+        case TODO_OP_CHECKPOINT:
+            status = server->journal ? journal_checkpoint(server->journal) : TODO_ERR_INVALID;
+            break;
+        case TODO_OP_STATS: {
+            if (reader.error || reader.left > 0) {
+                status = TODO_ERR_INVALID;
+                break;
+            }
+            TodoMetrics metrics;
+            todo_metrics_snapshot(&metrics);
+            wire_put_metrics(out, &metrics);
+            break;
+        }
+        default:
+            status = TODO_ERR_INVALID;
+            break;
+    }
+    
+    if (out->error != TODO_OK) {
+        return;
+    }
+    if (status != TODO_OK) {
+        // Failed requests carry no body
+        out->size = frame + TODO_WIRE_HEADER_SIZE;
+        out->data[frame + 5] = (unsigned char)(int8_t)status;
+    }
+    wire_end_frame(out, frame);
+}
+
+/**
+ * @brief Handle every complete request received on a connection
+ * @param server Server
+ * @param connection Connection with new input
+ */
+static void handle_input(Server* server, Connection* connection) {
+    size_t offset = 0;
+    while (!connection->closing) {
+        size_t body_size;
+        int op, status;
+        uint32_t tag;
+        int complete = wire_peek_frame(connection->in.data + offset, connection->in.size - offset,
+                                       &body_size, &op, &status, &tag);
+        if (complete < 0 || (complete == 0 && connection->in.size - offset >= TODO_WIRE_HEADER_SIZE &&
+                             body_size > TODO_WIRE_MAX_REQUEST)) {
+            // Not speaking the protocol: answer what came before and hang up
+            connection->closing = 1;
+            break;
+        }
+        if (complete == 0) {
+            break;
+        }
+        
+        handle_request(server, &connection->out, op, tag,
+                       connection->in.data + offset + TODO_WIRE_HEADER_SIZE, body_size);
+        offset += TODO_WIRE_HEADER_SIZE + body_size;
+        if (connection->out.error != TODO_OK) {
+            todo_log(TODO_LOG_WARNING, "Dropping connection after allocation failure");
+            close_connection(server, connection);
+            return;
+        }
+    }
+    wire_buffer_consume(&connection->in, connection->closing ? connection->in.size : offset);
+}
+
+/**
+ * @brief Read from a ready connection and handle what arrived
+ * @param server Server
+ * @param connection Readable connection
+ */
+static void read_connection(Server* server, Connection* connection) {
+    touch(server, connection);
+    while (!connection->dead && !connection->closing &&
+           connection->out.size - connection->sent < SERVER_MAX_BACKLOG) {
+        if (wire_buffer_reserve(&connection->in, SERVER_READ_SIZE) != TODO_OK) {
+            close_connection(server, connection);
+            return;
+        }
+        
+        ssize_t received = recv(connection->fd, connection->in.data + connection->in.size, SERVER_READ_SIZE, 0);
+        if (received > 0) {
+            connection->in.size += (size_t)received;
+            handle_input(server, connection);
+        } else if (received == 0) {
+            // The client is done sending; answer what it sent, then close
+            connection->closing = 1;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        } else {
+            close_connection(server, connection);
+        }
+    }
+}
+
+/**
+ * @brief Write queued responses and update what the connection waits for
+ * @param server Server
+ * @param connection Connection handled this wakeup
+ */
+static void flush_connection(Server* server, Connection* connection) {
+    while (!connection->dead && connection->sent < connection->out.size) {
+        ssize_t written = send(connection->fd, connection->out.data + connection->sent,
+                               connection->out.size - connection->sent,
+#ifdef MSG_NOSIGNAL
+                               MSG_NOSIGNAL);
+#else
+                               0);
+#endif
+        if (written > 0) {
+            connection->sent += (size_t)written;
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            close_connection(server, connection);
+        }
+    }
+    if (connection->dead) {
+        return;
+    }
+    
+    if (connection->sent == connection->out.size) {
+        connection->out.size = 0;
+        connection->sent = 0;
+        if (connection->closing) {
+            close_connection(server, connection);
+            return;
+        }
+    } else if (connection->sent >= SERVER_READ_SIZE) {
+        wire_buffer_consume(&connection->out, connection->sent);
+        connection->sent = 0;
+    }
+    
+    size_t backlog = connection->out.size - connection->sent;
+    int reading = !connection->closing && backlog < SERVER_MAX_BACKLOG;
+    int writing = backlog > 0;
+    if (reading != connection->reading || writing != connection->writing) {
+        if (poller_set(&server->poller, connection->fd, connection, 1, reading, writing) != 0) {
+            close_connection(server, connection);
+            return;
+        }
+        connection->reading = reading;
+        connection->writing = writing;
+    }
+}
+
+/**
+ * @brief Commit the wakeup's changes, then send its responses
+ * @param server Server
+ */
+static void finish_wakeup(Server* server) {
+    if (server->modified && server->journal) {
+        int result = journal_commit(server->journal);
+        if (result != TODO_OK) {
+            todo_log(TODO_LOG_ERROR, "Journal commit failed: %s", todo_strerror(result));
+        }
+    }
+    server->modified = 0;
+    
+    for (int i = 0; i < server->touched_count; i++) {
+        flush_connection(server, server->touched[i]);
+        server->touched[i]->touched = 0;
+    }
+    server->touched_count = 0;
+    
+    // Free closed connections now that no event refers to them
+    int kept = 0;
+    for (int i = 0; i < server->connection_count; i++) {
+        Connection* connection = server->connections[i];
+        if (connection->dead) {
+            wire_buffer_free(&connection->in);
+            wire_buffer_free(&connection->out);
+            free(connection);
+        } else {
+            server->connections[kept++] = connection;
+        }
+    }
+    server->connection_count = kept;
+}
+
+/**
+ * @brief Time to wait for events before the next check
+ * @param server Server
+ * @return Milliseconds until the next reminder is due, at most SERVER_WAIT_MS
+ */
+static int wait_time(const Server* server) {
+    time_t next_due = todo_scheduler_next_due(server->scheduler);
+    if (next_due == 0) {
+        return SERVER_WAIT_MS;
+    }
+    
+    time_t now = time(NULL);
+    if (next_due <= now) {
+        return 0;
+    }
+    double wait_ms = difftime(next_due, now) * 1000.0;
+    return wait_ms < SERVER_WAIT_MS ? (int)wait_ms : SERVER_WAIT_MS;
+}
+
+/**
+ * @brief Serve a list until todo_server_stop is called
+ * @param list List to serve
+ * @param journal Journal recording changes to list, or NULL to keep them in memory only
+ * @param scheduler Scheduler whose reminders to fire, or NULL
+ * @param socket_path Path of the Unix socket (NULL for TODO_SERVER_DEFAULT_SOCKET)
+ * @return TODO_OK once stopped, negative TodoError if the server could not start or failed
+ */
+int todo_server_run(TodoList* list, Journal* journal, TodoScheduler* scheduler, const char* socket_path) {
+    if (!list) {
+        return TODO_ERR_INVALID;
+    }
+    const char* path = socket_path ? socket_path : TODO_SERVER_DEFAULT_SOCKET;
+    
+    Server* server = (Server*)calloc(1, sizeof(Server));
+    if (!server) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    server->list = list;
+    server->journal = journal;
+    server->scheduler = scheduler;
+    
+    server->listener = open_listener(path);
+    if (server->listener < 0) {
+        free(server);
+        return TODO_ERR_IO;
+    }
+    if (poller_open(&server->poller) != 0 ||
+        poller_set(&server->poller, server->listener, NULL, 0, 1, 0) != 0) {
+        todo_log(TODO_LOG_ERROR, "Unable to watch '%s': %s", path, strerror(errno));
+        close(server->listener);
+        unlink(path);
+        free(server);
+        return TODO_ERR_IO;
+    }
+    
+    int result = TODO_OK;
+    stop_requested = 0;
+    while (!stop_requested) {
+        PollEvent events[SERVER_MAX_EVENTS];
+        int count = poller_wait(&server->poller, events, SERVER_MAX_EVENTS, wait_time(server));
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            todo_log(TODO_LOG_ERROR, "Waiting for clients failed: %s", strerror(errno));
+            result = TODO_ERR_IO;
+            break;
+        }
+        
+        for (int i = 0; i < count; i++) {
+            Connection* connection = events[i].connection;
+            if (!connection) {
+                accept_connections(server);
+            } else if (!connection->dead) {
+                if (events[i].readable) {
+                    read_connection(server, connection);
+                }
+                if (events[i].writable) {
+                    touch(server, connection);
+                }
+            }
+        }
+        finish_wakeup(server);
+        
+        // Reminders go out after the wakeup so they see its committed changes
+        todo_scheduler_fire(server->scheduler, time(NULL));
+    }
+    
+    for (int i = 0; i < server->connection_count; i++) {
+        close_connection(server, server->connections[i]);
+    }
+    finish_wakeup(server);
+    poller_close(&server->poller);
+    close(server->listener);
+    unlink(path);
+    free(server);
+    return result;
+}
+
+#endif
\ No newline at end of file
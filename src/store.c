@@ -0,0 +1,477 @@
+/**
+ * @file store.c
+ * @brief Implementation of the sharded multi-project store
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the store on top of the snapshot and journal code:
+ * every project is an ordinary todo file with its own journal, so each
+ * one gets the same atomic saves, checksums and crash recovery as the
+ * single-file layout. The manifest is a text file of the form
+ *
+ *   TODOSTORE 1
+ *   <name> <todo count>
+ *
+ * with one line per project in name order, replaced atomically whenever
+ * it changes.
+ */
+
+#include "../include/store.h"
+#include "../include/file_io.h"
+#include "../include/journal.h"
+#include "../include/todo_log.h"
+
+#include <ctype.h>
+
+// First line of the manifest
+#define MANIFEST_HEADER "TODOSTORE 1"
+
+// Extension of project snapshot files
+#define SHARD_SUFFIX ".dat"
+
+/**
+ * @brief One project of a store
+ */
+typedef struct {
+    char name[TODO_STORE_MAX_NAME + 1];
+    int count;                             // Todo count recorded in the manifest
+    TodoList* list;                        // NULL until loaded
+    Journal* journal;                      // Journal of list
+} StoreShard;
+
+struct TodoStore {
+    char* directory;
+    StoreShard* shards;                    // Sorted by name
+    int shard_count;
+    int shard_capacity;
+};
+
+/**
+ * @brief Check that a project name is safe to use as a file name
+ * @param name Name to check
+ * @return 1 if valid, 0 otherwise
+ */
+static int valid_name(const char* name) {
+    size_t length = strlen(name);
+    if (length == 0 || length > TODO_STORE_MAX_NAME || name[0] == '.') {
+        return 0;
+    }
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)name[i];
+        if (!isalnum(c) && c != '-' && c != '_' && c != '.') {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Build the name of a file inside the store directory
+ * @param store Store owning the directory
+ * @param name File name, or project name if suffix is given
+ * @param suffix Text appended to name
+ * @param buffer Receives the path
+ * @param size Size of buffer
+ * @return TODO_OK on success, TODO_ERR_INVALID if the path does not fit
+ */
+static int store_path(const TodoStore* store, const char* name, const char* suffix, char* buffer, size_t size) {
+    if (snprintf(buffer, size, "%s/%s%s", store->directory, name, suffix) >= (int)size) {
+        todo_log(TODO_LOG_ERROR, "Store path for '%s' is too long", name);
+        return TODO_ERR_INVALID;
+    }
+    return TODO_OK;
+}
+
+/**
+ * @brief Find a project or the position where it would be inserted
+ * @param store Store to search
+ * @param name Project name
+ * @param found Set to 1 if the project exists, 0 otherwise
+ * @return Position of the project, or of the first project after it
+ */
+static int shard_search(const TodoStore* store, const char* name, int* found) {
+    int low = 0;
+    int high = store->shard_count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        int order = strcmp(store->shards[middle].name, name);
+        if (order == 0) {
+            *found = 1;
+            return middle;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    *found = 0;
+    return low;
+}
+
+/**
+ * @brief Insert an unloaded project entry in name order
+ * @param store Store to add to
+ * @param name Valid project name not yet in the store
+ * @param count Todo count to record
+ * @return Position of the new entry, -1 on allocation failure
+ */
+static int shard_insert(TodoStore* store, const char* name, int count) {
+    int found;
+    int position = shard_search(store, name, &found);
+    
+    if (store->shard_count == store->shard_capacity) {
+        int capacity = store->shard_capacity > 0 ? store->shard_capacity * 2 : 8;
+        StoreShard* shards = (StoreShard*)realloc(store->shards, sizeof(StoreShard) * capacity);
+        if (!shards) {
+            todo_log(TODO_LOG_ERROR, "Memory allocation failed for store");
+            return -1;
+        }
+        store->shards = shards;
+        store->shard_capacity = capacity;
+    }
+    
+    memmove(&store->shards[position + 1], &store->shards[position],
+            sizeof(StoreShard) * (store->shard_count - position));
+    StoreShard* shard = &store->shards[position];
+    strcpy(shard->name, name);
+    shard->count = count;
+    shard->list = NULL;
+    shard->journal = NULL;
+    store->shard_count++;
+    return position;
+}
+
+/**
+ * @brief Free a project's list and journal, keeping its entry
+ * @param shard Project to unload
+ */
+static void shard_unload(StoreShard* shard) {
+    journal_close(shard->journal);
+    todo_list_destroy(shard->list);
+    shard->journal = NULL;
+    shard->list = NULL;
+}
+
+/**
+ * @brief Read the manifest into an empty store
+ * @param store Store to fill
+ * @return TODO_OK on success (including a missing manifest), negative TodoError on failure
+ */
+static int read_manifest(TodoStore* store) {
+    char filename[512];
+    if (store_path(store, TODO_STORE_MANIFEST, "", filename, sizeof(filename)) != TODO_OK) {
+        return TODO_ERR_INVALID;
+    }
+    
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        return file_exists(filename) ? TODO_ERR_IO : TODO_OK;
+    }
+    
+    char line[TODO_STORE_MAX_NAME + 64];
+    int result = TODO_OK;
+    if (!fgets(line, sizeof(line), file) || strncmp(line, MANIFEST_HEADER, strlen(MANIFEST_HEADER)) != 0) {
+        result = TODO_ERR_CORRUPT;
+    }
+    
+    while (result == TODO_OK && fgets(line, sizeof(line), file)) {
+        char name[TODO_STORE_MAX_NAME + 2];
+        int count;
+        if (sscanf(line, "%64s %d", name, &count) != 2 || !valid_name(name) || count < 0 ||
+            todo_store_find(store, name) >= 0) {
+            result = TODO_ERR_CORRUPT;
+        } else if (shard_insert(store, name, count) < 0) {
+            result = TODO_ERR_NO_MEMORY;
+        }
+    }
+    
+    if (result == TODO_ERR_CORRUPT) {
+        todo_log(TODO_LOG_ERROR, "Store manifest '%s' is corrupt", filename);
+    }
+    fclose(file);
+    return result;
+}
+
+/**
+ * @brief Replace the manifest with the current project list
+ * @param store Store to describe
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int write_manifest(const TodoStore* store) {
+    char filename[512], temp_filename[512];
+    if (store_path(store, TODO_STORE_MANIFEST, "", filename, sizeof(filename)) != TODO_OK ||
+        store_path(store, TODO_STORE_MANIFEST, TEMP_SUFFIX, temp_filename, sizeof(temp_filename)) != TODO_OK) {
+        return TODO_ERR_INVALID;
+    }
+    
+    FILE* file = fopen(temp_filename, "w");
+    if (!file) {
+        todo_log(TODO_LOG_ERROR, "Unable to open file '%s' for writing", temp_filename);
+        return TODO_ERR_IO;
+    }
+    
+    int ok = fprintf(file, "%s\n", MANIFEST_HEADER) > 0;
+    for (int i = 0; i < store->shard_count && ok; i++) {
+        ok = fprintf(file, "%s %d\n", store->shards[i].name, store->shards[i].count) > 0;
+    }
+    ok = ok && fflush(file) == 0 && file_sync(file) == TODO_OK;
+    ok = fclose(file) == 0 && ok;
+    
+    if (!ok || file_replace(temp_filename, filename) != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Failed to write store manifest '%s'", filename);
+        remove(temp_filename);
+        return TODO_ERR_IO;
+    }
+    return TODO_OK;
+}
+
+/**
+ * @brief Open a store and read its manifest, creating the directory if needed
+ * @param directory Store directory (NULL for TODO_STORE_DEFAULT_DIR)
+ * @return New store, NULL on failure (including a corrupt manifest)
+ */
+TodoStore* todo_store_open(const char* directory) {
+    if (!directory) {
+        // The default directory lives inside the data directory
+        if (ensure_data_directory() != TODO_OK) {
+            todo_log(TODO_LOG_WARNING, "Could not create data directory");
+        }
+        directory = TODO_STORE_DEFAULT_DIR;
+    }
+    if (ensure_directory(directory) != TODO_OK) {
+        todo_log(TODO_LOG_ERROR, "Could not create store directory '%s'", directory);
+        return NULL;
+    }
+    
+    TodoStore* store = (TodoStore*)calloc(1, sizeof(TodoStore));
+    char* copy = (char*)malloc(strlen(directory) + 1);
+    if (!store || !copy) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for store");
+        free(store);
+        free(copy);
+        return NULL;
+    }
+    strcpy(copy, directory);
+    store->directory = copy;
+    
+    if (read_manifest(store) != TODO_OK) {
+        todo_store_close(store);
+        return NULL;
+    }
+    return store;
+}
+
+/**
+ * @brief Free a store and every project it loaded
+ * @param store Store to close (may be NULL)
+ */
+void todo_store_close(TodoStore* store) {
+    if (!store) {
+        return;
+    }
+    
+    for (int i = 0; i < store->shard_count; i++) {
+        shard_unload(&store->shards[i]);
+    }
+    free(store->shards);
+    free(store->directory);
+    free(store);
+}
+
+/**
+ * @brief Number of projects in a store
+ * @param store Store to inspect
+ * @return Project count
+ */
+int todo_store_count(const TodoStore* store) {
+    return store ? store->shard_count : 0;
+}
+
+/**
+ * @brief Name of a project
+ * @param store Store to inspect
+ * @param index Project position (0 to todo_store_count - 1, in name order)
+ * @return Project name, NULL if index is out of range
+ */
+const char* todo_store_name(const TodoStore* store, int index) {
+    if (!store || index < 0 || index >= store->shard_count) {
+        return NULL;
+    }
+    return store->shards[index].name;
+}
+
+/**
+ * @brief Number of todos in a project, without loading it
+ * @param store Store to inspect
+ * @param index Project position
+ * @return Live todo count, negative TodoError on failure
+ */
+int todo_store_todo_count(const TodoStore* store, int index) {
+    if (!store || index < 0 || index >= store->shard_count) {
+        return TODO_ERR_INVALID;
+    }
+    const StoreShard* shard = &store->shards[index];
+    return shard->list ? shard->list->count : shard->count;
+}
+
+/**
+ * @brief Position of a project
+ * @param store Store to search
+ * @param name Project name
+ * @return Project position, -1 if there is no such project
+ */
+int todo_store_find(const TodoStore* store, const char* name) {
+    if (!store || !name) {
+        return -1;
+    }
+    int found;
+    int position = shard_search(store, name, &found);
+    return found ? position : -1;
+}
+
+/**
+ * @brief Get a project's list, loading it on first use
+ * @param store Store holding the project
+ * @param name Project name
+ * @return The project's list, NULL if there is no such project or it fails to load
+ */
+TodoList* todo_store_get(TodoStore* store, const char* name) {
+    int position = todo_store_find(store, name);
+    if (position < 0) {
+        return NULL;
+    }
+    
+    StoreShard* shard = &store->shards[position];
+    if (shard->list) {
+        return shard->list;
+    }
+    
+    char filename[512];
+    if (store_path(store, shard->name, SHARD_SUFFIX, filename, sizeof(filename)) != TODO_OK) {
+        return NULL;
+    }
+    
+    // Map the file; only projects that change are copied into memory
+    shard->list = todo_list_create();
+    if (!shard->list || load_todos_from_file_ex(shard->list, filename, TODO_LOAD_MAP) != TODO_OK ||
+        !(shard->journal = journal_open(shard->list, filename))) {
+        todo_log(TODO_LOG_ERROR, "Failed to load project '%s'", shard->name);
+        shard_unload(shard);
+        return NULL;
+    }
+    return shard->list;
+}
+
+/**
+ * @brief Add an empty project
+ * @param store Store to add to
+ * @param name Project name
+ * @return The new project's list (owned by the store), NULL on failure
+ */
+TodoList* todo_store_add(TodoStore* store, const char* name) {
+    if (!store || !name || !valid_name(name)) {
+        todo_log(TODO_LOG_ERROR, "Invalid project name '%s'", name ? name : "");
+        return NULL;
+    }
+    if (todo_store_find(store, name) >= 0) {
+        todo_log(TODO_LOG_ERROR, "Project '%s' already exists", name);
+        return NULL;
+    }
+    
+    int position = shard_insert(store, name, 0);
+    if (position < 0) {
+        return NULL;
+    }
+    if (write_manifest(store) != TODO_OK) {
+        memmove(&store->shards[position], &store->shards[position + 1],
+                sizeof(StoreShard) * (store->shard_count - position - 1));
+        store->shard_count--;
+        return NULL;
+    }
+    
+    // Leftovers of an earlier project of the same name would be replayed
+    char filename[512], log_filename[512];
+    if (store_path(store, name, SHARD_SUFFIX, filename, sizeof(filename)) == TODO_OK &&
+        journal_log_path(filename, log_filename, sizeof(log_filename)) == TODO_OK) {
+        remove(filename);
+        remove(log_filename);
+    }
+    return todo_store_get(store, name);
+}
+
+/**
+ * @brief Delete a project and its files
+ * @param store Store holding the project
+ * @param name Project name
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND if there is no such project, negative TodoError on failure
+ */
+int todo_store_remove(TodoStore* store, const char* name) {
+    int position = todo_store_find(store, name);
+    if (position < 0) {
+        return store && name ? TODO_ERR_NOT_FOUND : TODO_ERR_INVALID;
+    }
+    
+    // Drop the entry first: files without an entry are harmless
+    StoreShard removed = store->shards[position];
+    memmove(&store->shards[position], &store->shards[position + 1],
+            sizeof(StoreShard) * (store->shard_count - position - 1));
+    store->shard_count--;
+    int result = write_manifest(store);
+    if (result != TODO_OK) {
+        memmove(&store->shards[position + 1], &store->shards[position],
+                sizeof(StoreShard) * (store->shard_count - position));
+        store->shards[position] = removed;
+        store->shard_count++;
+        return result;
+    }
+    shard_unload(&removed);
+    
+    static const char* const suffixes[] = { "", JOURNAL_LOG_SUFFIX, BACKUP_SUFFIX, TEMP_SUFFIX };
+    for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++) {
+        char filename[512];
+        if (snprintf(filename, sizeof(filename), "%s/%s%s%s", store->directory, removed.name,
+                     SHARD_SUFFIX, suffixes[i]) < (int)sizeof(filename)) {
+            remove(filename);
+        }
+    }
+    return TODO_OK;
+}
+
+/**
+ * @brief Commit the changes of every loaded project and update the manifest
+ * @param store Store to save
+ * @return TODO_OK on success, negative TodoError if any project failed to save
+ */
+int todo_store_save(TodoStore* store) {
+    if (!store) {
+        return TODO_ERR_INVALID;
+    }
+    
+    int result = TODO_OK;
+    int counts_changed = 0;
+    for (int i = 0; i < store->shard_count; i++) {
+        StoreShard* shard = &store->shards[i];
+        if (!shard->list || journal_pending_bytes(shard->journal) == 0) {
+            continue;
+        }
+        
+        int saved = journal_commit(shard->journal);
+        if (saved != TODO_OK) {
+            todo_log(TODO_LOG_ERROR, "Failed to save project '%s'", shard->name);
+            result = saved;
+        }
+        if (shard->count != shard->list->count) {
+            shard->count = shard->list->count;
+            counts_changed = 1;
+        }
+    }
+    
+    if (counts_changed) {
+        int written = write_manifest(store);
+        if (result == TODO_OK) {
+            result = written;
+        }
+    }
+    return result;
+}
\ No newline at end of file
@@ -8,317 +8,2172 @@
  */
 
 #include "../include/todo.h"
+#include "../include/render.h"
+#include "../include/todo_log.h"
+#include "../include/metrics.h"
+#include "../include/view.h"
+#include "../include/search.h"
+#include "../include/scan.h"
+
+#include <limits.h>
+
+// Initial number of IDs covered by the ID index
+#define INITIAL_INDEX_CAPACITY 64
+
+// Initial size in bytes of the string arena
+#define INITIAL_STRINGS_CAPACITY 1024
+
+// Garbage in the string arena is ignored until it reaches this many bytes
+#define STRINGS_COMPACT_MIN_GARBAGE 4096
+
+// Fewest slots worth giving each thread when the index is rebuilt in parallel
+#define PARALLEL_INDEX_MIN_SLOTS 65536
+
+// IDs per task when filling the buckets in parallel; a multiple of 4096,
+// so that no two tasks write the same summary word
+#define PARALLEL_BUCKET_IDS 262144
+
+/**
+ * @brief One range of slots of a parallel index rebuild
+ */
+typedef struct {
+    int start;                            // First slot
+    int end;                              // One past the last slot
+    int max_id;                           // Largest ID in the range
+    int bad_slot;                         // Slot holding an invalid todo, or -1
+    int duplicate_id;                     // ID seen twice in the range, or 0
+    uint64_t* seen;                       // Bitmap of the IDs in the range
+} IndexChunk;
+
+/**
+ * @brief Shared state of a parallel index rebuild
+ *
+ * Every task writes only its own chunk or its own range of IDs, so the
+ * tasks need no locking.
+ */
+typedef struct {
+    TodoList* list;
+    IndexChunk* chunks;
+    int chunk_count;
+    size_t words;                         // Words per seen bitmap
+    int* duplicates;                      // Per ID-range task: ID found in two chunks, or 0
+    int* counts;                          // Per ID-range task: TODO_BUCKET_COUNT bucket sizes
+} IndexBuild;
+
+/**
+ * @brief Number of 64-bit words in each bucket bitmap
+ * @param index_capacity Number of IDs the bitmaps cover (a multiple of 64)
+ * @return Words per bucket
+ */
+static size_t bucket_words(int index_capacity) {
+    return (size_t)index_capacity / 64;
+}
+
+/**
+ * @brief Number of 64-bit words in each bucket's summary bitmap
+ * @param index_capacity Number of IDs the bitmaps cover
+ * @return Summary words per bucket
+ */
+static size_t summary_words(int index_capacity) {
+    return (bucket_words(index_capacity) + 63) / 64;
+}
+
+/**
+ * @brief Index of the lowest set bit of a non-zero word
+ * @param word Word to inspect
+ * @return Bit position (0-63)
+ */
+static int lowest_bit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief Set an ID's bits in a bucket bitmap and its summary
+ * @param list Pointer to the todo list
+ * @param bucket Bucket to add the ID to
+ * @param id ID covered by the index
+ */
+static void bucket_mark(TodoList* list, int bucket, int id) {
+    size_t word = (size_t)id / 64;
+    list->bucket_bits[bucket * bucket_words(list->index_capacity) + word] |= 1ull << (id % 64);
+    list->bucket_summary[bucket * summary_words(list->index_capacity) + word / 64] |= 1ull << (word % 64);
+}
+
+/**
+ * @brief Add a todo to the bucket matching its status and priority
+ * @param list Pointer to the todo list
+ * @param todo Live todo whose ID is covered by the index
+ */
+static void bucket_insert(TodoList* list, const Todo* todo) {
+    int bucket = TODO_BUCKET(todo->status, todo->priority);
+    bucket_mark(list, bucket, todo->id);
+    list->bucket_counts[bucket]++;
+}
+
+/**
+ * @brief Remove a todo from the bucket matching its status and priority
+ * @param list Pointer to the todo list
+ * @param todo Todo previously added with bucket_insert, unchanged since
+ */
+static void bucket_erase(TodoList* list, const Todo* todo) {
+    int bucket = TODO_BUCKET(todo->status, todo->priority);
+    size_t word = (size_t)todo->id / 64;
+    uint64_t* bits = &list->bucket_bits[bucket * bucket_words(list->index_capacity) + word];
+    *bits &= ~(1ull << (todo->id % 64));
+    if (*bits == 0) {
+        list->bucket_summary[bucket * summary_words(list->index_capacity) + word / 64] &= ~(1ull << (word % 64));
+    }
+    list->bucket_counts[bucket]--;
+}
+
+/**
+ * @brief Empty every bucket of the query index
+ * @param list Pointer to the todo list
+ */
+static void buckets_reset(TodoList* list) {
+    if (list->bucket_bits) {
+        memset(list->bucket_bits, 0, sizeof(uint64_t) * TODO_BUCKET_COUNT * bucket_words(list->index_capacity));
+        memset(list->bucket_summary, 0, sizeof(uint64_t) * TODO_BUCKET_COUNT * summary_words(list->index_capacity));
+    }
+    memset(list->bucket_counts, 0, sizeof(list->bucket_counts));
+}
+
+/**
+ * @brief Add a todo to the query buckets, enabled sorted views and columns
+ *
+ * A view or the columns failing to update are disabled rather than left
+ * inconsistent.
+ *
+ * @param list Pointer to the todo list
+ * @param todo Live todo with its current field values
+ */
+static void secondary_insert(TodoList* list, const Todo* todo) {
+    bucket_insert(list, todo);
+    for (int key = 0; key < TODO_SORT_COUNT; key++) {
+        if (list->views[key] && view_insert(list->views[key], todo) != 0) {
+            todo_log(TODO_LOG_WARNING, "Disabling sorted view %d after allocation failure", key);
+            todo_list_disable_view(list, (TodoSortKey)key);
+        }
+    }
+    if (list->columns && columns_insert(list->columns, todo) != 0) {
+        todo_log(TODO_LOG_WARNING, "Disabling scan columns after allocation failure");
+        todo_list_disable_columns(list);
+    }
+}
+
+/**
+ * @brief Remove a todo from the query buckets, enabled sorted views and columns
+ *
+ * Must be called before any of the todo's indexed fields change.
+ *
+ * @param list Pointer to the todo list
+ * @param todo Todo as it was when last inserted
+ */
+static void secondary_erase(TodoList* list, const Todo* todo) {
+    bucket_erase(list, todo);
+    for (int key = 0; key < TODO_SORT_COUNT; key++) {
+        if (list->views[key]) {
+            view_erase(list->views[key], todo);
+        }
+    }
+    if (list->columns) {
+        columns_erase(list->columns, todo->id);
+    }
+}
+
+/**
+ * @brief Empty the query buckets, enabled sorted views and columns
+ * @param list Pointer to the todo list
+ */
+static void secondary_reset(TodoList* list) {
+    buckets_reset(list);
+    for (int key = 0; key < TODO_SORT_COUNT; key++) {
+        if (list->views[key]) {
+            view_reset(list->views[key]);
+        }
+    }
+    if (list->columns) {
+        columns_reset(list->columns);
+    }
+}
+
+/**
+ * @brief Update the search index after a todo's text was set
+ *
+ * An index whose update fails is disabled rather than left inconsistent.
+ *
+ * @param list Pointer to the todo list
+ * @param todo Live todo with its current text
+ */
+static void text_changed(TodoList* list, const Todo* todo) {
+    if (list->search && search_index_todo(list->search, list, todo) != 0) {
+        todo_log(TODO_LOG_WARNING, "Disabling search index after allocation failure");
+        todo_list_disable_search(list);
+    }
+}
+
+/**
+ * @brief Rebuild the search index from the whole list
+ * @param list Pointer to the todo list
+ */
+static void text_rebuild(TodoList* list) {
+    if (list->search && search_rebuild(list->search, list) != 0) {
+        todo_log(TODO_LOG_WARNING, "Disabling search index after allocation failure");
+        todo_list_disable_search(list);
+    }
+}
+
+/**
+ * @brief Grow the ID index so that it covers IDs up to and including max_id
+ * @param list Pointer to the todo list
+ * @param max_id Largest ID that must be addressable
+ * @return 0 on success, -1 on allocation failure
+ */
+static int index_reserve(TodoList* list, int max_id) {
+    if (max_id < list->index_capacity) {
+        return 0;
+    }
+    
+    int new_capacity = list->index_capacity > 0 ? list->index_capacity : INITIAL_INDEX_CAPACITY;
+    while (new_capacity <= max_id) {
+        new_capacity *= 2;
+    }
+    
+    // The bucket bitmaps are laid out by capacity, so they are rebuilt rather than grown in place
+    size_t words = bucket_words(new_capacity);
+    size_t summaries = summary_words(new_capacity);
+    uint64_t* new_bits = (uint64_t*)calloc(TODO_BUCKET_COUNT * words, sizeof(uint64_t));
+    uint64_t* new_summary = (uint64_t*)calloc(TODO_BUCKET_COUNT * summaries, sizeof(uint64_t));
+    int* new_index = NULL;
+    if (new_bits && new_summary) {
+        new_index = (int*)realloc(list->id_index, sizeof(int) * new_capacity);
+    }
+    if (!new_index) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for ID index");
+        free(new_bits);
+        free(new_summary);
+        return -1;
+    }
+    
+    for (int i = list->index_capacity; i < new_capacity; i++) {
+        new_index[i] = -1;
+    }
+    
+    if (list->bucket_bits) {
+        size_t old_words = bucket_words(list->index_capacity);
+        size_t old_summaries = summary_words(list->index_capacity);
+        for (int bucket = 0; bucket < TODO_BUCKET_COUNT; bucket++) {
+            memcpy(new_bits + bucket * words, list->bucket_bits + bucket * old_words,
+                   sizeof(uint64_t) * old_words);
+            memcpy(new_summary + bucket * summaries, list->bucket_summary + bucket * old_summaries,
+                   sizeof(uint64_t) * old_summaries);
+        }
+        free(list->bucket_bits);
+        free(list->bucket_summary);
+    }
+    
+    list->id_index = new_index;
+    list->index_capacity = new_capacity;
+    list->bucket_bits = new_bits;
+    list->bucket_summary = new_summary;
+    return 0;
+}
+
+/**
+ * @brief Look up the array slot holding a todo
+ * @param list Pointer to the todo list
+ * @param id ID to search for
+ * @return Slot index if found, -1 otherwise
+ */
+static int index_lookup(const TodoList* list, int id) {
+    if (id <= 0 || id >= list->index_capacity) {
+        return -1;
+    }
+    return list->id_index[id];
+}
+
+/**
+ * @brief Ensure the string arena has room for extra more bytes
+ * @param list Pointer to the todo list
+ * @param extra Number of additional bytes needed
+ * @return 0 on success, -1 on failure
+ */
+static int strings_reserve(TodoList* list, size_t extra) {
+    if (todo_list_make_writable(list) != TODO_OK) {
+        return -1;
+    }
+    
+    size_t needed = list->strings_size + extra;
+    if (needed > UINT32_MAX) {
+        todo_log(TODO_LOG_ERROR, "String storage limit reached");
+        return -1;
+    }
+    
+    if (needed <= list->strings_capacity) {
+        return 0;
+    }
+    
+    size_t new_capacity = list->strings_capacity > 0 ? list->strings_capacity : INITIAL_STRINGS_CAPACITY;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    
+    char* new_strings = (char*)realloc(list->strings, new_capacity);
+    if (!new_strings) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for string storage");
+        return -1;
+    }
+    
+    list->strings = new_strings;
+    list->strings_capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * @brief Size in bytes of a todo's text block, including both terminators
+ * @param todo Pointer to the todo
+ * @return Text block size
+ */
+static size_t text_block_size(const Todo* todo) {
+    return (size_t)todo->title_length + 1 + (size_t)todo->desc_length + 1;
+}
+
+/**
+ * @brief Check whether a pointer refers into the list's string arena
+ * @param list Pointer to the todo list
+ * @param str Pointer to test
+ * @return 1 if str lies inside the arena, 0 otherwise
+ */
+static int points_into_strings(const TodoList* list, const char* str) {
+    uintptr_t p = (uintptr_t)str;
+    uintptr_t base = (uintptr_t)list->strings;
+    return list->strings && p >= base && p < base + list->strings_size;
+}
+
+/**
+ * @brief Append a "title\0description\0" block to the string arena
+ *
+ * Either source string may itself point into the arena (for example the
+ * current description passed back through todo_update); it is located by
+ * offset so that growing the arena cannot leave it dangling.
+ *
+ * @param list Pointer to the todo list
+ * @param todo Todo whose text fields are filled in
+ * @param title Title to store
+ * @param title_length Length of title
+ * @param description Description to store (may be NULL if desc_length is 0)
+ * @param desc_length Length of description
+ * @return 0 on success, -1 on failure
+ */
+static int strings_store(TodoList* list, Todo* todo, const char* title, size_t title_length,
+                         const char* description, size_t desc_length) {
+    size_t title_from = points_into_strings(list, title) ? (size_t)(title - list->strings) : SIZE_MAX;
+    size_t desc_from = points_into_strings(list, description) ? (size_t)(description - list->strings) : SIZE_MAX;
+    
+    if (strings_reserve(list, title_length + 1 + desc_length + 1) != 0) {
+        return -1;
+    }
+    
+    if (title_from != SIZE_MAX) {
+        title = list->strings + title_from;
+    }
+    if (desc_from != SIZE_MAX) {
+        description = list->strings + desc_from;
+    }
+    
+    char* dest = list->strings + list->strings_size;
+    memcpy(dest, title, title_length);
+    dest[title_length] = '\0';
+    if (desc_length > 0) {
+        memcpy(dest + title_length + 1, description, desc_length);
+    }
+    dest[title_length + 1 + desc_length] = '\0';
+    
+    todo->text_offset = (uint32_t)list->strings_size;
+    todo->title_length = (uint16_t)title_length;
+    todo->desc_length = (uint16_t)desc_length;
+    list->strings_size += title_length + 1 + desc_length + 1;
+    return 0;
+}
+
+/**
+ * @brief Rewrite the string arena keeping only text still referenced
+ *
+ * Runs once unreferenced bytes outweigh live ones, so the cost is
+ * amortized over the updates and deletes that produced the garbage.
+ *
+ * @param list Pointer to the todo list
+ */
+static void strings_maybe_compact(TodoList* list) {
+    if (list->strings_garbage < STRINGS_COMPACT_MIN_GARBAGE ||
+        list->strings_garbage * 2 < list->strings_size) {
+        return;
+    }
+    
+    size_t live = list->strings_size - list->strings_garbage;
+    char* compacted = (char*)malloc(live > 0 ? live : 1);
+    if (!compacted) {
+        return; // Keep the fragmented arena, it is still valid
+    }
+    
+    size_t offset = 0;
+    for (int i = 0; i < list->used; i++) {
+        Todo* todo = &list->todos[i];
+        if (todo->id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        size_t size = text_block_size(todo);
+        memcpy(compacted + offset, list->strings + todo->text_offset, size);
+        todo->text_offset = (uint32_t)offset;
+        offset += size;
+    }
+    
+    free(list->strings);
+    list->strings = compacted;
+    list->strings_size = offset;
+    list->strings_capacity = live > 0 ? live : 1;
+    list->strings_garbage = 0;
+}
+
+/**
+ * @brief Tell every registered observer about a change
+ * @param list Pointer to the todo list
+ * @param change Kind of change
+ * @param todo Affected todo
+ */
+static void notify_observers(const TodoList* list, TodoChange change, const Todo* todo) {
+    for (int i = 0; i < list->observer_count; i++) {
+        list->observers[i].fn(list, change, todo, list->observers[i].user_data);
+    }
+}
+
+/**
+ * @brief Append a todo to the end of the used slots
+ *
+ * Lengths must already be validated. Reservations are no-ops when the
+ * caller has reserved room up front, as the batch functions do.
+ *
+ * @param list Pointer to the todo list
+ * @param id ID of the new todo (must not be in use)
+ * @param title Title text
+ * @param title_length Length of title
+ * @param description Description text (may be NULL if desc_length is 0)
+ * @param desc_length Length of description
+ * @param priority Priority level
+ * @param status Completion status
+ * @param created_at Creation timestamp
+ * @param updated_at Last update timestamp
+ * @param due_at Due timestamp (0 for none)
+ * @return 0 on success, -1 on allocation failure
+ */
+static int append_todo(TodoList* list, int id, const char* title, size_t title_length,
+                       const char* description, size_t desc_length, Priority priority,
+                       Status status, time_t created_at, time_t updated_at, time_t due_at) {
+    if (todo_list_reserve(list, list->used + 1) != 0 ||
+        index_reserve(list, id >= list->next_id ? id + 1 : list->next_id) != 0) {
+        return -1;
+    }
+    
+    Todo* todo = &list->todos[list->used];
+    if (strings_store(list, todo, title, title_length, description, desc_length) != 0) {
+        return -1;
+    }
+    
+    todo->id = id;
+    todo->priority = (uint8_t)priority;
+    todo->status = (uint8_t)status;
+    todo->flags = 0;
+    todo->created_at = (int64_t)created_at;
+    todo->updated_at = (int64_t)updated_at;
+    todo->due_at = (int64_t)due_at;
+    
+    list->id_index[id] = list->used++;
+    list->count++;
+    secondary_insert(list, todo);
+    text_changed(list, todo);
+    if (id >= list->next_id) {
+        list->next_id = id + 1;
+    }
+    
+    notify_observers(list, TODO_CHANGE_CREATE, todo);
+    return 0;
+}
+
+/**
+ * @brief Replace the title and/or description of a todo
+ *
+ * Writes a fresh text block and accounts the old one as garbage; the
+ * caller decides when to compact. Lengths must already be validated.
+ *
+ * @param list Pointer to the todo list
+ * @param todo Todo to modify
+ * @param title New title (NULL to keep existing)
+ * @param title_length Length of the resulting title
+ * @param description New description (NULL to keep existing)
+ * @param desc_length Length of the resulting description
+ * @return 0 on success, -1 on allocation failure
+ */
+static int replace_text(TodoList* list, Todo* todo, const char* title, size_t title_length,
+                        const char* description, size_t desc_length) {
+    if (!title && !description) {
+        return 0;
+    }
+    
+    Todo updated = *todo;
+    const char* new_title = title ? title : todo_get_title(list, todo);
+    const char* new_description = description ? description : todo_get_description(list, todo);
+    if (strings_store(list, &updated, new_title, title_length, new_description, desc_length) != 0) {
+        return -1;
+    }
+    
+    list->strings_garbage += text_block_size(todo);
+    *todo = updated;
+    text_changed(list, todo);
+    return 0;
+}
+
+/**
+ * @brief Drop the list's read-only backing storage without copying it
+ *
+ * The todos and strings arrays are forgotten, so the caller must already
+ * have copied or discarded their contents.
+ *
+ * @param list Pointer to the todo list
+ */
+static void release_backing(TodoList* list) {
+    if (list->backing_release) {
+        list->backing_release(list->backing);
+    }
+    list->backing = NULL;
+    list->backing_release = NULL;
+    list->todos = NULL;
+    list->capacity = 0;
+    list->strings = NULL;
+    list->strings_capacity = 0;
+}
+
+/**
+ * @brief Initialize a new todo list
+ * @return Pointer to initialized TodoList, NULL on failure
+ */
+TodoList* todo_list_create(void) {
+    TodoList* list = (TodoList*)malloc(sizeof(TodoList));
+    if (!list) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for TodoList");
+        return NULL;
+    }
+    
+    list->todos = NULL;
+    list->count = 0;
+    list->used = 0;
+    list->capacity = 0;
+    list->next_id = 1;
+    list->id_index = NULL;
+    list->index_capacity = 0;
+    list->strings = NULL;
+    list->strings_size = 0;
+    list->strings_capacity = 0;
+    list->strings_garbage = 0;
+    list->delete_mode = TODO_DELETE_STABLE;
+    list->observer_count = 0;
+    list->backing = NULL;
+    list->backing_release = NULL;
+    list->bucket_bits = NULL;
+    list->bucket_summary = NULL;
+    memset(list->bucket_counts, 0, sizeof(list->bucket_counts));
+    for (int key = 0; key < TODO_SORT_COUNT; key++) {
+        list->views[key] = NULL;
+    }
+    list->search = NULL;
+    list->columns = NULL;
+    list->lock = NULL;
+    
+    return list;
+}
+
+/**
+ * @brief Free memory allocated for todo list
+ * @param list Pointer to the todo list to destroy
+ */
+void todo_list_destroy(TodoList* list) {
+    if (list) {
+        if (list->backing) {
+            release_backing(list);
+        } else {
+            free(list->todos);
+            free(list->strings);
+        }
+        free(list->id_index);
+        free(list->bucket_bits);
+        free(list->bucket_summary);
+        for (int key = 0; key < TODO_SORT_COUNT; key++) {
+            view_destroy(list->views[key]);
+        }
+        search_destroy(list->search);
+        columns_destroy(list->columns);
+        todo_rwlock_destroy(list->lock);
+        free(list);
+    }
+}
+
+/**
+ * @brief Choose how todo_delete closes the gap left by a deleted todo
+ * @param list Pointer to the todo list
+ * @param mode Deletion strategy
+ */
+void todo_list_set_delete_mode(TodoList* list, TodoDeleteMode mode) {
+    if (!list) {
+        return;
+    }
+    
+    // Swap mode relies on every used slot being live
+    if (mode == TODO_DELETE_SWAP) {
+        todo_list_compact(list);
+    }
+    list->delete_mode = mode;
+}
+
+/**
+ * @brief Remove tombstones so that slots 0..count-1 are all live todos
+ * @param list Pointer to the todo list
+ */
+void todo_list_compact(TodoList* list) {
+    if (!list || list->used == list->count || todo_list_make_writable(list) != TODO_OK) {
+        return;
+    }
+    
+    int dest = 0;
+    for (int i = 0; i < list->used; i++) {
+        if (list->todos[i].id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        if (dest != i) {
+            list->todos[dest] = list->todos[i];
+            list->id_index[list->todos[dest].id] = dest;
+        }
+        dest++;
+    }
+    
+    list->used = dest;
+}
+
+/**
+ * @brief Make a list safe to share between threads
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_enable_locking(TodoList* list) {
+    if (!list) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (!list->lock) {
+        list->lock = todo_rwlock_create();
+        if (!list->lock) {
+            todo_log(TODO_LOG_ERROR, "Failed to create list lock");
+            return TODO_ERR_NO_MEMORY;
+        }
+    }
+    return TODO_OK;
+}
+
+/**
+ * @brief Acquire the list's lock for reading (no-op unless locking is enabled)
+ * @param list Pointer to the todo list
+ */
+void todo_list_lock_shared(const TodoList* list) {
+    if (list && list->lock) {
+        todo_rwlock_read_lock(list->lock);
+    }
+}
+
+/**
+ * @brief Release the list's lock after reading
+ * @param list Pointer to the todo list
+ */
+void todo_list_unlock_shared(const TodoList* list) {
+    if (list && list->lock) {
+        todo_rwlock_read_unlock(list->lock);
+    }
+}
+
+/**
+ * @brief Acquire the list's lock for modification (no-op unless locking is enabled)
+ * @param list Pointer to the todo list
+ */
+void todo_list_lock_exclusive(TodoList* list) {
+    if (list && list->lock) {
+        todo_rwlock_write_lock(list->lock);
+    }
+}
+
+/**
+ * @brief Release the list's lock after modification
+ * @param list Pointer to the todo list
+ */
+void todo_list_unlock_exclusive(TodoList* list) {
+    if (list && list->lock) {
+        todo_rwlock_write_unlock(list->lock);
+    }
+}
+
+/**
+ * @brief Register a callback to be told about every change to the list
+ * @param list Pointer to the todo list
+ * @param fn Callback to invoke
+ * @param user_data Context passed to the callback
+ * @return TODO_OK on success, TODO_ERR_NO_MEMORY if all observer slots are taken
+ */
+int todo_list_add_observer(TodoList* list, TodoObserverFn fn, void* user_data) {
+    if (!list || !fn) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (list->observer_count >= TODO_MAX_OBSERVERS) {
+        todo_log(TODO_LOG_ERROR, "Too many observers on todo list");
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    list->observers[list->observer_count].fn = fn;
+    list->observers[list->observer_count].user_data = user_data;
+    list->observer_count++;
+    return TODO_OK;
+}
+
+/**
+ * @brief Unregister a callback added with todo_list_add_observer
+ * @param list Pointer to the todo list
+ * @param fn Callback to remove
+ * @param user_data Context it was registered with
+ */
+void todo_list_remove_observer(TodoList* list, TodoObserverFn fn, void* user_data) {
+    if (!list) {
+        return;
+    }
+    
+    for (int i = 0; i < list->observer_count; i++) {
+        if (list->observers[i].fn == fn && list->observers[i].user_data == user_data) {
+            // Keep registration order for the remaining observers
+            memmove(&list->observers[i], &list->observers[i + 1],
+                    sizeof(TodoObserver) * (list->observer_count - i - 1));
+            list->observer_count--;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Remove all todos from the list, keeping its allocations
+ * @param list Pointer to the todo list
+ */
+void todo_list_clear(TodoList* list) {
+    if (!list) {
+        return;
+    }
+    
+    for (int i = 0; i < list->used; i++) {
+        if (list->todos[i].id != TODO_TOMBSTONE_ID) {
+            list->id_index[list->todos[i].id] = -1;
+        }
+    }
+    secondary_reset(list);
+    
+    if (list->backing) {
+        release_backing(list);
+    }
+    
+    list->count = 0;
+    list->used = 0;
+    list->next_id = 1;
+    list->strings_size = 0;
+    list->strings_garbage = 0;
+    text_rebuild(list);
+}
+
+/**
+ * @brief Replace the contents of a list with prepared arrays
+ * @param list Pointer to the todo list
+ * @param todos Array of used todo slots
+ * @param used Number of slots in todos
+ * @param strings String arena referenced by the todos
+ * @param strings_size Size of the string arena in bytes
+ * @param next_id Next ID to hand out (raised past the largest ID if needed)
+ * @param backing Owner of read-only storage, or NULL for heap arrays
+ * @param release Called with backing when it is no longer needed (may be NULL)
+ * @return TODO_OK on success, negative TodoError on failure (the list is left empty)
+ */
+int todo_list_attach(TodoList* list, Todo* todos, int used, char* strings, size_t strings_size,
+                     int next_id, void* backing, void (*release)(void* backing)) {
+    if (!list || used < 0 || next_id < 1 || strings_size > UINT32_MAX) {
+        if (backing && release) {
+            release(backing);
+        } else if (!backing) {
+            free(todos);
+            free(strings);
+        }
+        return TODO_ERR_INVALID;
+    }
+    
+    todo_list_clear(list);
+    if (!list->backing) {
+        free(list->todos);
+        free(list->strings);
+    }
+    
+    list->todos = todos;
+    list->used = used;
+    list->capacity = backing ? 0 : used;
+    list->strings = strings;
+    list->strings_size = strings_size;
+    list->strings_capacity = backing ? 0 : strings_size;
+    list->strings_garbage = 0;
+    list->next_id = next_id;
+    list->backing = backing;
+    list->backing_release = backing ? release : NULL;
+    
+    int result = todo_list_rebuild_index(list);
+    if (result != TODO_OK) {
+        // The index may be partly filled in, so reset it wholesale
+        for (int i = 0; i < list->index_capacity; i++) {
+            list->id_index[i] = -1;
+        }
+        secondary_reset(list);
+        list->used = 0;
+        todo_list_clear(list);
+        return result;
+    }
+    
+    // Text blocks of tombstoned slots are unreferenced
+    size_t live = 0;
+    for (int i = 0; i < list->used; i++) {
+        if (list->todos[i].id != TODO_TOMBSTONE_ID) {
+            live += text_block_size(&list->todos[i]);
+        }
+    }
+    list->strings_garbage = live < strings_size ? strings_size - live : 0;
+    
+    return TODO_OK;
+}
+
+/**
+ * @brief Make an independent copy of a list's todos
+ * @param list Pointer to the todo list
+ * @return New list (free with todo_list_destroy), NULL on failure
+ */
+TodoList* todo_list_clone(const TodoList* list) {
+    if (!list) {
+        return NULL;
+    }
+    
+    TodoList* copy = todo_list_create();
+    Todo* todos = list->used > 0 ? (Todo*)malloc(sizeof(Todo) * list->used) : NULL;
+    char* strings = list->strings_size > 0 ? (char*)malloc(list->strings_size) : NULL;
+    if (!copy || (list->used > 0 && !todos) || (list->strings_size > 0 && !strings)) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for list copy");
+        todo_list_destroy(copy);
+        free(todos);
+        free(strings);
+        return NULL;
+    }
+    
+    if (list->used > 0) {
+        memcpy(todos, list->todos, sizeof(Todo) * list->used);
+    }
+    if (list->strings_size > 0) {
+        memcpy(strings, list->strings, list->strings_size);
+    }
+    if (todo_list_attach(copy, todos, list->used, strings, list->strings_size, list->next_id, NULL, NULL) != TODO_OK) {
+        todo_list_destroy(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+/**
+ * @brief Copy read-only backing storage into heap memory owned by the list
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_make_writable(TodoList* list) {
+    if (!list) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (!list->backing) {
+        return TODO_OK;
+    }
+    
+    Todo* todos = NULL;
+    char* strings = NULL;
+    if (list->used > 0) {
+        todos = (Todo*)malloc(sizeof(Todo) * list->used);
+    }
+    if (list->strings_size > 0) {
+        strings = (char*)malloc(list->strings_size);
+    }
+    if ((list->used > 0 && !todos) || (list->strings_size > 0 && !strings)) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed while copying mapped todos");
+        free(todos);
+        free(strings);
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    if (todos) {
+        memcpy(todos, list->todos, sizeof(Todo) * list->used);
+    }
+    if (strings) {
+        memcpy(strings, list->strings, list->strings_size);
+    }
+    
+    release_backing(list);
+    list->todos = todos;
+    list->capacity = list->used;
+    list->strings = strings;
+    list->strings_capacity = list->strings_size;
+    return TODO_OK;
+}
+
+/**
+ * @brief Ensure a todo list can hold at least min_capacity todos
+ * @param list Pointer to the todo list
+ * @param min_capacity Number of todos the list must be able to hold
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_reserve(TodoList* list, int min_capacity) {
+    if (!list || min_capacity < 0) {
+        return TODO_ERR_INVALID;
+    }
+    
+    // Mapped storage is read-only; copy it to the heap before the first write
+    if (todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    if (min_capacity <= list->capacity) {
+        return 0;
+    }
+    
+    // Grow geometrically so that repeated appends stay amortized O(1)
+    size_t new_capacity = list->capacity > 0 ? (size_t)list->capacity : INITIAL_TODO_CAPACITY;
+    while (new_capacity < (size_t)min_capacity) {
+        new_capacity *= 2;
+    }
+    if (new_capacity > INT_MAX) {
+        new_capacity = INT_MAX;
+    }
+    
+    Todo* new_todos = (Todo*)realloc(list->todos, sizeof(Todo) * new_capacity);
+    if (!new_todos) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for todos array");
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    list->todos = new_todos;
+    list->capacity = (int)new_capacity;
+    return 0;
+}
+
+/**
+ * @brief Compact the list and release unused capacity
+ * @param list Pointer to the todo list
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_shrink_to_fit(TodoList* list) {
+    if (!list) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    todo_list_compact(list);
+    
+    if (list->count == list->capacity) {
+        return 0;
+    }
+    
+    if (list->count == 0) {
+        free(list->todos);
+        list->todos = NULL;
+        list->capacity = 0;
+        return 0;
+    }
+    
+    Todo* new_todos = (Todo*)realloc(list->todos, sizeof(Todo) * list->count);
+    if (!new_todos) {
+        return TODO_ERR_NO_MEMORY; // Original block is still valid
+    }
+    
+    list->todos = new_todos;
+    list->capacity = list->count;
+    return 0;
+}
+
+/**
+ * @brief Validate and append a new todo
+ * @param list Pointer to the todo list
+ * @param title Title of the todo
+ * @param description Description of the todo
+ * @param priority Priority level
+ * @return ID of created todo, negative TodoError on failure
+ */
+static int create_todo(TodoList* list, const char* title, const char* description, Priority priority) {
+    if (!list || !title || priority < PRIORITY_LOW || priority > PRIORITY_HIGH) {
+        todo_log(TODO_LOG_ERROR, "Invalid parameters");
+        return TODO_ERR_INVALID;
+    }
+    
+    // Validate input lengths
+    size_t title_length = strlen(title);
+    if (title_length >= MAX_TITLE_LENGTH) {
+        todo_log(TODO_LOG_ERROR, "Title too long (max %d characters)", MAX_TITLE_LENGTH - 1);
+        return TODO_ERR_TOO_LONG;
+    }
+    
+    size_t desc_length = description ? strlen(description) : 0;
+    if (desc_length >= MAX_DESC_LENGTH) {
+        todo_log(TODO_LOG_ERROR, "Description too long (max %d characters)", MAX_DESC_LENGTH - 1);
+        return TODO_ERR_TOO_LONG;
+    }
+    
+    // Get current time
+    time_t now = time(NULL);
+    
+    // Create new todo
+    int id = list->next_id;
+    if (append_todo(list, id, title, title_length, description, desc_length,
+                    priority, STATUS_PENDING, now, now, 0) != 0) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    return id;
+}
+
+/**
+ * @brief Create a new todo item
+ * @param list Pointer to the todo list
+ * @param title Title of the todo
+ * @param description Description of the todo
+ * @param priority Priority level
+ * @return ID of created todo, negative TodoError on failure
+ */
+int todo_create(TodoList* list, const char* title, const char* description, Priority priority) {
+    TODO_METRICS_BEGIN(TODO_METRIC_CREATE, start);
+    int id = create_todo(list, title, description, priority);
+    TODO_METRICS_END(TODO_METRIC_CREATE, start);
+    return id;
+}
+
+/**
+ * @brief Render the heading of the todo table
+ * @param out Buffer to render into
+ */
+static void render_table_header(RenderBuffer* out) {
+    render_string(out, "\n=== TODO LIST ===\n");
+    render_string(out, "ID   | Title                | Priority   | Status   | Created             | Updated            \n");
+    render_string(out, "-----|----------------------|------------|----------|---------------------|---------------------\n");
+}
+
+/**
+ * @brief Render one row of the todo table
+ * @param out Buffer to render into
+ * @param list List owning the todo
+ * @param todo Todo to render
+ */
+static void render_table_row(RenderBuffer* out, const TodoList* list, const Todo* todo) {
+    render_int(out, todo->id, 4);
+    render_string(out, " | ");
+    render_padded(out, todo_get_title(list, todo), 20, 20);
+    render_string(out, " | ");
+    render_padded(out, get_priority_string(todo->priority), 10, 0);
+    render_string(out, " | ");
+    render_padded(out, get_status_string(todo->status), 8, 0);
+    render_string(out, " | ");
+    render_datetime(out, todo->created_at, 0);
+    render_string(out, "    | ");
+    render_datetime(out, todo->updated_at, 0);
+    render_string(out, "   \n");
+}
+
+/**
+ * @brief Render the closing total of the todo table
+ * @param out Buffer to render into
+ * @param total Number of todos shown
+ */
+static void render_table_footer(RenderBuffer* out, int total) {
+    render_string(out, "\nTotal todos: ");
+    render_int(out, total, 0);
+    render_string(out, "\n");
+}
+
+/**
+ * @brief Read/display all todos
+ * @param list Pointer to the todo list
+ */
+void todo_read_all(const TodoList* list) {
+    if (!list) {
+        return;
+    }
+    
+    if (list->count == 0) {
+        printf("No todos found.\n");
+        return;
+    }
+    
+    // Format the whole table into one buffer and write it in large chunks
+    TODO_METRICS_BEGIN(TODO_METRIC_RENDER, start);
+    char storage[RENDER_BUFFER_SIZE];
+    RenderBuffer out;
+    render_init(&out, stdout, storage, sizeof(storage));
+    
+    render_table_header(&out);
+    for (int i = 0; i < list->used; i++) {
+        const Todo* todo = &list->todos[i];
+        if (todo->id != TODO_TOMBSTONE_ID) {
+            render_table_row(&out, list, todo);
+        }
+    }
+    render_table_footer(&out, list->count);
+    render_flush(&out);
+    TODO_METRICS_END(TODO_METRIC_RENDER, start);
+}
+
+/**
+ * @brief todo_query callback rendering each match as a table row
+ * @param list List being queried
+ * @param todo Matching todo
+ * @param user_data RenderBuffer to render into
+ * @return 0 to continue the query
+ */
+static int render_match(const TodoList* list, const Todo* todo, void* user_data) {
+    render_table_row((RenderBuffer*)user_data, list, todo);
+    return 0;
+}
+
+/**
+ * @brief Display the todos matching a status and priority filter
+ * @param list Pointer to the todo list
+ * @param status_mask TODO_STATUS_BIT values to include (TODO_STATUS_ANY for all)
+ * @param priority_mask TODO_PRIORITY_BIT values to include (TODO_PRIORITY_ANY for all)
+ */
+void todo_read_matching(const TodoList* list, unsigned status_mask, unsigned priority_mask) {
+    int total = todo_query_count(list, status_mask, priority_mask);
+    if (total <= 0) {
+        printf("No todos found.\n");
+        return;
+    }
+    
+    char storage[RENDER_BUFFER_SIZE];
+    RenderBuffer out;
+    render_init(&out, stdout, storage, sizeof(storage));
+    
+    render_table_header(&out);
+    todo_query(list, status_mask, priority_mask, render_match, &out);
+    render_table_footer(&out, total);
+    render_flush(&out);
+}
+
+/**
+ * @brief Collect the buckets selected by a pair of query masks
+ * @param list Pointer to the todo list
+ * @param status_mask TODO_STATUS_BIT values to include
+ * @param priority_mask TODO_PRIORITY_BIT values to include
+ * @param buckets Receives the indexes of the non-empty selected buckets
+ * @return Number of buckets written
+ */
+static int select_buckets(const TodoList* list, unsigned status_mask, unsigned priority_mask,
+                          int buckets[TODO_BUCKET_COUNT]) {
+    int selected = 0;
+    for (int status = STATUS_PENDING; status <= STATUS_COMPLETED; status++) {
+        for (int priority = PRIORITY_LOW; priority <= PRIORITY_HIGH; priority++) {
+            int bucket = TODO_BUCKET(status, priority);
+            if ((status_mask & TODO_STATUS_BIT(status)) && (priority_mask & TODO_PRIORITY_BIT(priority)) &&
+                list->bucket_counts[bucket] > 0) {
+                buckets[selected++] = bucket;
+            }
+        }
+    }
+    return selected;
+}
+
+/**
+ * @brief Visit the todos of the buckets selected by a filter
+ * @param list Pointer to the todo list
+ * @param status_mask TODO_STATUS_BIT values to include
+ * @param priority_mask TODO_PRIORITY_BIT values to include
+ * @param fn Callback invoked for each match
+ * @param user_data Context passed to fn
+ * @return Number of todos visited
+ */
+static int query_buckets(const TodoList* list, unsigned status_mask, unsigned priority_mask,
+                         TodoVisitFn fn, void* user_data) {
+    int buckets[TODO_BUCKET_COUNT];
+    int selected = select_buckets(list, status_mask, priority_mask, buckets);
+    if (selected == 0) {
+        return 0;
+    }
+    
+    size_t words = bucket_words(list->index_capacity);
+    size_t summaries = summary_words(list->index_capacity);
+    int visited = 0;
+    for (size_t s = 0; s < summaries; s++) {
+        // Buckets are disjoint, so OR-ing them yields each match once, in ID order
+        uint64_t summary = 0;
+        for (int b = 0; b < selected; b++) {
+            summary |= list->bucket_summary[buckets[b] * summaries + s];
+        }
+        
+        while (summary) {
+            size_t word_index = s * 64 + (size_t)lowest_bit(summary);
+            summary &= summary - 1;
+            
+            uint64_t word = 0;
+            for (int b = 0; b < selected; b++) {
+                word |= list->bucket_bits[buckets[b] * words + word_index];
+            }
+            
+            while (word) {
+                int id = (int)(word_index * 64 + (size_t)lowest_bit(word));
+                word &= word - 1;
+                visited++;
+                if (fn(list, &list->todos[list->id_index[id]], user_data) != 0) {
+                    return visited;
+                }
+            }
+        }
+    }
+    
+    return visited;
+}
+
+/**
+ * @brief Visit the todos matching a status and priority filter
+ * @param list Pointer to the todo list
+ * @param status_mask TODO_STATUS_BIT values to include (TODO_STATUS_ANY for all)
+ * @param priority_mask TODO_PRIORITY_BIT values to include (TODO_PRIORITY_ANY for all)
+ * @param fn Callback invoked for each match
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, negative TodoError on invalid arguments
+ */
+int todo_query(const TodoList* list, unsigned status_mask, unsigned priority_mask,
+               TodoVisitFn fn, void* user_data) {
+    if (!list || !fn) {
+        return TODO_ERR_INVALID;
+    }
+    
+    TODO_METRICS_BEGIN(TODO_METRIC_QUERY, start);
+    int visited = query_buckets(list, status_mask, priority_mask, fn, user_data);
+    TODO_METRICS_END(TODO_METRIC_QUERY, start);
+    return visited;
+}
+
+/**
+ * @brief Count the todos matching a status and priority filter in constant time
+ * @param list Pointer to the todo list
+ * @param status_mask TODO_STATUS_BIT values to include
+ * @param priority_mask TODO_PRIORITY_BIT values to include
+ * @return Number of matching todos, negative TodoError on invalid arguments
+ */
+int todo_query_count(const TodoList* list, unsigned status_mask, unsigned priority_mask) {
+    if (!list) {
+        return TODO_ERR_INVALID;
+    }
+    
+    int buckets[TODO_BUCKET_COUNT];
+    int selected = select_buckets(list, status_mask, priority_mask, buckets);
+    int total = 0;
+    for (int b = 0; b < selected; b++) {
+        total += list->bucket_counts[buckets[b]];
+    }
+    return total;
+}
+
+/**
+ * @brief Read/display a specific todo by ID
+ * @param list Pointer to the todo list
+ * @param id ID of the todo to display
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+int todo_read_by_id(const TodoList* list, int id) {
+    const Todo* todo = todo_find_by_id(list, id);
+    if (!todo) {
+        return TODO_ERR_NOT_FOUND;
+    }
+    
+    char created_str[20], updated_str[20];
+    time_t created_at = (time_t)todo->created_at;
+    time_t updated_at = (time_t)todo->updated_at;
+    strftime(created_str, sizeof(created_str), "%Y-%m-%d %H:%M:%S", localtime(&created_at));
+    strftime(updated_str, sizeof(updated_str), "%Y-%m-%d %H:%M:%S", localtime(&updated_at));
+    
+    printf("\n=== TODO DETAILS ===\n");
+    printf("ID: %d\n", todo->id);
+    printf("Title: %s\n", todo_get_title(list, todo));
+    printf("Description: %s\n", todo->desc_length > 0 ? todo_get_description(list, todo) : "(No description)");
+    printf("Priority: %s\n", get_priority_string(todo->priority));
+    printf("Status: %s\n", get_status_string(todo->status));
+    printf("Created: %s\n", created_str);
+    printf("Updated: %s\n", updated_str);
+    if (todo->due_at != 0) {
+        char due_str[20];
+        time_t due_at = (time_t)todo->due_at;
+        strftime(due_str, sizeof(due_str), "%Y-%m-%d %H:%M:%S", localtime(&due_at));
+        printf("Due: %s%s\n", due_str, todo->status == STATUS_PENDING && due_at <= time(NULL) ? " (overdue)" : "");
+    }
+    printf("===================\n");
+    
+    return TODO_OK;
+}
+
+/**
+ * @brief Validate and apply an update to a todo
+ * @param list Pointer to the todo list
+ * @param id ID of the todo to update
+ * @param title New title (NULL to keep existing)
+ * @param description New description (NULL to keep existing)
+ * @param priority New priority (-1 to keep existing)
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+static int update_todo(TodoList* list, int id, const char* title, const char* description, int priority) {
+    if (list && todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    Todo* todo = todo_find_by_id(list, id);
+    if (!todo) {
+        return TODO_ERR_NOT_FOUND;
+    }
+    
+    // Validate input lengths before changing anything
+    size_t title_length = title ? strlen(title) : todo->title_length;
+    if (title_length >= MAX_TITLE_LENGTH) {
+        todo_log(TODO_LOG_ERROR, "Title too long (max %d characters)", MAX_TITLE_LENGTH - 1);
+        return TODO_ERR_TOO_LONG;
+    }
+    
+    size_t desc_length = description ? strlen(description) : todo->desc_length;
+    if (desc_length >= MAX_DESC_LENGTH) {
+        todo_log(TODO_LOG_ERROR, "Description too long (max %d characters)", MAX_DESC_LENGTH - 1);
+        return TODO_ERR_TOO_LONG;
+    }
+    
+    notify_observers(list, TODO_CHANGE_PREPARE, todo);
+    
+    // Update title and/or description by writing a fresh text block
+    if (replace_text(list, todo, title, title_length, description, desc_length) != 0) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    secondary_erase(list, todo);
+    
+    // Update priority if provided (valid range)
+    if (priority >= PRIORITY_LOW && priority <= PRIORITY_HIGH) {
+        todo->priority = (uint8_t)priority;
+    }
+    
+    // Update timestamp
+    todo->updated_at = time(NULL);
+    secondary_insert(list, todo);
+    
+    notify_observers(list, TODO_CHANGE_UPDATE, todo);
+    strings_maybe_compact(list);
+    
+    return TODO_OK;
+}
+
+/**
+ * @brief Update a todo item
+ * @param list Pointer to the todo list
+ * @param id ID of the todo to update
+ * @param title New title (NULL to keep existing)
+ * @param description New description (NULL to keep existing)
+ * @param priority New priority (-1 to keep existing)
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+int todo_update(TodoList* list, int id, const char* title, const char* description, int priority) {
+    TODO_METRICS_BEGIN(TODO_METRIC_UPDATE, start);
+    int result = update_todo(list, id, title, description, priority);
+    TODO_METRICS_END(TODO_METRIC_UPDATE, start);
+    return result;
+}
+
+/**
+ * @brief Remove a todo from the list and its indexes
+ * @param list Pointer to the todo list
+ * @param id ID of the todo to delete
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+static int delete_todo(TodoList* list, int id) {
+    if (!list) {
+        return TODO_ERR_INVALID;
+    }
+    
+    // Find the todo index
+    int index = index_lookup(list, id);
+    if (index == -1) {
+        return TODO_ERR_NOT_FOUND;
+    }
+    
+    if (todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    notify_observers(list, TODO_CHANGE_DELETE, &list->todos[index]);
+    
+    secondary_erase(list, &list->todos[index]);
+    list->strings_garbage += text_block_size(&list->todos[index]);
+    list->id_index[id] = -1;
+    list->count--;
+    if (list->search) {
+        search_forget_todo(list->search, id);
+    }
+    
+    if (list->delete_mode == TODO_DELETE_SWAP) {
+        // Fill the gap with the last todo
+        int last = list->used - 1;
+        if (index != last) {
+            list->todos[index] = list->todos[last];
+            list->id_index[list->todos[index].id] = index;
+        }
+        list->used--;
+    } else {
+        // Leave a tombstone and compact once they dominate the array
+        list->todos[index].id = TODO_TOMBSTONE_ID;
+        while (list->used > 0 && list->todos[list->used - 1].id == TODO_TOMBSTONE_ID) {
+            list->used--;
+        }
+        if ((list->used - list->count) * 2 > list->used) {
+            todo_list_compact(list);
+        }
+    }
+    
+    strings_maybe_compact(list);
+    return TODO_OK;
+}
+
+/**
+ * @brief Delete a todo item
+ * @param list Pointer to the todo list
+ * @param id ID of the todo to delete
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+int todo_delete(TodoList* list, int id) {
+    TODO_METRICS_BEGIN(TODO_METRIC_DELETE, start);
+    int result = delete_todo(list, id);
+    TODO_METRICS_END(TODO_METRIC_DELETE, start);
+    return result;
+}
+
+/**
+ * @brief Change the status of a todo
+ * @param list Pointer to the todo list
+ * @param id ID of the todo
+ * @param status New status
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+static int set_status(TodoList* list, int id, Status status) {
+    if (list && todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    Todo* todo = todo_find_by_id(list, id);
+    if (!todo) {
+        return TODO_ERR_NOT_FOUND;
+    }
+    
+    if (todo->status == status) {
+        return TODO_OK;
+    }
+    
+    notify_observers(list, TODO_CHANGE_PREPARE, todo);
+    secondary_erase(list, todo);
+    todo->status = (uint8_t)status;
+    todo->updated_at = time(NULL);
+    secondary_insert(list, todo);
+    
+    notify_observers(list, TODO_CHANGE_UPDATE, todo);
+    return TODO_OK;
+}
+
+/**
+ * @brief Mark a todo as completed
+ * @param list Pointer to the todo list
+ * @param id ID of the todo to complete
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+int todo_complete(TodoList* list, int id) {
+    TODO_METRICS_BEGIN(TODO_METRIC_UPDATE, start);
+    int result = set_status(list, id, STATUS_COMPLETED);
+    TODO_METRICS_END(TODO_METRIC_UPDATE, start);
+    return result;
+}
 
 /**
- * @brief Initialize a new todo list
- * @return Pointer to initialized TodoList, NULL on failure
+ * @brief Mark a todo as pending
+ * @param list Pointer to the todo list
+ * @param id ID of the todo to mark pending
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
  */
-TodoList* todo_list_create(void) {
-    TodoList* list = (TodoList*)malloc(sizeof(TodoList));
-    if (!list) {
-        fprintf(stderr, "Error: Memory allocation failed for TodoList\n");
-        return NULL;
+int todo_mark_pending(TodoList* list, int id) {
+    TODO_METRICS_BEGIN(TODO_METRIC_UPDATE, start);
+    int result = set_status(list, id, STATUS_PENDING);
+    TODO_METRICS_END(TODO_METRIC_UPDATE, start);
+    return result;
+}
+
+/**
+ * @brief Change the due date of a todo
+ * @param list Pointer to the todo list
+ * @param id ID of the todo
+ * @param due_at Due timestamp (0 to clear it)
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
+ */
+static int set_due_date(TodoList* list, int id, time_t due_at) {
+    if (due_at < 0) {
+        return TODO_ERR_INVALID;
+    }
+    if (list && todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
     }
     
-    list->todos = (Todo*)malloc(sizeof(Todo) * MAX_TODOS);
-    if (!list->todos) {
-        fprintf(stderr, "Error: Memory allocation failed for todos array\n");
-        free(list);
-        return NULL;
+    Todo* todo = todo_find_by_id(list, id);
+    if (!todo) {
+        return TODO_ERR_NOT_FOUND;
     }
     
-    list->count = 0;
-    list->capacity = MAX_TODOS;
-    list->next_id = 1;
+    if (todo->due_at == (int64_t)due_at) {
+        return TODO_OK;
+    }
     
-    return list;
+    notify_observers(list, TODO_CHANGE_PREPARE, todo);
+    secondary_erase(list, todo);
+    todo->due_at = (int64_t)due_at;
+    todo->updated_at = time(NULL);
+    secondary_insert(list, todo);
+    
+    notify_observers(list, TODO_CHANGE_UPDATE, todo);
+    return TODO_OK;
 }
 
 /**
- * @brief Free memory allocated for todo list
- * @param list Pointer to the todo list to destroy
+ * @brief Set or clear the due date of a todo
+ * @param list Pointer to the todo list
+ * @param id ID of the todo
+ * @param due_at Due timestamp (0 to clear it)
+ * @return TODO_OK on success, TODO_ERR_NOT_FOUND or another negative TodoError
  */
-void todo_list_destroy(TodoList* list) {
-    if (list) {
-        if (list->todos) {
-            free(list->todos);
-        }
-        free(list);
-    }
+int todo_set_due(TodoList* list, int id, time_t due_at) {
+    TODO_METRICS_BEGIN(TODO_METRIC_UPDATE, start);
+    int result = set_due_date(list, id, due_at);
+    TODO_METRICS_END(TODO_METRIC_UPDATE, start);
+    return result;
 }
 
 /**
- * @brief Create a new todo item
+ * @brief Create many todo items in one pass
  * @param list Pointer to the todo list
- * @param title Title of the todo
- * @param description Description of the todo
- * @param priority Priority level
- * @return ID of created todo, -1 on failure
+ * @param specs Array of todos to create
+ * @param n Number of entries in specs
+ * @param out_ids Receives the new ID, or a negative TodoError if that spec was rejected (may be NULL)
+ * @return Number of todos created, negative TodoError on invalid arguments or allocation failure
  */
-int todo_create(TodoList* list, const char* title, const char* description, Priority priority) {
-    if (!list || !title || list->count >= list->capacity) {
-        fprintf(stderr, "Error: Invalid parameters or list is full\n");
-        return -1;
+int todo_create_many(TodoList* list, const TodoSpec* specs, int n, int* out_ids) {
+    if (!list || n < 0 || (n > 0 && !specs)) {
+        return TODO_ERR_INVALID;
     }
     
-    // Validate input lengths
-    if (strlen(title) >= MAX_TITLE_LENGTH) {
-        fprintf(stderr, "Error: Title too long (max %d characters)\n", MAX_TITLE_LENGTH - 1);
-        return -1;
+    if (n == 0) {
+        return 0;
     }
     
-    if (description && strlen(description) >= MAX_DESC_LENGTH) {
-        fprintf(stderr, "Error: Description too long (max %d characters)\n", MAX_DESC_LENGTH - 1);
-        return -1;
+    // Validation pass: remember each accepted length pair (0 marks a reject)
+    uint32_t* lengths = (uint32_t*)malloc(sizeof(uint32_t) * n);
+    if (!lengths) {
+        return TODO_ERR_NO_MEMORY;
     }
     
-    // Get current time
-    time_t now = time(NULL);
-    
-    // Create new todo
-    Todo* new_todo = &list->todos[list->count];
-    new_todo->id = list->next_id++;
-    strncpy(new_todo->title, title, MAX_TITLE_LENGTH - 1);
-    new_todo->title[MAX_TITLE_LENGTH - 1] = '\0';
-    
-    if (description) {
-        strncpy(new_todo->description, description, MAX_DESC_LENGTH - 1);
-        new_todo->description[MAX_DESC_LENGTH - 1] = '\0';
-    } else {
-        new_todo->description[0] = '\0';
+    int valid = 0;
+    size_t text_bytes = 0;
+    for (int i = 0; i < n; i++) {
+        const TodoSpec* spec = &specs[i];
+        lengths[i] = 0;
+        if (!spec->title || spec->priority < PRIORITY_LOW || spec->priority > PRIORITY_HIGH) {
+            continue;
+        }
+        
+        size_t title_length = strlen(spec->title);
+        size_t desc_length = spec->description ? strlen(spec->description) : 0;
+        if (title_length >= MAX_TITLE_LENGTH || desc_length >= MAX_DESC_LENGTH) {
+            continue;
+        }
+        
+        // Store length + 1 so an empty title is distinguishable from a reject
+        lengths[i] = (uint32_t)(title_length + 1) | ((uint32_t)desc_length << 16);
+        text_bytes += title_length + 1 + desc_length + 1;
+        valid++;
     }
     
-    new_todo->priority = priority;
-    new_todo->status = STATUS_PENDING;
-    new_todo->created_at = now;
-    new_todo->updated_at = now;
+    // Reserve everything the batch needs up front
+    if ((long long)list->used + valid > INT_MAX ||
+        todo_list_reserve(list, list->used + valid) != 0 ||
+        index_reserve(list, list->next_id + valid) != 0 ||
+        strings_reserve(list, text_bytes) != 0) {
+        free(lengths);
+        return TODO_ERR_NO_MEMORY;
+    }
     
-    list->count++;
+    time_t now = time(NULL);
+    int created = 0;
+    for (int i = 0; i < n; i++) {
+        int id = TODO_ERR_INVALID;
+        if (lengths[i] != 0) {
+            size_t title_length = (lengths[i] & 0xFFFF) - 1;
+            size_t desc_length = lengths[i] >> 16;
+            id = list->next_id;
+            append_todo(list, id, specs[i].title, title_length, specs[i].description,
+                        desc_length, specs[i].priority, STATUS_PENDING, now, now, 0);
+            created++;
+        }
+        if (out_ids) {
+            out_ids[i] = id;
+        }
+    }
     
-    printf("Todo created successfully with ID: %d\n", new_todo->id);
-    return new_todo->id;
+    free(lengths);
+    return created;
 }
 
 /**
- * @brief Read/display all todos
+ * @brief Update many todo items in one pass
  * @param list Pointer to the todo list
+ * @param updates Array of updates to apply
+ * @param n Number of entries in updates
+ * @param out_results Receives TODO_OK or a negative TodoError per update (may be NULL)
+ * @return Number of todos updated, negative TodoError on invalid arguments or allocation failure
  */
-void todo_read_all(const TodoList* list) {
-    if (!list) {
-        fprintf(stderr, "Error: Invalid todo list\n");
-        return;
+int todo_update_many(TodoList* list, const TodoUpdate* updates, int n, int* out_results) {
+    if (!list || n < 0 || (n > 0 && !updates)) {
+        return TODO_ERR_INVALID;
     }
     
-    if (list->count == 0) {
-        printf("No todos found.\n");
-        return;
+    if (todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    // Size the new text up front so the arena grows at most once
+    size_t text_bytes = 0;
+    for (int i = 0; i < n; i++) {
+        const TodoUpdate* update = &updates[i];
+        const Todo* todo = todo_find_by_id(list, update->id);
+        if (todo && (update->title || update->description)) {
+            text_bytes += (update->title ? strlen(update->title) : todo->title_length) + 1;
+            text_bytes += (update->description ? strlen(update->description) : todo->desc_length) + 1;
+        }
     }
     
-    printf("\n=== TODO LIST ===\n");
-    printf("%-4s | %-20s | %-10s | %-8s | %-19s | %-19s\n", 
-           "ID", "Title", "Priority", "Status", "Created", "Updated");
-    printf("-----|----------------------|------------|----------|---------------------|---------------------\n");
+    if (strings_reserve(list, text_bytes) != 0) {
+        return TODO_ERR_NO_MEMORY;
+    }
     
-    for (int i = 0; i < list->count; i++) {
-        const Todo* todo = &list->todos[i];
-        char created_str[20], updated_str[20];
+    time_t now = time(NULL);
+    int updated = 0;
+    for (int i = 0; i < n; i++) {
+        const TodoUpdate* update = &updates[i];
+        Todo* todo = todo_find_by_id(list, update->id);
+        int result = TODO_ERR_NOT_FOUND;
         
-        // Format timestamps
-        strftime(created_str, sizeof(created_str), "%Y-%m-%d %H:%M", localtime(&todo->created_at));
-        strftime(updated_str, sizeof(updated_str), "%Y-%m-%d %H:%M", localtime(&todo->updated_at));
+        if (todo) {
+            result = TODO_ERR_TOO_LONG;
+            size_t title_length = update->title ? strlen(update->title) : todo->title_length;
+            size_t desc_length = update->description ? strlen(update->description) : todo->desc_length;
+            int fits = title_length < MAX_TITLE_LENGTH && desc_length < MAX_DESC_LENGTH;
+            if (fits) {
+                notify_observers(list, TODO_CHANGE_PREPARE, todo);
+            }
+            if (fits && replace_text(list, todo, update->title, title_length,
+                                     update->description, desc_length) == 0) {
+                secondary_erase(list, todo);
+                if (update->priority >= PRIORITY_LOW && update->priority <= PRIORITY_HIGH) {
+                    todo->priority = (uint8_t)update->priority;
+                }
+                todo->updated_at = now;
+                secondary_insert(list, todo);
+                notify_observers(list, TODO_CHANGE_UPDATE, todo);
+                result = TODO_OK;
+                updated++;
+            }
+        }
         
-        printf("%-4d | %-20.20s | %-10s | %-8s | %-19s | %-19s\n",
-               todo->id,
-               todo->title,
-               get_priority_string(todo->priority),
-               get_status_string(todo->status),
-               created_str,
-               updated_str);
+        if (out_results) {
+            out_results[i] = result;
+        }
     }
-    printf("\nTotal todos: %d\n", list->count);
+    
+    strings_maybe_compact(list);
+    return updated;
 }
 
 /**
- * @brief Read/display a specific todo by ID
+ * @brief Mark many todos as completed in one pass
  * @param list Pointer to the todo list
- * @param id ID of the todo to display
- * @return 0 on success, -1 if not found
+ * @param ids Array of IDs to complete
+ * @param n Number of entries in ids
+ * @param out_results Receives TODO_OK or TODO_ERR_NOT_FOUND per ID (may be NULL)
+ * @return Number of IDs found, TODO_ERR_INVALID on invalid arguments
  */
-int todo_read_by_id(const TodoList* list, int id) {
-    const Todo* todo = todo_find_by_id(list, id);
-    if (!todo) {
-        printf("Todo with ID %d not found.\n", id);
-        return -1;
+int todo_complete_many(TodoList* list, const int* ids, int n, int* out_results) {
+    if (!list || n < 0 || (n > 0 && !ids)) {
+        return TODO_ERR_INVALID;
     }
     
-    char created_str[20], updated_str[20];
-    strftime(created_str, sizeof(created_str), "%Y-%m-%d %H:%M:%S", localtime(&todo->created_at));
-    strftime(updated_str, sizeof(updated_str), "%Y-%m-%d %H:%M:%S", localtime(&todo->updated_at));
+    if (todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
+    }
     
-    printf("\n=== TODO DETAILS ===\n");
-    printf("ID: %d\n", todo->id);
-    printf("Title: %s\n", todo->title);
-    printf("Description: %s\n", todo->description[0] ? todo->description : "(No description)");
-    printf("Priority: %s\n", get_priority_string(todo->priority));
-    printf("Status: %s\n", get_status_string(todo->status));
-    printf("Created: %s\n", created_str);
-    printf("Updated: %s\n", updated_str);
-    printf("===================\n");
+    time_t now = time(NULL);
+    int found = 0;
+    for (int i = 0; i < n; i++) {
+        Todo* todo = todo_find_by_id(list, ids[i]);
+        if (todo) {
+            if (todo->status != STATUS_COMPLETED) {
+                notify_observers(list, TODO_CHANGE_PREPARE, todo);
+                secondary_erase(list, todo);
+                todo->status = STATUS_COMPLETED;
+                todo->updated_at = now;
+                secondary_insert(list, todo);
+                notify_observers(list, TODO_CHANGE_UPDATE, todo);
+            }
+            found++;
+        }
+        if (out_results) {
+            out_results[i] = todo ? TODO_OK : TODO_ERR_NOT_FOUND;
+        }
+    }
     
-    return 0;
+    return found;
 }
 
 /**
- * @brief Update a todo item
+ * @brief Find a todo by ID
  * @param list Pointer to the todo list
- * @param id ID of the todo to update
- * @param title New title (NULL to keep existing)
- * @param description New description (NULL to keep existing)
- * @param priority New priority (-1 to keep existing)
- * @return 0 on success, -1 if not found
+ * @param id ID to search for
+ * @return Pointer to todo if found, NULL otherwise
  */
-int todo_update(TodoList* list, int id, const char* title, const char* description, int priority) {
-    Todo* todo = todo_find_by_id(list, id);
-    if (!todo) {
-        printf("Todo with ID %d not found.\n", id);
-        return -1;
+Todo* todo_find_by_id(const TodoList* list, int id) {
+    if (!list) {
+        return NULL;
     }
     
-    // Update title if provided
-    if (title) {
-        if (strlen(title) >= MAX_TITLE_LENGTH) {
-            fprintf(stderr, "Error: Title too long (max %d characters)\n", MAX_TITLE_LENGTH - 1);
-            return -1;
-        }
-        strncpy(todo->title, title, MAX_TITLE_LENGTH - 1);
-        todo->title[MAX_TITLE_LENGTH - 1] = '\0';
+    int index = index_lookup(list, id);
+    return index == -1 ? NULL : &list->todos[index];
+}
+
+/**
+ * @brief Append a todo with explicit field values (used when loading)
+ * @param list Pointer to the todo list
+ * @param id ID of the todo (must not already be in use)
+ * @param title Title of the todo
+ * @param description Description of the todo (NULL for none)
+ * @param priority Priority level
+ * @param status Completion status
+ * @param created_at Creation timestamp
+ * @param updated_at Last update timestamp
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_restore(TodoList* list, int id, const char* title, const char* description,
+                 Priority priority, Status status, time_t created_at, time_t updated_at) {
+    return todo_restore_ex(list, id, title, description, priority, status, created_at, updated_at, 0);
+}
+
+/**
+ * @brief Restore a todo with explicit field values, including its due date
+ * @param list Pointer to the todo list
+ * @param id ID of the todo
+ * @param title Title of the todo
+ * @param description Description of the todo (NULL for none)
+ * @param priority Priority level
+ * @param status Completion status
+ * @param created_at Creation timestamp
+ * @param updated_at Last update timestamp
+ * @param due_at Due timestamp (0 for none)
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_restore_ex(TodoList* list, int id, const char* title, const char* description,
+                    Priority priority, Status status, time_t created_at, time_t updated_at,
+                    time_t due_at) {
+    if (!list || !title || id <= 0 || priority < PRIORITY_LOW || priority > PRIORITY_HIGH ||
+        status < STATUS_PENDING || status > STATUS_COMPLETED || due_at < 0) {
+        return TODO_ERR_INVALID;
+    }
+    
+    size_t title_length = strlen(title);
+    size_t desc_length = description ? strlen(description) : 0;
+    if (title_length >= MAX_TITLE_LENGTH || desc_length >= MAX_DESC_LENGTH) {
+        todo_log(TODO_LOG_ERROR, "Todo %d has oversized text", id);
+        return TODO_ERR_CORRUPT;
+    }
+    
+    if (todo_list_make_writable(list) != TODO_OK) {
+        return TODO_ERR_NO_MEMORY;
     }
     
-    // Update description if provided
-    if (description) {
-        if (strlen(description) >= MAX_DESC_LENGTH) {
-            fprintf(stderr, "Error: Description too long (max %d characters)\n", MAX_DESC_LENGTH - 1);
-            return -1;
+    int index = index_lookup(list, id);
+    if (index == -1) {
+        if (append_todo(list, id, title, title_length, description, desc_length,
+                        priority, status, created_at, updated_at, due_at) != 0) {
+            return TODO_ERR_NO_MEMORY;
         }
-        strncpy(todo->description, description, MAX_DESC_LENGTH - 1);
-        todo->description[MAX_DESC_LENGTH - 1] = '\0';
+        return TODO_OK;
     }
     
-    // Update priority if provided (valid range)
-    if (priority >= PRIORITY_LOW && priority <= PRIORITY_HIGH) {
-        todo->priority = (Priority)priority;
+    // Overwrite the existing todo in place
+    Todo* todo = &list->todos[index];
+    notify_observers(list, TODO_CHANGE_PREPARE, todo);
+    if (replace_text(list, todo, title, title_length, description ? description : "", desc_length) != 0) {
+        return TODO_ERR_NO_MEMORY;
     }
     
-    // Update timestamp
-    todo->updated_at = time(NULL);
+    secondary_erase(list, todo);
+    todo->priority = (uint8_t)priority;
+    todo->status = (uint8_t)status;
+    todo->created_at = (int64_t)created_at;
+    todo->updated_at = (int64_t)updated_at;
+    todo->due_at = (int64_t)due_at;
+    secondary_insert(list, todo);
     
-    printf("Todo with ID %d updated successfully.\n", id);
-    return 0;
+    notify_observers(list, TODO_CHANGE_UPDATE, todo);
+    strings_maybe_compact(list);
+    return TODO_OK;
 }
 
 /**
- * @brief Delete a todo item
- * @param list Pointer to the todo list
- * @param id ID of the todo to delete
- * @return 0 on success, -1 if not found
+ * @brief Get the title of a todo
+ * @param list Pointer to the todo list owning the todo
+ * @param todo Pointer to the todo
+ * @return NUL-terminated title
  */
-int todo_delete(TodoList* list, int id) {
-    if (!list) {
-        return -1;
-    }
-    
-    // Find the todo index
-    int index = -1;
-    for (int i = 0; i < list->count; i++) {
-        if (list->todos[i].id == id) {
-            index = i;
-            break;
+const char* todo_get_title(const TodoList* list, const Todo* todo) {
+    return list->strings + todo->text_offset;
+}
+
+/**
+ * @brief Get the description of a todo
+ * @param list Pointer to the todo list owning the todo
+ * @param todo Pointer to the todo
+ * @return NUL-terminated description ("" if none)
+ */
+const char* todo_get_description(const TodoList* list, const Todo* todo) {
+    return list->strings + todo->text_offset + todo->title_length + 1;
+}
+
+/**
+ * @brief Validate one chunk and find its largest ID
+ * @param arg The IndexBuild
+ * @param task Chunk number
+ */
+static void index_check_chunk(void* arg, int task) {
+    IndexBuild* build = (IndexBuild*)arg;
+    IndexChunk* chunk = &build->chunks[task];
+    const Todo* todos = build->list->todos;
+    for (int i = chunk->start; i < chunk->end; i++) {
+        const Todo* todo = &todos[i];
+        if (todo->id < 0 || (todo->id != TODO_TOMBSTONE_ID && (todo->priority < PRIORITY_LOW ||
+            todo->priority > PRIORITY_HIGH || todo->status > STATUS_COMPLETED))) {
+            chunk->bad_slot = i;
+            return;
+        }
+        if (todo->id > chunk->max_id) {
+            chunk->max_id = todo->id;
         }
     }
-    
-    if (index == -1) {
-        printf("Todo with ID %d not found.\n", id);
-        return -1;
+}
+
+/**
+ * @brief Record the IDs of one chunk in its own bitmap
+ * @param arg The IndexBuild
+ * @param task Chunk number
+ */
+static void index_mark_chunk(void* arg, int task) {
+    IndexBuild* build = (IndexBuild*)arg;
+    IndexChunk* chunk = &build->chunks[task];
+    chunk->seen = (uint64_t*)calloc(build->words, sizeof(uint64_t));
+    if (!chunk->seen) {
+        return;
     }
     
-    // Shift remaining todos to fill the gap
-    for (int i = index; i < list->count - 1; i++) {
-        list->todos[i] = list->todos[i + 1];
+    const Todo* todos = build->list->todos;
+    for (int i = chunk->start; i < chunk->end; i++) {
+        int id = todos[i].id;
+        if (id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        uint64_t bit = 1ull << (id % 64);
+        if (chunk->seen[id / 64] & bit) {
+            chunk->duplicate_id = id;
+            return;
+        }
+        chunk->seen[id / 64] |= bit;
     }
-    
-    list->count--;
-    printf("Todo with ID %d deleted successfully.\n", id);
-    return 0;
 }
 
 /**
- * @brief Mark a todo as completed
- * @param list Pointer to the todo list
- * @param id ID of the todo to complete
- * @return 0 on success, -1 if not found
+ * @brief Look for IDs present in more than one chunk within a range of IDs
+ * @param arg The IndexBuild
+ * @param task ID range number (PARALLEL_BUCKET_IDS each)
  */
-int todo_complete(TodoList* list, int id) {
-    Todo* todo = todo_find_by_id(list, id);
-    if (!todo) {
-        printf("Todo with ID %d not found.\n", id);
-        return -1;
+static void index_merge_range(void* arg, int task) {
+    IndexBuild* build = (IndexBuild*)arg;
+    size_t first = (size_t)task * (PARALLEL_BUCKET_IDS / 64);
+    size_t last = first + PARALLEL_BUCKET_IDS / 64 < build->words ? first + PARALLEL_BUCKET_IDS / 64 : build->words;
+    for (size_t word = first; word < last; word++) {
+        uint64_t seen = 0;
+        for (int c = 0; c < build->chunk_count; c++) {
+            uint64_t bits = build->chunks[c].seen[word];
+            if (seen & bits) {
+                build->duplicates[task] = (int)(word * 64) + lowest_bit(seen & bits);
+                return;
+            }
+            seen |= bits;
+        }
     }
-    
-    if (todo->status == STATUS_COMPLETED) {
-        printf("Todo with ID %d is already completed.\n", id);
-        return 0;
+}
+
+/**
+ * @brief Point the ID index at the slots of one chunk
+ * @param arg The IndexBuild
+ * @param task Chunk number
+ */
+static void index_fill_chunk(void* arg, int task) {
+    IndexBuild* build = (IndexBuild*)arg;
+    IndexChunk* chunk = &build->chunks[task];
+    TodoList* list = build->list;
+    for (int i = chunk->start; i < chunk->end; i++) {
+        if (list->todos[i].id != TODO_TOMBSTONE_ID) {
+            list->id_index[list->todos[i].id] = i;
+        }
     }
-    
-    todo->status = STATUS_COMPLETED;
-    todo->updated_at = time(NULL);
-    
-    printf("Todo with ID %d marked as completed.\n", id);
-    return 0;
 }
 
 /**
- * @brief Mark a todo as pending
- * @param list Pointer to the todo list
- * @param id ID of the todo to mark pending
- * @return 0 on success, -1 if not found
+ * @brief Add the todos of a range of IDs to the query buckets
+ * @param arg The IndexBuild
+ * @param task ID range number (PARALLEL_BUCKET_IDS each)
  */
-int todo_mark_pending(TodoList* list, int id) {
-    Todo* todo = todo_find_by_id(list, id);
-    if (!todo) {
-        printf("Todo with ID %d not found.\n", id);
-        return -1;
+static void index_fill_buckets(void* arg, int task) {
+    IndexBuild* build = (IndexBuild*)arg;
+    TodoList* list = build->list;
+    int* counts = &build->counts[task * TODO_BUCKET_COUNT];
+    int first = task * PARALLEL_BUCKET_IDS;
+    int last = list->index_capacity - first > PARALLEL_BUCKET_IDS ? first + PARALLEL_BUCKET_IDS : list->index_capacity;
+    for (int id = first; id < last; id++) {
+        int slot = list->id_index[id];
+        if (slot >= 0) {
+            const Todo* todo = &list->todos[slot];
+            int bucket = TODO_BUCKET(todo->status, todo->priority);
+            bucket_mark(list, bucket, id);
+            counts[bucket]++;
+        }
+    }
+}
+
+/**
+ * @brief Rebuild the ID index and query buckets on several threads
+ *
+ * The slots are split into one chunk per thread. Each chunk is validated
+ * and its IDs collected into a private bitmap; merging the bitmaps finds
+ * duplicates across chunks. Once IDs are known to be unique, the chunks
+ * fill in the ID index, and the buckets are filled by ranges of IDs,
+ * which never share a bitmap word.
+ *
+ * @param list Pointer to the todo list (without sorted views or columns)
+ * @param chunk_count Number of chunks (at least 2)
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+static int rebuild_index_parallel(TodoList* list, int chunk_count) {
+    IndexBuild build = {list, NULL, chunk_count, 0, NULL, NULL};
+    build.chunks = (IndexChunk*)calloc(chunk_count, sizeof(IndexChunk));
+    if (!build.chunks) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for ID index");
+        return TODO_ERR_NO_MEMORY;
+    }
+    for (int c = 0; c < chunk_count; c++) {
+        build.chunks[c].start = (int)((int64_t)list->used * c / chunk_count);
+        build.chunks[c].end = (int)((int64_t)list->used * (c + 1) / chunk_count);
+        build.chunks[c].bad_slot = -1;
     }
     
-    if (todo->status == STATUS_PENDING) {
-        printf("Todo with ID %d is already pending.\n", id);
-        return 0;
+    todo_parallel_run(chunk_count, index_check_chunk, &build);
+    int max_id = 0;
+    int result = TODO_OK;
+    for (int c = 0; c < chunk_count && result == TODO_OK; c++) {
+        const IndexChunk* chunk = &build.chunks[c];
+        if (chunk->bad_slot >= 0) {
+            const Todo* todo = &list->todos[chunk->bad_slot];
+            if (todo->id < 0) {
+                todo_log(TODO_LOG_ERROR, "Invalid todo ID %d", todo->id);
+            } else {
+                todo_log(TODO_LOG_ERROR, "Todo %d has an invalid priority or status", todo->id);
+            }
+            result = TODO_ERR_CORRUPT;
+        }
+        if (chunk->max_id > max_id) {
+            max_id = chunk->max_id;
+        }
     }
     
-    todo->status = STATUS_PENDING;
-    todo->updated_at = time(NULL);
+    if (result == TODO_OK && index_reserve(list, max_id > list->next_id ? max_id : list->next_id) != 0) {
+        result = TODO_ERR_NO_MEMORY;
+    }
     
-    printf("Todo with ID %d marked as pending.\n", id);
-    return 0;
+    int ranges = (list->index_capacity + PARALLEL_BUCKET_IDS - 1) / PARALLEL_BUCKET_IDS;
+    if (result == TODO_OK) {
+        build.words = bucket_words(list->index_capacity);
+        build.duplicates = (int*)calloc(ranges, sizeof(int));
+        build.counts = (int*)calloc((size_t)ranges * TODO_BUCKET_COUNT, sizeof(int));
+        if (build.duplicates && build.counts) {
+            todo_parallel_run(chunk_count, index_mark_chunk, &build);
+        }
+        for (int c = 0; c < chunk_count; c++) {
+            if (!build.chunks[c].seen) {
+                todo_log(TODO_LOG_ERROR, "Memory allocation failed for ID index");
+                result = TODO_ERR_NO_MEMORY;
+                break;
+            }
+        }
+    }
+    
+    if (result == TODO_OK) {
+        todo_parallel_run(ranges, index_merge_range, &build);
+        int duplicate_id = 0;
+        for (int c = 0; c < chunk_count && !duplicate_id; c++) {
+            duplicate_id = build.chunks[c].duplicate_id;
+        }
+        for (int r = 0; r < ranges && !duplicate_id; r++) {
+            duplicate_id = build.duplicates[r];
+        }
+        if (duplicate_id) {
+            todo_log(TODO_LOG_ERROR, "Duplicate todo ID %d", duplicate_id);
+            result = TODO_ERR_CORRUPT;
+        }
+    }
+    
+    if (result == TODO_OK) {
+        for (int i = 0; i < list->index_capacity; i++) {
+            list->id_index[i] = -1;
+        }
+        secondary_reset(list);
+        todo_parallel_run(chunk_count, index_fill_chunk, &build);
+        todo_parallel_run(ranges, index_fill_buckets, &build);
+        
+        list->count = 0;
+        for (int r = 0; r < ranges; r++) {
+            for (int bucket = 0; bucket < TODO_BUCKET_COUNT; bucket++) {
+                list->bucket_counts[bucket] += build.counts[r * TODO_BUCKET_COUNT + bucket];
+                list->count += build.counts[r * TODO_BUCKET_COUNT + bucket];
+            }
+        }
+        text_rebuild(list);
+        
+        // Never hand out an ID that is already in use
+        if (list->next_id <= max_id) {
+            list->next_id = max_id + 1;
+        }
+    }
+    
+    for (int c = 0; c < chunk_count; c++) {
+        free(build.chunks[c].seen);
+    }
+    free(build.chunks);
+    free(build.duplicates);
+    free(build.counts);
+    return result;
 }
 
 /**
- * @brief Find a todo by ID
+ * @brief Rebuild the ID index from the current contents of the list
  * @param list Pointer to the todo list
- * @param id ID to search for
- * @return Pointer to todo if found, NULL otherwise
+ * @return TODO_OK on success, negative TodoError on failure
  */
-Todo* todo_find_by_id(const TodoList* list, int id) {
+int todo_list_rebuild_index(TodoList* list) {
     if (!list) {
-        return NULL;
+        return TODO_ERR_INVALID;
+    }
+    
+    // Large lists are indexed on several threads; sorted views and
+    // columns are only maintained one todo at a time
+    int chunk_count = list->used / PARALLEL_INDEX_MIN_SLOTS;
+    if (chunk_count > todo_parallelism()) {
+        chunk_count = todo_parallelism();
+    }
+    int ordered = list->columns != NULL;
+    for (int key = 0; key < TODO_SORT_COUNT; key++) {
+        ordered |= list->views[key] != NULL;
+    }
+    if (chunk_count > 1 && !ordered) {
+        return rebuild_index_parallel(list, chunk_count);
+    }
+    
+    // Find the largest ID so the index is grown only once
+    int max_id = 0;
+    for (int i = 0; i < list->used; i++) {
+        const Todo* todo = &list->todos[i];
+        if (todo->id < 0) {
+            todo_log(TODO_LOG_ERROR, "Invalid todo ID %d", todo->id);
+            return TODO_ERR_CORRUPT;
+        }
+        
+        // Every live todo must map to a query bucket
+        if (todo->id != TODO_TOMBSTONE_ID && (todo->priority < PRIORITY_LOW ||
+            todo->priority > PRIORITY_HIGH || todo->status > STATUS_COMPLETED)) {
+            todo_log(TODO_LOG_ERROR, "Todo %d has an invalid priority or status", todo->id);
+            return TODO_ERR_CORRUPT;
+        }
+        if (list->todos[i].id > max_id) {
+            max_id = list->todos[i].id;
+        }
+    }
+    
+    if (index_reserve(list, max_id > list->next_id ? max_id : list->next_id) != 0) {
+        return TODO_ERR_NO_MEMORY;
     }
     
-    for (int i = 0; i < list->count; i++) {
-        if (list->todos[i].id == id) {
-            return &list->todos[i];
+    for (int i = 0; i < list->index_capacity; i++) {
+        list->id_index[i] = -1;
+    }
+    secondary_reset(list);
+    
+    list->count = 0;
+    for (int i = 0; i < list->used; i++) {
+        int id = list->todos[i].id;
+        if (id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        if (list->id_index[id] != -1) {
+            todo_log(TODO_LOG_ERROR, "Duplicate todo ID %d", id);
+            return TODO_ERR_CORRUPT;
         }
+        list->id_index[id] = i;
+        list->count++;
+        secondary_insert(list, &list->todos[i]);
     }
+    text_rebuild(list);
     
-    return NULL;
+    // Never hand out an ID that is already in use
+    if (list->next_id <= max_id) {
+        list->next_id = max_id + 1;
+    }
+    
+    return 0;
 }
 
 /**
@@ -346,4 +2201,22 @@ const char* get_status_string(Status status) {
         case STATUS_COMPLETED: return "Completed";
         default:               return "Unknown";
     }
+}
+
+/**
+ * @brief Get a human-readable description of a result code
+ * @param error TodoError value (or any negative return code)
+ * @return Static description string
+ */
+const char* todo_strerror(int error) {
+    switch (error) {
+        case TODO_OK:            return "Success";
+        case TODO_ERR_INVALID:   return "Invalid argument";
+        case TODO_ERR_NOT_FOUND: return "Todo not found";
+        case TODO_ERR_TOO_LONG:  return "Text too long";
+        case TODO_ERR_NO_MEMORY: return "Out of memory";
+        case TODO_ERR_IO:        return "I/O error";
+        case TODO_ERR_CORRUPT:   return "Corrupt data";
+        default:                 return error > 0 ? "Success" : "Unknown error";
+    }
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+/**
+ * @file todo_log.c
+ * @brief Implementation of pluggable diagnostic logging
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file stores the application's log handler and formats messages
+ * for it on demand.
+ */
+
+#include "../include/todo_log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+// Longest message passed to a handler; longer ones are truncated
+#define LOG_MESSAGE_SIZE 512
+
+static TodoLogFn log_handler = NULL;
+static void* log_user_data = NULL;
+
+/**
+ * @brief Install the handler that receives library log messages
+ * @param handler Handler to call, or NULL to discard messages
+ * @param user_data Pointer handed back to the handler on every call
+ */
+void todo_set_log_handler(TodoLogFn handler, void* user_data) {
+    log_handler = handler;
+    log_user_data = user_data;
+}
+
+/**
+ * @brief Emit a log message (used internally by the library)
+ * @param level Severity of the message
+ * @param format printf-style format string
+ */
+void todo_log(TodoLogLevel level, const char* format, ...) {
+    if (!log_handler) {
+        return;
+    }
+    
+    char message[LOG_MESSAGE_SIZE];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    
+    log_handler(level, message, log_user_data);
+}
@@ -0,0 +1,527 @@
+/**
+ * @file todo_sync.c
+ * @brief Implementation of the portable synchronization primitives
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file maps the wrappers onto POSIX threads, or on Windows onto
+ * SRWLOCK, CRITICAL_SECTION, CONDITION_VARIABLE and CreateThread, and
+ * implements the fork-join pool on top of them.
+ */
+
+// Needed for pthread_rwlock_t under -std=c99, and for writer preference on glibc
+#define _POSIX_C_SOURCE 200809L
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "../include/todo_sync.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+struct TodoRwLock {
+#ifdef _WIN32
+    SRWLOCK lock;
+#else
+    pthread_rwlock_t lock;
+#endif
+};
+
+struct TodoMutex {
+#ifdef _WIN32
+    CRITICAL_SECTION lock;
+#else
+    pthread_mutex_t lock;
+#endif
+};
+
+struct TodoCond {
+#ifdef _WIN32
+    CONDITION_VARIABLE cond;
+#else
+    pthread_cond_t cond;
+#endif
+};
+
+struct TodoThread {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    void (*fn)(void* arg);
+    void* arg;
+};
+
+// Process-wide lock behind todo_global_lock, usable before any setup
+#ifdef _WIN32
+static SRWLOCK global_lock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t global_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+// Called by every thread of todo_thread_start as it finishes (guarded by global_lock)
+static void (*thread_exit_hook)(void) = NULL;
+
+/**
+ * @brief Shared state of one todo_parallel_run call
+ */
+typedef struct {
+    TodoMutex* mutex;                     // Guards next
+    int next;                             // Next task to hand out
+    int tasks;
+    void (*fn)(void* arg, int task);
+    void* arg;
+} ParallelRun;
+
+// Thread count requested with todo_set_parallelism (0 for one per processor)
+static int parallelism_setting = 0;
+
+/**
+ * @brief Create a reader-writer lock
+ * @return New lock, NULL on failure
+ */
+TodoRwLock* todo_rwlock_create(void) {
+    TodoRwLock* lock = (TodoRwLock*)malloc(sizeof(TodoRwLock));
+    if (!lock) {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    InitializeSRWLock(&lock->lock);
+#else
+    pthread_rwlockattr_t attributes;
+    pthread_rwlockattr_init(&attributes);
+#ifdef __GLIBC__
+    // glibc prefers readers by default, so a steady stream of them starves writers
+    pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    int result = pthread_rwlock_init(&lock->lock, &attributes);
+    pthread_rwlockattr_destroy(&attributes);
+    if (result != 0) {
+        free(lock);
+        return NULL;
+    }
+#endif
+    return lock;
+}
+
+/**
+ * @brief Destroy a reader-writer lock, which must not be held
+ * @param lock Lock to destroy (may be NULL)
+ */
+void todo_rwlock_destroy(TodoRwLock* lock) {
+    if (lock) {
+#ifndef _WIN32
+        pthread_rwlock_destroy(&lock->lock);
+#endif
+        free(lock);
+    }
+}
+
+/**
+ * @brief Acquire a lock in shared mode, waiting for any writer
+ * @param lock Lock to acquire
+ */
+void todo_rwlock_read_lock(TodoRwLock* lock) {
+#ifdef _WIN32
+    AcquireSRWLockShared(&lock->lock);
+#else
+    pthread_rwlock_rdlock(&lock->lock);
+#endif
+}
+
+/**
+ * @brief Release a lock held in shared mode
+ * @param lock Lock to release
+ */
+void todo_rwlock_read_unlock(TodoRwLock* lock) {
+#ifdef _WIN32
+    ReleaseSRWLockShared(&lock->lock);
+#else
+    pthread_rwlock_unlock(&lock->lock);
+#endif
+}
+
+/**
+ * @brief Acquire a lock in exclusive mode, waiting for readers and writers
+ * @param lock Lock to acquire
+ */
+void todo_rwlock_write_lock(TodoRwLock* lock) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&lock->lock);
+#else
+    pthread_rwlock_wrlock(&lock->lock);
+#endif
+}
+
+/**
+ * @brief Release a lock held in exclusive mode
+ * @param lock Lock to release
+ */
+void todo_rwlock_write_unlock(TodoRwLock* lock) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&lock->lock);
+#else
+    pthread_rwlock_unlock(&lock->lock);
+#endif
+}
+
+/**
+ * @brief Create a mutex
+ * @return New mutex, NULL on failure
+ */
+TodoMutex* todo_mutex_create(void) {
+    TodoMutex* mutex = (TodoMutex*)malloc(sizeof(TodoMutex));
+    if (!mutex) {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    InitializeCriticalSection(&mutex->lock);
+#else
+    if (pthread_mutex_init(&mutex->lock, NULL) != 0) {
+        free(mutex);
+        return NULL;
+    }
+#endif
+    return mutex;
+}
+
+/**
+ * @brief Destroy a mutex, which must not be held
+ * @param mutex Mutex to destroy (may be NULL)
+ */
+void todo_mutex_destroy(TodoMutex* mutex) {
+    if (mutex) {
+#ifdef _WIN32
+        DeleteCriticalSection(&mutex->lock);
+#else
+        pthread_mutex_destroy(&mutex->lock);
+#endif
+        free(mutex);
+    }
+}
+
+/**
+ * @brief Acquire a mutex
+ * @param mutex Mutex to acquire
+ */
+void todo_mutex_lock(TodoMutex* mutex) {
+#ifdef _WIN32
+    EnterCriticalSection(&mutex->lock);
+#else
+    pthread_mutex_lock(&mutex->lock);
+#endif
+}
+
+/**
+ * @brief Release a mutex
+ * @param mutex Mutex to release
+ */
+void todo_mutex_unlock(TodoMutex* mutex) {
+#ifdef _WIN32
+    LeaveCriticalSection(&mutex->lock);
+#else
+    pthread_mutex_unlock(&mutex->lock);
+#endif
+}
+
+/**
+ * @brief Create a condition variable
+ * @return New condition variable, NULL on failure
+ */
+TodoCond* todo_cond_create(void) {
+    TodoCond* cond = (TodoCond*)malloc(sizeof(TodoCond));
+    if (!cond) {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    InitializeConditionVariable(&cond->cond);
+#else
+    if (pthread_cond_init(&cond->cond, NULL) != 0) {
+        free(cond);
+        return NULL;
+    }
+#endif
+    return cond;
+}
+
+/**
+ * @brief Destroy a condition variable nobody is waiting on
+ * @param cond Condition variable to destroy (may be NULL)
+ */
+void todo_cond_destroy(TodoCond* cond) {
+    if (cond) {
+#ifndef _WIN32
+        pthread_cond_destroy(&cond->cond);
+#endif
+        free(cond);
+    }
+}
+
+/**
+ * @brief Release a mutex, wait for a signal and reacquire the mutex
+ * @param cond Condition variable to wait on
+ * @param mutex Mutex held by the caller
+ */
+void todo_cond_wait(TodoCond* cond, TodoMutex* mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(&cond->cond, &mutex->lock, INFINITE);
+#else
+    pthread_cond_wait(&cond->cond, &mutex->lock);
+#endif
+}
+
+/**
+ * @brief Wake one thread waiting on a condition variable
+ * @param cond Condition variable to signal
+ */
+void todo_cond_signal(TodoCond* cond) {
+#ifdef _WIN32
+    WakeConditionVariable(&cond->cond);
+#else
+    pthread_cond_signal(&cond->cond);
+#endif
+}
+
+/**
+ * @brief Wake every thread waiting on a condition variable
+ * @param cond Condition variable to signal
+ */
+void todo_cond_broadcast(TodoCond* cond) {
+#ifdef _WIN32
+    WakeAllConditionVariable(&cond->cond);
+#else
+    pthread_cond_broadcast(&cond->cond);
+#endif
+}
+
+/**
+ * @brief Take the process-wide lock
+ */
+void todo_global_lock(void) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&global_lock);
+#else
+    pthread_mutex_lock(&global_lock);
+#endif
+}
+
+/**
+ * @brief Release the process-wide lock
+ */
+void todo_global_unlock(void) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&global_lock);
+#else
+    pthread_mutex_unlock(&global_lock);
+#endif
+}
+
+/**
+ * @brief Set the function threads call as they finish
+ * @param hook Function to call (NULL for none)
+ */
+void todo_thread_set_exit_hook(void (*hook)(void)) {
+    todo_global_lock();
+    thread_exit_hook = hook;
+    todo_global_unlock();
+}
+
+/**
+ * @brief Run a thread's function, then the exit hook
+ * @param thread Thread being run
+ */
+static void run_thread(TodoThread* thread) {
+    thread->fn(thread->arg);
+
+    todo_global_lock();
+    void (*hook)(void) = thread_exit_hook;
+    todo_global_unlock();
+    if (hook) {
+        hook();
+    }
+}
+
+#ifdef _WIN32
+/**
+ * @brief Entry point adapting a TodoThread to the Win32 thread signature
+ * @param arg The TodoThread
+ * @return 0
+ */
+static DWORD WINAPI thread_main(LPVOID arg) {
+    run_thread((TodoThread*)arg);
+    return 0;
+}
+#else
+/**
+ * @brief Entry point adapting a TodoThread to the pthread signature
+ * @param arg The TodoThread
+ * @return NULL
+ */
+static void* thread_main(void* arg) {
+    run_thread((TodoThread*)arg);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Start a thread
+ * @param fn Function run by the thread
+ * @param arg Argument passed to fn
+ * @return Handle to pass to todo_thread_join, NULL on failure
+ */
+TodoThread* todo_thread_start(void (*fn)(void* arg), void* arg) {
+    TodoThread* thread = (TodoThread*)malloc(sizeof(TodoThread));
+    if (!thread) {
+        return NULL;
+    }
+    thread->fn = fn;
+    thread->arg = arg;
+
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, thread_main, thread, 0, NULL);
+    if (!thread->handle) {
+        free(thread);
+        return NULL;
+    }
+#else
+    if (pthread_create(&thread->handle, NULL, thread_main, thread) != 0) {
+        free(thread);
+        return NULL;
+    }
+#endif
+    return thread;
+}
+
+/**
+ * @brief Wait for a thread to finish and free its handle
+ * @param thread Thread to join
+ */
+void todo_thread_join(TodoThread* thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+    free(thread);
+}
+
+/**
+ * @brief Read a monotonic clock
+ * @return Nanoseconds since an arbitrary point, never 0
+ */
+uint64_t todo_clock_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    uint64_t ticks = (uint64_t)counter.QuadPart;
+    uint64_t per_second = (uint64_t)frequency.QuadPart;
+    uint64_t ns = ticks / per_second * 1000000000u + ticks % per_second * 1000000000u / per_second;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t ns = (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+    return ns ? ns : 1;
+}
+
+/**
+ * @brief Number of processors available to the process
+ * @return Processor count (at least 1)
+ */
+int todo_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Set how many threads todo_parallel_run may use
+ * @param threads Thread count, or 0 for one per processor
+ */
+void todo_set_parallelism(int threads) {
+    parallelism_setting = threads > 0 ? threads : 0;
+}
+
+/**
+ * @brief Number of threads todo_parallel_run uses
+ * @return Thread count between 1 and TODO_MAX_PARALLELISM
+ */
+int todo_parallelism(void) {
+    int threads = parallelism_setting > 0 ? parallelism_setting : todo_cpu_count();
+    return threads < TODO_MAX_PARALLELISM ? threads : TODO_MAX_PARALLELISM;
+}
+
+/**
+ * @brief Run tasks until none are left
+ * @param arg The ParallelRun
+ */
+static void parallel_worker(void* arg) {
+    ParallelRun* run = (ParallelRun*)arg;
+    for (;;) {
+        todo_mutex_lock(run->mutex);
+        int task = run->next < run->tasks ? run->next++ : -1;
+        todo_mutex_unlock(run->mutex);
+        if (task < 0) {
+            return;
+        }
+        run->fn(run->arg, task);
+    }
+}
+
+/**
+ * @brief Run tasks 0 to tasks - 1 on a pool of threads and wait for them
+ * @param tasks Number of tasks
+ * @param fn Function run once per task
+ * @param arg Argument passed to fn
+ */
+void todo_parallel_run(int tasks, void (*fn)(void* arg, int task), void* arg) {
+    int threads = todo_parallelism();
+    if (threads > tasks) {
+        threads = tasks;
+    }
+
+    ParallelRun run = {NULL, 0, tasks, fn, arg};
+    if (threads > 1) {
+        run.mutex = todo_mutex_create();
+    }
+    if (!run.mutex) {
+        for (int task = 0; task < tasks; task++) {
+            fn(arg, task);
+        }
+        return;
+    }
+
+    // Threads that fail to start just leave more tasks for the others
+    TodoThread* workers[TODO_MAX_PARALLELISM];
+    int started = 0;
+    while (started < threads - 1 && (workers[started] = todo_thread_start(parallel_worker, &run)) != NULL) {
+        started++;
+    }
+    parallel_worker(&run);
+
+    for (int i = 0; i < started; i++) {
+        todo_thread_join(workers[i]);
+    }
+    todo_mutex_destroy(run.mutex);
+}
\ No newline at end of file
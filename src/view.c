@@ -0,0 +1,350 @@
+/**
+ * @file view.c
+ * @brief Implementation of incrementally maintained sorted views
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements sorted views as skip lists. Each node stores the
+ * sort key of its todo next to the ID, so searches never touch the todo
+ * array; the list removes a todo before changing its fields and inserts
+ * it again afterwards, so the stored key always matches the node. Nodes
+ * come from per-height pools in an arena owned by the view, so resetting
+ * or destroying a view frees a few chunks rather than every node.
+ */
+
+#include "../include/view.h"
+#include "../include/arena.h"
+#include "../include/todo_log.h"
+
+#include <stddef.h>
+
+// Tallest skip list tower; with a 1-in-4 promotion rate this covers 4^16 todos
+#define VIEW_MAX_LEVEL 16
+
+/**
+ * @brief Skip list node for one todo
+ */
+typedef struct ViewNode {
+    int64_t primary;              // Sort key, compared first
+    int64_t secondary;            // Sort key, compared second
+    int id;                       // Todo ID, compared last
+    int height;                   // Number of levels the node is linked into
+    struct ViewNode* next[];      // Successor at each level
+} ViewNode;
+
+struct TodoView {
+    TodoSortKey key;
+    int levels;                         // Levels currently in use
+    uint32_t random_state;              // xorshift state for tower heights
+    ViewNode* head[VIEW_MAX_LEVEL];     // First node at each level
+    Arena arena;                        // Storage of every node
+    Pool pools[VIEW_MAX_LEVEL];         // Nodes of each height, from arena
+};
+
+/**
+ * @brief Compute the sort key of a todo for a view
+ *
+ * Keys are arranged so that ascending (primary, secondary, id) order is
+ * the view's order; "descending" fields are stored bitwise inverted.
+ *
+ * @param key Order of the view
+ * @param todo Todo to compute the key for
+ * @param node Receives primary, secondary and id
+ */
+static void make_key(TodoSortKey key, const Todo* todo, ViewNode* node) {
+    switch (key) {
+        case TODO_SORT_PRIORITY:
+            node->primary = -(int64_t)todo->priority;
+            node->secondary = todo->created_at;
+            node->id = todo->id;
+            break;
+        case TODO_SORT_CREATED:
+            node->primary = todo->created_at;
+            node->secondary = 0;
+            node->id = todo->id;
+            break;
+        default:
+            node->primary = ~todo->updated_at;
+            node->secondary = 0;
+            node->id = ~todo->id;
+            break;
+    }
+}
+
+/**
+ * @brief Compare two node keys
+ * @param a First key
+ * @param b Second key
+ * @return Negative, zero or positive as a sorts before, equal to or after b
+ */
+static int compare_keys(const ViewNode* a, const ViewNode* b) {
+    if (a->primary != b->primary) {
+        return a->primary < b->primary ? -1 : 1;
+    }
+    if (a->secondary != b->secondary) {
+        return a->secondary < b->secondary ? -1 : 1;
+    }
+    if (a->id != b->id) {
+        return a->id < b->id ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Find, at every level, the link that a key would be inserted at
+ * @param view View to search
+ * @param key Key to search for
+ * @param links Receives, per level, the link pointing at the first node not before key
+ */
+static void find_links(TodoView* view, const ViewNode* key, ViewNode** links[VIEW_MAX_LEVEL]) {
+    ViewNode** next = view->head;
+    for (int level = view->levels - 1; level >= 0; level--) {
+        while (next[level] && compare_keys(next[level], key) < 0) {
+            next = next[level]->next;
+        }
+        links[level] = &next[level];
+    }
+}
+
+/**
+ * @brief Draw a random tower height
+ * @param view View owning the random state
+ * @return Height between 1 and VIEW_MAX_LEVEL
+ */
+static int random_height(TodoView* view) {
+    uint32_t x = view->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    view->random_state = x;
+    
+    int height = 1;
+    while (height < VIEW_MAX_LEVEL && (x & 3) == 0) {
+        height++;
+        x >>= 2;
+    }
+    return height;
+}
+
+/**
+ * @brief Allocate an unlinked node for a todo
+ * @param view View the node is for
+ * @param todo Todo to take the key from
+ * @return New node, NULL on allocation failure
+ */
+static ViewNode* new_node(TodoView* view, const Todo* todo) {
+    int height = random_height(view);
+    ViewNode* node = (ViewNode*)pool_alloc(&view->pools[height - 1]);
+    if (!node) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for sorted view");
+        return NULL;
+    }
+    make_key(view->key, todo, node);
+    node->height = height;
+    return node;
+}
+
+/**
+ * @brief qsort comparator for an array of node pointers
+ * @param a Pointer to the first node pointer
+ * @param b Pointer to the second node pointer
+ * @return Result of compare_keys
+ */
+static int compare_node_pointers(const void* a, const void* b) {
+    return compare_keys(*(ViewNode* const*)a, *(ViewNode* const*)b);
+}
+
+/**
+ * @brief Add a todo to a view (used internally by the list)
+ * @param view View to update
+ * @param todo Live todo with its current field values
+ * @return 0 on success, -1 on allocation failure
+ */
+int view_insert(TodoView* view, const Todo* todo) {
+    ViewNode* node = new_node(view, todo);
+    if (!node) {
+        return -1;
+    }
+    int height = node->height;
+    
+    ViewNode** links[VIEW_MAX_LEVEL];
+    find_links(view, node, links);
+    for (int level = view->levels; level < height; level++) {
+        links[level] = &view->head[level];
+    }
+    if (height > view->levels) {
+        view->levels = height;
+    }
+    
+    for (int level = 0; level < height; level++) {
+        node->next[level] = *links[level];
+        *links[level] = node;
+    }
+    return 0;
+}
+
+/**
+ * @brief Remove a todo from a view (used internally by the list)
+ * @param view View to update
+ * @param todo Todo with the field values it had when it was inserted
+ */
+void view_erase(TodoView* view, const Todo* todo) {
+    ViewNode key;
+    make_key(view->key, todo, &key);
+    
+    ViewNode** links[VIEW_MAX_LEVEL];
+    find_links(view, &key, links);
+    ViewNode* node = view->levels > 0 ? *links[0] : NULL;
+    if (!node || compare_keys(node, &key) != 0) {
+        return;
+    }
+    
+    for (int level = 0; level < node->height; level++) {
+        *links[level] = node->next[level];
+    }
+    pool_free(&view->pools[node->height - 1], node);
+    
+    while (view->levels > 0 && !view->head[view->levels - 1]) {
+        view->levels--;
+    }
+}
+
+/**
+ * @brief Remove every todo from a view (used internally by the list)
+ * @param view View to empty
+ */
+void view_reset(TodoView* view) {
+    arena_reset(&view->arena);
+    for (int level = 0; level < VIEW_MAX_LEVEL; level++) {
+        pool_reset(&view->pools[level]);
+        view->head[level] = NULL;
+    }
+    view->levels = 0;
+}
+
+/**
+ * @brief Free a view (used internally by the list)
+ * @param view View to free (may be NULL)
+ */
+void view_destroy(TodoView* view) {
+    if (view) {
+        arena_destroy(&view->arena);
+        free(view);
+    }
+}
+
+/**
+ * @brief Start maintaining a sorted view of a list
+ * @param list Pointer to the todo list
+ * @param key Order of the view
+ * @return TODO_OK on success, negative TodoError on failure
+ */
+int todo_list_enable_view(TodoList* list, TodoSortKey key) {
+    if (!list || (unsigned)key >= TODO_SORT_COUNT) {
+        return TODO_ERR_INVALID;
+    }
+    
+    if (list->views[key]) {
+        return TODO_OK;
+    }
+    
+    TodoView* view = (TodoView*)malloc(sizeof(TodoView));
+    if (!view) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for sorted view");
+        return TODO_ERR_NO_MEMORY;
+    }
+    view->key = key;
+    view->levels = 0;
+    view->random_state = 0x9E3779B9u ^ (uint32_t)key;
+    arena_init(&view->arena);
+    for (int level = 0; level < VIEW_MAX_LEVEL; level++) {
+        view->head[level] = NULL;
+        pool_init(&view->pools[level], &view->arena, offsetof(ViewNode, next) + sizeof(ViewNode*) * (level + 1));
+    }
+    
+    // Build from a sorted array of nodes rather than by repeated insertion
+    ViewNode** nodes = list->count > 0 ? (ViewNode**)malloc(sizeof(ViewNode*) * list->count) : NULL;
+    if (list->count > 0 && !nodes) {
+        todo_log(TODO_LOG_ERROR, "Memory allocation failed for sorted view");
+        free(view);
+        return TODO_ERR_NO_MEMORY;
+    }
+    
+    int n = 0;
+    for (int i = 0; i < list->used; i++) {
+        if (list->todos[i].id == TODO_TOMBSTONE_ID) {
+            continue;
+        }
+        nodes[n] = new_node(view, &list->todos[i]);
+        if (!nodes[n]) {
+            free(nodes);
+            view_destroy(view);
+            return TODO_ERR_NO_MEMORY;
+        }
+        n++;
+    }
+    if (n > 0) {
+        qsort(nodes, (size_t)n, sizeof(ViewNode*), compare_node_pointers);
+    }
+    
+    // Append in order, keeping the last link at each level
+    ViewNode** tails[VIEW_MAX_LEVEL];
+    for (int level = 0; level < VIEW_MAX_LEVEL; level++) {
+        tails[level] = &view->head[level];
+    }
+    for (int i = 0; i < n; i++) {
+        ViewNode* node = nodes[i];
+        for (int level = 0; level < node->height; level++) {
+            node->next[level] = NULL;
+            *tails[level] = node;
+            tails[level] = &node->next[level];
+        }
+        if (node->height > view->levels) {
+            view->levels = node->height;
+        }
+    }
+    free(nodes);
+    
+    list->views[key] = view;
+    return TODO_OK;
+}
+
+/**
+ * @brief Stop maintaining a sorted view and free it
+ * @param list Pointer to the todo list
+ * @param key Order of the view
+ */
+void todo_list_disable_view(TodoList* list, TodoSortKey key) {
+    if (!list || (unsigned)key >= TODO_SORT_COUNT) {
+        return;
+    }
+    
+    view_destroy(list->views[key]);
+    list->views[key] = NULL;
+}
+
+/**
+ * @brief Visit todos in the order of an enabled view
+ * @param list Pointer to the todo list
+ * @param key Order of the view, which must be enabled
+ * @param limit Most todos to visit (0 for all)
+ * @param fn Callback invoked for each todo
+ * @param user_data Context passed to fn
+ * @return Number of todos visited, TODO_ERR_INVALID if the view is not enabled
+ */
+int todo_view(const TodoList* list, TodoSortKey key, int limit, TodoVisitFn fn, void* user_data) {
+    if (!list || !fn || limit < 0 || (unsigned)key >= TODO_SORT_COUNT || !list->views[key]) {
+        return TODO_ERR_INVALID;
+    }
+    
+    int visited = 0;
+    for (const ViewNode* node = list->views[key]->head[0]; node && (limit == 0 || visited < limit);
+         node = node->next[0]) {
+        int id = key == TODO_SORT_UPDATED ? ~node->id : node->id;
+        visited++;
+        if (fn(list, todo_find_by_id(list, id), user_data) != 0) {
+            break;
+        }
+    }
+    return visited;
+}
\ No newline at end of file
@@ -0,0 +1,392 @@
+/**
+ * @file wire.c
+ * @brief Implementation of the server protocol encoding helpers
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements frame encoding into growable buffers and bounds-
+ * checked decoding of received frames. A failed allocation or a read
+ * past the end is remembered in the buffer or reader, so a whole frame
+ * can be encoded or decoded and checked once at the end.
+ */
+
+#include "../include/wire.h"
+#include "../include/codec.h"
+
+// Smallest allocation of a buffer
+#define WIRE_MIN_CAPACITY 4096
+
+/**
+ * @brief Prepare an empty buffer (allocates nothing)
+ * @param buffer Buffer to initialize
+ */
+void wire_buffer_init(WireBuffer* buffer) {
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+    buffer->error = TODO_OK;
+}
+
+/**
+ * @brief Free a buffer's storage
+ * @param buffer Buffer to free (left empty and reusable)
+ */
+void wire_buffer_free(WireBuffer* buffer) {
+    free(buffer->data);
+    wire_buffer_init(buffer);
+}
+
+/**
+ * @brief Drop the first bytes of a buffer, moving the rest to the front
+ * @param buffer Buffer to shrink
+ * @param count Number of bytes to drop
+ */
+void wire_buffer_consume(WireBuffer* buffer, size_t count) {
+    if (count >= buffer->size) {
+        buffer->size = 0;
+        return;
+    }
+    memmove(buffer->data, buffer->data + count, buffer->size - count);
+    buffer->size -= count;
+}
+
+/**
+ * @brief Make room for at least extra more bytes
+ * @param buffer Buffer to grow
+ * @param extra Number of bytes needed after size
+ * @return TODO_OK on success, TODO_ERR_NO_MEMORY on failure
+ */
+int wire_buffer_reserve(WireBuffer* buffer, size_t extra) {
+    if (buffer->error != TODO_OK) {
+        return buffer->error;
+    }
+    if (extra <= buffer->capacity - buffer->size) {
+        return TODO_OK;
+    }
+    
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : WIRE_MIN_CAPACITY;
+    while (capacity - buffer->size < extra) {
+        if (capacity > SIZE_MAX / 2) {
+            buffer->error = TODO_ERR_NO_MEMORY;
+            return buffer->error;
+        }
+        capacity *= 2;
+    }
+    
+    unsigned char* data = (unsigned char*)realloc(buffer->data, capacity);
+    if (!data) {
+        buffer->error = TODO_ERR_NO_MEMORY;
+        return buffer->error;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return TODO_OK;
+}
+
+/**
+ * @brief Append raw bytes
+ * @param buffer Buffer to append to
+ * @param bytes Bytes to append
+ * @param length Number of bytes
+ */
+static void put_bytes(WireBuffer* buffer, const void* bytes, size_t length) {
+    if (length > 0 && wire_buffer_reserve(buffer, length) == TODO_OK) {
+        memcpy(buffer->data + buffer->size, bytes, length);
+        buffer->size += length;
+    }
+}
+
+/**
+ * @brief Start a frame (its length is filled in by wire_end_frame)
+ * @param buffer Buffer to append to
+ * @param op Operation
+ * @param status Status (0 for requests)
+ * @param tag Tag of the request
+ * @return Offset of the frame, to pass to wire_end_frame
+ */
+size_t wire_begin_frame(WireBuffer* buffer, TodoWireOp op, int status, uint32_t tag) {
+    size_t start = buffer->size;
+    wire_put_u32(buffer, 0);
+    wire_put_u8(buffer, (uint8_t)op);
+    wire_put_u8(buffer, (uint8_t)(int8_t)status);
+    wire_put_u32(buffer, tag);
+    return start;
+}
+
+/**
+ * @brief Finish a frame started with wire_begin_frame
+ * @param buffer Buffer holding the frame
+ * @param start Offset returned by wire_begin_frame
+ */
+void wire_end_frame(WireBuffer* buffer, size_t start) {
+    if (buffer->error == TODO_OK) {
+        codec_put_u32(buffer->data + start, (uint32_t)(buffer->size - start - 4));
+    }
+}
+
+/**
+ * @brief Append an 8-bit value
+ * @param buffer Buffer to append to
+ * @param value Value to append
+ */
+void wire_put_u8(WireBuffer* buffer, uint8_t value) {
+    put_bytes(buffer, &value, 1);
+}
+
+/**
+ * @brief Append a little-endian 16-bit value
+ * @param buffer Buffer to append to
+ * @param value Value to append
+ */
+void wire_put_u16(WireBuffer* buffer, uint16_t value) {
+    unsigned char bytes[2];
+    codec_put_u16(bytes, value);
+    put_bytes(buffer, bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Append a little-endian 32-bit value
+ * @param buffer Buffer to append to
+ * @param value Value to append
+ */
+void wire_put_u32(WireBuffer* buffer, uint32_t value) {
+    unsigned char bytes[4];
+    codec_put_u32(bytes, value);
+    put_bytes(buffer, bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Append a little-endian 64-bit value
+ * @param buffer Buffer to append to
+ * @param value Value to append
+ */
+void wire_put_u64(WireBuffer* buffer, uint64_t value) {
+    unsigned char bytes[8];
+    codec_put_u64(bytes, value);
+    put_bytes(buffer, bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Append a length-prefixed string
+ * @param buffer Buffer to append to
+ * @param text String bytes (may be NULL if length is 0)
+ * @param length Number of bytes (below TODO_WIRE_KEEP)
+ */
+void wire_put_string(WireBuffer* buffer, const char* text, size_t length) {
+    wire_put_u16(buffer, (uint16_t)length);
+    put_bytes(buffer, text, length);
+}
+
+/**
+ * @brief Append a todo in the layout of GET and LIST responses
+ * @param buffer Buffer to append to
+ * @param list List owning the todo
+ * @param todo Live todo
+ */
+void wire_put_todo(WireBuffer* buffer, const TodoList* list, const Todo* todo) {
+    wire_put_u32(buffer, (uint32_t)todo->id);
+    wire_put_u8(buffer, todo->priority);
+    wire_put_u8(buffer, todo->status);
+    wire_put_u64(buffer, (uint64_t)todo->created_at);
+    wire_put_u64(buffer, (uint64_t)todo->updated_at);
+    wire_put_u64(buffer, (uint64_t)todo->due_at);
+    wire_put_string(buffer, todo_get_title(list, todo), todo->title_length);
+    wire_put_string(buffer, todo_get_description(list, todo), todo->desc_length);
+}
+
+/**
+ * @brief Append metrics in the layout of STATS responses
+ * @param buffer Buffer to append to
+ * @param metrics Metrics to append
+ */
+void wire_put_metrics(WireBuffer* buffer, const TodoMetrics* metrics) {
+    wire_put_u8(buffer, TODO_METRIC_COUNT);
+    wire_put_u8(buffer, TODO_METRICS_BUCKETS);
+    for (int op = 0; op < TODO_METRIC_COUNT; op++) {
+        const TodoOpMetrics* stats = &metrics->ops[op];
+        wire_put_u64(buffer, stats->calls);
+        wire_put_u64(buffer, stats->timed);
+        wire_put_u64(buffer, stats->total_ns);
+        wire_put_u64(buffer, stats->max_ns);
+        for (int bucket = 0; bucket < TODO_METRICS_BUCKETS; bucket++) {
+            wire_put_u64(buffer, stats->histogram[bucket]);
+        }
+    }
+    wire_put_u64(buffer, metrics->bytes_read);
+    wire_put_u64(buffer, metrics->bytes_written);
+    wire_put_u32(buffer, (uint32_t)metrics->threads);
+    wire_put_u8(buffer, (uint8_t)metrics->enabled);
+}
+
+/**
+ * @brief Decode the header of the frame at the start of some bytes
+ * @param data Received bytes
+ * @param size Number of bytes available
+ * @param body_size Receives the size of the body
+ * @param op Receives the operation
+ * @param status Receives the status
+ * @param tag Receives the tag
+ * @return 1 if the whole frame is available, 0 if more bytes are needed,
+ *         TODO_ERR_INVALID if the length field is malformed
+ */
+int wire_peek_frame(const unsigned char* data, size_t size, size_t* body_size,
+                    int* op, int* status, uint32_t* tag) {
+    if (size < TODO_WIRE_HEADER_SIZE) {
+        return 0;
+    }
+    
+    uint32_t length = codec_get_u32(data);
+    if (length < TODO_WIRE_HEADER_SIZE - 4) {
+        return TODO_ERR_INVALID;
+    }
+    *body_size = length - (TODO_WIRE_HEADER_SIZE - 4);
+    *op = data[4];
+    *status = (int8_t)data[5];
+    *tag = codec_get_u32(data + 6);
+    return size - TODO_WIRE_HEADER_SIZE >= *body_size;
+}
+
+/**
+ * @brief Start reading a frame body
+ * @param reader Reader to initialize
+ * @param data First byte of the body
+ * @param size Size of the body
+ */
+void wire_reader_init(WireReader* reader, const unsigned char* data, size_t size) {
+    reader->data = data;
+    reader->left = size;
+    reader->error = 0;
+}
+
+/**
+ * @brief Take bytes from a reader
+ * @param reader Reader
+ * @param length Number of bytes wanted
+ * @return First of the bytes, NULL (and the error set) if fewer are left
+ */
+static const unsigned char* take(WireReader* reader, size_t length) {
+    if (reader->error || reader->left < length) {
+        reader->error = 1;
+        return NULL;
+    }
+    const unsigned char* bytes = reader->data;
+    reader->data += length;
+    reader->left -= length;
+    return bytes;
+}
+
+/**
+ * @brief Read an 8-bit value
+ * @param reader Reader
+ * @return Value read (0 past the end)
+ */
+uint8_t wire_get_u8(WireReader* reader) {
+    const unsigned char* bytes = take(reader, 1);
+    return bytes ? bytes[0] : 0;
+}
+
+/**
+ * @brief Read a little-endian 16-bit value
+ * @param reader Reader
+ * @return Value read (0 past the end)
+ */
+uint16_t wire_get_u16(WireReader* reader) {
+    const unsigned char* bytes = take(reader, 2);
+    return bytes ? codec_get_u16(bytes) : 0;
+}
+
+/**
+ * @brief Read a little-endian 32-bit value
+ * @param reader Reader
+ * @return Value read (0 past the end)
+ */
+uint32_t wire_get_u32(WireReader* reader) {
+    const unsigned char* bytes = take(reader, 4);
+    return bytes ? codec_get_u32(bytes) : 0;
+}
+
+/**
+ * @brief Read a little-endian 64-bit value
+ * @param reader Reader
+ * @return Value read (0 past the end)
+ */
+uint64_t wire_get_u64(WireReader* reader) {
+    const unsigned char* bytes = take(reader, 8);
+    return bytes ? codec_get_u64(bytes) : 0;
+}
+
+/**
+ * @brief Read a length-prefixed string into a NUL-terminated buffer
+ * @param reader Reader
+ * @param buffer Receives the string
+ * @param size Size of buffer
+ * @return 1 if a string was read, 0 if it was TODO_WIRE_KEEP, TODO_ERR_TOO_LONG
+ *         if it does not fit, TODO_ERR_INVALID past the end
+ */
+int wire_get_string(WireReader* reader, char* buffer, size_t size) {
+    uint16_t length = wire_get_u16(reader);
+    if (length == TODO_WIRE_KEEP && !reader->error) {
+        return 0;
+    }
+    
+    const unsigned char* bytes = take(reader, length);
+    if (!bytes) {
+        return TODO_ERR_INVALID;
+    }
+    if (length >= size) {
+        return TODO_ERR_TOO_LONG;
+    }
+    memcpy(buffer, bytes, length);
+    buffer[length] = '\0';
+    return 1;
+}
+
+/**
+ * @brief Read a todo in the layout of GET and LIST responses
+ * @param reader Reader
+ * @param todo Receives the todo
+ * @return TODO_OK on success, TODO_ERR_INVALID if the body is malformed
+ */
+int wire_get_todo(WireReader* reader, TodoWireTodo* todo) {
+    todo->id = (int)wire_get_u32(reader);
+    todo->priority = (Priority)wire_get_u8(reader);
+    todo->status = (Status)wire_get_u8(reader);
+    todo->created_at = (int64_t)wire_get_u64(reader);
+    todo->updated_at = (int64_t)wire_get_u64(reader);
+    todo->due_at = (int64_t)wire_get_u64(reader);
+    if (wire_get_string(reader, todo->title, sizeof(todo->title)) != 1 ||
+        wire_get_string(reader, todo->description, sizeof(todo->description)) != 1) {
+        return TODO_ERR_INVALID;
+    }
+    return reader->error ? TODO_ERR_INVALID : TODO_OK;
+}
+
+/**
+ * @brief Read metrics in the layout of STATS responses
+ * @param reader Reader
+ * @param metrics Receives the metrics
+ * @return TODO_OK on success, TODO_ERR_INVALID if the body is malformed
+ */
+int wire_get_metrics(WireReader* reader, TodoMetrics* metrics) {
+    memset(metrics, 0, sizeof(TodoMetrics));
+    int ops = wire_get_u8(reader);
+    int buckets = wire_get_u8(reader);
+    for (int op = 0; op < ops && !reader->error; op++) {
+        TodoOpMetrics skipped;
+        TodoOpMetrics* stats = op < TODO_METRIC_COUNT ? &metrics->ops[op] : &skipped;
+        stats->calls = wire_get_u64(reader);
+        stats->timed = wire_get_u64(reader);
+        stats->total_ns = wire_get_u64(reader);
+        stats->max_ns = wire_get_u64(reader);
+        for (int bucket = 0; bucket < buckets; bucket++) {
+            // Slower buckets than this build keeps fold into its last one
+            uint64_t count = wire_get_u64(reader);
+            stats->histogram[bucket < TODO_METRICS_BUCKETS ? bucket : TODO_METRICS_BUCKETS - 1] += count;
+        }
+    }
+    metrics->bytes_read = wire_get_u64(reader);
+    metrics->bytes_written = wire_get_u64(reader);
+    metrics->threads = (int)wire_get_u32(reader);
+    metrics->enabled = wire_get_u8(reader);
+    return reader->error ? TODO_ERR_INVALID : TODO_OK;
+}
\ No newline at end of file
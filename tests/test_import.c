@@ -0,0 +1,129 @@
+/**
+ * @file test_import.c
+ * @brief Round-trip tests of the exporters and the importer
+ * @author Jiya Pancholi
+ * @date 2025-09-21
+ * 
+ * This file implements the program behind "make test". It builds a small
+ * list covering every exported field (priorities, both statuses, due
+ * dates, text needing CSV and JSON escapes), exports it as CSV and as
+ * JSON Lines, imports each export into an empty list and checks that
+ * every imported todo matches its original apart from the ID and the
+ * timestamps, which import assigns afresh. It prints one line per failed
+ * check and exits with status 1 if there was any.
+ */
+
+#include "../include/todo.h"
+#include "../include/file_io.h"
+#include "../include/import.h"
+
+// Directory the exports are written to (created if needed)
+#define TEST_DIR "build/tests"
+
+// Number of failed checks
+static int failures = 0;
+
+/**
+ * @brief Record a failed check unless a condition holds
+ * @param ok Condition that should hold
+ * @param what Description of the check
+ * @param id ID of the original todo being checked (0 if none)
+ */
+static void check(int ok, const char* what, int id) {
+    if (!ok) {
+        printf("FAIL: %s (todo %d)\n", what, id);
+        failures++;
+    }
+}
+
+/**
+ * @brief Build the list that is exported
+ * @return New list, NULL on failure
+ */
+static TodoList* build_list(void) {
+    TodoList* list = todo_list_create();
+    if (!list) {
+        return NULL;
+    }
+    
+    int plain = todo_create(list, "Buy milk", "2 litres", PRIORITY_LOW);
+    int quoted = todo_create(list, "Quote \"this\", please", "comma, quote \" and\nnewline", PRIORITY_HIGH);
+    int due = todo_create(list, "File taxes", "", PRIORITY_MEDIUM);
+    int done_due = todo_create(list, "Renew passport", "backslash \\ and tab\t", PRIORITY_HIGH);
+    todo_create(list, "No description", NULL, PRIORITY_MEDIUM);
+    
+    todo_set_due(list, due, (time_t)1767225600);
+    todo_set_due(list, done_due, (time_t)1750000000);
+    todo_complete(list, done_due);
+    todo_complete(list, quoted);
+    (void)plain;
+    return list;
+}
+
+/**
+ * @brief Export a list, import the file into an empty list and compare
+ * @param original List to export
+ * @param filename Export file
+ * @param csv Non-zero for CSV, zero for JSON Lines
+ */
+static void round_trip(const TodoList* original, const char* filename, int csv) {
+    const char* format = csv ? "CSV" : "JSON Lines";
+    int result = csv ? export_todos_to_csv(original, filename, NULL, NULL)
+                     : export_todos_to_jsonl(original, filename, NULL, NULL);
+    check(result == original->count, csv ? "export CSV" : "export JSON Lines", 0);
+    
+    TodoList* imported = todo_list_create();
+    int rejected = -1;
+    int count = imported ? import_todos(imported, filename, TODO_IMPORT_AUTO, &rejected) : TODO_ERR_NO_MEMORY;
+    check(count == original->count, csv ? "import CSV count" : "import JSON Lines count", 0);
+    check(rejected == 0, csv ? "import CSV rejected nothing" : "import JSON Lines rejected nothing", 0);
+    if (count != original->count) {
+        printf("  %s: imported %d of %d todos\n", format, count, original->count);
+        todo_list_destroy(imported);
+        return;
+    }
+    
+    // Both lists are in ID order, and import keeps the export's order
+    for (int i = 0; i < original->count; i++) {
+        const Todo* expected = &original->todos[i];
+        const Todo* actual = &imported->todos[i];
+        int id = expected->id;
+        check(strcmp(todo_get_title(original, expected), todo_get_title(imported, actual)) == 0, "title", id);
+        check(strcmp(todo_get_description(original, expected), todo_get_description(imported, actual)) == 0,
+              "description", id);
+        check(expected->priority == actual->priority, "priority", id);
+        check(expected->status == actual->status, "status", id);
+        check(expected->due_at == actual->due_at, "due_at", id);
+    }
+    if (failures > 0) {
+        printf("  while round-tripping %s through '%s'\n", format, filename);
+    }
+    todo_list_destroy(imported);
+}
+
+/**
+ * @brief Run the round-trip tests
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void) {
+    if (ensure_parent_directory(TEST_DIR "/") != TODO_OK) {
+        printf("FAIL: cannot create '%s'\n", TEST_DIR);
+        return 1;
+    }
+    TodoList* list = build_list();
+    if (!list) {
+        printf("FAIL: cannot build the test list\n");
+        return 1;
+    }
+    
+    round_trip(list, TEST_DIR "/round_trip.csv", 1);
+    round_trip(list, TEST_DIR "/round_trip.jsonl", 0);
+    todo_list_destroy(list);
+    
+    if (failures > 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All import round-trip checks passed\n");
+    return 0;
+}
\ No newline at end of file